@@ -0,0 +1,1061 @@
+/*
+ * ira - iRacing Application
+ * Microbenchmarks for the hot paths
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bench_alloc.h"
+#include "util/json.h"
+#include "irsdk/yaml_parser.h"
+#include "data/database.h"
+#include "filter/race_filter.h"
+
+#ifdef _WIN32
+#include "irsdk/irsdk.h"
+#include "telemetry/telemetry_log.h"
+#endif
+
+/*
+ * Usage: ira_bench [case...] [--schedule <path>] [--time <seconds>]
+ *
+ * Runs each case until it has taken at least the minimum time, then
+ * prints nanoseconds, allocations and bytes per operation, and the
+ * peak heap held above what was live before the run. Files the cases
+ * need are written to the current directory.
+ */
+
+/* Default minimum run time per case, in seconds */
+#define BENCH_MIN_TIME      0.5
+
+/* Synthetic catalog, roughly the size of the full iRacing service */
+#define SYN_TRACKS          450
+#define SYN_CARS            180
+#define SYN_CAR_CLASSES     200
+#define SYN_SERIES          420
+#define SYN_WEEKS           12
+#define SYN_OWNED_CARS      40
+#define SYN_OWNED_TRACKS    60
+
+/* Drivers in the synthetic session string */
+#define SYN_DRIVERS         60
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    bool (*setup)(void);
+    void (*run)(void);
+    void (*teardown)(void);
+    void (*idle)(void);         /* Untimed, between batches */
+} bench_case;
+
+/* Settings */
+static const char *g_schedule_path = "data/schedule.json";
+static double g_min_time = BENCH_MIN_TIME;
+
+/* Case state */
+static char *g_text;
+static ira_database *g_db;
+static filter_results *g_results;
+static int g_threads;
+static yaml_index *g_index;
+static char g_paths[SYN_DRIVERS + 1][128];
+static int g_path_next;
+static long long g_batch_limit;    /* Ops between idle() calls, 0 = no limit */
+
+/*
+ * Clock
+ */
+
+static double now_seconds(void)
+{
+#ifdef _WIN32
+    static double seconds_per_count;
+    LARGE_INTEGER now;
+    if (seconds_per_count == 0.0) {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        seconds_per_count = 1.0 / (double)freq.QuadPart;
+    }
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * seconds_per_count;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*
+ * Helper: Read a whole file as a string
+ */
+static char *read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *text = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (text && fread(text, 1, (size_t)size, f) == (size_t)size) {
+        text[size] = '\0';
+    } else {
+        free(text);
+        text = NULL;
+    }
+    fclose(f);
+    return text;
+}
+
+/*
+ * Synthetic Data
+ */
+
+static unsigned int g_seed = 12345;
+
+/* Deterministic so runs are comparable */
+static int rnd(int range)
+{
+    g_seed = g_seed * 1103515245u + 12345u;
+    return (int)((g_seed >> 16) % (unsigned int)range);
+}
+
+static const race_category syn_categories[] = {
+    CATEGORY_OVAL, CATEGORY_DIRT_OVAL, CATEGORY_DIRT_ROAD, CATEGORY_SPORTS_CAR, CATEGORY_FORMULA
+};
+#define SYN_CATEGORY_COUNT ((int)(sizeof(syn_categories) / sizeof(syn_categories[0])))
+
+/*
+ * Helper: Format a name into the database's string pool
+ */
+static const char *syn_name(ira_database *db, const char *fmt, ...)
+{
+    char buf[128];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return intern_string(&db->strings, buf);
+}
+
+/*
+ * Helper: Fill a database with a full catalog and one season per series,
+ * each with a complete schedule
+ */
+static ira_database *build_database(void)
+{
+    ira_database *db = database_create();
+    if (!db) {
+        return NULL;
+    }
+    g_seed = 12345;
+    time_t now = time(NULL);
+
+    db->tracks = calloc(SYN_TRACKS, sizeof(ira_track));
+    db->cars = calloc(SYN_CARS, sizeof(ira_car));
+    db->car_classes = calloc(SYN_CAR_CLASSES, sizeof(ira_car_class));
+    db->series = calloc(SYN_SERIES, sizeof(ira_series));
+    db->seasons = calloc(SYN_SERIES, sizeof(ira_season));
+    db->owned.owned_car_ids = calloc(SYN_OWNED_CARS, sizeof(int));
+    db->owned.owned_track_ids = calloc(SYN_OWNED_TRACKS, sizeof(int));
+    if (!db->tracks || !db->cars || !db->car_classes || !db->series || !db->seasons ||
+        !db->owned.owned_car_ids || !db->owned.owned_track_ids) {
+        database_destroy(db);
+        return NULL;
+    }
+
+    for (int i = 0; i < SYN_TRACKS; i++) {
+        ira_track *t = &db->tracks[i];
+        t->track_id = i + 1;
+        t->track_name = syn_name(db, "Synthetic Raceway %d", i / 3 + 1);
+        t->config_name = syn_name(db, "Layout %c", 'A' + i % 3);
+        t->category = syn_categories[rnd(SYN_CATEGORY_COUNT)];
+        t->is_oval = t->category == CATEGORY_OVAL || t->category == CATEGORY_DIRT_OVAL;
+        t->is_dirt = t->category == CATEGORY_DIRT_OVAL || t->category == CATEGORY_DIRT_ROAD;
+        t->length_km = 1.0f + (float)rnd(60) / 10.0f;
+        t->corners = 4 + rnd(20);
+        t->max_cars = 20 + rnd(44);
+        t->price = 14.95f;
+        t->free_with_subscription = (i % 10) == 0;
+        t->package_id = 1000 + i / 3;
+        t->location = syn_name(db, "Town %d, Country", i / 3 + 1);
+    }
+    db->track_count = SYN_TRACKS;
+    db->tracks_updated = now;
+
+    for (int i = 0; i < SYN_CARS; i++) {
+        ira_car *c = &db->cars[i];
+        c->car_id = i + 1;
+        c->car_name = syn_name(db, "Synthetic Motors Model %d", i + 1);
+        c->car_abbrev = syn_name(db, "SM%d", i + 1);
+        c->car_make = syn_name(db, "Synthetic Motors");
+        c->car_model = syn_name(db, "Model %d", i + 1);
+        c->hp = 100 + rnd(900);
+        c->weight_kg = 500 + rnd(1000);
+        c->categories[0] = syn_categories[rnd(SYN_CATEGORY_COUNT)];
+        c->category_count = 1;
+        c->price = 11.95f;
+        c->free_with_subscription = (i % 8) == 0;
+        c->package_id = 2000 + i;
+    }
+    db->car_count = SYN_CARS;
+    db->cars_updated = now;
+
+    for (int i = 0; i < SYN_CAR_CLASSES; i++) {
+        ira_car_class *cc = &db->car_classes[i];
+        cc->car_class_id = i + 1;
+        cc->car_class_name = syn_name(db, "Synthetic Class %d", i + 1);
+        cc->short_name = syn_name(db, "SC%d", i + 1);
+        int ids[4];
+        int id_count = 1 + rnd(4);
+        for (int j = 0; j < id_count; j++) {
+            ids[j] = 1 + rnd(SYN_CARS);
+        }
+        cc->car_ids = intern_ids(&db->strings, ids, id_count);
+        cc->car_count = cc->car_ids ? id_count : 0;
+    }
+    db->car_class_count = SYN_CAR_CLASSES;
+    db->car_classes_updated = now;
+
+    for (int i = 0; i < SYN_SERIES; i++) {
+        ira_series *s = &db->series[i];
+        s->series_id = i + 1;
+        s->series_name = syn_name(db, "Synthetic Championship %d", i + 1);
+        s->short_name = syn_name(db, "SYN %d", i + 1);
+        s->category = syn_categories[rnd(SYN_CATEGORY_COUNT)];
+        s->min_license = (license_level)(LICENSE_ROOKIE + rnd(5));
+        s->min_starters = 2;
+        s->max_starters = 20 + rnd(44);
+    }
+    db->series_count = SYN_SERIES;
+    db->series_updated = now;
+
+    /* Five weeks into the season */
+    time_t season_start = now - 5 * 7 * 24 * 3600;
+    for (int i = 0; i < SYN_SERIES; i++) {
+        ira_season *season = &db->seasons[i];
+        season->season_id = 5000 + i;
+        season->series_id = i + 1;
+        season->season_name = syn_name(db, "Synthetic Championship %d - 2026 Season 4", i + 1);
+        season->short_name = syn_name(db, "2026 S4 SYN %d", i + 1);
+        season->season_year = 2026;
+        season->season_quarter = 4;
+        season->fixed_setup = rnd(2) == 0;
+        season->official = rnd(4) != 0;
+        season->active = true;
+        season->license_group = db->series[i].min_license;
+        season->max_weeks = SYN_WEEKS;
+        season->current_week = 5;
+        season->car_class_ids[0] = 1 + rnd(SYN_CAR_CLASSES);
+        season->car_class_count = 1;
+
+        season->schedule = calloc(SYN_WEEKS, sizeof(ira_schedule_week));
+        if (!season->schedule) {
+            database_destroy(db);
+            return NULL;
+        }
+        season->schedule_count = SYN_WEEKS;
+
+        for (int w = 0; w < SYN_WEEKS; w++) {
+            ira_schedule_week *week = &season->schedule[w];
+            const ira_track *track = &db->tracks[rnd(SYN_TRACKS)];
+            week->race_week_num = w;
+            week->track_id = track->track_id;
+            week->track_name = track->track_name;
+            week->config_name = track->config_name;
+            week->start_date = season_start + (time_t)w * 7 * 24 * 3600;
+            week->end_date = week->start_date + 7 * 24 * 3600;
+            if (rnd(3) == 0) {
+                week->race_lap_limit = 10 + rnd(40);
+            } else {
+                week->race_time_limit_mins = 15 + 5 * rnd(10);
+            }
+            week->practice_mins = 30;
+            week->qualify_mins = 10;
+            week->warmup_mins = 2;
+            int ids[3];
+            int id_count = 1 + rnd(3);
+            for (int c = 0; c < id_count; c++) {
+                ids[c] = 1 + rnd(SYN_CARS);
+            }
+            week->car_ids = intern_ids(&db->strings, ids, id_count);
+            week->car_count = week->car_ids ? id_count : 0;
+            week->repeating = rnd(4) != 0;
+            week->first_session_mins = 15 * rnd(8);
+            week->repeat_minutes = week->repeating ? 60 * (1 + rnd(4)) : 0;
+            if (!week->repeating) {
+                week->session_time_count = 3;
+                for (int t = 0; t < week->session_time_count; t++) {
+                    week->session_times[t] = week->start_date + (time_t)(1 + 2 * t) * 24 * 3600;
+                }
+            }
+        }
+    }
+    db->season_count = SYN_SERIES;
+    db->season_year = 2026;
+    db->season_quarter = 4;
+    db->seasons_updated = now;
+
+    db->owned.cust_id = 123456;
+    db->owned.last_updated = now;
+    for (int i = 0; i < SYN_OWNED_CARS; i++) {
+        db->owned.owned_car_ids[i] = 1 + i * (SYN_CARS / SYN_OWNED_CARS);
+    }
+    db->owned.owned_car_count = SYN_OWNED_CARS;
+    for (int i = 0; i < SYN_OWNED_TRACKS; i++) {
+        db->owned.owned_track_ids[i] = 1 + i * (SYN_TRACKS / SYN_OWNED_TRACKS);
+    }
+    db->owned.owned_track_count = SYN_OWNED_TRACKS;
+
+    database_rebuild_indexes(db);
+    return db;
+}
+
+/*
+ * Helper: Write the synthetic catalog to the default database paths
+ */
+static bool save_database(ira_database *db)
+{
+    return database_save_tracks(db, database_get_tracks_path()) &&
+           database_save_cars(db, database_get_cars_path()) &&
+           database_save_car_classes(db, database_get_car_classes_path()) &&
+           database_save_series(db, database_get_series_path()) &&
+           database_save_seasons(db, database_get_seasons_path()) &&
+           database_save_owned(db, database_get_owned_path()) &&
+           database_save_all(db);
+}
+
+/*
+ * Helper: Append to a growing string
+ */
+static bool append(char **buf, size_t *len, size_t *cap, const char *fmt, ...)
+{
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(*buf + *len, *cap - *len, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            return false;
+        }
+        if (*len + (size_t)n < *cap) {
+            *len += (size_t)n;
+            return true;
+        }
+        size_t new_cap = *cap * 2 + (size_t)n;
+        char *grown = realloc(*buf, new_cap);
+        if (!grown) {
+            return false;
+        }
+        *buf = grown;
+        *cap = new_cap;
+    }
+}
+
+/*
+ * Helper: Build a session info string for a full 60 car race, laid out
+ * the way the sim writes it
+ */
+static char *build_session(void)
+{
+    size_t len = 0, cap = 4096;
+    char *s = malloc(cap);
+    if (!s) {
+        return NULL;
+    }
+    s[0] = '\0';
+
+    bool ok = append(&s, &len, &cap,
+        "---\n"
+        "WeekendInfo:\n"
+        " TrackName: synthetic raceway\n"
+        " TrackID: 163\n"
+        " TrackLength: 6.93 km\n"
+        " TrackDisplayName: Synthetic Raceway\n"
+        " TrackDisplayShortName: Synthetic\n"
+        " TrackConfigName: Grand Prix\n"
+        " TrackCity: Town\n"
+        " TrackCountry: Country\n"
+        " TrackAltitude: 400.00 m\n"
+        " TrackNumTurns: 20\n"
+        " TrackPitSpeedLimit: 60.00 kph\n"
+        " TrackType: road course\n"
+        " SeriesID: 231\n"
+        " SeasonID: 5123\n"
+        " SessionID: 81234567\n"
+        " SubSessionID: 71234567\n"
+        " LeagueID: 0\n"
+        " Official: 1\n"
+        " RaceWeek: 5\n"
+        " EventType: Race\n"
+        " Category: Road\n"
+        " NumCarClasses: 1\n"
+        " NumCarTypes: 1\n"
+        " WeekendOptions:\n"
+        "  NumStarters: %d\n"
+        "  StartingGrid: 2x2 inline pole on left\n"
+        "  QualifyScoring: best lap\n"
+        "  CourseCautions: local\n"
+        "  StandingStart: 0\n"
+        "  Restarts: single file\n"
+        "  WeatherType: Realistic\n"
+        "  Skies: Partly Cloudy\n"
+        "  WindDirection: N\n"
+        "  WindSpeed: 3.22 km/h\n"
+        "  WeatherTemp: 25.56 C\n"
+        "  RelativeHumidity: 55 %%\n"
+        "  FogLevel: 0 %%\n"
+        "  TimeOfDay: 2:00 pm\n"
+        "  Date: 2026-10-14\n"
+        "  EarthRotationSpeedupFactor: 1\n"
+        "  Unofficial: 0\n"
+        "  CommercialMode: consumer\n"
+        "  NightMode: variable\n"
+        "  IsFixedSetup: 1\n"
+        "  StrictLapsChecking: default\n"
+        "  HasOpenRegistration: 0\n"
+        "  HardcoreLevel: 1\n"
+        "  NumJokerLaps: 0\n"
+        "  IncidentLimit: 17\n"
+        "  FastRepairsLimit: 1\n"
+        "  GreenWhiteCheckeredLimit: 0\n"
+        "\n"
+        "SessionInfo:\n"
+        " Sessions:\n", SYN_DRIVERS);
+
+    static const char *session_names[] = { "PRACTICE", "QUALIFY", "RACE" };
+    for (int i = 0; ok && i < 3; i++) {
+        ok = append(&s, &len, &cap,
+            " - SessionNum: %d\n"
+            "   SessionLaps: unlimited\n"
+            "   SessionTime: %d.0000 sec\n"
+            "   SessionNumLapsToAvg: 0\n"
+            "   SessionType: %s\n"
+            "   SessionTrackRubberState: moderate usage\n"
+            "   SessionName: %s\n"
+            "   ResultsPositions:\n",
+            i, (i + 1) * 600, session_names[i], session_names[i]);
+        for (int p = 0; ok && p < SYN_DRIVERS; p++) {
+            ok = append(&s, &len, &cap,
+                "   - Position: %d\n"
+                "     ClassPosition: %d\n"
+                "     CarIdx: %d\n"
+                "     Lap: %d\n"
+                "     Time: %d.%03d\n"
+                "     FastestLap: %d\n"
+                "     FastestTime: 137.%03d\n"
+                "     LastTime: 138.%03d\n"
+                "     LapsLed: 0\n"
+                "     LapsComplete: %d\n"
+                "     JokerLapsComplete: 0\n"
+                "     LapsDriven: %d.000\n"
+                "     Incidents: %d\n"
+                "     ReasonOutId: 0\n"
+                "     ReasonOutStr: Running\n",
+                p + 1, p, (p * 7) % SYN_DRIVERS, 12, 1650 + p, p * 37 % 1000,
+                3 + p % 8, p * 13 % 1000, p * 17 % 1000, 12, 12, p % 5);
+        }
+        ok = ok && append(&s, &len, &cap, "   ResultsFastestLap:\n   - CarIdx: 0\n     FastestLap: 4\n");
+    }
+
+    ok = ok && append(&s, &len, &cap,
+        "\n"
+        "DriverInfo:\n"
+        " DriverCarIdx: 12\n"
+        " DriverUserID: 123456\n"
+        " PaceCarIdx: %d\n"
+        " DriverCarFuelMaxLtr: 110.000\n"
+        " DriverCarRedLine: 8500.000\n"
+        " Drivers:\n", SYN_DRIVERS);
+
+    for (int i = 0; ok && i < SYN_DRIVERS; i++) {
+        ok = append(&s, &len, &cap,
+            " - CarIdx: %d\n"
+            "   UserName: Synthetic Driver %d\n"
+            "   AbbrevName: Driver, S\n"
+            "   Initials: SD\n"
+            "   UserID: %d\n"
+            "   TeamID: 0\n"
+            "   TeamName: Synthetic Driver %d\n"
+            "   CarNumber: \"%d\"\n"
+            "   CarNumberRaw: %d\n"
+            "   CarPath: synthetic gt3\n"
+            "   CarClassID: 4083\n"
+            "   CarID: 156\n"
+            "   CarIsPaceCar: 0\n"
+            "   CarIsAI: 0\n"
+            "   CarScreenName: Synthetic GT3\n"
+            "   CarScreenNameShort: Synthetic GT3\n"
+            "   CarClassShortName: GT3 Class\n"
+            "   CarClassRelSpeed: 0\n"
+            "   CarClassLicenseLevel: 0\n"
+            "   CarClassMaxFuelPct: 1.000 %%\n"
+            "   CarClassWeightPenalty: 0.000 kg\n"
+            "   CarClassPowerAdjust: 0.000 %%\n"
+            "   CarClassEstLapTime: 137.5000\n"
+            "   IRating: %d\n"
+            "   LicLevel: 16\n"
+            "   LicSubLevel: 349\n"
+            "   LicString: A 3.49\n"
+            "   LicColor: 0x0153db\n"
+            "   IsSpectator: 0\n"
+            "   CarDesignStr: 0,ffffff,000000,ff0000\n"
+            "   HelmetDesignStr: 0,ffffff,000000,ff0000\n"
+            "   SuitDesignStr: 0,ffffff,000000,ff0000\n"
+            "   CarNumberDesignStr: 0,0,ffffff,777777,000000\n"
+            "   CarSponsor_1: 0\n"
+            "   CarSponsor_2: 0\n"
+            "   CurDriverIncidentCount: %d\n"
+            "   TeamIncidentCount: %d\n",
+            i, i, 100000 + i, i, i + 1, i + 1, 1500 + i * 53 % 4000, i % 5, i % 5);
+    }
+
+    ok = ok && append(&s, &len, &cap,
+        "\n"
+        "SplitTimeInfo:\n"
+        " Sectors:\n"
+        " - SectorNum: 0\n"
+        "   SectorStartPct: 0.000000\n"
+        " - SectorNum: 1\n"
+        "   SectorStartPct: 0.333333\n"
+        " - SectorNum: 2\n"
+        "   SectorStartPct: 0.666667\n"
+        "\n...\n");
+
+    if (!ok) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+/*
+ * Helper: Lookups the session display does, cycling over every driver
+ */
+static void build_session_paths(void)
+{
+    snprintf(g_paths[0], sizeof(g_paths[0]), "WeekendInfo:TrackDisplayName:");
+    for (int i = 0; i < SYN_DRIVERS; i++) {
+        snprintf(g_paths[i + 1], sizeof(g_paths[i + 1]), "DriverInfo:Drivers:CarIdx:{%d}UserName:", i);
+    }
+    g_path_next = 0;
+}
+
+static const char *next_session_path(void)
+{
+    const char *path = g_paths[g_path_next];
+    g_path_next = (g_path_next + 1) % (SYN_DRIVERS + 1);
+    return path;
+}
+
+/*
+ * Cases
+ */
+
+static void free_text(void)
+{
+    free(g_text);
+    g_text = NULL;
+}
+
+static void free_database(void)
+{
+    filter_results_destroy(g_results);
+    g_results = NULL;
+    database_destroy(g_db);
+    g_db = NULL;
+}
+
+/* json_parse and json_free of a document held in g_text */
+static void run_json_parse(void)
+{
+    json_value *root = json_parse(g_text);
+    if (!root) {
+        fprintf(stderr, "json_parse failed\n");
+        exit(1);
+    }
+    json_free(root);
+}
+
+static bool setup_json_schedule(void)
+{
+    g_text = read_file(g_schedule_path);
+    return g_text != NULL;
+}
+
+static bool setup_json_seasons(void)
+{
+    ira_database *db = build_database();
+    if (!db) {
+        return false;
+    }
+    bool ok = database_save_seasons(db, database_get_seasons_path());
+    database_destroy(db);
+
+    g_text = ok ? read_file(database_get_seasons_path()) : NULL;
+    return g_text != NULL;
+}
+
+static bool setup_session(void)
+{
+    g_text = build_session();
+    build_session_paths();
+    return g_text != NULL;
+}
+
+static void run_yaml_parse(void)
+{
+    const char *val;
+    int len;
+    if (!yaml_parse(g_text, next_session_path(), &val, &len)) {
+        fprintf(stderr, "yaml_parse lookup failed\n");
+        exit(1);
+    }
+}
+
+static bool setup_yaml_index(void)
+{
+    g_index = yaml_index_create();
+    return g_index && setup_session();
+}
+
+static void run_yaml_index_build(void)
+{
+    if (!yaml_index_build(g_index, g_text)) {
+        fprintf(stderr, "yaml_index_build failed\n");
+        exit(1);
+    }
+}
+
+static bool setup_yaml_index_find(void)
+{
+    return setup_yaml_index() && yaml_index_build(g_index, g_text);
+}
+
+static void run_yaml_index_find(void)
+{
+    const char *val;
+    int len;
+    if (!yaml_index_find(g_index, next_session_path(), &val, &len)) {
+        fprintf(stderr, "yaml_index_find lookup failed\n");
+        exit(1);
+    }
+}
+
+static void teardown_yaml_index(void)
+{
+    yaml_index_destroy(g_index);
+    g_index = NULL;
+    free_text();
+}
+
+static bool setup_filter(void)
+{
+    g_db = build_database();
+    g_results = filter_results_create();
+    g_threads = filter_default_threads();
+    return g_db && g_results;
+}
+
+static void run_filter_apply(void)
+{
+    filter_apply(g_db, g_results);
+    filter_results_sort(g_results, SORT_BY_START_TIME, true);
+}
+
+static void run_filter_apply_parallel(void)
+{
+    filter_apply_parallel(g_db, g_results, g_threads);
+    filter_results_sort(g_results, SORT_BY_START_TIME, true);
+}
+
+static bool setup_database_files(void)
+{
+    ira_database *db = build_database();
+    if (!db) {
+        return false;
+    }
+    bool ok = save_database(db);
+    database_destroy(db);
+    return ok;
+}
+
+/* Snapshot in step with the JSON files, as on every start after a sync */
+static void run_database_load_all(void)
+{
+    ira_database *db = database_create();
+    if (!db || !database_load_all(db) || db->season_count != SYN_SERIES) {
+        fprintf(stderr, "database_load_all failed\n");
+        exit(1);
+    }
+    database_destroy(db);
+}
+
+/* The JSON path taken after a sync, without the snapshot */
+static void run_database_load_seasons(void)
+{
+    ira_database *db = database_create();
+    if (!db || !database_load_seasons(db, database_get_seasons_path()) ||
+        db->season_count != SYN_SERIES) {
+        fprintf(stderr, "database_load_seasons failed\n");
+        exit(1);
+    }
+    database_destroy(db);
+}
+
+static bool setup_database_save(void)
+{
+    g_db = build_database();
+    return g_db != NULL;
+}
+
+/* Rewrite of the largest table, as after a schedule sync */
+static void run_database_save_seasons(void)
+{
+    if (!database_save_seasons(g_db, database_get_seasons_path())) {
+        fprintf(stderr, "database_save_seasons failed\n");
+        exit(1);
+    }
+}
+
+#ifdef _WIN32
+
+/*
+ * Telemetry logging, fed from a synthetic .ibt through the replay source
+ */
+
+#define SYN_IBT_FILE        "bench_synthetic.ibt"
+#define SYN_IBT_ROWS        64
+#define SYN_SCALARS         240     /* About what the sim publishes */
+#define SYN_CAR_ARRAYS      8
+#define SYN_CAR_SLOTS       64
+
+static telem_logger *g_logger;
+static char *g_row;
+
+/*
+ * Helper: Write an .ibt with a typical mix of scalars and per-car arrays
+ */
+static bool write_synthetic_ibt(const char *path)
+{
+    int num_vars = SYN_SCALARS + SYN_CAR_ARRAYS;
+    irsdk_VarHeader *vars = calloc((size_t)num_vars, sizeof(irsdk_VarHeader));
+    if (!vars) {
+        return false;
+    }
+
+    int offset = 0;
+    for (int i = 0; i < SYN_SCALARS; i++) {
+        irsdk_VarHeader *v = &vars[i];
+        v->type = (i % 10 == 0) ? IRSDK_TYPE_INT : (i % 25 == 1) ? IRSDK_TYPE_DOUBLE :
+                  (i % 20 == 2) ? IRSDK_TYPE_BOOL : IRSDK_TYPE_FLOAT;
+        v->count = 1;
+        snprintf(v->name, sizeof(v->name), "Channel%03d", i);
+        snprintf(v->unit, sizeof(v->unit), "u");
+    }
+    for (int i = 0; i < SYN_CAR_ARRAYS; i++) {
+        irsdk_VarHeader *v = &vars[SYN_SCALARS + i];
+        v->type = (i % 2) ? IRSDK_TYPE_INT : IRSDK_TYPE_FLOAT;
+        v->count = SYN_CAR_SLOTS;
+        snprintf(v->name, sizeof(v->name), "CarIdxChannel%d", i);
+    }
+
+    for (int i = 0; i < num_vars; i++) {
+        int size = irsdk_var_type_bytes[vars[i].type];
+        offset = (offset + size - 1) / size * size;
+        vars[i].offset = offset;
+        offset += size * vars[i].count;
+    }
+    int buf_len = (offset + 15) & ~15;
+
+    const char *session = "---\nWeekendInfo:\n TrackName: synthetic raceway\n...\n";
+    int session_len = (int)strlen(session) + 1;
+
+    irsdk_Header header = {0};
+    irsdk_DiskSubHeader sub = {0};
+    header.ver = IRSDK_VER;
+    header.tick_rate = 60;
+    header.num_vars = num_vars;
+    header.var_header_offset = (int)(sizeof(header) + sizeof(sub));
+    header.session_info_offset = header.var_header_offset + num_vars * (int)sizeof(irsdk_VarHeader);
+    header.session_info_len = session_len;
+    header.num_buf = 1;
+    header.buf_len = buf_len;
+    header.var_buf[0].buf_offset = (header.session_info_offset + session_len + 15) & ~15;
+    sub.session_start_date = time(NULL);
+    sub.session_record_count = SYN_IBT_ROWS;
+
+    char *row = calloc(1, (size_t)buf_len);
+    FILE *f = fopen(path, "wb");
+    bool ok = row && f;
+    if (ok) {
+        fwrite(&header, sizeof(header), 1, f);
+        fwrite(&sub, sizeof(sub), 1, f);
+        fwrite(vars, sizeof(irsdk_VarHeader), (size_t)num_vars, f);
+        fwrite(session, 1, (size_t)session_len, f);
+        for (long pos = ftell(f); pos < header.var_buf[0].buf_offset; pos++) {
+            fputc(0, f);
+        }
+        for (int r = 0; r < SYN_IBT_ROWS; r++) {
+            for (int i = 0; i < num_vars; i++) {
+                char *dest = row + vars[i].offset;
+                for (int j = 0; j < vars[i].count; j++) {
+                    switch (vars[i].type) {
+                    case IRSDK_TYPE_INT:    ((int *)dest)[j] = r + j; break;
+                    case IRSDK_TYPE_DOUBLE: ((double *)dest)[j] = r / 60.0; break;
+                    case IRSDK_TYPE_BOOL:   ((bool *)dest)[j] = (r + j) & 1; break;
+                    default:                ((float *)dest)[j] = (float)(r * i + j) * 0.125f; break;
+                    }
+                }
+            }
+            fwrite(row, 1, (size_t)buf_len, f);
+        }
+        ok = !ferror(f);
+    }
+    if (f) {
+        fclose(f);
+    }
+    free(row);
+    free(vars);
+    return ok;
+}
+
+static bool setup_telem_log(void)
+{
+    if (!write_synthetic_ibt(SYN_IBT_FILE) || !irsdk_startup_file(SYN_IBT_FILE, IRSDK_REPLAY_FAST)) {
+        return false;
+    }
+
+    g_row = calloc(1, (size_t)irsdk_get_buf_len());
+    if (!g_row || !irsdk_get_new_data(g_row)) {
+        return false;
+    }
+
+    g_logger = telem_log_create(".", "bench");
+    if (!g_logger || telem_log_add_all(g_logger) <= 0 || !telem_log_start(g_logger)) {
+        return false;
+    }
+
+    /* Never queue more than the ring holds between drains */
+    telem_log_stats stats;
+    telem_log_get_stats(g_logger, &stats);
+    g_batch_limit = stats.ring_capacity / 2;
+    return true;
+}
+
+static void run_telem_log_sample(void)
+{
+    telem_log_sample(g_logger, g_row);
+}
+
+/* Let the writer empty the ring so every timed sample is queued, not dropped */
+static void idle_telem_log(void)
+{
+    telem_log_stats stats;
+    do {
+        Sleep(1);
+        telem_log_get_stats(g_logger, &stats);
+    } while (stats.samples_queued > 0 && !stats.write_failed);
+}
+
+static void teardown_telem_log(void)
+{
+    telem_log_stats stats;
+    telem_log_get_stats(g_logger, &stats);
+    if (stats.samples_dropped > 0) {
+        printf("  (%d samples dropped)\n", stats.samples_dropped);
+    }
+
+    char path[MAX_PATH];
+    snprintf(path, sizeof(path), "%s", telem_log_get_filepath(g_logger));
+    telem_log_destroy(g_logger);
+    g_logger = NULL;
+    remove(path);
+
+    irsdk_shutdown();
+    remove(SYN_IBT_FILE);
+    free(g_row);
+    g_row = NULL;
+}
+
+#endif /* _WIN32 */
+
+static const bench_case g_cases[] = {
+    { "json_parse_schedule", "json_parse + json_free of data/schedule.json",
+      setup_json_schedule, run_json_parse, free_text, NULL },
+    { "json_parse_seasons", "json_parse + json_free of a full-catalog seasons file",
+      setup_json_seasons, run_json_parse, free_text, NULL },
+    { "yaml_parse", "yaml_parse lookup in a 60 car session string",
+      setup_session, run_yaml_parse, free_text, NULL },
+    { "yaml_index_build", "yaml_index_build of a 60 car session string",
+      setup_yaml_index, run_yaml_index_build, teardown_yaml_index, NULL },
+    { "yaml_index_find", "yaml_index_find lookup in a 60 car session string",
+      setup_yaml_index_find, run_yaml_index_find, teardown_yaml_index, NULL },
+    { "filter_apply", "filter_apply + filter_results_sort over the full catalog",
+      setup_filter, run_filter_apply, free_database, NULL },
+    { "filter_apply_parallel", "filter_apply_parallel + filter_results_sort, default threads",
+      setup_filter, run_filter_apply_parallel, free_database, NULL },
+    { "database_load_all", "database_load_all of the full catalog from the snapshot",
+      setup_database_files, run_database_load_all, NULL, NULL },
+    { "database_load_seasons", "database_load_seasons of the full-catalog JSON",
+      setup_database_files, run_database_load_seasons, NULL, NULL },
+    { "database_save_seasons", "database_save_seasons of the full catalog",
+      setup_database_save, run_database_save_seasons, free_database, NULL },
+#ifdef _WIN32
+    { "telem_log_sample", "telem_log_sample of every variable in a 248 var row",
+      setup_telem_log, run_telem_log_sample, teardown_telem_log, idle_telem_log },
+#endif
+};
+
+#define CASE_COUNT ((int)(sizeof(g_cases) / sizeof(g_cases[0])))
+
+/*
+ * Runner
+ */
+
+/*
+ * Helper: Time n operations, split into batches with untimed idle time
+ * between them. Returns seconds.
+ */
+static double time_ops(const bench_case *bc, long long n)
+{
+    double elapsed = 0.0;
+    long long done = 0;
+
+    while (done < n) {
+        long long batch = n - done;
+        if (g_batch_limit > 0 && batch > g_batch_limit) {
+            batch = g_batch_limit;
+        }
+
+        double start = now_seconds();
+        for (long long i = 0; i < batch; i++) {
+            bc->run();
+        }
+        elapsed += now_seconds() - start;
+        done += batch;
+
+        if (bc->idle) {
+            bc->idle();
+        }
+    }
+    return elapsed;
+}
+
+static bool run_case(const bench_case *bc)
+{
+    g_batch_limit = 0;
+    if (!bc->setup || !bc->setup()) {
+        fprintf(stderr, "%s: setup failed\n", bc->name);
+        if (bc->teardown) {
+            bc->teardown();
+        }
+        return false;
+    }
+
+    /* Warm up caches, lazy paths and files written on first use */
+    time_ops(bc, 1);
+
+    /* Double the count until a run takes long enough to trust */
+    long long n = 1;
+    double elapsed = time_ops(bc, n);
+    while (elapsed < g_min_time / 8) {
+        n *= 2;
+        elapsed = time_ops(bc, n);
+    }
+    n = (long long)((double)n * g_min_time / elapsed) + 1;
+
+    bench_alloc_stats before, after;
+    bench_alloc_reset_peak();
+    bench_alloc_get(&before);
+    elapsed = time_ops(bc, n);
+    bench_alloc_get(&after);
+
+    double ns = elapsed * 1e9 / (double)n;
+    double allocs = (double)(after.allocs - before.allocs) / (double)n;
+    double bytes = (double)(after.bytes - before.bytes) / (double)n;
+    long long peak = after.peak_bytes - before.live_bytes;
+
+    printf("%-24s %10lld ops %12.1f ns/op %10.1f allocs/op %12.0f B/op   peak %8.1f KB\n",
+           bc->name, n, ns, allocs, bytes, (double)peak / 1024.0);
+
+    if (bc->teardown) {
+        bc->teardown();
+    }
+    return true;
+}
+
+static void print_usage(void)
+{
+    printf("Usage: ira_bench [case...] [--schedule <path>] [--time <seconds>]\n\n");
+    printf("Cases:\n");
+    for (int i = 0; i < CASE_COUNT; i++) {
+        printf("  %-24s %s\n", g_cases[i].name, g_cases[i].desc);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *selected[CASE_COUNT];
+    int selected_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--schedule") == 0 && i + 1 < argc) {
+            g_schedule_path = argv[++i];
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            g_min_time = atof(argv[++i]);
+            if (g_min_time <= 0.0) {
+                g_min_time = BENCH_MIN_TIME;
+            }
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage();
+            return 0;
+        } else if (argv[i][0] != '-' && selected_count < CASE_COUNT) {
+            selected[selected_count++] = argv[i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    int failed = 0;
+    for (int i = 0; i < selected_count; i++) {
+        bool known = false;
+        for (int c = 0; c < CASE_COUNT; c++) {
+            known = known || strcmp(selected[i], g_cases[c].name) == 0;
+        }
+        if (!known) {
+            fprintf(stderr, "Unknown case: %s\n", selected[i]);
+            return 1;
+        }
+    }
+
+    for (int c = 0; c < CASE_COUNT; c++) {
+        bool run = selected_count == 0;
+        for (int i = 0; i < selected_count && !run; i++) {
+            run = strcmp(selected[i], g_cases[c].name) == 0;
+        }
+        if (run && !run_case(&g_cases[c])) {
+            failed++;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
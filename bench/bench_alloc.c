@@ -0,0 +1,152 @@
+/*
+ * ira - iRacing Application
+ * Benchmark Allocation Counting Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#include <stdbool.h>
+
+#include "bench_alloc.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* The wrappers themselves call the real allocator */
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+#undef strdup
+
+/* Each block carries its size in front, padded to keep the alignment */
+#define HEADER_SIZE 16
+
+static bench_alloc_stats g_stats;
+
+/* filter_apply_parallel and the log writer allocate from other threads */
+#ifdef _WIN32
+static SRWLOCK g_lock = SRWLOCK_INIT;
+#define LOCK()      AcquireSRWLockExclusive(&g_lock)
+#define UNLOCK()    ReleaseSRWLockExclusive(&g_lock)
+#else
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK()      pthread_mutex_lock(&g_lock)
+#define UNLOCK()    pthread_mutex_unlock(&g_lock)
+#endif
+
+/*
+ * Helper: Count an allocation of added bytes replacing removed bytes,
+ * or a free of removed bytes
+ */
+static void count_block(long long added, long long removed, bool is_free)
+{
+    LOCK();
+    if (is_free) {
+        g_stats.frees++;
+    } else {
+        g_stats.allocs++;
+        g_stats.bytes += added;
+    }
+    g_stats.live_bytes += added - removed;
+    if (g_stats.live_bytes > g_stats.peak_bytes) {
+        g_stats.peak_bytes = g_stats.live_bytes;
+    }
+    UNLOCK();
+}
+
+/*
+ * Helper: Record the size in front of a raw block, return the user pointer
+ */
+static void *wrap_block(char *raw, size_t size)
+{
+    if (!raw) {
+        return NULL;
+    }
+    *(size_t *)raw = size;
+    return raw + HEADER_SIZE;
+}
+
+/*
+ * Helper: Size of a block from its user pointer
+ */
+static size_t block_size(const void *ptr)
+{
+    return *(const size_t *)((const char *)ptr - HEADER_SIZE);
+}
+
+void *bench_malloc(size_t size)
+{
+    void *ptr = wrap_block((char *)malloc(size + HEADER_SIZE), size);
+    if (ptr) {
+        count_block((long long)size, 0, false);
+    }
+    return ptr;
+}
+
+void *bench_calloc(size_t count, size_t size)
+{
+    if (size && count > ((size_t)-1 - HEADER_SIZE) / size) {
+        return NULL;
+    }
+    size_t total = count * size;
+    void *ptr = wrap_block((char *)calloc(1, total + HEADER_SIZE), total);
+    if (ptr) {
+        count_block((long long)total, 0, false);
+    }
+    return ptr;
+}
+
+void *bench_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return bench_malloc(size);
+    }
+
+    size_t old_size = block_size(ptr);
+    char *raw = (char *)realloc((char *)ptr - HEADER_SIZE, size + HEADER_SIZE);
+    if (!raw) {
+        return NULL;
+    }
+
+    /* A realloc is an allocation of the new size replacing the old block */
+    count_block((long long)size, (long long)old_size, false);
+    return wrap_block(raw, size);
+}
+
+void bench_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    count_block(0, (long long)block_size(ptr), true);
+    free((char *)ptr - HEADER_SIZE);
+}
+
+char *bench_strdup(const char *str)
+{
+    size_t len = strlen(str) + 1;
+    char *copy = (char *)bench_malloc(len);
+    if (copy) {
+        memcpy(copy, str, len);
+    }
+    return copy;
+}
+
+void bench_alloc_get(bench_alloc_stats *stats)
+{
+    LOCK();
+    *stats = g_stats;
+    UNLOCK();
+}
+
+void bench_alloc_reset_peak(void)
+{
+    LOCK();
+    g_stats.peak_bytes = g_stats.live_bytes;
+    UNLOCK();
+}
@@ -0,0 +1,47 @@
+/*
+ * ira - iRacing Application
+ * Benchmark Allocation Counting
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_BENCH_ALLOC_H
+#define IRA_BENCH_ALLOC_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Force-included into every benchmarked source file, so the modules'
+ * malloc/calloc/realloc/free go through counting wrappers. Only the
+ * benchmark build sees this; the modules themselves are unchanged.
+ */
+
+typedef struct {
+    long long allocs;           /* malloc, calloc, realloc and strdup calls */
+    long long frees;
+    long long bytes;            /* Total bytes requested */
+    long long live_bytes;       /* Bytes allocated and not yet freed */
+    long long peak_bytes;       /* Highest live_bytes since the last reset */
+} bench_alloc_stats;
+
+void *bench_malloc(size_t size);
+void *bench_calloc(size_t count, size_t size);
+void *bench_realloc(void *ptr, size_t size);
+void bench_free(void *ptr);
+char *bench_strdup(const char *str);
+
+/* Current counters */
+void bench_alloc_get(bench_alloc_stats *stats);
+
+/* Restart the peak from the current live bytes */
+void bench_alloc_reset_peak(void);
+
+#define malloc(size)            bench_malloc(size)
+#define calloc(count, size)     bench_calloc(count, size)
+#define realloc(ptr, size)      bench_realloc(ptr, size)
+#define free(ptr)               bench_free(ptr)
+#define strdup(str)             bench_strdup(str)
+
+#endif /* IRA_BENCH_ALLOC_H */
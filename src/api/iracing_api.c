@@ -13,12 +13,90 @@
 #include <stdio.h>
 #include <time.h>
 
+#include <windows.h>
+
 #include "iracing_api.h"
 #include "../util/http.h"
 #include "../util/crypto.h"
 #include "../util/json.h"
 #include "../util/oauth.h"
 
+/* Longest S3 link accepted from a data endpoint */
+#define API_MAX_LINK_LEN 2048
+
+/*
+ * Helper: Record the rate limit headers of a response. S3 downloads carry
+ * none, so only responses naming a reset time count.
+ */
+static void update_rate_limit(iracing_api *api, const http_response *resp)
+{
+    if (resp->rate_limit_reset <= 0) return;
+
+    /* The reset is an epoch time; small values are seconds from now */
+    time_t reset = resp->rate_limit_reset;
+    if (reset < 1000000000) reset += time(NULL);
+
+    api->rate_limit_remaining = resp->rate_limit_remaining;
+    api->rate_limit_reset = reset;
+}
+
+/*
+ * Auth state. The background refresh writes state and token_expires while
+ * the sync and main threads read them and a 401 marks the token expired,
+ * so every access goes through auth_lock.
+ */
+
+static SRWLOCK *auth_lock(iracing_api *api)
+{
+    return (SRWLOCK *)&api->auth_lock;
+}
+
+static void set_auth_state(iracing_api *api, auth_state state)
+{
+    AcquireSRWLockExclusive(auth_lock(api));
+    api->state = state;
+    ReleaseSRWLockExclusive(auth_lock(api));
+}
+
+static void set_authenticated(iracing_api *api, time_t expires)
+{
+    AcquireSRWLockExclusive(auth_lock(api));
+    api->state = AUTH_STATE_AUTHENTICATED;
+    api->token_expires = expires;
+    ReleaseSRWLockExclusive(auth_lock(api));
+}
+
+static void set_token_expires(iracing_api *api, time_t expires)
+{
+    AcquireSRWLockExclusive(auth_lock(api));
+    api->token_expires = expires;
+    ReleaseSRWLockExclusive(auth_lock(api));
+}
+
+/*
+ * Helper: Mark the token expired after a 401, unless the background
+ * refresh already replaced the token the request was sent with
+ */
+static void expire_token(iracing_api *api)
+{
+    /*
+     * A refresh stores its token before setting state under auth_lock, so
+     * seeing the old token here means its AUTHENTICATED lands after us
+     */
+    AcquireSRWLockExclusive(auth_lock(api));
+    char *current = api->oauth ? oauth_copy_access_token(api->oauth) : NULL;
+    bool renewed = current && (!api->access_token || strcmp(current, api->access_token) != 0);
+    if (!renewed) {
+        api->state = AUTH_STATE_EXPIRED;
+    }
+    ReleaseSRWLockExclusive(auth_lock(api));
+
+    if (current) {
+        memset(current, 0, strlen(current));
+        free(current);
+    }
+}
+
 /*
  * Helper: Set API error from HTTP response
  */
@@ -32,7 +110,7 @@ static api_error map_http_status(iracing_api *api, http_response *resp)
     }
 
     /* Update rate limit info */
-    api->rate_limit_remaining = resp->rate_limit_remaining;
+    update_rate_limit(api, resp);
 
     switch (resp->status_code) {
         case 200:
@@ -46,21 +124,22 @@ static api_error map_http_status(iracing_api *api, http_response *resp)
             api->last_error = API_ERROR_NOT_AUTHENTICATED;
             snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                      "Not authenticated (401)");
-            api->state = AUTH_STATE_EXPIRED;
+            expire_token(api);
             return API_ERROR_NOT_AUTHENTICATED;
 
         case 403:
             api->last_error = API_ERROR_INVALID_CREDENTIALS;
             snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                      "Invalid credentials (403)");
-            api->state = AUTH_STATE_FAILED;
+            set_auth_state(api, AUTH_STATE_FAILED);
             return API_ERROR_INVALID_CREDENTIALS;
 
         case 429:
             api->last_error = API_ERROR_RATE_LIMITED;
             snprintf(api->last_error_msg, sizeof(api->last_error_msg),
-                     "Rate limited (429). Reset in %d seconds.",
-                     resp->rate_limit_reset);
+                     "Rate limited (429). Reset in %lld seconds.",
+                     api->rate_limit_reset > time(NULL)
+                         ? (long long)(api->rate_limit_reset - time(NULL)) : 0LL);
             return API_ERROR_RATE_LIMITED;
 
         default:
@@ -78,78 +157,230 @@ static api_error map_http_status(iracing_api *api, http_response *resp)
 }
 
 /*
- * Helper: Fetch data from an iRacing endpoint with link-redirect pattern.
- *
- * iRacing data endpoints return {"link": "https://s3..."} which must be fetched.
- * Returns parsed JSON from the final URL, or NULL on error.
+ * Response Cache
  */
-static json_value *fetch_data_endpoint(iracing_api *api, const char *endpoint)
+
+static api_validator *find_validator(iracing_api *api, const char *endpoint)
 {
-    if (!api || !endpoint) return NULL;
+    for (int i = 0; i < api->validator_count; i++) {
+        if (strcmp(api->validators[i].endpoint, endpoint) == 0) {
+            return &api->validators[i];
+        }
+    }
+    return NULL;
+}
 
-    char url[512];
-    snprintf(url, sizeof(url), "%s%s", IRACING_API_BASE, endpoint);
+/*
+ * Helper: Validators to send for an endpoint. Only offered when the table
+ * already holds data, since a 304 leaves it as it is.
+ */
+static const api_validator *conditional_for(iracing_api *api, const char *endpoint, bool have_data)
+{
+    return have_data ? find_validator(api, endpoint) : NULL;
+}
 
-    /* First request to get the link */
-    http_response *resp;
+static const char *validator_etag(const api_validator *v)
+{
+    return (v && v->etag[0]) ? v->etag : NULL;
+}
 
-    /* Use OAuth token if available */
-    if (api->oauth && oauth_token_valid(api->oauth)) {
-        const char *token = oauth_get_access_token(api->oauth);
-        resp = http_get_with_token(api->http, url, token);
-    } else {
-        resp = http_get(api->http, url);
+static const char *validator_last_modified(const api_validator *v)
+{
+    return (v && v->last_modified[0]) ? v->last_modified : NULL;
+}
+
+/*
+ * Helper: Copy a response's validators. A validator too long for the
+ * fixed fields is dropped rather than truncated.
+ */
+static void read_validator(api_validator *v, const char *endpoint, const http_response *resp)
+{
+    memset(v, 0, sizeof(*v));
+    if (strlen(endpoint) >= sizeof(v->endpoint)) return;
+    memcpy(v->endpoint, endpoint, strlen(endpoint) + 1);
+
+    if (resp->etag && strlen(resp->etag) < sizeof(v->etag)) {
+        memcpy(v->etag, resp->etag, strlen(resp->etag) + 1);
+    }
+    if (resp->last_modified && strlen(resp->last_modified) < sizeof(v->last_modified)) {
+        memcpy(v->last_modified, resp->last_modified, strlen(resp->last_modified) + 1);
+    }
+}
+
+/*
+ * Helper: Remember the validators of a download once it has been applied.
+ */
+static void store_validator(iracing_api *api, const api_validator *fresh)
+{
+    if (!fresh->endpoint[0]) return;
+
+    api_validator *v = find_validator(api, fresh->endpoint);
+
+    if (!fresh->etag[0] && !fresh->last_modified[0]) {
+        /* Server stopped sending validators; forget the old ones */
+        if (v) {
+            *v = api->validators[--api->validator_count];
+            api->cache_dirty = true;
+        }
+        return;
+    }
+
+    if (!v) {
+        if (api->validator_count == API_MAX_VALIDATORS) {
+            /* Evict the oldest entry */
+            memmove(&api->validators[0], &api->validators[1],
+                    (API_MAX_VALIDATORS - 1) * sizeof(api_validator));
+            api->validator_count--;
+        }
+        v = &api->validators[api->validator_count++];
+    } else if (memcmp(v, fresh, sizeof(*v)) == 0) {
+        return;
+    }
+
+    *v = *fresh;
+    api->cache_dirty = true;
+}
+
+/*
+ * Helper: Handle a 304 answer to a conditional request.
+ * Returns true, with no error set, if resp is one.
+ */
+static bool check_not_modified(iracing_api *api, http_response *resp)
+{
+    if (!http_response_not_modified(resp)) return false;
+
+    update_rate_limit(api, resp);
+    api->not_modified = true;
+    api->last_error = API_OK;
+    api->last_error_msg[0] = '\0';
+    return true;
+}
+
+/*
+ * Helper: Get the bearer token to send, or NULL for cookie authentication.
+ * The token is copied, since the background refresh may replace it.
+ */
+static const char *current_token(iracing_api *api)
+{
+    if (!api->oauth) return NULL;
+
+    char *token = oauth_copy_access_token(api->oauth);
+    if (api->access_token) {
+        memset(api->access_token, 0, strlen(api->access_token));
+        free(api->access_token);
+    }
+    api->access_token = token;
+    return token;
+}
+
+/*
+ * Helper: Wait for a background authentication to settle, so requests
+ * made while it runs queue instead of failing. cancel, if not NULL, is an
+ * event that ends the wait early. Returns true if authenticated.
+ */
+static bool await_auth(iracing_api *api, HANDLE cancel)
+{
+    if (api->auth_settled) {
+        HANDLE events[2] = { api->auth_settled, cancel };
+        WaitForMultipleObjects(cancel ? 2 : 1, events, FALSE, INFINITE);
     }
+    return api_is_authenticated(api);
+}
+
+/*
+ * Helper: Check a data response. net_error describes why resp is NULL.
+ * Sets the API error and returns false unless resp is a 2xx response.
+ */
+static bool check_data_response(iracing_api *api, http_response *resp, const char *net_error)
+{
     if (!resp) {
-        map_http_status(api, NULL);
-        return NULL;
+        api->last_error = API_ERROR_NETWORK;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Network error: %s", net_error);
+        return false;
     }
 
     if (!http_response_ok(resp)) {
         map_http_status(api, resp);
-        http_response_free(resp);
-        return NULL;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Helper: Extract the download link from a data endpoint response.
+ *
+ * iRacing data endpoints return {"link": "https://s3..."} which must be fetched.
+ * Copies the link into link_buf. Returns false on error.
+ */
+static bool parse_link_response(iracing_api *api, http_response *resp, const char *net_error,
+                                char *link_buf, size_t link_size)
+{
+    if (!check_data_response(api, resp, net_error)) {
+        return false;
     }
 
     /* Parse response to extract link */
-    json_value *link_json = json_parse(resp->body);
-    http_response_free(resp);
+    json_document *link_json = json_document_parse(resp->body);
 
     if (!link_json) {
         api->last_error = API_ERROR_INVALID_RESPONSE;
         snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                  "Failed to parse link response");
-        return NULL;
+        return false;
     }
 
-    const char *link = json_get_string(json_object_get(link_json, "link"));
-    if (!link) {
-        json_free(link_json);
+    const char *link = json_get_string(json_object_get(json_document_root(link_json), "link"));
+    if (!link || strlen(link) >= link_size) {
+        json_document_free(link_json);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                  "No link in response");
-        return NULL;
+        return false;
     }
 
-    /* Fetch the actual data from S3 */
-    resp = http_get(api->http, link);
-    json_free(link_json);
+    memcpy(link_buf, link, strlen(link) + 1);
+    json_document_free(link_json);
+    return true;
+}
 
-    if (!resp) {
-        map_http_status(api, NULL);
+/*
+ * Helper: Resolve an iRacing data endpoint to its download link.
+ */
+static bool resolve_data_link(iracing_api *api, const char *endpoint,
+                              char *link_buf, size_t link_size)
+{
+    char url[512];
+    snprintf(url, sizeof(url), "%s%s", IRACING_API_BASE, endpoint);
+
+    /* Use OAuth token if available */
+    http_response *resp = http_get_with_token(api->http, url, current_token(api));
+    bool ok = parse_link_response(api, resp, http_session_get_error(api->http),
+                                  link_buf, link_size);
+    http_response_free(resp);
+    return ok;
+}
+
+/*
+ * Helper: Parse a downloaded data body into a document.
+ *
+ * Returns NULL with no error set if the body is unchanged (304). The
+ * response's validators are copied to fresh, if given, for
+ * store_validator().
+ */
+static json_document *parse_data_response(iracing_api *api, http_response *resp,
+                                          const char *net_error, const char *endpoint,
+                                          api_validator *fresh)
+{
+    if (check_not_modified(api, resp)) {
         return NULL;
     }
 
-    if (!http_response_ok(resp)) {
-        map_http_status(api, resp);
-        http_response_free(resp);
+    if (!check_data_response(api, resp, net_error)) {
         return NULL;
     }
 
-    /* Parse the actual data */
-    json_value *data = json_parse(resp->body);
-    http_response_free(resp);
-
+    json_document *data = json_document_parse(resp->body);
     if (!data) {
         api->last_error = API_ERROR_INVALID_RESPONSE;
         snprintf(api->last_error_msg, sizeof(api->last_error_msg),
@@ -157,10 +388,122 @@ static json_value *fetch_data_endpoint(iracing_api *api, const char *endpoint)
         return NULL;
     }
 
+    if (fresh) read_validator(fresh, endpoint, resp);
+
     api->last_error = API_OK;
     return data;
 }
 
+/*
+ * Helper: Fetch data from an iRacing endpoint with link-redirect pattern.
+ *
+ * cond, if not NULL, makes the download conditional. Returns the parsed
+ * document from the final URL, or NULL on error. NULL with API_OK and
+ * api->not_modified set means the data is unchanged.
+ */
+static json_document *fetch_data_endpoint(iracing_api *api, const char *endpoint,
+                                          const api_validator *cond, api_validator *fresh)
+{
+    if (!api || !endpoint) return NULL;
+
+    api->not_modified = false;
+
+    char link[API_MAX_LINK_LEN];
+    if (!resolve_data_link(api, endpoint, link, sizeof(link))) {
+        return NULL;
+    }
+
+    /* Fetch the actual data from S3 */
+    http_response *resp = http_get_conditional(api->http, link, NULL,
+                                               validator_etag(cond),
+                                               validator_last_modified(cond));
+    json_document *data = parse_data_response(api, resp, http_session_get_error(api->http),
+                                              endpoint, fresh);
+    http_response_free(resp);
+    return data;
+}
+
+/* Body sink that feeds a streaming JSON parser */
+static bool feed_json_stream(void *user, const char *data, size_t len)
+{
+    return json_stream_feed((json_stream *)user, data, len);
+}
+
+/*
+ * Helper: Check a download that was streamed through a parser.
+ * Returns false with no error set if the body is unchanged (304).
+ */
+static bool finish_stream_response(iracing_api *api, http_response *resp, const char *net_error,
+                                   json_stream *stream, const char *endpoint,
+                                   api_validator *fresh)
+{
+    if (check_not_modified(api, resp)) {
+        return false;
+    }
+
+    if (!resp) {
+        /* Either the transfer failed or the parser rejected a chunk */
+        api->last_error = API_ERROR_INVALID_RESPONSE;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Failed to stream data response: %s", net_error);
+        return false;
+    }
+
+    if (!check_data_response(api, resp, net_error)) {
+        return false;
+    }
+
+    if (!json_stream_finish(stream)) {
+        api->last_error = API_ERROR_INVALID_RESPONSE;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Failed to parse data response");
+        return false;
+    }
+
+    if (fresh) read_validator(fresh, endpoint, resp);
+
+    api->last_error = API_OK;
+    return true;
+}
+
+/*
+ * Helper: Stream data from an iRacing endpoint through an event callback.
+ *
+ * Like fetch_data_endpoint(), but the S3 body is parsed as it downloads and
+ * no tree is built. Returns false on error; the callback stopping counts as
+ * an invalid response.
+ */
+static bool fetch_data_stream(iracing_api *api, const char *endpoint,
+                              json_event_fn callback, void *user,
+                              const api_validator *cond, api_validator *fresh)
+{
+    if (!api || !endpoint || !callback) return false;
+
+    api->not_modified = false;
+
+    char link[API_MAX_LINK_LEN];
+    if (!resolve_data_link(api, endpoint, link, sizeof(link))) {
+        return false;
+    }
+
+    json_stream *stream = json_stream_create(callback, user);
+    if (!stream) {
+        api->last_error = API_ERROR_INVALID_RESPONSE;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Out of memory");
+        return false;
+    }
+
+    http_response *resp = http_get_stream(api->http, link, NULL,
+                                          validator_etag(cond), validator_last_modified(cond),
+                                          feed_json_stream, stream);
+    bool ok = finish_stream_response(api, resp, http_session_get_error(api->http), stream,
+                                     endpoint, fresh);
+    http_response_free(resp);
+    json_stream_destroy(stream);
+    return ok;
+}
+
 /*
  * Helper: Safe string copy
  */
@@ -189,6 +532,7 @@ iracing_api *api_create(void)
     api->state = AUTH_STATE_NONE;
     api->timeout_ms = 30000;  /* 30 second default */
     api->last_error = API_OK;
+    safe_strcpy(api->token_file, sizeof(api->token_file), API_TOKEN_FILE);
 
     http_session_set_timeout(api->http, api->timeout_ms);
 
@@ -199,9 +543,22 @@ void api_destroy(iracing_api *api)
 {
     if (!api) return;
 
+    /* Stop background authentication, interrupting a browser login */
+    if (api->auth_thread) {
+        SetEvent(api->auth_stop);
+        oauth_cancel(api->oauth);
+        WaitForSingleObject(api->auth_thread, INFINITE);
+        CloseHandle(api->auth_thread);
+    }
+    if (api->auth_settled) CloseHandle(api->auth_settled);
+    if (api->auth_stop) CloseHandle(api->auth_stop);
+
     if (api->http) http_session_destroy(api->http);
     if (api->oauth) oauth_destroy(api->oauth);
-    if (api->access_token) free(api->access_token);
+    if (api->access_token) {
+        memset(api->access_token, 0, strlen(api->access_token));
+        free(api->access_token);
+    }
     if (api->refresh_token) free(api->refresh_token);
     if (api->username) free(api->username);
     if (api->password_hash) {
@@ -237,7 +594,7 @@ void api_set_credentials(iracing_api *api, const char *email, const char *passwo
     }
 
     /* Reset auth state when credentials change */
-    api->state = AUTH_STATE_NONE;
+    set_auth_state(api, AUTH_STATE_NONE);
 }
 
 void api_set_oauth(iracing_api *api, const char *client_id, const char *client_secret)
@@ -261,7 +618,7 @@ void api_set_oauth(iracing_api *api, const char *client_id, const char *client_s
     api->oauth = oauth_create(&config);
 
     /* Reset auth state */
-    api->state = AUTH_STATE_NONE;
+    set_auth_state(api, AUTH_STATE_NONE);
 }
 
 void api_set_timeout(iracing_api *api, int timeout_ms)
@@ -275,49 +632,133 @@ void api_set_timeout(iracing_api *api, int timeout_ms)
 
 bool api_load_tokens(iracing_api *api, const char *filename)
 {
-    (void)api;
-    (void)filename;
     /* Legacy auth uses session cookies managed by WinHTTP, not tokens */
-    return false;
+    if (!api || !api->oauth || !filename) return false;
+
+    if (!oauth_load_tokens(api->oauth, filename)) return false;
+
+    safe_strcpy(api->token_file, sizeof(api->token_file), filename);
+    set_token_expires(api, oauth_access_expires(api->oauth));
+    return true;
 }
 
 bool api_save_tokens(iracing_api *api, const char *filename)
 {
-    (void)api;
-    (void)filename;
     /* Legacy auth uses session cookies managed by WinHTTP, not tokens */
-    return false;
+    if (!api || !api->oauth || !filename) return false;
+
+    return oauth_save_tokens(api->oauth, filename);
+}
+
+bool api_load_cache(iracing_api *api, const char *filename)
+{
+    if (!api || !filename) return false;
+
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+
+    json_value *list = json_object_get(json_document_root(doc), "validators");
+    int count = json_array_length(list);
+
+    api->validator_count = 0;
+    for (int i = 0; i < count && api->validator_count < API_MAX_VALIDATORS; i++) {
+        json_value *item = json_array_get(list, i);
+        const char *endpoint = json_get_string(json_object_get(item, "endpoint"));
+        const char *etag = json_get_string(json_object_get(item, "etag"));
+        const char *modified = json_get_string(json_object_get(item, "last_modified"));
+        if (!endpoint) continue;
+
+        api_validator *v = &api->validators[api->validator_count];
+        memset(v, 0, sizeof(*v));
+        safe_strcpy(v->endpoint, sizeof(v->endpoint), endpoint);
+        if (etag) safe_strcpy(v->etag, sizeof(v->etag), etag);
+        if (modified) safe_strcpy(v->last_modified, sizeof(v->last_modified), modified);
+        api->validator_count++;
+    }
+
+    api->cache_dirty = false;
+    json_document_free(doc);
+    return true;
+}
+
+bool api_save_cache(iracing_api *api, const char *filename)
+{
+    if (!api || !filename) return false;
+    if (!api->cache_dirty) return true;
+
+    json_value *root = json_new_object();
+    json_value *list = json_new_array();
+    if (!root || !list) {
+        json_free(root);
+        json_free(list);
+        return false;
+    }
+    json_object_set(root, "validators", list);
+
+    for (int i = 0; i < api->validator_count; i++) {
+        const api_validator *v = &api->validators[i];
+        json_value *item = json_new_object();
+        if (!item) continue;
+
+        json_object_set(item, "endpoint", json_new_string(v->endpoint));
+        if (v->etag[0]) json_object_set(item, "etag", json_new_string(v->etag));
+        if (v->last_modified[0]) {
+            json_object_set(item, "last_modified", json_new_string(v->last_modified));
+        }
+        json_array_push(list, item);
+    }
+
+    bool result = json_write_file(root, filename, true);
+    json_free(root);
+    if (result) api->cache_dirty = false;
+    return result;
 }
 
 /*
  * Authentication
  */
 
+/*
+ * Helper: Renew the OAuth access token and save it. Leaves the API error
+ * alone, as the background refresh runs beside other requests.
+ */
+static bool renew_token(iracing_api *api)
+{
+    if (!oauth_refresh(api->oauth)) return false;
+
+    oauth_save_tokens(api->oauth, api->token_file);
+    set_authenticated(api, oauth_access_expires(api->oauth));
+    return true;
+}
+
 api_error api_authenticate(iracing_api *api)
 {
     if (!api) return API_ERROR_INVALID_CREDENTIALS;
 
     /* Prefer OAuth if configured */
     if (api->oauth) {
-        api->state = AUTH_STATE_AUTHENTICATING;
+        set_auth_state(api, AUTH_STATE_AUTHENTICATING);
 
-        /* Try to load existing tokens first */
-        if (oauth_load_tokens(api->oauth, "oauth_tokens.json")) {
+        /* Try existing tokens first */
+        if (oauth_load_tokens(api->oauth, api->token_file) ||
+            oauth_access_expires(api->oauth) != 0) {
             if (oauth_token_valid(api->oauth)) {
-                api->state = AUTH_STATE_AUTHENTICATED;
-                api->token_expires = time(NULL) + 3600;  /* Estimate */
+                set_authenticated(api, oauth_access_expires(api->oauth));
+                return API_OK;
+            } else if (renew_token(api)) {
                 return API_OK;
-            } else if (oauth_token_expiring(api->oauth, 0)) {
-                /* Try to refresh */
-                if (oauth_refresh(api->oauth)) {
-                    oauth_save_tokens(api->oauth, "oauth_tokens.json");
-                    api->state = AUTH_STATE_AUTHENTICATED;
-                    api->token_expires = time(NULL) + 3600;
-                    return API_OK;
-                }
             }
         }
 
+        /* api_destroy() may have stopped us while a refresh was running */
+        if (api->auth_stop && WaitForSingleObject(api->auth_stop, 0) == WAIT_OBJECT_0) {
+            set_auth_state(api, AUTH_STATE_FAILED);
+            api->last_error = API_ERROR_CANCELLED;
+            snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                     "Authentication cancelled");
+            return API_ERROR_CANCELLED;
+        }
+
         /* Need to do full OAuth flow */
         printf("\n");
         printf("=== OAuth2 Authorization Required ===\n");
@@ -326,13 +767,12 @@ api_error api_authenticate(iracing_api *api)
         printf("\n");
 
         if (oauth_authorize(api->oauth)) {
-            oauth_save_tokens(api->oauth, "oauth_tokens.json");
-            api->state = AUTH_STATE_AUTHENTICATED;
-            api->token_expires = time(NULL) + 3600;
+            oauth_save_tokens(api->oauth, api->token_file);
+            set_authenticated(api, oauth_access_expires(api->oauth));
             printf("Authentication successful!\n");
             return API_OK;
         } else {
-            api->state = AUTH_STATE_FAILED;
+            set_auth_state(api, AUTH_STATE_FAILED);
             api->last_error = API_ERROR_INVALID_CREDENTIALS;
             snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                      "OAuth authentication failed: %s", oauth_get_error(api->oauth));
@@ -348,7 +788,7 @@ api_error api_authenticate(iracing_api *api)
         return API_ERROR_INVALID_CREDENTIALS;
     }
 
-    api->state = AUTH_STATE_AUTHENTICATING;
+    set_auth_state(api, AUTH_STATE_AUTHENTICATING);
 
     /* Build auth request body */
     char body[1024];
@@ -366,7 +806,7 @@ api_error api_authenticate(iracing_api *api)
     memset(body, 0, sizeof(body));
 
     if (!resp) {
-        api->state = AUTH_STATE_FAILED;
+        set_auth_state(api, AUTH_STATE_FAILED);
         return map_http_status(api, NULL);
     }
 
@@ -379,7 +819,7 @@ api_error api_authenticate(iracing_api *api)
             /* Check for verification_required (2FA enabled) */
             json_value *verify = json_object_get(json, "verificationRequired");
             if (verify && json_get_bool(verify)) {
-                api->state = AUTH_STATE_FAILED;
+                set_auth_state(api, AUTH_STATE_FAILED);
                 api->last_error = API_ERROR_INVALID_CREDENTIALS;
                 snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                          "Account has 2FA enabled. Legacy auth requires 2FA disabled.");
@@ -391,11 +831,10 @@ api_error api_authenticate(iracing_api *api)
             json_free(json);
         }
 
-        api->state = AUTH_STATE_AUTHENTICATED;
-        api->token_expires = time(NULL) + (2 * 60 * 60);  /* ~2 hours */
+        set_authenticated(api, time(NULL) + (2 * 60 * 60));  /* ~2 hours */
         err = API_OK;
     } else {
-        api->state = AUTH_STATE_FAILED;
+        set_auth_state(api, AUTH_STATE_FAILED);
     }
 
     http_response_free(resp);
@@ -404,9 +843,18 @@ api_error api_authenticate(iracing_api *api)
 
 api_error api_refresh_token(iracing_api *api)
 {
-    /* Legacy auth: re-authenticate to refresh session */
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
 
+    if (api->oauth) {
+        if (renew_token(api)) return API_OK;
+
+        api->last_error = API_ERROR_NOT_AUTHENTICATED;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Token refresh failed: %s", oauth_get_error(api->oauth));
+        return API_ERROR_NOT_AUTHENTICATED;
+    }
+
+    /* Legacy auth: re-authenticate to refresh session */
     if (api->username && api->password_hash) {
         return api_authenticate(api);
     }
@@ -418,55 +866,146 @@ api_error api_refresh_token(iracing_api *api)
 bool api_is_authenticated(iracing_api *api)
 {
     if (!api) return false;
-    return api->state == AUTH_STATE_AUTHENTICATED;
+
+    AcquireSRWLockShared(auth_lock(api));
+    bool authenticated = api->state == AUTH_STATE_AUTHENTICATED;
+    ReleaseSRWLockShared(auth_lock(api));
+    return authenticated;
 }
 
 bool api_token_expiring(iracing_api *api, int margin_seconds)
 {
-    if (!api || api->token_expires == 0) return true;
+    if (!api) return true;
+    if (api->oauth) return oauth_token_expiring(api->oauth, margin_seconds);
 
-    time_t now = time(NULL);
-    return (api->token_expires - now) < margin_seconds;
+    AcquireSRWLockShared(auth_lock(api));
+    time_t expires = api->token_expires;
+    ReleaseSRWLockShared(auth_lock(api));
+
+    if (expires == 0) return true;
+    return (expires - time(NULL)) < margin_seconds;
 }
 
 /*
- * Data Fetching - Cars
+ * Background Authentication
  */
-api_error api_fetch_cars(iracing_api *api, ira_database *db)
+
+/*
+ * Helper: Milliseconds until the access token is due for renewal. Capped
+ * at an hour so a sleep spanning a system suspend is soon corrected.
+ */
+static DWORD renew_delay_ms(iracing_api *api)
 {
-    if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    time_t due = oauth_access_expires(api->oauth) - API_TOKEN_REFRESH_MARGIN;
+    time_t now = time(NULL);
+    if (due <= now) return 0;
 
-    json_value *data = fetch_data_endpoint(api, API_CARS_GET);
-    if (!data) return api->last_error;
+    time_t secs = due - now;
+    if (secs > 3600) secs = 3600;
+    return (DWORD)secs * 1000;
+}
 
-    /* Data is an array of car objects */
-    if (json_get_type(data) != JSON_ARRAY) {
-        json_free(data);
-        api->last_error = API_ERROR_INVALID_RESPONSE;
-        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
-                 "Expected array of cars");
-        return API_ERROR_INVALID_RESPONSE;
-    }
+static DWORD WINAPI auth_thread_proc(LPVOID param)
+{
+    iracing_api *api = (iracing_api *)param;
 
-    int count = json_array_length(data);
+    api_error err = api_authenticate(api);
+    SetEvent(api->auth_settled);
 
-    /* Free existing cars */
-    if (db->cars) {
-        free(db->cars);
-        db->cars = NULL;
+    /* Cookie sessions can't be renewed ahead of time */
+    if (err != API_OK || !api->oauth) return 0;
+
+    DWORD wait = renew_delay_ms(api);
+    while (WaitForSingleObject(api->auth_stop, wait) == WAIT_TIMEOUT) {
+        if (!oauth_token_expiring(api->oauth, API_TOKEN_REFRESH_MARGIN) || renew_token(api)) {
+            wait = renew_delay_ms(api);
+        } else if (oauth_token_valid(api->oauth)) {
+            wait = API_TOKEN_RETRY_SECS * 1000;
+        } else {
+            /* Expired and can't be renewed; the next api_auth_start() logs in */
+            set_auth_state(api, AUTH_STATE_EXPIRED);
+            break;
+        }
+    }
+    return 0;
+}
+
+bool api_auth_start(iracing_api *api)
+{
+    if (!api) return false;
+
+    if (api->auth_thread) {
+        /* Still authenticating, or keeping a token the server accepts fresh */
+        bool running = WaitForSingleObject(api->auth_thread, 0) == WAIT_TIMEOUT;
+        if (running && (!api_auth_wait(api, 0) || api_is_authenticated(api))) return true;
+
+        /* A 401 means the token was revoked; stop renewing it and log in again */
+        if (running) {
+            SetEvent(api->auth_stop);
+            WaitForSingleObject(api->auth_thread, INFINITE);
+            ResetEvent(api->auth_stop);
+        }
+        CloseHandle(api->auth_thread);
+        api->auth_thread = NULL;
+        if (api_is_authenticated(api)) return true;
+    }
+
+    if (!api->auth_settled) api->auth_settled = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!api->auth_stop) api->auth_stop = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!api->auth_settled || !api->auth_stop) return false;
+
+    ResetEvent(api->auth_settled);
+    oauth_reset_cancel(api->oauth);
+    set_auth_state(api, AUTH_STATE_AUTHENTICATING);
+
+    api->auth_thread = CreateThread(NULL, 0, auth_thread_proc, api, 0, NULL);
+    if (!api->auth_thread) {
+        set_auth_state(api, AUTH_STATE_FAILED);
+        SetEvent(api->auth_settled);
+        return false;
+    }
+    return true;
+}
+
+bool api_auth_wait(iracing_api *api, int timeout_ms)
+{
+    if (!api || !api->auth_settled) return true;
+
+    DWORD wait = timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms;
+    return WaitForSingleObject(api->auth_settled, wait) == WAIT_OBJECT_0;
+}
+
+/*
+ * Data Fetching - Cars
+ */
+static api_error apply_cars(iracing_api *api, ira_database *db, const json_value *data)
+{
+    /* Data is an array of car objects */
+    if (json_get_type(data) != JSON_ARRAY) {
+        api->last_error = API_ERROR_INVALID_RESPONSE;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Expected array of cars");
+        return API_ERROR_INVALID_RESPONSE;
+    }
+
+    int count = json_array_length(data);
+
+    /* Free existing cars */
+    if (db->cars) {
+        free(db->cars);
+        db->cars = NULL;
         db->car_count = 0;
     }
 
     if (count == 0) {
-        json_free(data);
         db->cars_updated = time(NULL);
+        database_mark_dirty(db, DB_DIRTY_CARS);
+        database_rebuild_indexes(db);
         return API_OK;
     }
 
     db->cars = calloc(count, sizeof(ira_car));
     if (!db->cars) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -481,17 +1020,14 @@ api_error api_fetch_cars(iracing_api *api, ira_database *db)
 
         car->car_id = json_get_int(json_object_get(c, "car_id"));
 
-        const char *name = json_get_string(json_object_get(c, "car_name"));
-        if (name) safe_strcpy(car->car_name, sizeof(car->car_name), name);
-
-        const char *abbrev = json_get_string(json_object_get(c, "car_name_abbreviated"));
-        if (abbrev) safe_strcpy(car->car_abbrev, sizeof(car->car_abbrev), abbrev);
-
-        const char *make = json_get_string(json_object_get(c, "car_make"));
-        if (make) safe_strcpy(car->car_make, sizeof(car->car_make), make);
-
-        const char *model = json_get_string(json_object_get(c, "car_model"));
-        if (model) safe_strcpy(car->car_model, sizeof(car->car_model), model);
+        car->car_name = intern_string(&db->strings,
+                                      json_get_string(json_object_get(c, "car_name")));
+        car->car_abbrev = intern_string(&db->strings,
+                                        json_get_string(json_object_get(c, "car_name_abbreviated")));
+        car->car_make = intern_string(&db->strings,
+                                      json_get_string(json_object_get(c, "car_make")));
+        car->car_model = intern_string(&db->strings,
+                                       json_get_string(json_object_get(c, "car_model")));
 
         car->hp = json_get_int(json_object_get(c, "hp"));
         car->weight_kg = json_get_int(json_object_get(c, "car_weight"));
@@ -519,23 +1055,34 @@ api_error api_fetch_cars(iracing_api *api, ira_database *db)
     }
 
     db->cars_updated = time(NULL);
-    json_free(data);
+    database_mark_dirty(db, DB_DIRTY_CARS);
+    database_rebuild_indexes(db);
     return API_OK;
 }
 
-/*
- * Data Fetching - Tracks
- */
-api_error api_fetch_tracks(iracing_api *api, ira_database *db)
+api_error api_fetch_cars(iracing_api *api, ira_database *db)
 {
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
-    json_value *data = fetch_data_endpoint(api, API_TRACKS_GET);
-    if (!data) return api->last_error;
+    api_validator fresh;
+    json_document *doc = fetch_data_endpoint(api, API_CARS_GET,
+                                             conditional_for(api, API_CARS_GET, db->car_count > 0),
+                                             &fresh);
+    if (!doc) return api->last_error;
 
+    api_error err = apply_cars(api, db, json_document_root(doc));
+    if (err == API_OK) store_validator(api, &fresh);
+    json_document_free(doc);
+    return err;
+}
+
+/*
+ * Data Fetching - Tracks
+ */
+static api_error apply_tracks(iracing_api *api, ira_database *db, const json_value *data)
+{
     if (json_get_type(data) != JSON_ARRAY) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         snprintf(api->last_error_msg, sizeof(api->last_error_msg),
                  "Expected array of tracks");
@@ -552,14 +1099,14 @@ api_error api_fetch_tracks(iracing_api *api, ira_database *db)
     }
 
     if (count == 0) {
-        json_free(data);
         db->tracks_updated = time(NULL);
+        database_mark_dirty(db, DB_DIRTY_TRACKS);
+        database_rebuild_indexes(db);
         return API_OK;
     }
 
     db->tracks = calloc(count, sizeof(ira_track));
     if (!db->tracks) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -574,11 +1121,10 @@ api_error api_fetch_tracks(iracing_api *api, ira_database *db)
 
         track->track_id = json_get_int(json_object_get(t, "track_id"));
 
-        const char *name = json_get_string(json_object_get(t, "track_name"));
-        if (name) safe_strcpy(track->track_name, sizeof(track->track_name), name);
-
-        const char *config = json_get_string(json_object_get(t, "config_name"));
-        if (config) safe_strcpy(track->config_name, sizeof(track->config_name), config);
+        track->track_name = intern_string(&db->strings,
+                                          json_get_string(json_object_get(t, "track_name")));
+        track->config_name = intern_string(&db->strings,
+                                           json_get_string(json_object_get(t, "config_name")));
 
         track->category = json_get_int(json_object_get(t, "category_id"));
         track->is_oval = json_get_bool(json_object_get(t, "is_oval"));
@@ -594,8 +1140,8 @@ api_error api_fetch_tracks(iracing_api *api, ira_database *db)
         track->package_id = json_get_int(json_object_get(t, "package_id"));
         track->sku = json_get_int(json_object_get(t, "sku"));
 
-        const char *loc = json_get_string(json_object_get(t, "location"));
-        if (loc) safe_strcpy(track->location, sizeof(track->location), loc);
+        track->location = intern_string(&db->strings,
+                                        json_get_string(json_object_get(t, "location")));
 
         track->latitude = (float)json_get_number(json_object_get(t, "latitude"));
         track->longitude = (float)json_get_number(json_object_get(t, "longitude"));
@@ -604,23 +1150,34 @@ api_error api_fetch_tracks(iracing_api *api, ira_database *db)
     }
 
     db->tracks_updated = time(NULL);
-    json_free(data);
+    database_mark_dirty(db, DB_DIRTY_TRACKS);
+    database_rebuild_indexes(db);
     return API_OK;
 }
 
-/*
- * Data Fetching - Car Classes
- */
-api_error api_fetch_car_classes(iracing_api *api, ira_database *db)
+api_error api_fetch_tracks(iracing_api *api, ira_database *db)
 {
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
-    json_value *data = fetch_data_endpoint(api, API_CARCLASS_GET);
-    if (!data) return api->last_error;
+    api_validator fresh;
+    json_document *doc = fetch_data_endpoint(api, API_TRACKS_GET,
+                                             conditional_for(api, API_TRACKS_GET, db->track_count > 0),
+                                             &fresh);
+    if (!doc) return api->last_error;
+
+    api_error err = apply_tracks(api, db, json_document_root(doc));
+    if (err == API_OK) store_validator(api, &fresh);
+    json_document_free(doc);
+    return err;
+}
 
+/*
+ * Data Fetching - Car Classes
+ */
+static api_error apply_car_classes(iracing_api *api, ira_database *db, const json_value *data)
+{
     if (json_get_type(data) != JSON_ARRAY) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -635,14 +1192,14 @@ api_error api_fetch_car_classes(iracing_api *api, ira_database *db)
     }
 
     if (count == 0) {
-        json_free(data);
         db->car_classes_updated = time(NULL);
+        database_mark_dirty(db, DB_DIRTY_CAR_CLASSES);
+        database_rebuild_indexes(db);
         return API_OK;
     }
 
     db->car_classes = calloc(count, sizeof(ira_car_class));
     if (!db->car_classes) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -657,45 +1214,56 @@ api_error api_fetch_car_classes(iracing_api *api, ira_database *db)
 
         car_class->car_class_id = json_get_int(json_object_get(cc, "car_class_id"));
 
-        const char *name = json_get_string(json_object_get(cc, "name"));
-        if (name) safe_strcpy(car_class->car_class_name, sizeof(car_class->car_class_name), name);
-
-        const char *short_name = json_get_string(json_object_get(cc, "short_name"));
-        if (short_name) safe_strcpy(car_class->short_name, sizeof(car_class->short_name), short_name);
+        car_class->car_class_name = intern_string(&db->strings,
+                                                  json_get_string(json_object_get(cc, "name")));
+        car_class->short_name = intern_string(&db->strings,
+                                              json_get_string(json_object_get(cc, "short_name")));
 
         /* Parse cars_in_class array */
         json_value *cars = json_object_get(cc, "cars_in_class");
         if (cars && json_get_type(cars) == JSON_ARRAY) {
             int car_count = json_array_length(cars);
-            if (car_count > 32) car_count = 32;
-            car_class->car_count = car_count;
-            for (int j = 0; j < car_count; j++) {
-                json_value *car_entry = json_array_get(cars, j);
-                if (car_entry) {
-                    car_class->car_ids[j] = json_get_int(json_object_get(car_entry, "car_id"));
+            int *ids = car_count > 0 ? malloc((size_t)car_count * sizeof(int)) : NULL;
+            if (ids) {
+                for (int j = 0; j < car_count; j++) {
+                    ids[j] = json_get_int(json_object_get(json_array_get(cars, j), "car_id"));
                 }
+                car_class->car_ids = intern_ids(&db->strings, ids, car_count);
+                if (car_class->car_ids) car_class->car_count = car_count;
+                free(ids);
             }
         }
     }
 
     db->car_classes_updated = time(NULL);
-    json_free(data);
+    database_mark_dirty(db, DB_DIRTY_CAR_CLASSES);
+    database_rebuild_indexes(db);
     return API_OK;
 }
 
-/*
- * Data Fetching - Series
- */
-api_error api_fetch_series(iracing_api *api, ira_database *db)
+api_error api_fetch_car_classes(iracing_api *api, ira_database *db)
 {
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
+
+    api_validator fresh;
+    json_document *doc = fetch_data_endpoint(api, API_CARCLASS_GET,
+                                             conditional_for(api, API_CARCLASS_GET, db->car_class_count > 0),
+                                             &fresh);
+    if (!doc) return api->last_error;
 
-    json_value *data = fetch_data_endpoint(api, API_SERIES_GET);
-    if (!data) return api->last_error;
+    api_error err = apply_car_classes(api, db, json_document_root(doc));
+    if (err == API_OK) store_validator(api, &fresh);
+    json_document_free(doc);
+    return err;
+}
 
+/*
+ * Data Fetching - Series
+ */
+static api_error apply_series(iracing_api *api, ira_database *db, const json_value *data)
+{
     if (json_get_type(data) != JSON_ARRAY) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -710,14 +1278,14 @@ api_error api_fetch_series(iracing_api *api, ira_database *db)
     }
 
     if (count == 0) {
-        json_free(data);
         db->series_updated = time(NULL);
+        database_mark_dirty(db, DB_DIRTY_SERIES);
+        database_rebuild_indexes(db);
         return API_OK;
     }
 
     db->series = calloc(count, sizeof(ira_series));
     if (!db->series) {
-        json_free(data);
         api->last_error = API_ERROR_INVALID_RESPONSE;
         return API_ERROR_INVALID_RESPONSE;
     }
@@ -732,11 +1300,10 @@ api_error api_fetch_series(iracing_api *api, ira_database *db)
 
         series->series_id = json_get_int(json_object_get(s, "series_id"));
 
-        const char *name = json_get_string(json_object_get(s, "series_name"));
-        if (name) safe_strcpy(series->series_name, sizeof(series->series_name), name);
-
-        const char *short_name = json_get_string(json_object_get(s, "series_short_name"));
-        if (short_name) safe_strcpy(series->short_name, sizeof(series->short_name), short_name);
+        series->series_name = intern_string(&db->strings,
+                                            json_get_string(json_object_get(s, "series_name")));
+        series->short_name = intern_string(&db->strings,
+                                           json_get_string(json_object_get(s, "series_short_name")));
 
         series->category = json_get_int(json_object_get(s, "category_id"));
 
@@ -754,147 +1321,443 @@ api_error api_fetch_series(iracing_api *api, ira_database *db)
     }
 
     db->series_updated = time(NULL);
-    json_free(data);
+    database_mark_dirty(db, DB_DIRTY_SERIES);
+    database_rebuild_indexes(db);
     return API_OK;
 }
 
+api_error api_fetch_series(iracing_api *api, ira_database *db)
+{
+    if (!api) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
+
+    api_validator fresh;
+    json_document *doc = fetch_data_endpoint(api, API_SERIES_GET,
+                                             conditional_for(api, API_SERIES_GET, db->series_count > 0),
+                                             &fresh);
+    if (!doc) return api->last_error;
+
+    api_error err = apply_series(api, db, json_document_root(doc));
+    if (err == API_OK) store_validator(api, &fresh);
+    json_document_free(doc);
+    return err;
+}
+
 /*
  * Data Fetching - Seasons
+ *
+ * The seasons payload is by far the largest, so it is streamed straight into
+ * ira_season/ira_schedule_week structs instead of being parsed into a tree.
  */
-api_error api_fetch_seasons(iracing_api *api, ira_database *db, int year, int quarter)
+
+/* Keys the season builder cares about */
+typedef enum {
+    SEASON_KEY_OTHER,
+    SEASON_KEY_SEASON_ID,
+    SEASON_KEY_SERIES_ID,
+    SEASON_KEY_SEASON_NAME,
+    SEASON_KEY_SHORT_NAME,
+    SEASON_KEY_SEASON_YEAR,
+    SEASON_KEY_SEASON_QUARTER,
+    SEASON_KEY_FIXED_SETUP,
+    SEASON_KEY_OFFICIAL,
+    SEASON_KEY_ACTIVE,
+    SEASON_KEY_LICENSE_GROUP,
+    SEASON_KEY_SCHEDULES,
+    SEASON_KEY_CAR_CLASS_IDS,
+    SEASON_KEY_RACE_WEEK_NUM,
+    SEASON_KEY_TRACK,
+    SEASON_KEY_TRACK_ID,
+    SEASON_KEY_TRACK_NAME,
+    SEASON_KEY_CONFIG_NAME,
+    SEASON_KEY_RACE_TIME_LIMIT,
+    SEASON_KEY_RACE_LAP_LIMIT,
+    SEASON_KEY_START_DATE,
+    SEASON_KEY_RACE_TIME_DESCRIPTORS,
+    SEASON_KEY_REPEATING,
+    SEASON_KEY_FIRST_SESSION_TIME,
+    SEASON_KEY_REPEAT_MINUTES,
+    SEASON_KEY_DAY_OFFSET,
+    SEASON_KEY_SESSION_TIMES
+} season_key;
+
+static const struct {
+    const char *name;
+    season_key key;
+} g_season_keys[] = {
+    { "season_id",         SEASON_KEY_SEASON_ID },
+    { "series_id",         SEASON_KEY_SERIES_ID },
+    { "season_name",       SEASON_KEY_SEASON_NAME },
+    { "season_short_name", SEASON_KEY_SHORT_NAME },
+    { "season_year",       SEASON_KEY_SEASON_YEAR },
+    { "season_quarter",    SEASON_KEY_SEASON_QUARTER },
+    { "fixed_setup",       SEASON_KEY_FIXED_SETUP },
+    { "official",          SEASON_KEY_OFFICIAL },
+    { "active",            SEASON_KEY_ACTIVE },
+    { "license_group",     SEASON_KEY_LICENSE_GROUP },
+    { "schedules",         SEASON_KEY_SCHEDULES },
+    { "car_class_ids",     SEASON_KEY_CAR_CLASS_IDS },
+    { "race_week_num",     SEASON_KEY_RACE_WEEK_NUM },
+    { "track",             SEASON_KEY_TRACK },
+    { "track_id",          SEASON_KEY_TRACK_ID },
+    { "track_name",        SEASON_KEY_TRACK_NAME },
+    { "config_name",       SEASON_KEY_CONFIG_NAME },
+    { "race_time_limit",   SEASON_KEY_RACE_TIME_LIMIT },
+    { "race_lap_limit",    SEASON_KEY_RACE_LAP_LIMIT },
+    { "start_date",        SEASON_KEY_START_DATE },
+    { "race_time_descriptors", SEASON_KEY_RACE_TIME_DESCRIPTORS },
+    { "repeating",         SEASON_KEY_REPEATING },
+    { "first_session_time", SEASON_KEY_FIRST_SESSION_TIME },
+    { "repeat_minutes",    SEASON_KEY_REPEAT_MINUTES },
+    { "day_offset",        SEASON_KEY_DAY_OFFSET },
+    { "session_times",     SEASON_KEY_SESSION_TIMES },
+};
+
+static season_key lookup_season_key(const char *name)
 {
-    if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    for (size_t i = 0; i < sizeof(g_season_keys) / sizeof(g_season_keys[0]); i++) {
+        if (strcmp(g_season_keys[i].name, name) == 0) {
+            return g_season_keys[i].key;
+        }
+    }
+    return SEASON_KEY_OTHER;
+}
 
-    char endpoint[256];
-    snprintf(endpoint, sizeof(endpoint), "%s?season_year=%d&season_quarter=%d",
-             API_SERIES_SEASONS, year, quarter);
+/*
+ * Streaming season builder. Event depths for the payload:
+ *   0 root array, 1 season objects, 2 season fields, 3 schedule weeks and
+ *   car class ids, 4 week fields, 5 track fields and race time
+ *   descriptors, 6 descriptor fields, 7 day offsets and session times.
+ */
+typedef struct {
+    ira_intern *strings;        /* Pool of the database the seasons go into */
+    ira_season *seasons;
+    int count;
+    int capacity;
+    bool root_is_array;
+    bool failed;
+    int week_capacity;          /* Allocated weeks in the current season */
+    season_key season_field;    /* Last key seen at depth 2 */
+    season_key week_field;      /* Last key seen at depth 4 */
+    season_key track_field;     /* Last key seen at depth 5 */
+    season_key descriptor_field; /* Last key seen at depth 6 */
+} season_builder;
+
+static void season_builder_free(season_builder *b)
+{
+    for (int i = 0; i < b->count; i++) {
+        season_free_schedule(&b->seasons[i]);
+    }
+    free(b->seasons);
+    b->seasons = NULL;
+    b->count = 0;
+}
 
-    json_value *data = fetch_data_endpoint(api, endpoint);
-    if (!data) return api->last_error;
+static bool season_builder_begin_season(season_builder *b)
+{
+    if (b->count >= b->capacity) {
+        int new_capacity = b->capacity ? b->capacity * 2 : 64;
+        ira_season *new_seasons = realloc(b->seasons, new_capacity * sizeof(ira_season));
+        if (!new_seasons) return false;
+        b->seasons = new_seasons;
+        b->capacity = new_capacity;
+    }
+    ira_season *season = &b->seasons[b->count++];
+    memset(season, 0, sizeof(ira_season));
+    season->season_name = "";
+    season->short_name = "";
+    b->week_capacity = 0;
+    b->season_field = SEASON_KEY_OTHER;
+    return true;
+}
 
-    if (json_get_type(data) != JSON_ARRAY) {
-        json_free(data);
-        api->last_error = API_ERROR_INVALID_RESPONSE;
-        return API_ERROR_INVALID_RESPONSE;
+static bool season_builder_begin_week(season_builder *b, ira_season *season)
+{
+    if (season->schedule_count >= b->week_capacity) {
+        int new_capacity = b->week_capacity ? b->week_capacity * 2 : 16;
+        ira_schedule_week *new_weeks = realloc(season->schedule,
+                                               new_capacity * sizeof(ira_schedule_week));
+        if (!new_weeks) return false;
+        season->schedule = new_weeks;
+        b->week_capacity = new_capacity;
     }
+    ira_schedule_week *week = &season->schedule[season->schedule_count++];
+    memset(week, 0, sizeof(ira_schedule_week));
+    week->track_name = "";
+    week->config_name = "";
+    season->max_weeks = season->schedule_count;
+    b->week_field = SEASON_KEY_OTHER;
+    return true;
+}
 
-    int count = json_array_length(data);
+static void season_builder_season_value(season_builder *b, ira_season *season, season_key key,
+                                        const json_event *ev)
+{
+    bool is_num = ev->type == JSON_EVENT_NUMBER;
+    bool is_bool = ev->type == JSON_EVENT_BOOL;
+    bool is_str = ev->type == JSON_EVENT_STRING;
+
+    switch (key) {
+    case SEASON_KEY_SEASON_ID:      if (is_num) season->season_id = (int)ev->number; break;
+    case SEASON_KEY_SERIES_ID:      if (is_num) season->series_id = (int)ev->number; break;
+    case SEASON_KEY_SEASON_YEAR:    if (is_num) season->season_year = (int)ev->number; break;
+    case SEASON_KEY_SEASON_QUARTER: if (is_num) season->season_quarter = (int)ev->number; break;
+    case SEASON_KEY_LICENSE_GROUP:  if (is_num) season->license_group = (int)ev->number; break;
+    case SEASON_KEY_FIXED_SETUP:    if (is_bool) season->fixed_setup = ev->bool_val; break;
+    case SEASON_KEY_OFFICIAL:       if (is_bool) season->official = ev->bool_val; break;
+    case SEASON_KEY_ACTIVE:         if (is_bool) season->active = ev->bool_val; break;
+    case SEASON_KEY_SEASON_NAME:
+        if (is_str) season->season_name = intern_string(b->strings, ev->str);
+        break;
+    case SEASON_KEY_SHORT_NAME:
+        if (is_str) season->short_name = intern_string(b->strings, ev->str);
+        break;
+    default:
+        break;
+    }
+}
 
-    /* Free existing seasons */
-    if (db->seasons) {
-        for (int i = 0; i < db->season_count; i++) {
-            season_free_schedule(&db->seasons[i]);
+static void season_builder_week_value(ira_schedule_week *week, season_key key, const json_event *ev)
+{
+    if (key == SEASON_KEY_START_DATE && ev->type == JSON_EVENT_STRING) {
+        week->start_date = parse_utc_timestamp(ev->str);
+        week->end_date = week->start_date ? week->start_date + 7 * 86400 : 0;
+        return;
+    }
+    if (ev->type != JSON_EVENT_NUMBER) return;
+
+    switch (key) {
+    case SEASON_KEY_RACE_WEEK_NUM:   week->race_week_num = (int)ev->number; break;
+    case SEASON_KEY_RACE_TIME_LIMIT: week->race_time_limit_mins = (int)ev->number; break;
+    case SEASON_KEY_RACE_LAP_LIMIT:  week->race_lap_limit = (int)ev->number; break;
+    default: break;
+    }
+}
+
+static void season_builder_track_value(season_builder *b, ira_schedule_week *week,
+                                       season_key key, const json_event *ev)
+{
+    if (key == SEASON_KEY_TRACK_ID && ev->type == JSON_EVENT_NUMBER) {
+        week->track_id = (int)ev->number;
+    } else if (key == SEASON_KEY_TRACK_NAME && ev->type == JSON_EVENT_STRING) {
+        week->track_name = intern_string(b->strings, ev->str);
+    } else if (key == SEASON_KEY_CONFIG_NAME && ev->type == JSON_EVENT_STRING) {
+        week->config_name = intern_string(b->strings, ev->str);
+    }
+}
+
+static void season_builder_descriptor_value(ira_schedule_week *week, season_key key,
+                                            const json_event *ev)
+{
+    if (key == SEASON_KEY_REPEATING && ev->type == JSON_EVENT_BOOL) {
+        week->repeating = ev->bool_val;
+    } else if (key == SEASON_KEY_REPEAT_MINUTES && ev->type == JSON_EVENT_NUMBER) {
+        week->repeat_minutes = (int)ev->number;
+    } else if (key == SEASON_KEY_FIRST_SESSION_TIME && ev->type == JSON_EVENT_STRING) {
+        int hour = 0, min = 0;
+        if (sscanf(ev->str, "%d:%d", &hour, &min) == 2) {
+            week->first_session_mins = hour * 60 + min;
         }
-        free(db->seasons);
-        db->seasons = NULL;
-        db->season_count = 0;
+    } else if (key == SEASON_KEY_START_DATE && ev->type == JSON_EVENT_STRING &&
+               week->start_date == 0) {
+        week->start_date = parse_utc_timestamp(ev->str);
+        week->end_date = week->start_date ? week->start_date + 7 * 86400 : 0;
     }
+}
 
-    db->season_year = year;
-    db->season_quarter = quarter;
+/* Elements of the descriptor's day_offset and session_times arrays */
+static void season_builder_descriptor_item(ira_schedule_week *week, season_key key,
+                                           const json_event *ev)
+{
+    if (key == SEASON_KEY_DAY_OFFSET && ev->type == JSON_EVENT_NUMBER) {
+        int day = (int)ev->number;
+        if (day >= 0 && day < 7) week->day_mask |= (unsigned char)(1u << day);
+    } else if (key == SEASON_KEY_SESSION_TIMES && ev->type == JSON_EVENT_STRING &&
+               week->session_time_count < IRA_MAX_SESSION_TIMES) {
+        time_t t = parse_utc_timestamp(ev->str);
+        if (t) week->session_times[week->session_time_count++] = t;
+    }
+}
 
-    if (count == 0) {
-        json_free(data);
-        db->seasons_updated = time(NULL);
-        return API_OK;
+static bool season_builder_event(void *user, const json_event *ev)
+{
+    season_builder *b = (season_builder *)user;
+    bool is_start = ev->type == JSON_EVENT_OBJECT_START || ev->type == JSON_EVENT_ARRAY_START;
+    bool is_end = ev->type == JSON_EVENT_OBJECT_END || ev->type == JSON_EVENT_ARRAY_END;
+
+    if (ev->depth == 0) {
+        if (ev->type == JSON_EVENT_ARRAY_START) b->root_is_array = true;
+        return true;
+    }
+    if (!b->root_is_array || is_end) {
+        return true;
     }
 
-    db->seasons = calloc(count, sizeof(ira_season));
-    if (!db->seasons) {
-        json_free(data);
-        api->last_error = API_ERROR_INVALID_RESPONSE;
-        return API_ERROR_INVALID_RESPONSE;
+    if (ev->depth == 1) {
+        if (ev->type == JSON_EVENT_OBJECT_START && !season_builder_begin_season(b)) {
+            b->failed = true;
+            return false;
+        }
+        return true;
     }
 
-    db->season_count = count;
+    if (b->count == 0) return true;
+    ira_season *season = &b->seasons[b->count - 1];
 
-    for (int i = 0; i < count; i++) {
-        json_value *s = json_array_get(data, i);
-        if (!s) continue;
+    switch (ev->depth) {
+    case 2:
+        if (ev->type == JSON_EVENT_KEY) {
+            b->season_field = lookup_season_key(ev->str);
+        } else if (!is_start) {
+            season_builder_season_value(b, season, b->season_field, ev);
+        }
+        break;
 
-        ira_season *season = &db->seasons[i];
-
-        season->season_id = json_get_int(json_object_get(s, "season_id"));
-        season->series_id = json_get_int(json_object_get(s, "series_id"));
-
-        const char *name = json_get_string(json_object_get(s, "season_name"));
-        if (name) safe_strcpy(season->season_name, sizeof(season->season_name), name);
-
-        const char *short_name = json_get_string(json_object_get(s, "season_short_name"));
-        if (short_name) safe_strcpy(season->short_name, sizeof(season->short_name), short_name);
-
-        season->season_year = json_get_int(json_object_get(s, "season_year"));
-        season->season_quarter = json_get_int(json_object_get(s, "season_quarter"));
-        season->fixed_setup = json_get_bool(json_object_get(s, "fixed_setup"));
-        season->official = json_get_bool(json_object_get(s, "official"));
-        season->active = json_get_bool(json_object_get(s, "active"));
-        season->license_group = json_get_int(json_object_get(s, "license_group"));
-
-        /* Parse schedules array */
-        json_value *schedules = json_object_get(s, "schedules");
-        if (schedules && json_get_type(schedules) == JSON_ARRAY) {
-            int sched_count = json_array_length(schedules);
-            if (sched_count > 0) {
-                season->schedule = calloc(sched_count, sizeof(ira_schedule_week));
-                if (season->schedule) {
-                    season->schedule_count = sched_count;
-                    season->max_weeks = sched_count;
-
-                    for (int j = 0; j < sched_count; j++) {
-                        json_value *w = json_array_get(schedules, j);
-                        if (!w) continue;
-
-                        ira_schedule_week *week = &season->schedule[j];
-
-                        week->race_week_num = json_get_int(json_object_get(w, "race_week_num"));
-
-                        /* Track info may be nested */
-                        json_value *track_obj = json_object_get(w, "track");
-                        if (track_obj) {
-                            week->track_id = json_get_int(json_object_get(track_obj, "track_id"));
-                            const char *track_name = json_get_string(json_object_get(track_obj, "track_name"));
-                            if (track_name) safe_strcpy(week->track_name, sizeof(week->track_name), track_name);
-                            const char *config = json_get_string(json_object_get(track_obj, "config_name"));
-                            if (config) safe_strcpy(week->config_name, sizeof(week->config_name), config);
-                        }
-
-                        week->race_time_limit_mins = json_get_int(json_object_get(w, "race_time_limit"));
-                        week->race_lap_limit = json_get_int(json_object_get(w, "race_lap_limit"));
-
-                        /* Parse car_class_ids or car_ids */
-                        json_value *car_classes = json_object_get(w, "car_class_ids");
-                        if (car_classes && json_get_type(car_classes) == JSON_ARRAY) {
-                            /* Would need to resolve car class to cars */
-                        }
-                    }
-                }
+    case 3:
+        if (b->season_field == SEASON_KEY_SCHEDULES && ev->type == JSON_EVENT_OBJECT_START) {
+            if (!season_builder_begin_week(b, season)) {
+                b->failed = true;
+                return false;
             }
+        } else if (b->season_field == SEASON_KEY_CAR_CLASS_IDS &&
+                   season->car_class_count < 8) {
+            season->car_class_ids[season->car_class_count++] =
+                ev->type == JSON_EVENT_NUMBER ? (int)ev->number : 0;
+        }
+        break;
+
+    case 4:
+        if (b->season_field != SEASON_KEY_SCHEDULES || season->schedule_count == 0) break;
+        if (ev->type == JSON_EVENT_KEY) {
+            b->week_field = lookup_season_key(ev->str);
+            b->track_field = SEASON_KEY_OTHER;
+        } else if (!is_start) {
+            season_builder_week_value(&season->schedule[season->schedule_count - 1],
+                                      b->week_field, ev);
         }
+        break;
 
-        /* Parse car_class_ids */
-        json_value *cc_ids = json_object_get(s, "car_class_ids");
-        if (cc_ids && json_get_type(cc_ids) == JSON_ARRAY) {
-            int cc_count = json_array_length(cc_ids);
-            if (cc_count > 8) cc_count = 8;
-            season->car_class_count = cc_count;
-            for (int j = 0; j < cc_count; j++) {
-                season->car_class_ids[j] = json_get_int(json_array_get(cc_ids, j));
-            }
+    case 5:
+        if (b->season_field != SEASON_KEY_SCHEDULES || season->schedule_count == 0) break;
+        if (b->week_field == SEASON_KEY_RACE_TIME_DESCRIPTORS) {
+            if (ev->type == JSON_EVENT_OBJECT_START) b->descriptor_field = SEASON_KEY_OTHER;
+            break;
+        }
+        if (b->week_field != SEASON_KEY_TRACK) break;
+        if (ev->type == JSON_EVENT_KEY) {
+            b->track_field = lookup_season_key(ev->str);
+        } else if (!is_start) {
+            season_builder_track_value(b, &season->schedule[season->schedule_count - 1],
+                                       b->track_field, ev);
         }
+        break;
+
+    case 6:
+    case 7:
+        if (b->season_field != SEASON_KEY_SCHEDULES || season->schedule_count == 0 ||
+            b->week_field != SEASON_KEY_RACE_TIME_DESCRIPTORS) break;
+        if (ev->depth == 6 && ev->type == JSON_EVENT_KEY) {
+            b->descriptor_field = lookup_season_key(ev->str);
+        } else if (ev->depth == 6 && !is_start) {
+            season_builder_descriptor_value(&season->schedule[season->schedule_count - 1],
+                                            b->descriptor_field, ev);
+        } else if (ev->depth == 7 && !is_start) {
+            season_builder_descriptor_item(&season->schedule[season->schedule_count - 1],
+                                           b->descriptor_field, ev);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+/*
+ * Helper: Swap streamed seasons into the database.
+ *
+ * ok is the result of the download. The builder is consumed either way, so
+ * a failed sync leaves the existing seasons untouched.
+ */
+static api_error apply_seasons(iracing_api *api, ira_database *db, season_builder *builder,
+                               bool ok, int year, int quarter)
+{
+    if (ok && !builder->root_is_array) {
+        api->last_error = API_ERROR_INVALID_RESPONSE;
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Expected array of seasons");
+        ok = false;
+    } else if (!ok && builder->failed) {
+        snprintf(api->last_error_msg, sizeof(api->last_error_msg),
+                 "Out of memory reading seasons");
+    }
+
+    if (!ok) {
+        season_builder_free(builder);
+        return api->last_error;
     }
 
+    /* Free existing seasons */
+    if (db->seasons) {
+        for (int i = 0; i < db->season_count; i++) {
+            season_free_schedule(&db->seasons[i]);
+        }
+        free(db->seasons);
+    }
+
+    db->seasons = builder->seasons;
+    db->season_count = builder->count;
+    db->season_year = year;
+    db->season_quarter = quarter;
     db->seasons_updated = time(NULL);
-    json_free(data);
+    database_mark_dirty(db, DB_DIRTY_SEASONS);
+    database_rebuild_indexes(db);
+
+    memset(builder, 0, sizeof(*builder));
     return API_OK;
 }
 
+/* Helper: Check whether db already holds the seasons of a quarter */
+static bool have_seasons(const ira_database *db, int year, int quarter)
+{
+    return db->season_count > 0 && db->season_year == year && db->season_quarter == quarter;
+}
+
+static void seasons_endpoint(char *buf, size_t size, int year, int quarter)
+{
+    snprintf(buf, size, "%s?season_year=%d&season_quarter=%d",
+             API_SERIES_SEASONS, year, quarter);
+}
+
+api_error api_fetch_seasons(iracing_api *api, ira_database *db, int year, int quarter)
+{
+    if (!api) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
+
+    char endpoint[256];
+    seasons_endpoint(endpoint, sizeof(endpoint), year, quarter);
+
+    /* Build into temporaries so a failed sync leaves the database untouched */
+    season_builder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.strings = &db->strings;
+
+    api_validator fresh;
+    bool ok = fetch_data_stream(api, endpoint, season_builder_event, &builder,
+                                conditional_for(api, endpoint, have_seasons(db, year, quarter)),
+                                &fresh);
+    api_error err = apply_seasons(api, db, &builder, ok, year, quarter);
+    if (ok && err == API_OK) store_validator(api, &fresh);
+    return err;
+}
+
 api_error api_fetch_season_schedule(iracing_api *api, ira_database *db, int season_id)
 {
     (void)db;
     (void)season_id;
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
     /* Season schedules are embedded in api_fetch_seasons response */
     api->last_error = API_OK;
@@ -907,22 +1770,36 @@ api_error api_fetch_season_schedule(iracing_api *api, ira_database *db, int seas
 api_error api_fetch_member_info(iracing_api *api, ira_database *db)
 {
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
-    json_value *data = fetch_data_endpoint(api, API_MEMBER_INFO);
-    if (!data) return api->last_error;
+    json_document *doc = fetch_data_endpoint(api, API_MEMBER_INFO, NULL, NULL);
+    if (!doc) return api->last_error;
+    json_value *data = json_document_root(doc);
 
     /* Extract cust_id */
-    db->owned.cust_id = json_get_int(json_object_get(data, "cust_id"));
+    int cust_id = json_get_int(json_object_get(data, "cust_id"));
+    if (cust_id != db->owned.cust_id) {
+        db->owned.cust_id = cust_id;
+        database_mark_dirty(db, DB_DIRTY_OWNED);
+    }
 
-    json_free(data);
+    json_document_free(doc);
     return API_OK;
 }
 
+/*
+ * Helper: Check two ID lists hold the same IDs in the same order
+ */
+static bool same_ids(const int *a, int a_count, const int *b, int b_count)
+{
+    if (a_count != b_count) return false;
+    return a_count == 0 || memcmp(a, b, (size_t)a_count * sizeof(int)) == 0;
+}
+
 api_error api_fetch_owned_content(iracing_api *api, ira_database *db)
 {
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
     /*
      * iRacing doesn't have a direct "owned content" endpoint.
@@ -932,9 +1809,6 @@ api_error api_fetch_owned_content(iracing_api *api, ira_database *db)
      * and actual purchases would need to come from member profile.
      */
 
-    /* Free existing owned lists */
-    owned_content_free(&db->owned);
-
     /* Count free cars and tracks */
     int free_cars = 0;
     int free_tracks = 0;
@@ -946,34 +1820,53 @@ api_error api_fetch_owned_content(iracing_api *api, ira_database *db)
         if (db->tracks[i].free_with_subscription) free_tracks++;
     }
 
-    /* Allocate owned arrays */
+    /* Build the new lists aside, to compare with the current ones */
+    ira_owned_content owned = {0};
+
     if (free_cars > 0) {
-        db->owned.owned_car_ids = malloc(free_cars * sizeof(int));
-        if (db->owned.owned_car_ids) {
+        owned.owned_car_ids = malloc(free_cars * sizeof(int));
+        if (owned.owned_car_ids) {
             int idx = 0;
             for (int i = 0; i < db->car_count; i++) {
                 if (db->cars[i].free_with_subscription) {
-                    db->owned.owned_car_ids[idx++] = db->cars[i].car_id;
+                    owned.owned_car_ids[idx++] = db->cars[i].car_id;
                 }
             }
-            db->owned.owned_car_count = free_cars;
+            owned.owned_car_count = free_cars;
         }
     }
 
     if (free_tracks > 0) {
-        db->owned.owned_track_ids = malloc(free_tracks * sizeof(int));
-        if (db->owned.owned_track_ids) {
+        owned.owned_track_ids = malloc(free_tracks * sizeof(int));
+        if (owned.owned_track_ids) {
             int idx = 0;
             for (int i = 0; i < db->track_count; i++) {
                 if (db->tracks[i].free_with_subscription) {
-                    db->owned.owned_track_ids[idx++] = db->tracks[i].track_id;
+                    owned.owned_track_ids[idx++] = db->tracks[i].track_id;
                 }
             }
-            db->owned.owned_track_count = free_tracks;
+            owned.owned_track_count = free_tracks;
         }
     }
 
+    /* Unchanged lists keep their timestamp, so owned.json isn't rewritten */
+    if (same_ids(owned.owned_car_ids, owned.owned_car_count,
+                 db->owned.owned_car_ids, db->owned.owned_car_count) &&
+        same_ids(owned.owned_track_ids, owned.owned_track_count,
+                 db->owned.owned_track_ids, db->owned.owned_track_count)) {
+        owned_content_free(&owned);
+        return API_OK;
+    }
+
+    owned_content_free(&db->owned);
+    db->owned.owned_car_ids = owned.owned_car_ids;
+    db->owned.owned_car_count = owned.owned_car_count;
+    db->owned.owned_track_ids = owned.owned_track_ids;
+    db->owned.owned_track_count = owned.owned_track_count;
+
     db->owned.last_updated = time(NULL);
+    database_mark_dirty(db, DB_DIRTY_OWNED);
+    database_rebuild_indexes(db);
     return API_OK;
 }
 
@@ -981,7 +1874,7 @@ api_error api_fetch_race_guide(iracing_api *api, ira_database *db)
 {
     (void)db;
     if (!api) return API_ERROR_NOT_AUTHENTICATED;
-    if (!api_is_authenticated(api)) return API_ERROR_NOT_AUTHENTICATED;
+    if (!await_auth(api, NULL)) return API_ERROR_NOT_AUTHENTICATED;
 
     /* TODO: Implement race guide parsing */
     api->last_error = API_ERROR_NOT_IMPLEMENTED;
@@ -1019,12 +1912,96 @@ api_error api_fetch_static_data(iracing_api *api, ira_database *db)
     return API_OK;
 }
 
-api_error api_fetch_filter_data(iracing_api *api, ira_database *db)
+/*
+ * Background sync job, see api_sync_start()
+ */
+
+/* Steps reported by fetch_filter_data() */
+#define SYNC_STEP_COUNT 4
+
+struct api_sync_job {
+    iracing_api *api;
+    ira_database *shadow;       /* Written only by the sync thread */
+    api_sync_progress_fn progress_fn;
+    void *progress_user;
+
+    HANDLE thread;
+    HANDLE cancel_event;        /* Manual-reset: api_sync_cancel() called */
+
+    CRITICAL_SECTION lock;
+    api_sync_progress progress;
+    api_error result;
+};
+
+/*
+ * Helper: Enter a step (-1 = same step, new stage) and tell the caller.
+ * job may be NULL.
+ */
+static void sync_step(api_sync_job *job, int step, const char *stage)
 {
-    api_error err;
+    if (!job) return;
 
-    err = api_fetch_static_data(api, db);
-    if (err != API_OK) return err;
+    EnterCriticalSection(&job->lock);
+    if (step >= 0) job->progress.step = step;
+    job->progress.stage = stage;
+    api_sync_progress snapshot = job->progress;
+    LeaveCriticalSection(&job->lock);
+
+    if (job->progress_fn) job->progress_fn(job->progress_user, &snapshot);
+}
+
+static bool sync_cancelled(api_sync_job *job)
+{
+    return job && WaitForSingleObject(job->cancel_event, 0) == WAIT_OBJECT_0;
+}
+
+static api_error set_cancelled(iracing_api *api)
+{
+    api->last_error = API_ERROR_CANCELLED;
+    snprintf(api->last_error_msg, sizeof(api->last_error_msg), "Sync cancelled");
+    return API_ERROR_CANCELLED;
+}
+
+/*
+ * Catalog endpoints fetched together by api_fetch_filter_data().
+ * Seasons must stay last: it is streamed rather than parsed into a tree.
+ */
+typedef enum {
+    SYNC_CARS,
+    SYNC_TRACKS,
+    SYNC_SERIES,
+    SYNC_SEASONS,
+    SYNC_COUNT
+} sync_table;
+
+typedef api_error (*apply_fn)(iracing_api *api, ira_database *db, const json_value *data);
+
+static const apply_fn g_sync_apply[SYNC_SEASONS] = {
+    apply_cars,
+    apply_tracks,
+    apply_series,
+};
+
+/*
+ * Helper: api_fetch_filter_data(), reporting progress to job and
+ * stopping early if it is cancelled. job may be NULL.
+ */
+static api_error fetch_filter_data(iracing_api *api, ira_database *db, api_sync_job *job)
+{
+    if (!api) return API_ERROR_NOT_AUTHENTICATED;
+    if (sync_cancelled(job)) return set_cancelled(api);
+
+    /* A sync started during startup waits here for the token */
+    if (!api_auth_wait(api, 0)) sync_step(job, -1, "Waiting for authentication");
+    bool authed = await_auth(api, job ? job->cancel_event : NULL);
+    if (sync_cancelled(job)) return set_cancelled(api);
+    if (!authed) {
+        if (api->last_error == API_OK) {
+            api->last_error = API_ERROR_NOT_AUTHENTICATED;
+            snprintf(api->last_error_msg, sizeof(api->last_error_msg), "Not authenticated");
+        }
+        return api->last_error;
+    }
 
     /* Get current year/quarter */
     time_t now = time(NULL);
@@ -1037,13 +2014,260 @@ api_error api_fetch_filter_data(iracing_api *api, ira_database *db)
     int year = tm->tm_year + 1900;
     int quarter = (tm->tm_mon / 3) + 1;
 
-    err = api_fetch_seasons(api, db, year, quarter);
-    if (err != API_OK) return err;
+    char season_ep[256];
+    seasons_endpoint(season_ep, sizeof(season_ep), year, quarter);
+
+    const char *endpoints[SYNC_COUNT] = {
+        API_CARS_GET, API_TRACKS_GET, API_SERIES_GET, season_ep
+    };
+    const bool have_data[SYNC_COUNT] = {
+        db->car_count > 0, db->track_count > 0, db->series_count > 0,
+        have_seasons(db, year, quarter)
+    };
+
+    char urls[SYNC_COUNT][512];
+    char links[SYNC_COUNT][API_MAX_LINK_LEN];
+    bool resolved[SYNC_COUNT];
+    http_batch_item items[SYNC_COUNT];
+    const char *token = current_token(api);
+
+    /* Round one: every endpoint's link request at once */
+    sync_step(job, 1, "Requesting download links");
+    memset(items, 0, sizeof(items));
+    for (int i = 0; i < SYNC_COUNT; i++) {
+        snprintf(urls[i], sizeof(urls[i]), "%s%s", IRACING_API_BASE, endpoints[i]);
+        items[i].url = urls[i];
+        items[i].bearer_token = token;
+    }
+    http_batch_get(api->http, items, SYNC_COUNT, SYNC_COUNT);
+
+    /* A table that fails is skipped; the first error is reported */
+    api_error first_err = API_OK;
+    char first_msg[sizeof(api->last_error_msg)] = "";
+
+    for (int i = 0; i < SYNC_COUNT; i++) {
+        resolved[i] = parse_link_response(api, items[i].response, items[i].error,
+                                          links[i], sizeof(links[i]));
+        if (!resolved[i] && first_err == API_OK) {
+            first_err = api->last_error;
+            memcpy(first_msg, api->last_error_msg, sizeof(first_msg));
+        }
+        http_response_free(items[i].response);
+    }
 
-    err = api_fetch_owned_content(api, db);
-    if (err != API_OK) return err;
+    if (sync_cancelled(job)) return set_cancelled(api);
+
+    /* Round two: every download at once, streaming seasons into a builder */
+    sync_step(job, 2, "Downloading catalog");
+    season_builder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.strings = &db->strings;
+    json_stream *stream = json_stream_create(season_builder_event, &builder);
+    if (!stream) {
+        resolved[SYNC_SEASONS] = false;
+        if (first_err == API_OK) {
+            first_err = API_ERROR_INVALID_RESPONSE;
+            snprintf(first_msg, sizeof(first_msg), "Out of memory");
+        }
+    }
 
-    return API_OK;
+    memset(items, 0, sizeof(items));
+    for (int i = 0; i < SYNC_COUNT; i++) {
+        if (!resolved[i]) continue;
+        const api_validator *cond = conditional_for(api, endpoints[i], have_data[i]);
+        items[i].url = links[i];
+        items[i].etag = validator_etag(cond);
+        items[i].last_modified = validator_last_modified(cond);
+    }
+    items[SYNC_SEASONS].sink = feed_json_stream;
+    items[SYNC_SEASONS].user = stream;
+    http_batch_get(api->http, items, SYNC_COUNT, SYNC_COUNT);
+
+    /* Apply on this thread, in table order; unchanged tables are skipped */
+    sync_step(job, 3, "Applying updates");
+    api_validator fresh;
+    int unchanged = 0;
+
+    for (int i = 0; i < SYNC_SEASONS; i++) {
+        if (!resolved[i]) continue;
+
+        api_error err;
+        api->not_modified = false;
+        json_document *doc = parse_data_response(api, items[i].response, items[i].error,
+                                                 endpoints[i], &fresh);
+        if (doc) {
+            err = g_sync_apply[i](api, db, json_document_root(doc));
+            if (err == API_OK) store_validator(api, &fresh);
+            json_document_free(doc);
+        } else {
+            if (api->not_modified) unchanged++;
+            err = api->last_error;
+        }
+        http_response_free(items[i].response);
+
+        if (err != API_OK && first_err == API_OK) {
+            first_err = err;
+            memcpy(first_msg, api->last_error_msg, sizeof(first_msg));
+        }
+    }
+
+    if (resolved[SYNC_SEASONS]) {
+        http_batch_item *item = &items[SYNC_SEASONS];
+        api->not_modified = false;
+        bool ok = finish_stream_response(api, item->response, item->error, stream,
+                                         endpoints[SYNC_SEASONS], &fresh);
+        if (api->not_modified) unchanged++;
+        api_error err = apply_seasons(api, db, &builder, ok, year, quarter);
+        if (ok && err == API_OK) store_validator(api, &fresh);
+        http_response_free(item->response);
+
+        if (err != API_OK && first_err == API_OK) {
+            first_err = err;
+            memcpy(first_msg, api->last_error_msg, sizeof(first_msg));
+        }
+    }
+    json_stream_destroy(stream);
+
+    sync_step(job, 4, "Updating owned content");
+    api_error err = api_fetch_owned_content(api, db);
+    api->not_modified = (unchanged == SYNC_COUNT);
+    if (first_err != API_OK) {
+        api->last_error = first_err;
+        memcpy(api->last_error_msg, first_msg, sizeof(first_msg));
+        return first_err;
+    }
+    return err;
+}
+
+api_error api_fetch_filter_data(iracing_api *api, ira_database *db)
+{
+    return fetch_filter_data(api, db, NULL);
+}
+
+/*
+ * Helper: Seconds to wait before the next attempt, or 0 to go ahead.
+ * Waits for the server's reset time when the budget is spent, else
+ * backs off exponentially after a 429.
+ */
+static int rate_limit_wait_secs(const iracing_api *api, int attempt, bool limited)
+{
+    time_t now = time(NULL);
+    bool spent = api->rate_limit_reset > now && api->rate_limit_remaining < SYNC_COUNT;
+
+    if (!limited && !spent) return 0;
+
+    int secs = spent ? (int)(api->rate_limit_reset - now) + 1 : (5 << attempt);
+    return secs < API_SYNC_MAX_WAIT_SECS ? secs : API_SYNC_MAX_WAIT_SECS;
+}
+
+static DWORD WINAPI sync_thread_proc(LPVOID param)
+{
+    api_sync_job *job = (api_sync_job *)param;
+    iracing_api *api = job->api;
+    api_error err = API_OK;
+
+    for (int attempt = 0; ; attempt++) {
+        int wait = rate_limit_wait_secs(api, attempt, err == API_ERROR_RATE_LIMITED);
+        if (wait > 0) {
+            sync_step(job, -1, "Waiting for rate limit reset");
+            if (WaitForSingleObject(job->cancel_event, (DWORD)wait * 1000) == WAIT_OBJECT_0) {
+                err = set_cancelled(api);
+                break;
+            }
+        }
+
+        /*
+         * A retry repeats every link request, but tables applied by an
+         * earlier attempt now revalidate as 304s.
+         */
+        err = fetch_filter_data(api, job->shadow, job);
+        if (err != API_ERROR_RATE_LIMITED || attempt >= API_SYNC_MAX_RETRIES) break;
+
+        EnterCriticalSection(&job->lock);
+        job->progress.retries++;
+        LeaveCriticalSection(&job->lock);
+    }
+
+    EnterCriticalSection(&job->lock);
+    job->result = err;
+    job->progress.finished = true;
+    api_sync_progress snapshot = job->progress;
+    LeaveCriticalSection(&job->lock);
+
+    if (job->progress_fn) job->progress_fn(job->progress_user, &snapshot);
+    return 0;
+}
+
+api_sync_job *api_sync_start(iracing_api *api, const ira_database *db,
+                             api_sync_progress_fn progress, void *user)
+{
+    if (!api || !db) return NULL;
+
+    api_sync_job *job = calloc(1, sizeof(api_sync_job));
+    if (!job) return NULL;
+
+    job->api = api;
+    job->progress_fn = progress;
+    job->progress_user = user;
+    job->progress.stage = "Starting";
+    job->progress.total = SYNC_STEP_COUNT;
+    InitializeCriticalSection(&job->lock);
+
+    job->shadow = database_clone_catalog(db);
+    job->cancel_event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (job->shadow && job->cancel_event) {
+        job->thread = CreateThread(NULL, 0, sync_thread_proc, job, 0, NULL);
+    }
+
+    if (!job->thread) {
+        if (job->cancel_event) CloseHandle(job->cancel_event);
+        database_destroy(job->shadow);
+        DeleteCriticalSection(&job->lock);
+        free(job);
+        return NULL;
+    }
+
+    return job;
+}
+
+void api_sync_cancel(api_sync_job *job)
+{
+    if (job) SetEvent(job->cancel_event);
+}
+
+bool api_sync_wait(api_sync_job *job, int timeout_ms, api_sync_progress *progress)
+{
+    if (!job) return true;
+
+    DWORD wait = timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms;
+    bool done = WaitForSingleObject(job->thread, wait) == WAIT_OBJECT_0;
+
+    if (progress) {
+        EnterCriticalSection(&job->lock);
+        *progress = job->progress;
+        LeaveCriticalSection(&job->lock);
+    }
+    return done;
+}
+
+api_error api_sync_finish(api_sync_job *job, ira_database *db)
+{
+    if (!job) return API_ERROR_INVALID_RESPONSE;
+
+    WaitForSingleObject(job->thread, INFINITE);
+    api_error result = job->result;
+
+    /* Tables that failed kept their old contents, so a partial sync still applies */
+    if (result != API_ERROR_CANCELLED && db) {
+        database_swap_catalog(db, job->shadow);
+    }
+
+    CloseHandle(job->thread);
+    CloseHandle(job->cancel_event);
+    DeleteCriticalSection(&job->lock);
+    database_destroy(job->shadow);
+    free(job);
+    return result;
 }
 
 api_error api_refresh_stale_data(iracing_api *api, ira_database *db)
@@ -1091,6 +2315,7 @@ const char *api_error_string(api_error err)
         case API_ERROR_SERVER_ERROR:      return "Server error";
         case API_ERROR_INVALID_RESPONSE:  return "Invalid response";
         case API_ERROR_NOT_IMPLEMENTED:   return "Not implemented";
+        case API_ERROR_CANCELLED:         return "Cancelled";
         default:                          return "Unknown error";
     }
 }
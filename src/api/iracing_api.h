@@ -33,7 +33,8 @@ typedef enum {
     API_ERROR_TIMEOUT,
     API_ERROR_SERVER_ERROR,
     API_ERROR_INVALID_RESPONSE,
-    API_ERROR_NOT_IMPLEMENTED
+    API_ERROR_NOT_IMPLEMENTED,
+    API_ERROR_CANCELLED
 } api_error;
 
 /*
@@ -47,6 +48,31 @@ typedef enum {
     AUTH_STATE_EXPIRED
 } auth_state;
 
+/* Default response cache file */
+#define API_CACHE_FILE "api_cache.json"
+
+/* Default OAuth token file */
+#define API_TOKEN_FILE "oauth_tokens.json"
+
+/* Seconds before expiry that the background refresh renews the token */
+#define API_TOKEN_REFRESH_MARGIN 300
+
+/* Seconds between attempts after a failed background refresh */
+#define API_TOKEN_RETRY_SECS 30
+
+/* Endpoints whose validators are remembered */
+#define API_MAX_VALIDATORS 16
+
+/*
+ * Cache validators of the last download applied from an endpoint.
+ * Sent back as conditional headers so unchanged data answers 304.
+ */
+typedef struct {
+    char endpoint[128];
+    char etag[128];
+    char last_modified[64];
+} api_validator;
+
 /*
  * API Client structure
  */
@@ -57,11 +83,18 @@ typedef struct {
     /* OAuth2 Client (optional - for OAuth auth) */
     oauth_client *oauth;
 
-    /* Authentication */
+    /* Authentication; state and token_expires are read under auth_lock */
+    void *auth_lock;            /* SRWLOCK, zeroed by api_create() */
     auth_state state;
-    char *access_token;
+    char *access_token;         /* Token sent by the request in flight */
     char *refresh_token;
     time_t token_expires;
+    char token_file[260];       /* Where refreshed tokens are saved */
+
+    /* Background authentication, see api_auth_start() */
+    void *auth_thread;          /* HANDLE */
+    void *auth_settled;         /* Manual-reset event: first attempt done */
+    void *auth_stop;            /* Manual-reset event: api_destroy() called */
 
     /* Rate limiting */
     int rate_limit_remaining;
@@ -72,6 +105,12 @@ typedef struct {
     char *password_hash;  /* SHA256(password + lowercase(email)) base64 encoded */
     int timeout_ms;
 
+    /* Response cache */
+    api_validator validators[API_MAX_VALIDATORS];
+    int validator_count;
+    bool cache_dirty;           /* Validators changed since load/save */
+    bool not_modified;          /* Last data fetch was answered 304 */
+
     /* Last error */
     api_error last_error;
     char last_error_msg[256];
@@ -100,12 +139,27 @@ void api_set_oauth(iracing_api *api, const char *client_id, const char *client_s
 /* Set request timeout in milliseconds */
 void api_set_timeout(iracing_api *api, int timeout_ms);
 
-/* Load saved tokens from file (for session persistence) */
+/*
+ * Load saved OAuth tokens from file (for session persistence). Tokens
+ * renewed later are saved back to the same file.
+ */
 bool api_load_tokens(iracing_api *api, const char *filename);
 
-/* Save tokens to file */
+/* Save OAuth tokens to file */
 bool api_save_tokens(iracing_api *api, const char *filename);
 
+/*
+ * Load response cache validators from file.
+ *
+ * Data fetches then send If-None-Match / If-Modified-Since for tables that
+ * already hold data, and leave a table untouched when the server answers
+ * 304 Not Modified.
+ */
+bool api_load_cache(iracing_api *api, const char *filename);
+
+/* Save response cache validators to file. Does nothing if unchanged. */
+bool api_save_cache(iracing_api *api, const char *filename);
+
 /*
  * Authentication
  */
@@ -113,6 +167,25 @@ bool api_save_tokens(iracing_api *api, const char *filename);
 /* Authenticate with iRacing (blocking) */
 api_error api_authenticate(iracing_api *api);
 
+/*
+ * Authenticate on a background thread, so startup and the UI don't wait
+ * on a token refresh or the browser login. Data requests made meanwhile
+ * queue until the attempt settles rather than failing.
+ *
+ * With OAuth the thread then stays up, renewing the access token
+ * API_TOKEN_REFRESH_MARGIN seconds before it expires, until
+ * api_destroy(). Starting again after a failed attempt retries it; while
+ * one is running this does nothing. Returns false if the thread could
+ * not be started.
+ */
+bool api_auth_start(iracing_api *api);
+
+/*
+ * Wait up to timeout_ms (negative = forever) for a background attempt to
+ * settle. Returns true if it has, or none was started.
+ */
+bool api_auth_wait(iracing_api *api, int timeout_ms);
+
 /* Refresh access token using refresh token */
 api_error api_refresh_token(iracing_api *api);
 
@@ -179,12 +252,75 @@ api_error api_fetch_session_registrations(iracing_api *api, int session_id, int
 /* Fetch all static data (cars, tracks, series) */
 api_error api_fetch_static_data(iracing_api *api, ira_database *db);
 
-/* Fetch all data needed for filtering (static + seasons + owned) */
+/*
+ * Fetch all data needed for filtering (static + seasons + owned).
+ * Catalog endpoints are requested in parallel over shared connections.
+ * A table that fails to download keeps its old contents; the first
+ * error is returned.
+ */
 api_error api_fetch_filter_data(iracing_api *api, ira_database *db);
 
 /* Refresh stale data based on age thresholds */
 api_error api_refresh_stale_data(iracing_api *api, ira_database *db);
 
+/*
+ * Background Sync
+ *
+ * Runs api_fetch_filter_data() on its own thread against a shadow copy of
+ * the database, so the caller stays responsive. The fetched tables are
+ * only swapped into the caller's database by api_sync_finish(), on the
+ * caller's thread, so readers never see a half-updated catalog.
+ */
+
+/* Rate-limited attempts retried before giving up */
+#define API_SYNC_MAX_RETRIES     3
+
+/* Longest wait for a rate limit reset, in seconds */
+#define API_SYNC_MAX_WAIT_SECS   120
+
+typedef struct api_sync_job api_sync_job;
+
+/* Sync progress snapshot */
+typedef struct {
+    const char *stage;          /* Description of the current step */
+    int step;                   /* Current step, 1-based */
+    int total;                  /* Step count */
+    int retries;                /* Rate-limited attempts so far */
+    bool finished;
+} api_sync_progress;
+
+/* Progress callback, called on the sync thread at each step */
+typedef void (*api_sync_progress_fn)(void *user, const api_sync_progress *progress);
+
+/*
+ * Start syncing. api must be authenticated, or authenticating through
+ * api_auth_start(), in which case the job waits for it. api belongs to
+ * the job until api_sync_finish() returns; db is only read here, to build
+ * the shadow. progress may be NULL. Returns NULL on error.
+ */
+api_sync_job *api_sync_start(iracing_api *api, const ira_database *db,
+                             api_sync_progress_fn progress, void *user);
+
+/*
+ * Ask the job to stop. It stops between requests, or during a rate limit
+ * wait; the caller's database is then left untouched.
+ */
+void api_sync_cancel(api_sync_job *job);
+
+/*
+ * Wait up to timeout_ms (negative = forever) for the job to finish.
+ * Returns true once it has. progress, if not NULL, receives the latest
+ * state either way.
+ */
+bool api_sync_wait(api_sync_job *job, int timeout_ms, api_sync_progress *progress);
+
+/*
+ * Wait for the job, swap the fetched tables into db unless it was
+ * cancelled, and free the job. Returns the sync result; the message is
+ * in api_get_last_error().
+ */
+api_error api_sync_finish(api_sync_job *job, ira_database *db);
+
 /*
  * Error Handling
  */
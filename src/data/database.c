@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -13,7 +14,12 @@
 #include <windows.h>
 #endif
 
+#ifndef MAX_PATH
+#define MAX_PATH 260
+#endif
+
 #include "database.h"
+#include "db_snapshot.h"
 #include "../util/json.h"
 
 /* Default data file names */
@@ -33,6 +39,7 @@ static char g_series_path[MAX_PATH];
 static char g_seasons_path[MAX_PATH];
 static char g_owned_path[MAX_PATH];
 static char g_filter_path[MAX_PATH];
+static char g_snapshot_path[MAX_PATH];
 static bool g_paths_initialized = false;
 
 /*
@@ -42,6 +49,7 @@ static void init_paths(void)
 {
     if (g_paths_initialized) return;
 
+#ifdef _WIN32
     char exe_path[MAX_PATH];
     DWORD len = GetModuleFileNameA(NULL, exe_path, MAX_PATH);
 
@@ -56,10 +64,12 @@ static void init_paths(void)
             snprintf(g_seasons_path, MAX_PATH, "%s\\%s", exe_path, SEASONS_FILE);
             snprintf(g_owned_path, MAX_PATH, "%s\\%s", exe_path, OWNED_FILE);
             snprintf(g_filter_path, MAX_PATH, "%s\\%s", exe_path, FILTER_FILE);
+            snprintf(g_snapshot_path, MAX_PATH, "%s\\%s", exe_path, DB_SNAPSHOT_FILE);
             g_paths_initialized = true;
             return;
         }
     }
+#endif
 
     /* Fallback to current directory */
     strncpy(g_tracks_path, TRACKS_FILE, MAX_PATH);
@@ -69,6 +79,7 @@ static void init_paths(void)
     strncpy(g_seasons_path, SEASONS_FILE, MAX_PATH);
     strncpy(g_owned_path, OWNED_FILE, MAX_PATH);
     strncpy(g_filter_path, FILTER_FILE, MAX_PATH);
+    strncpy(g_snapshot_path, DB_SNAPSHOT_FILE, MAX_PATH);
     g_paths_initialized = true;
 }
 
@@ -118,6 +129,23 @@ const char *database_get_filter_path(void)
     return g_filter_path;
 }
 
+const char *database_get_snapshot_path(void)
+{
+    init_paths();
+    return g_snapshot_path;
+}
+
+/* JSON files covered by the snapshot, indexed by db_snapshot_source */
+static void snapshot_sources(const char *sources[DB_SOURCE_COUNT])
+{
+    sources[DB_SOURCE_TRACKS] = g_tracks_path;
+    sources[DB_SOURCE_CARS] = g_cars_path;
+    sources[DB_SOURCE_CAR_CLASSES] = g_car_classes_path;
+    sources[DB_SOURCE_SERIES] = g_series_path;
+    sources[DB_SOURCE_SEASONS] = g_seasons_path;
+    sources[DB_SOURCE_OWNED] = g_owned_path;
+}
+
 /*
  * Lifecycle
  */
@@ -176,17 +204,153 @@ void database_destroy(ira_database *db)
     /* Free filter */
     filter_free(&db->filter);
 
+    /* Free the names the tables pointed at */
+    intern_free(&db->strings);
+
+    /* Free indexes */
+    free(db->track_index.slots);
+    free(db->car_index.slots);
+    free(db->car_class_index.slots);
+    free(db->series_index.slots);
+    free(db->season_index.slots);
+    free(db->owned_cars.words);
+    free(db->owned_tracks.words);
+
     free(db);
 }
 
 /*
- * Helper: safe string copy
+ * Helper: Duplicate an array; NULL/0 stays NULL
  */
-static void safe_strcpy(char *dest, size_t dest_size, const char *src)
+static void *copy_array(const void *src, int count, size_t elem_size, bool *ok)
+{
+    if (!src || count <= 0) return NULL;
+
+    void *copy = malloc((size_t)count * elem_size);
+    if (!copy) {
+        *ok = false;
+        return NULL;
+    }
+    memcpy(copy, src, (size_t)count * elem_size);
+    return copy;
+}
+
+ira_database *database_clone_catalog(const ira_database *db)
+{
+    if (!db) return NULL;
+
+    ira_database *copy = database_create();
+    if (!copy) return NULL;
+
+    bool ok = true;
+
+    copy->tracks = copy_array(db->tracks, db->track_count, sizeof(ira_track), &ok);
+    copy->track_count = copy->tracks ? db->track_count : 0;
+    copy->tracks_updated = db->tracks_updated;
+
+    copy->cars = copy_array(db->cars, db->car_count, sizeof(ira_car), &ok);
+    copy->car_count = copy->cars ? db->car_count : 0;
+    copy->cars_updated = db->cars_updated;
+
+    copy->car_classes = copy_array(db->car_classes, db->car_class_count,
+                                   sizeof(ira_car_class), &ok);
+    copy->car_class_count = copy->car_classes ? db->car_class_count : 0;
+    copy->car_classes_updated = db->car_classes_updated;
+
+    copy->series = copy_array(db->series, db->series_count, sizeof(ira_series), &ok);
+    copy->series_count = copy->series ? db->series_count : 0;
+    copy->series_updated = db->series_updated;
+
+    copy->seasons = copy_array(db->seasons, db->season_count, sizeof(ira_season), &ok);
+    copy->season_count = copy->seasons ? db->season_count : 0;
+    copy->season_year = db->season_year;
+    copy->season_quarter = db->season_quarter;
+    copy->seasons_updated = db->seasons_updated;
+
+    /* Each season owns its schedule */
+    for (int i = 0; i < copy->season_count; i++) {
+        ira_season *season = &copy->seasons[i];
+        season->schedule = copy_array(season->schedule, season->schedule_count,
+                                      sizeof(ira_schedule_week), &ok);
+        if (!season->schedule) season->schedule_count = 0;
+    }
+
+    /* Point the copies at the new pool, which keeps only what is still used */
+    ira_intern *pool = &copy->strings;
+    for (int i = 0; i < copy->track_count; i++) {
+        ira_track *track = &copy->tracks[i];
+        track->track_name = intern_string(pool, track->track_name);
+        track->config_name = intern_string(pool, track->config_name);
+        track->location = intern_string(pool, track->location);
+    }
+    for (int i = 0; i < copy->car_count; i++) {
+        ira_car *car = &copy->cars[i];
+        car->car_name = intern_string(pool, car->car_name);
+        car->car_abbrev = intern_string(pool, car->car_abbrev);
+        car->car_make = intern_string(pool, car->car_make);
+        car->car_model = intern_string(pool, car->car_model);
+    }
+    for (int i = 0; i < copy->car_class_count; i++) {
+        ira_car_class *cc = &copy->car_classes[i];
+        cc->car_class_name = intern_string(pool, cc->car_class_name);
+        cc->short_name = intern_string(pool, cc->short_name);
+        cc->car_ids = intern_ids(pool, cc->car_ids, cc->car_count);
+        if (!cc->car_ids && cc->car_count > 0) ok = false;
+    }
+    for (int i = 0; i < copy->series_count; i++) {
+        ira_series *series = &copy->series[i];
+        series->series_name = intern_string(pool, series->series_name);
+        series->short_name = intern_string(pool, series->short_name);
+    }
+    for (int i = 0; i < copy->season_count; i++) {
+        ira_season *season = &copy->seasons[i];
+        season->season_name = intern_string(pool, season->season_name);
+        season->short_name = intern_string(pool, season->short_name);
+        for (int j = 0; j < season->schedule_count; j++) {
+            ira_schedule_week *week = &season->schedule[j];
+            week->track_name = intern_string(pool, week->track_name);
+            week->config_name = intern_string(pool, week->config_name);
+            week->car_ids = intern_ids(pool, week->car_ids, week->car_count);
+            if (!week->car_ids && week->car_count > 0) ok = false;
+        }
+    }
+
+    copy->owned.cust_id = db->owned.cust_id;
+    copy->owned.last_updated = db->owned.last_updated;
+    copy->owned.owned_car_ids = copy_array(db->owned.owned_car_ids, db->owned.owned_car_count,
+                                           sizeof(int), &ok);
+    copy->owned.owned_car_count = copy->owned.owned_car_ids ? db->owned.owned_car_count : 0;
+    copy->owned.owned_track_ids = copy_array(db->owned.owned_track_ids,
+                                             db->owned.owned_track_count, sizeof(int), &ok);
+    copy->owned.owned_track_count = copy->owned.owned_track_ids ? db->owned.owned_track_count : 0;
+
+    if (!ok) {
+        database_destroy(copy);
+        return NULL;
+    }
+
+    database_rebuild_indexes(copy);
+    return copy;
+}
+
+void database_swap_catalog(ira_database *db, ira_database *other)
 {
-    if (!dest || !src || dest_size == 0) return;
-    strncpy(dest, src, dest_size - 1);
-    dest[dest_size - 1] = '\0';
+    if (!db || !other || db == other) return;
+
+    /* Swap everything, then put the filters back where they were */
+    ira_database tmp = *db;
+    *db = *other;
+    *other = tmp;
+
+    ira_filter filter = db->filter;
+    db->filter = other->filter;
+    other->filter = filter;
+
+    /* Catalog flags are merged, the filter flag stays with its filter */
+    unsigned int catalog = (db->dirty | other->dirty) & DB_DIRTY_CATALOG;
+    unsigned int db_filter = other->dirty & DB_DIRTY_FILTER;
+    other->dirty = catalog | (db->dirty & DB_DIRTY_FILTER);
+    db->dirty = catalog | db_filter;
 }
 
 /*
@@ -212,6 +376,32 @@ static time_t parse_timestamp(const char *str)
     return 0;
 }
 
+/*
+ * Helper: Intern a JSON array of IDs; *count is 0 unless it was stored
+ */
+static const int *load_ids(ira_intern *pool, const json_value *arr, int *count)
+{
+    *count = 0;
+    if (!arr || json_get_type(arr) != JSON_ARRAY) return NULL;
+
+    int n = json_array_length(arr);
+    if (n <= 0) return NULL;
+
+    int stack_ids[64];
+    int *ids = n <= 64 ? stack_ids : malloc((size_t)n * sizeof(int));
+    if (!ids) return NULL;
+
+    for (int i = 0; i < n; i++) {
+        ids[i] = json_get_int(json_array_get(arr, i));
+    }
+
+    const int *pooled = intern_ids(pool, ids, n);
+    if (ids != stack_ids) free(ids);
+
+    if (pooled) *count = n;
+    return pooled;
+}
+
 /*
  * Load tracks from JSON
  */
@@ -219,8 +409,9 @@ bool database_load_tracks(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     json_value *updated = json_object_get(root, "last_updated");
     if (updated && json_get_type(updated) == JSON_STRING) {
@@ -229,20 +420,20 @@ bool database_load_tracks(ira_database *db, const char *filename)
 
     json_value *tracks_arr = json_object_get(root, "tracks");
     if (!tracks_arr || json_get_type(tracks_arr) != JSON_ARRAY) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
 
     int count = json_array_length(tracks_arr);
     if (count == 0) {
-        json_free(root);
+        json_document_free(doc);
         return true;
     }
 
     /* Allocate tracks array */
     db->tracks = calloc(count, sizeof(ira_track));
     if (!db->tracks) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
     db->track_count = count;
@@ -256,11 +447,10 @@ bool database_load_tracks(ira_database *db, const char *filename)
 
         track->track_id = json_get_int(json_object_get(t, "track_id"));
 
-        const char *name = json_get_string(json_object_get(t, "track_name"));
-        if (name) safe_strcpy(track->track_name, sizeof(track->track_name), name);
-
-        const char *config = json_get_string(json_object_get(t, "config_name"));
-        if (config) safe_strcpy(track->config_name, sizeof(track->config_name), config);
+        track->track_name = intern_string(&db->strings,
+                                          json_get_string(json_object_get(t, "track_name")));
+        track->config_name = intern_string(&db->strings,
+                                           json_get_string(json_object_get(t, "config_name")));
 
         track->category = json_get_int(json_object_get(t, "category_id"));
         track->is_oval = json_get_bool(json_object_get(t, "is_oval"));
@@ -276,8 +466,8 @@ bool database_load_tracks(ira_database *db, const char *filename)
         track->package_id = json_get_int(json_object_get(t, "package_id"));
         track->sku = json_get_int(json_object_get(t, "sku"));
 
-        const char *loc = json_get_string(json_object_get(t, "location"));
-        if (loc) safe_strcpy(track->location, sizeof(track->location), loc);
+        track->location = intern_string(&db->strings,
+                                        json_get_string(json_object_get(t, "location")));
 
         track->latitude = (float)json_get_number(json_object_get(t, "latitude"));
         track->longitude = (float)json_get_number(json_object_get(t, "longitude"));
@@ -285,7 +475,8 @@ bool database_load_tracks(ira_database *db, const char *filename)
         track->ai_enabled = json_get_bool(json_object_get(t, "ai_enabled"));
     }
 
-    json_free(root);
+    json_document_free(doc);
+    database_rebuild_indexes(db);
     return true;
 }
 
@@ -296,8 +487,9 @@ bool database_load_cars(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     json_value *updated = json_object_get(root, "last_updated");
     if (updated && json_get_type(updated) == JSON_STRING) {
@@ -306,19 +498,19 @@ bool database_load_cars(ira_database *db, const char *filename)
 
     json_value *cars_arr = json_object_get(root, "cars");
     if (!cars_arr || json_get_type(cars_arr) != JSON_ARRAY) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
 
     int count = json_array_length(cars_arr);
     if (count == 0) {
-        json_free(root);
+        json_document_free(doc);
         return true;
     }
 
     db->cars = calloc(count, sizeof(ira_car));
     if (!db->cars) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
     db->car_count = count;
@@ -331,17 +523,10 @@ bool database_load_cars(ira_database *db, const char *filename)
 
         car->car_id = json_get_int(json_object_get(c, "car_id"));
 
-        const char *name = json_get_string(json_object_get(c, "car_name"));
-        if (name) safe_strcpy(car->car_name, sizeof(car->car_name), name);
-
-        const char *abbrev = json_get_string(json_object_get(c, "car_abbrev"));
-        if (abbrev) safe_strcpy(car->car_abbrev, sizeof(car->car_abbrev), abbrev);
-
-        const char *make = json_get_string(json_object_get(c, "make"));
-        if (make) safe_strcpy(car->car_make, sizeof(car->car_make), make);
-
-        const char *model = json_get_string(json_object_get(c, "model"));
-        if (model) safe_strcpy(car->car_model, sizeof(car->car_model), model);
+        car->car_name = intern_string(&db->strings, json_get_string(json_object_get(c, "car_name")));
+        car->car_abbrev = intern_string(&db->strings, json_get_string(json_object_get(c, "car_abbrev")));
+        car->car_make = intern_string(&db->strings, json_get_string(json_object_get(c, "make")));
+        car->car_model = intern_string(&db->strings, json_get_string(json_object_get(c, "model")));
 
         car->hp = json_get_int(json_object_get(c, "hp"));
         car->weight_kg = json_get_int(json_object_get(c, "weight_kg"));
@@ -370,7 +555,8 @@ bool database_load_cars(ira_database *db, const char *filename)
         }
     }
 
-    json_free(root);
+    json_document_free(doc);
+    database_rebuild_indexes(db);
     return true;
 }
 
@@ -381,8 +567,9 @@ bool database_load_owned(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     db->owned.cust_id = json_get_int(json_object_get(root, "cust_id"));
 
@@ -421,7 +608,8 @@ bool database_load_owned(ira_database *db, const char *filename)
         }
     }
 
-    json_free(root);
+    json_document_free(doc);
+    database_rebuild_indexes(db);
     return true;
 }
 
@@ -432,12 +620,13 @@ bool database_load_filter(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     json_value *filters = json_object_get(root, "filters");
     if (!filters) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
 
@@ -483,7 +672,7 @@ bool database_load_filter(ira_database *db, const char *filename)
         }
     }
 
-    json_free(root);
+    json_document_free(doc);
     return true;
 }
 
@@ -496,13 +685,26 @@ bool database_load_all(ira_database *db)
 
     init_paths();
 
-    /* Load each file - failures are not fatal, just means no cached data */
-    database_load_tracks(db, g_tracks_path);
-    database_load_cars(db, g_cars_path);
-    database_load_series(db, g_series_path);
-    database_load_seasons(db, g_seasons_path);
-    database_load_owned(db, g_owned_path);
-    database_load_filter(db, g_filter_path);
+    const char *sources[DB_SOURCE_COUNT];
+    snapshot_sources(sources);
+
+    /* The snapshot is only used while every JSON file is unchanged */
+    if (!db_snapshot_load(db, g_snapshot_path, sources)) {
+        /* Load each file - failures are not fatal, just means no cached data */
+        database_load_tracks(db, g_tracks_path);
+        database_load_cars(db, g_cars_path);
+        database_load_series(db, g_series_path);
+        database_load_seasons(db, g_seasons_path);
+        database_load_owned(db, g_owned_path);
+
+        db_snapshot_save(db, g_snapshot_path, sources);
+    }
+
+    /* Filter preferences are hand-editable and always come from JSON */
+    if (!database_load_filter(db, g_filter_path)) {
+        /* Write the defaults out on the next save, for editing */
+        database_mark_dirty(db, DB_DIRTY_FILTER);
+    }
 
     return true;
 }
@@ -514,37 +716,41 @@ bool database_save_filter(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    json_value *filters = json_new_object();
+    json_out *out = json_out_open(filename, true);
+    if (!out) return false;
+
+    json_out_begin_object(out);
+    json_out_key(out, "filters");
+    json_out_begin_object(out);
 
-    json_object_set(filters, "owned_content_only", json_new_bool(db->filter.owned_content_only));
-    json_object_set(filters, "fixed_setup_only", json_new_bool(db->filter.fixed_setup_only));
-    json_object_set(filters, "open_setup_only", json_new_bool(db->filter.open_setup_only));
-    json_object_set(filters, "official_only", json_new_bool(db->filter.official_only));
-    json_object_set(filters, "min_race_minutes", json_new_number(db->filter.min_race_mins));
-    json_object_set(filters, "max_race_minutes", json_new_number(db->filter.max_race_mins));
-    json_object_set(filters, "min_license", json_new_string(license_to_string(db->filter.min_license)));
-    json_object_set(filters, "max_license", json_new_string(license_to_string(db->filter.max_license)));
+    json_out_field_bool(out, "owned_content_only", db->filter.owned_content_only);
+    json_out_field_bool(out, "fixed_setup_only", db->filter.fixed_setup_only);
+    json_out_field_bool(out, "open_setup_only", db->filter.open_setup_only);
+    json_out_field_bool(out, "official_only", db->filter.official_only);
+    json_out_field_number(out, "min_race_minutes", db->filter.min_race_mins);
+    json_out_field_number(out, "max_race_minutes", db->filter.max_race_mins);
+    json_out_field_string(out, "min_license", license_to_string(db->filter.min_license));
+    json_out_field_string(out, "max_license", license_to_string(db->filter.max_license));
 
     /* Categories */
-    json_value *cats = json_new_array();
+    json_out_key(out, "categories");
+    json_out_begin_array(out);
     for (int i = 0; i < db->filter.category_count; i++) {
-        json_array_push(cats, json_new_string(category_to_string(db->filter.categories[i])));
+        json_out_string(out, category_to_string(db->filter.categories[i]));
     }
-    json_object_set(filters, "categories", cats);
+    json_out_end_array(out);
 
     /* Excluded series */
-    json_value *excl = json_new_array();
+    json_out_key(out, "exclude_series");
+    json_out_begin_array(out);
     for (int i = 0; i < db->filter.excluded_series_count; i++) {
-        json_array_push(excl, json_new_number(db->filter.excluded_series[i]));
+        json_out_number(out, db->filter.excluded_series[i]);
     }
-    json_object_set(filters, "exclude_series", excl);
+    json_out_end_array(out);
 
-    json_object_set(root, "filters", filters);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_object(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -556,10 +762,192 @@ bool database_save_all(ira_database *db)
 
     init_paths();
 
-    /* Save filter settings */
-    database_save_filter(db, g_filter_path);
+    static const struct {
+        database_dirty table;
+        bool (*save)(ira_database *db, const char *filename);
+        const char *path;
+    } files[] = {
+        { DB_DIRTY_TRACKS,      database_save_tracks,      g_tracks_path },
+        { DB_DIRTY_CARS,        database_save_cars,        g_cars_path },
+        { DB_DIRTY_CAR_CLASSES, database_save_car_classes, g_car_classes_path },
+        { DB_DIRTY_SERIES,      database_save_series,      g_series_path },
+        { DB_DIRTY_SEASONS,     database_save_seasons,     g_seasons_path },
+        { DB_DIRTY_OWNED,       database_save_owned,       g_owned_path },
+        { DB_DIRTY_FILTER,      database_save_filter,      g_filter_path },
+    };
+
+    /* Only tables that changed; the rest keep their files */
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        if (!(db->dirty & files[i].table)) continue;
+        if (files[i].save(db, files[i].path)) {
+            db->dirty &= ~(unsigned int)files[i].table;
+        } else {
+            ok = false;
+        }
+    }
 
-    return true;
+    /* Rewritten files are newer than the snapshot, so it is refreshed too */
+    const char *sources[DB_SOURCE_COUNT];
+    snapshot_sources(sources);
+    if (!db_snapshot_current(db, g_snapshot_path, sources)) {
+        db_snapshot_save(db, g_snapshot_path, sources);
+    }
+
+    return ok;
+}
+
+void database_mark_dirty(ira_database *db, unsigned int tables)
+{
+    if (!db) return;
+    db->dirty |= tables;
+}
+
+/*
+ * Indexes
+ */
+
+/* IDs above this are not indexed; lookups for them scan instead */
+#define MAX_INDEXED_ID (1 << 20)
+
+/*
+ * Build an index over an array of structs, reading each ID at id_offset.
+ * Leaves the index empty (scan fallback) if an ID is out of range.
+ */
+static void build_index(ira_id_index *index, const void *base, int count,
+                        size_t stride, size_t id_offset)
+{
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+
+    if (!base || count <= 0) return;
+
+    int max_id = -1;
+    for (int i = 0; i < count; i++) {
+        int id = *(const int *)((const char *)base + i * stride + id_offset);
+        if (id < 0 || id > MAX_INDEXED_ID) return;
+        if (id > max_id) max_id = id;
+    }
+
+    index->slots = malloc((size_t)(max_id + 1) * sizeof(int));
+    if (!index->slots) return;
+
+    memset(index->slots, 0xFF, (size_t)(max_id + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        int id = *(const int *)((const char *)base + i * stride + id_offset);
+        /* First entry wins, matching the linear scan */
+        if (index->slots[id] < 0) {
+            index->slots[id] = i;
+        }
+    }
+
+    index->max_id = max_id;
+    index->base = base;
+    index->count = count;
+}
+
+/*
+ * Look up an ID. Returns the array position, -1 if absent, or -2 if the
+ * index does not cover this array and the caller must scan.
+ */
+static int index_find(const ira_id_index *index, const void *base, int count, int id)
+{
+    if (!index->slots || index->base != base || index->count != count) {
+        return -2;
+    }
+    if (id < 0 || id > index->max_id) {
+        return -1;
+    }
+    return index->slots[id];
+}
+
+static void bitset_set(ira_id_bitset *set, int id)
+{
+    if (id >= 0 && id <= set->max_id) {
+        set->words[id >> 5] |= 1u << (id & 31);
+    }
+}
+
+/*
+ * Build an ownership bitset from an owned ID list plus the catalog's
+ * free_with_subscription flags.
+ */
+static void build_owned_bitset(ira_id_bitset *set, const int *owned, int owned_count,
+                               const void *catalog, int catalog_count,
+                               size_t stride, size_t id_offset, size_t free_offset)
+{
+    free(set->words);
+    memset(set, 0, sizeof(*set));
+
+    int max_id = -1;
+    for (int i = 0; i < owned_count; i++) {
+        if (owned[i] < 0 || owned[i] > MAX_INDEXED_ID) return;
+        if (owned[i] > max_id) max_id = owned[i];
+    }
+    for (int i = 0; i < catalog_count; i++) {
+        int id = *(const int *)((const char *)catalog + i * stride + id_offset);
+        if (id < 0 || id > MAX_INDEXED_ID) return;
+        if (id > max_id) max_id = id;
+    }
+
+    size_t words = (size_t)(max_id + 1 + 31) / 32;
+    set->words = calloc(words ? words : 1, sizeof(unsigned int));
+    if (!set->words) return;
+    set->max_id = max_id;
+
+    for (int i = 0; i < owned_count; i++) {
+        bitset_set(set, owned[i]);
+    }
+    for (int i = 0; i < catalog_count; i++) {
+        const char *item = (const char *)catalog + i * stride;
+        if (*(const bool *)(item + free_offset)) {
+            bitset_set(set, *(const int *)(item + id_offset));
+        }
+    }
+
+    set->base = owned;
+    set->count = owned_count;
+    set->catalog = catalog;
+    set->catalog_count = catalog_count;
+}
+
+/*
+ * Test an ownership bitset. Returns 1/0, or -1 if the set is stale.
+ */
+static int bitset_test(const ira_id_bitset *set, const int *owned, int owned_count,
+                       const void *catalog, int catalog_count, int id)
+{
+    if (!set->words || set->base != owned || set->count != owned_count ||
+        set->catalog != catalog || set->catalog_count != catalog_count) {
+        return -1;
+    }
+    if (id < 0 || id > set->max_id) {
+        return 0;
+    }
+    return (set->words[id >> 5] >> (id & 31)) & 1u;
+}
+
+void database_rebuild_indexes(ira_database *db)
+{
+    if (!db) return;
+
+    build_index(&db->track_index, db->tracks, db->track_count,
+                sizeof(ira_track), offsetof(ira_track, track_id));
+    build_index(&db->car_index, db->cars, db->car_count,
+                sizeof(ira_car), offsetof(ira_car, car_id));
+    build_index(&db->car_class_index, db->car_classes, db->car_class_count,
+                sizeof(ira_car_class), offsetof(ira_car_class, car_class_id));
+    build_index(&db->series_index, db->series, db->series_count,
+                sizeof(ira_series), offsetof(ira_series, series_id));
+    build_index(&db->season_index, db->seasons, db->season_count,
+                sizeof(ira_season), offsetof(ira_season, season_id));
+
+    build_owned_bitset(&db->owned_cars, db->owned.owned_car_ids, db->owned.owned_car_count,
+                       db->cars, db->car_count, sizeof(ira_car),
+                       offsetof(ira_car, car_id), offsetof(ira_car, free_with_subscription));
+    build_owned_bitset(&db->owned_tracks, db->owned.owned_track_ids, db->owned.owned_track_count,
+                       db->tracks, db->track_count, sizeof(ira_track),
+                       offsetof(ira_track, track_id), offsetof(ira_track, free_with_subscription));
 }
 
 /*
@@ -570,6 +958,10 @@ ira_track *database_get_track(ira_database *db, int track_id)
 {
     if (!db || !db->tracks) return NULL;
 
+    int pos = index_find(&db->track_index, db->tracks, db->track_count, track_id);
+    if (pos >= 0) return &db->tracks[pos];
+    if (pos == -1) return NULL;
+
     for (int i = 0; i < db->track_count; i++) {
         if (db->tracks[i].track_id == track_id) {
             return &db->tracks[i];
@@ -582,6 +974,10 @@ ira_car *database_get_car(ira_database *db, int car_id)
 {
     if (!db || !db->cars) return NULL;
 
+    int pos = index_find(&db->car_index, db->cars, db->car_count, car_id);
+    if (pos >= 0) return &db->cars[pos];
+    if (pos == -1) return NULL;
+
     for (int i = 0; i < db->car_count; i++) {
         if (db->cars[i].car_id == car_id) {
             return &db->cars[i];
@@ -594,6 +990,10 @@ ira_car_class *database_get_car_class(ira_database *db, int car_class_id)
 {
     if (!db || !db->car_classes) return NULL;
 
+    int pos = index_find(&db->car_class_index, db->car_classes, db->car_class_count, car_class_id);
+    if (pos >= 0) return &db->car_classes[pos];
+    if (pos == -1) return NULL;
+
     for (int i = 0; i < db->car_class_count; i++) {
         if (db->car_classes[i].car_class_id == car_class_id) {
             return &db->car_classes[i];
@@ -606,6 +1006,10 @@ ira_series *database_get_series(ira_database *db, int series_id)
 {
     if (!db || !db->series) return NULL;
 
+    int pos = index_find(&db->series_index, db->series, db->series_count, series_id);
+    if (pos >= 0) return &db->series[pos];
+    if (pos == -1) return NULL;
+
     for (int i = 0; i < db->series_count; i++) {
         if (db->series[i].series_id == series_id) {
             return &db->series[i];
@@ -618,6 +1022,10 @@ ira_season *database_get_season(ira_database *db, int season_id)
 {
     if (!db || !db->seasons) return NULL;
 
+    int pos = index_find(&db->season_index, db->seasons, db->season_count, season_id);
+    if (pos >= 0) return &db->seasons[pos];
+    if (pos == -1) return NULL;
+
     for (int i = 0; i < db->season_count; i++) {
         if (db->seasons[i].season_id == season_id) {
             return &db->seasons[i];
@@ -634,6 +1042,10 @@ bool database_owns_car(ira_database *db, int car_id)
 {
     if (!db) return false;
 
+    int owned = bitset_test(&db->owned_cars, db->owned.owned_car_ids, db->owned.owned_car_count,
+                            db->cars, db->car_count, car_id);
+    if (owned >= 0) return owned == 1;
+
     /* Check if free with subscription */
     ira_car *car = database_get_car(db, car_id);
     if (car && car->free_with_subscription) return true;
@@ -649,6 +1061,10 @@ bool database_owns_track(ira_database *db, int track_id)
 {
     if (!db) return false;
 
+    int owned = bitset_test(&db->owned_tracks, db->owned.owned_track_ids, db->owned.owned_track_count,
+                            db->tracks, db->track_count, track_id);
+    if (owned >= 0) return owned == 1;
+
     /* Check if free with subscription */
     ira_track *track = database_get_track(db, track_id);
     if (track && track->free_with_subscription) return true;
@@ -701,24 +1117,25 @@ bool database_load_series(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     json_value *series_arr = json_object_get(root, "series");
     if (!series_arr || json_get_type(series_arr) != JSON_ARRAY) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
 
     int count = json_array_length(series_arr);
     if (count == 0) {
-        json_free(root);
+        json_document_free(doc);
         return true;
     }
 
     db->series = calloc(count, sizeof(ira_series));
     if (!db->series) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
     db->series_count = count;
@@ -731,11 +1148,10 @@ bool database_load_series(ira_database *db, const char *filename)
 
         series->series_id = json_get_int(json_object_get(s, "series_id"));
 
-        const char *name = json_get_string(json_object_get(s, "series_name"));
-        if (name) safe_strcpy(series->series_name, sizeof(series->series_name), name);
-
-        const char *short_name = json_get_string(json_object_get(s, "short_name"));
-        if (short_name) safe_strcpy(series->short_name, sizeof(series->short_name), short_name);
+        series->series_name = intern_string(&db->strings,
+                                            json_get_string(json_object_get(s, "series_name")));
+        series->short_name = intern_string(&db->strings,
+                                           json_get_string(json_object_get(s, "short_name")));
 
         series->category = json_get_int(json_object_get(s, "category_id"));
         series->min_license = json_get_int(json_object_get(s, "min_license"));
@@ -743,7 +1159,8 @@ bool database_load_series(ira_database *db, const char *filename)
         series->max_starters = json_get_int(json_object_get(s, "max_starters"));
     }
 
-    json_free(root);
+    json_document_free(doc);
+    database_rebuild_indexes(db);
     return true;
 }
 
@@ -754,8 +1171,9 @@ bool database_load_seasons(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_parse_file(filename);
-    if (!root) return false;
+    json_document *doc = json_document_parse_file(filename);
+    if (!doc) return false;
+    json_value *root = json_document_root(doc);
 
     json_value *updated = json_object_get(root, "last_updated");
     if (updated && json_get_type(updated) == JSON_STRING) {
@@ -767,19 +1185,19 @@ bool database_load_seasons(ira_database *db, const char *filename)
 
     json_value *seasons_arr = json_object_get(root, "seasons");
     if (!seasons_arr || json_get_type(seasons_arr) != JSON_ARRAY) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
 
     int count = json_array_length(seasons_arr);
     if (count == 0) {
-        json_free(root);
+        json_document_free(doc);
         return true;
     }
 
     db->seasons = calloc(count, sizeof(ira_season));
     if (!db->seasons) {
-        json_free(root);
+        json_document_free(doc);
         return false;
     }
     db->season_count = count;
@@ -793,11 +1211,10 @@ bool database_load_seasons(ira_database *db, const char *filename)
         season->season_id = json_get_int(json_object_get(s, "season_id"));
         season->series_id = json_get_int(json_object_get(s, "series_id"));
 
-        const char *name = json_get_string(json_object_get(s, "season_name"));
-        if (name) safe_strcpy(season->season_name, sizeof(season->season_name), name);
-
-        const char *short_name = json_get_string(json_object_get(s, "short_name"));
-        if (short_name) safe_strcpy(season->short_name, sizeof(season->short_name), short_name);
+        season->season_name = intern_string(&db->strings,
+                                            json_get_string(json_object_get(s, "season_name")));
+        season->short_name = intern_string(&db->strings,
+                                           json_get_string(json_object_get(s, "short_name")));
 
         season->season_year = json_get_int(json_object_get(s, "season_year"));
         season->season_quarter = json_get_int(json_object_get(s, "season_quarter"));
@@ -829,11 +1246,10 @@ bool database_load_seasons(ira_database *db, const char *filename)
                         week->race_week_num = json_get_int(json_object_get(w, "week"));
                         week->track_id = json_get_int(json_object_get(w, "track_id"));
 
-                        const char *track_name = json_get_string(json_object_get(w, "track_name"));
-                        if (track_name) safe_strcpy(week->track_name, sizeof(week->track_name), track_name);
-
-                        const char *config = json_get_string(json_object_get(w, "config_name"));
-                        if (config) safe_strcpy(week->config_name, sizeof(week->config_name), config);
+                        week->track_name = intern_string(&db->strings,
+                                                         json_get_string(json_object_get(w, "track_name")));
+                        week->config_name = intern_string(&db->strings,
+                                                          json_get_string(json_object_get(w, "config_name")));
 
                         week->race_time_limit_mins = json_get_int(json_object_get(w, "race_time_limit_mins"));
                         week->race_lap_limit = json_get_int(json_object_get(w, "race_lap_limit"));
@@ -842,13 +1258,24 @@ bool database_load_seasons(ira_database *db, const char *filename)
                         week->warmup_mins = json_get_int(json_object_get(w, "warmup_mins"));
 
                         /* Parse car_ids array */
-                        json_value *cars = json_object_get(w, "car_ids");
-                        if (cars && json_get_type(cars) == JSON_ARRAY) {
-                            int car_count = json_array_length(cars);
-                            if (car_count > 16) car_count = 16;
-                            week->car_count = car_count;
-                            for (int k = 0; k < car_count; k++) {
-                                week->car_ids[k] = json_get_int(json_array_get(cars, k));
+                        week->car_ids = load_ids(&db->strings, json_object_get(w, "car_ids"),
+                                                 &week->car_count);
+
+                        /* Race start times (UTC seconds) */
+                        week->start_date = (time_t)json_get_number(json_object_get(w, "start_date"));
+                        week->end_date = (time_t)json_get_number(json_object_get(w, "end_date"));
+                        week->repeating = json_get_bool(json_object_get(w, "repeating"));
+                        week->first_session_mins = json_get_int(json_object_get(w, "first_session_mins"));
+                        week->repeat_minutes = json_get_int(json_object_get(w, "repeat_minutes"));
+                        week->day_mask = (unsigned char)json_get_int(json_object_get(w, "day_mask"));
+
+                        json_value *times = json_object_get(w, "session_times");
+                        if (times && json_get_type(times) == JSON_ARRAY) {
+                            int time_count = json_array_length(times);
+                            if (time_count > IRA_MAX_SESSION_TIMES) time_count = IRA_MAX_SESSION_TIMES;
+                            week->session_time_count = time_count;
+                            for (int k = 0; k < time_count; k++) {
+                                week->session_times[k] = (time_t)json_get_number(json_array_get(times, k));
                             }
                         }
                     }
@@ -857,7 +1284,8 @@ bool database_load_seasons(ira_database *db, const char *filename)
         }
     }
 
-    json_free(root);
+    json_document_free(doc);
+    database_rebuild_indexes(db);
     return true;
 }
 /*
@@ -878,6 +1306,22 @@ static void format_timestamp(time_t t, char *buf, size_t buf_size)
     }
 }
 
+/*
+ * Helper: Start a table file, {"last_updated": ..., then the caller's fields
+ */
+static json_out *open_table(const char *filename, time_t updated)
+{
+    json_out *out = json_out_open(filename, true);
+    if (!out) return NULL;
+
+    char timestamp[32];
+    format_timestamp(updated, timestamp, sizeof(timestamp));
+
+    json_out_begin_object(out);
+    json_out_field_string(out, "last_updated", timestamp);
+    return out;
+}
+
 /*
  * Save tracks to JSON
  */
@@ -885,56 +1329,43 @@ bool database_save_tracks(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
+    json_out *out = open_table(filename, db->tracks_updated);
+    if (!out) return false;
 
-    /* Add last_updated timestamp */
-    char timestamp[32];
-    format_timestamp(db->tracks_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
-
-    /* Create tracks array */
-    json_value *tracks_arr = json_new_array();
-    if (!tracks_arr) {
-        json_free(root);
-        return false;
-    }
+    json_out_key(out, "tracks");
+    json_out_begin_array(out);
 
     for (int i = 0; i < db->track_count; i++) {
         ira_track *track = &db->tracks[i];
-        json_value *t = json_new_object();
-        if (!t) continue;
 
-        json_object_set(t, "track_id", json_new_number(track->track_id));
-        json_object_set(t, "track_name", json_new_string(track->track_name));
-        json_object_set(t, "config_name", json_new_string(track->config_name));
-        json_object_set(t, "category_id", json_new_number(track->category));
-        json_object_set(t, "is_oval", json_new_bool(track->is_oval));
-        json_object_set(t, "is_dirt", json_new_bool(track->is_dirt));
-        json_object_set(t, "length_km", json_new_number(track->length_km));
-        json_object_set(t, "corners", json_new_number(track->corners));
-        json_object_set(t, "max_cars", json_new_number(track->max_cars));
-        json_object_set(t, "grid_stalls", json_new_number(track->grid_stalls));
-        json_object_set(t, "pit_speed_kph", json_new_number(track->pit_speed_kph));
-        json_object_set(t, "price", json_new_number(track->price));
-        json_object_set(t, "free", json_new_bool(track->free_with_subscription));
-        json_object_set(t, "retired", json_new_bool(track->retired));
-        json_object_set(t, "package_id", json_new_number(track->package_id));
-        json_object_set(t, "sku", json_new_number(track->sku));
-        json_object_set(t, "location", json_new_string(track->location));
-        json_object_set(t, "latitude", json_new_number(track->latitude));
-        json_object_set(t, "longitude", json_new_number(track->longitude));
-        json_object_set(t, "night_lighting", json_new_bool(track->night_lighting));
-        json_object_set(t, "ai_enabled", json_new_bool(track->ai_enabled));
-
-        json_array_push(tracks_arr, t);
-    }
-
-    json_object_set(root, "tracks", tracks_arr);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+        json_out_begin_object(out);
+        json_out_field_number(out, "track_id", track->track_id);
+        json_out_field_string(out, "track_name", track->track_name);
+        json_out_field_string(out, "config_name", track->config_name);
+        json_out_field_number(out, "category_id", track->category);
+        json_out_field_bool(out, "is_oval", track->is_oval);
+        json_out_field_bool(out, "is_dirt", track->is_dirt);
+        json_out_field_number(out, "length_km", track->length_km);
+        json_out_field_number(out, "corners", track->corners);
+        json_out_field_number(out, "max_cars", track->max_cars);
+        json_out_field_number(out, "grid_stalls", track->grid_stalls);
+        json_out_field_number(out, "pit_speed_kph", track->pit_speed_kph);
+        json_out_field_number(out, "price", track->price);
+        json_out_field_bool(out, "free", track->free_with_subscription);
+        json_out_field_bool(out, "retired", track->retired);
+        json_out_field_number(out, "package_id", track->package_id);
+        json_out_field_number(out, "sku", track->sku);
+        json_out_field_string(out, "location", track->location);
+        json_out_field_number(out, "latitude", track->latitude);
+        json_out_field_number(out, "longitude", track->longitude);
+        json_out_field_bool(out, "night_lighting", track->night_lighting);
+        json_out_field_bool(out, "ai_enabled", track->ai_enabled);
+        json_out_end_object(out);
+    }
+
+    json_out_end_array(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -944,54 +1375,45 @@ bool database_save_cars(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
+    json_out *out = open_table(filename, db->cars_updated);
+    if (!out) return false;
 
-    char timestamp[32];
-    format_timestamp(db->cars_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
-
-    json_value *cars_arr = json_new_array();
-    if (!cars_arr) {
-        json_free(root);
-        return false;
-    }
+    json_out_key(out, "cars");
+    json_out_begin_array(out);
 
     for (int i = 0; i < db->car_count; i++) {
         ira_car *car = &db->cars[i];
-        json_value *c = json_new_object();
-        if (!c) continue;
 
-        json_object_set(c, "car_id", json_new_number(car->car_id));
-        json_object_set(c, "car_name", json_new_string(car->car_name));
-        json_object_set(c, "car_abbrev", json_new_string(car->car_abbrev));
-        json_object_set(c, "make", json_new_string(car->car_make));
-        json_object_set(c, "model", json_new_string(car->car_model));
-        json_object_set(c, "hp", json_new_number(car->hp));
-        json_object_set(c, "weight_kg", json_new_number(car->weight_kg));
-        json_object_set(c, "price", json_new_number(car->price));
-        json_object_set(c, "free", json_new_bool(car->free_with_subscription));
-        json_object_set(c, "retired", json_new_bool(car->retired));
-        json_object_set(c, "rain_enabled", json_new_bool(car->rain_enabled));
-        json_object_set(c, "ai_enabled", json_new_bool(car->ai_enabled));
-        json_object_set(c, "package_id", json_new_number(car->package_id));
-        json_object_set(c, "sku", json_new_number(car->sku));
+        json_out_begin_object(out);
+        json_out_field_number(out, "car_id", car->car_id);
+        json_out_field_string(out, "car_name", car->car_name);
+        json_out_field_string(out, "car_abbrev", car->car_abbrev);
+        json_out_field_string(out, "make", car->car_make);
+        json_out_field_string(out, "model", car->car_model);
+        json_out_field_number(out, "hp", car->hp);
+        json_out_field_number(out, "weight_kg", car->weight_kg);
+        json_out_field_number(out, "price", car->price);
+        json_out_field_bool(out, "free", car->free_with_subscription);
+        json_out_field_bool(out, "retired", car->retired);
+        json_out_field_bool(out, "rain_enabled", car->rain_enabled);
+        json_out_field_bool(out, "ai_enabled", car->ai_enabled);
+        json_out_field_number(out, "package_id", car->package_id);
+        json_out_field_number(out, "sku", car->sku);
 
         /* Categories array */
-        json_value *cats = json_new_array();
+        json_out_key(out, "categories");
+        json_out_begin_array(out);
         for (int j = 0; j < car->category_count; j++) {
-            json_array_push(cats, json_new_string(category_to_string(car->categories[j])));
+            json_out_string(out, category_to_string(car->categories[j]));
         }
-        json_object_set(c, "categories", cats);
+        json_out_end_array(out);
 
-        json_array_push(cars_arr, c);
+        json_out_end_object(out);
     }
 
-    json_object_set(root, "cars", cars_arr);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_array(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -1001,42 +1423,33 @@ bool database_save_car_classes(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
+    json_out *out = open_table(filename, db->car_classes_updated);
+    if (!out) return false;
 
-    char timestamp[32];
-    format_timestamp(db->car_classes_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
-
-    json_value *classes_arr = json_new_array();
-    if (!classes_arr) {
-        json_free(root);
-        return false;
-    }
+    json_out_key(out, "car_classes");
+    json_out_begin_array(out);
 
     for (int i = 0; i < db->car_class_count; i++) {
         ira_car_class *cc = &db->car_classes[i];
-        json_value *c = json_new_object();
-        if (!c) continue;
 
-        json_object_set(c, "car_class_id", json_new_number(cc->car_class_id));
-        json_object_set(c, "car_class_name", json_new_string(cc->car_class_name));
-        json_object_set(c, "short_name", json_new_string(cc->short_name));
+        json_out_begin_object(out);
+        json_out_field_number(out, "car_class_id", cc->car_class_id);
+        json_out_field_string(out, "car_class_name", cc->car_class_name);
+        json_out_field_string(out, "short_name", cc->short_name);
 
-        json_value *cars = json_new_array();
+        json_out_key(out, "car_ids");
+        json_out_begin_array(out);
         for (int j = 0; j < cc->car_count; j++) {
-            json_array_push(cars, json_new_number(cc->car_ids[j]));
+            json_out_number(out, cc->car_ids[j]);
         }
-        json_object_set(c, "car_ids", cars);
+        json_out_end_array(out);
 
-        json_array_push(classes_arr, c);
+        json_out_end_object(out);
     }
 
-    json_object_set(root, "car_classes", classes_arr);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_array(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -1046,40 +1459,29 @@ bool database_save_series(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
+    json_out *out = open_table(filename, db->series_updated);
+    if (!out) return false;
 
-    char timestamp[32];
-    format_timestamp(db->series_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
-
-    json_value *series_arr = json_new_array();
-    if (!series_arr) {
-        json_free(root);
-        return false;
-    }
+    json_out_key(out, "series");
+    json_out_begin_array(out);
 
     for (int i = 0; i < db->series_count; i++) {
         ira_series *series = &db->series[i];
-        json_value *s = json_new_object();
-        if (!s) continue;
-
-        json_object_set(s, "series_id", json_new_number(series->series_id));
-        json_object_set(s, "series_name", json_new_string(series->series_name));
-        json_object_set(s, "short_name", json_new_string(series->short_name));
-        json_object_set(s, "category_id", json_new_number(series->category));
-        json_object_set(s, "min_license", json_new_number(series->min_license));
-        json_object_set(s, "min_starters", json_new_number(series->min_starters));
-        json_object_set(s, "max_starters", json_new_number(series->max_starters));
 
-        json_array_push(series_arr, s);
+        json_out_begin_object(out);
+        json_out_field_number(out, "series_id", series->series_id);
+        json_out_field_string(out, "series_name", series->series_name);
+        json_out_field_string(out, "short_name", series->short_name);
+        json_out_field_number(out, "category_id", series->category);
+        json_out_field_number(out, "min_license", series->min_license);
+        json_out_field_number(out, "min_starters", series->min_starters);
+        json_out_field_number(out, "max_starters", series->max_starters);
+        json_out_end_object(out);
     }
 
-    json_object_set(root, "series", series_arr);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_array(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -1089,77 +1491,83 @@ bool database_save_seasons(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
+    json_out *out = open_table(filename, db->seasons_updated);
+    if (!out) return false;
 
-    char timestamp[32];
-    format_timestamp(db->seasons_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
-    json_object_set(root, "year", json_new_number(db->season_year));
-    json_object_set(root, "quarter", json_new_number(db->season_quarter));
-
-    json_value *seasons_arr = json_new_array();
-    if (!seasons_arr) {
-        json_free(root);
-        return false;
-    }
+    json_out_field_number(out, "year", db->season_year);
+    json_out_field_number(out, "quarter", db->season_quarter);
+
+    json_out_key(out, "seasons");
+    json_out_begin_array(out);
 
     for (int i = 0; i < db->season_count; i++) {
         ira_season *season = &db->seasons[i];
-        json_value *s = json_new_object();
-        if (!s) continue;
 
-        json_object_set(s, "season_id", json_new_number(season->season_id));
-        json_object_set(s, "series_id", json_new_number(season->series_id));
-        json_object_set(s, "season_name", json_new_string(season->season_name));
-        json_object_set(s, "short_name", json_new_string(season->short_name));
-        json_object_set(s, "season_year", json_new_number(season->season_year));
-        json_object_set(s, "season_quarter", json_new_number(season->season_quarter));
-        json_object_set(s, "fixed_setup", json_new_bool(season->fixed_setup));
-        json_object_set(s, "official", json_new_bool(season->official));
-        json_object_set(s, "active", json_new_bool(season->active));
-        json_object_set(s, "complete", json_new_bool(season->complete));
-        json_object_set(s, "license_group", json_new_number(season->license_group));
-        json_object_set(s, "max_weeks", json_new_number(season->max_weeks));
-        json_object_set(s, "current_week", json_new_number(season->current_week));
-        json_object_set(s, "multiclass", json_new_bool(season->multiclass));
-        json_object_set(s, "has_supersessions", json_new_bool(season->has_supersessions));
+        json_out_begin_object(out);
+        json_out_field_number(out, "season_id", season->season_id);
+        json_out_field_number(out, "series_id", season->series_id);
+        json_out_field_string(out, "season_name", season->season_name);
+        json_out_field_string(out, "short_name", season->short_name);
+        json_out_field_number(out, "season_year", season->season_year);
+        json_out_field_number(out, "season_quarter", season->season_quarter);
+        json_out_field_bool(out, "fixed_setup", season->fixed_setup);
+        json_out_field_bool(out, "official", season->official);
+        json_out_field_bool(out, "active", season->active);
+        json_out_field_bool(out, "complete", season->complete);
+        json_out_field_number(out, "license_group", season->license_group);
+        json_out_field_number(out, "max_weeks", season->max_weeks);
+        json_out_field_number(out, "current_week", season->current_week);
+        json_out_field_bool(out, "multiclass", season->multiclass);
+        json_out_field_bool(out, "has_supersessions", season->has_supersessions);
 
         /* Schedule array */
-        json_value *sched_arr = json_new_array();
+        json_out_key(out, "schedule");
+        json_out_begin_array(out);
         for (int j = 0; j < season->schedule_count; j++) {
             ira_schedule_week *week = &season->schedule[j];
-            json_value *w = json_new_object();
-            if (!w) continue;
-
-            json_object_set(w, "week", json_new_number(week->race_week_num));
-            json_object_set(w, "track_id", json_new_number(week->track_id));
-            json_object_set(w, "track_name", json_new_string(week->track_name));
-            json_object_set(w, "config_name", json_new_string(week->config_name));
-            json_object_set(w, "race_time_limit_mins", json_new_number(week->race_time_limit_mins));
-            json_object_set(w, "race_lap_limit", json_new_number(week->race_lap_limit));
-            json_object_set(w, "practice_mins", json_new_number(week->practice_mins));
-            json_object_set(w, "qualify_mins", json_new_number(week->qualify_mins));
-            json_object_set(w, "warmup_mins", json_new_number(week->warmup_mins));
-
-            json_value *cars = json_new_array();
+
+            json_out_begin_object(out);
+            json_out_field_number(out, "week", week->race_week_num);
+            json_out_field_number(out, "track_id", week->track_id);
+            json_out_field_string(out, "track_name", week->track_name);
+            json_out_field_string(out, "config_name", week->config_name);
+            json_out_field_number(out, "race_time_limit_mins", week->race_time_limit_mins);
+            json_out_field_number(out, "race_lap_limit", week->race_lap_limit);
+            json_out_field_number(out, "practice_mins", week->practice_mins);
+            json_out_field_number(out, "qualify_mins", week->qualify_mins);
+            json_out_field_number(out, "warmup_mins", week->warmup_mins);
+
+            json_out_key(out, "car_ids");
+            json_out_begin_array(out);
             for (int k = 0; k < week->car_count; k++) {
-                json_array_push(cars, json_new_number(week->car_ids[k]));
+                json_out_number(out, week->car_ids[k]);
+            }
+            json_out_end_array(out);
+
+            json_out_field_number(out, "start_date", (double)week->start_date);
+            json_out_field_number(out, "end_date", (double)week->end_date);
+            json_out_field_bool(out, "repeating", week->repeating);
+            json_out_field_number(out, "first_session_mins", week->first_session_mins);
+            json_out_field_number(out, "repeat_minutes", week->repeat_minutes);
+            json_out_field_number(out, "day_mask", week->day_mask);
+
+            json_out_key(out, "session_times");
+            json_out_begin_array(out);
+            for (int k = 0; k < week->session_time_count; k++) {
+                json_out_number(out, (double)week->session_times[k]);
             }
-            json_object_set(w, "car_ids", cars);
+            json_out_end_array(out);
 
-            json_array_push(sched_arr, w);
+            json_out_end_object(out);
         }
-        json_object_set(s, "schedule", sched_arr);
+        json_out_end_array(out);
 
-        json_array_push(seasons_arr, s);
+        json_out_end_object(out);
     }
 
-    json_object_set(root, "seasons", seasons_arr);
-
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_array(out);
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -1169,32 +1577,34 @@ bool database_save_owned(ira_database *db, const char *filename)
 {
     if (!db || !filename) return false;
 
-    json_value *root = json_new_object();
-    if (!root) return false;
-
-    json_object_set(root, "cust_id", json_new_number(db->owned.cust_id));
+    json_out *out = json_out_open(filename, true);
+    if (!out) return false;
 
     char timestamp[32];
     format_timestamp(db->owned.last_updated, timestamp, sizeof(timestamp));
-    json_object_set(root, "last_updated", json_new_string(timestamp));
+
+    json_out_begin_object(out);
+    json_out_field_number(out, "cust_id", db->owned.cust_id);
+    json_out_field_string(out, "last_updated", timestamp);
 
     /* Owned cars */
-    json_value *cars = json_new_array();
+    json_out_key(out, "owned_cars");
+    json_out_begin_array(out);
     for (int i = 0; i < db->owned.owned_car_count; i++) {
-        json_array_push(cars, json_new_number(db->owned.owned_car_ids[i]));
+        json_out_number(out, db->owned.owned_car_ids[i]);
     }
-    json_object_set(root, "owned_cars", cars);
+    json_out_end_array(out);
 
     /* Owned tracks */
-    json_value *tracks = json_new_array();
+    json_out_key(out, "owned_tracks");
+    json_out_begin_array(out);
     for (int i = 0; i < db->owned.owned_track_count; i++) {
-        json_array_push(tracks, json_new_number(db->owned.owned_track_ids[i]));
+        json_out_number(out, db->owned.owned_track_ids[i]);
     }
-    json_object_set(root, "owned_tracks", tracks);
+    json_out_end_array(out);
 
-    bool result = json_write_file(root, filename, true);
-    json_free(root);
-    return result;
+    json_out_end_object(out);
+    return json_out_close(out);
 }
 
 /*
@@ -12,6 +12,49 @@
 #include <time.h>
 
 #include "models.h"
+#include "intern.h"
+
+/*
+ * ID index - dense table from ID to array position.
+ * iRacing IDs are small positive integers, so a flat table is both
+ * smaller and faster than hashing. The table remembers which array it
+ * was built from; if that array has since been replaced, lookups fall
+ * back to a linear scan until the indexes are rebuilt.
+ */
+typedef struct {
+    int *slots;             /* slots[id] = array position, or -1 */
+    int max_id;             /* Highest ID covered by slots */
+    const void *base;       /* Array the index was built from */
+    int count;              /* Element count when built */
+} ira_id_index;
+
+/* Bitset over IDs, with the same staleness tracking as ira_id_index */
+typedef struct {
+    unsigned int *words;
+    int max_id;
+    const void *base;       /* Owned ID list the set was built from */
+    int count;
+    const void *catalog;    /* Car or track array used for free content */
+    int catalog_count;
+} ira_id_bitset;
+
+/*
+ * Tables with changes not yet written to their JSON file.
+ * See database_mark_dirty() and database_save_all().
+ */
+typedef enum {
+    DB_DIRTY_TRACKS      = 1 << 0,
+    DB_DIRTY_CARS        = 1 << 1,
+    DB_DIRTY_CAR_CLASSES = 1 << 2,
+    DB_DIRTY_SERIES      = 1 << 3,
+    DB_DIRTY_SEASONS     = 1 << 4,
+    DB_DIRTY_OWNED       = 1 << 5,
+    DB_DIRTY_FILTER      = 1 << 6,
+
+    /* Everything database_swap_catalog() exchanges */
+    DB_DIRTY_CATALOG     = DB_DIRTY_TRACKS | DB_DIRTY_CARS | DB_DIRTY_CAR_CLASSES |
+                           DB_DIRTY_SERIES | DB_DIRTY_SEASONS | DB_DIRTY_OWNED
+} database_dirty;
 
 /*
  * Database structure - holds all cached iRacing data
@@ -47,8 +90,23 @@ typedef struct {
     /* User's owned content */
     ira_owned_content owned;
 
+    /* Names and ID lists the catalog tables point into */
+    ira_intern strings;
+
+    /* database_dirty flags */
+    unsigned int dirty;
+
     /* User's filter preferences */
     ira_filter filter;
+
+    /* Lookup indexes, see database_rebuild_indexes() */
+    ira_id_index track_index;
+    ira_id_index car_index;
+    ira_id_index car_class_index;
+    ira_id_index series_index;
+    ira_id_index season_index;
+    ira_id_bitset owned_cars;       /* Owned or free with subscription */
+    ira_id_bitset owned_tracks;
 } ira_database;
 
 /*
@@ -61,17 +119,46 @@ ira_database *database_create(void);
 /* Free all database memory */
 void database_destroy(ira_database *db);
 
+/*
+ * Deep copy of the catalog tables and owned content, with a default
+ * filter. Used as the shadow a background sync writes into. Strings are
+ * re-interned into the copy's own pool, dropping any no longer used.
+ * Returns NULL on allocation failure.
+ */
+ira_database *database_clone_catalog(const ira_database *db);
+
+/*
+ * Exchange the catalog tables, owned content, string pools and indexes
+ * between two databases. Each keeps its own filter. Anything holding
+ * pointers into db's old tables must be refreshed afterwards.
+ *
+ * The other side is normally a clone of db, so unsaved catalog changes
+ * of either are flagged on both afterwards.
+ */
+void database_swap_catalog(ira_database *db, ira_database *other);
+
 /*
  * Persistence - Load/Save to JSON files
  * All files stored in same directory as executable
  */
 
-/* Load all data from JSON files */
+/*
+ * Load all data. The catalog tables come from the binary snapshot while it
+ * is still in step with the JSON files; otherwise they are parsed from JSON
+ * and the snapshot is rewritten.
+ */
 bool database_load_all(ira_database *db);
 
-/* Save all data to JSON files */
+/*
+ * Write the JSON file of every dirty table, then refresh the snapshot if
+ * it is out of date. Clean tables are not touched. Returns false if any
+ * file failed to write; its table stays dirty for the next save.
+ */
 bool database_save_all(ira_database *db);
 
+/* Flag tables (database_dirty) to be written by the next database_save_all() */
+void database_mark_dirty(ira_database *db, unsigned int tables);
+
 /* Individual load functions */
 bool database_load_tracks(ira_database *db, const char *filename);
 bool database_load_cars(ira_database *db, const char *filename);
@@ -81,7 +168,10 @@ bool database_load_seasons(ira_database *db, const char *filename);
 bool database_load_owned(ira_database *db, const char *filename);
 bool database_load_filter(ira_database *db, const char *filename);
 
-/* Individual save functions */
+/*
+ * Individual save functions. Each streams the table to a temp file and
+ * renames it over filename, so a failed save keeps the old file.
+ */
 bool database_save_tracks(ira_database *db, const char *filename);
 bool database_save_cars(ira_database *db, const char *filename);
 bool database_save_car_classes(ira_database *db, const char *filename);
@@ -94,6 +184,13 @@ bool database_save_filter(ira_database *db, const char *filename);
  * Lookups
  */
 
+/*
+ * Rebuild the ID indexes and ownership bitsets.
+ * Call after replacing any of the catalog arrays or the owned lists;
+ * the database_load_* functions do this themselves.
+ */
+void database_rebuild_indexes(ira_database *db);
+
 /* Find track by ID, returns NULL if not found */
 ira_track *database_get_track(ira_database *db, int track_id);
 
@@ -146,5 +243,6 @@ const char *database_get_series_path(void);
 const char *database_get_seasons_path(void);
 const char *database_get_owned_path(void);
 const char *database_get_filter_path(void);
+const char *database_get_snapshot_path(void);
 
 #endif /* IRA_DATABASE_H */
@@ -0,0 +1,734 @@
+/*
+ * ira - iRacing Application
+ * Database Snapshot Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ *
+ * File layout (little-endian, native struct layout):
+ *   snapshot_header
+ *   section data, each 8-byte aligned, at the offsets in the header
+ *
+ * Sections hold raw model arrays. Season schedules are stored back to back
+ * in one week section; each season's schedule_count says how many are its.
+ * Names and ID lists live in the strings section, and the model pointers
+ * to them hold offset + 1 into it, 0 for "" or no IDs.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include "db_snapshot.h"
+#include "intern.h"
+
+#define SNAPSHOT_MAGIC "IRADBSN"
+
+#ifndef MAX_PATH
+#define MAX_PATH 260
+#endif
+
+/* Section order in the file */
+typedef enum {
+    SECTION_TRACKS,
+    SECTION_CARS,
+    SECTION_CAR_CLASSES,
+    SECTION_SERIES,
+    SECTION_SEASONS,
+    SECTION_WEEKS,
+    SECTION_OWNED_CARS,
+    SECTION_OWNED_TRACKS,
+    SECTION_STRINGS,
+    SECTION_COUNT
+} snapshot_section_id;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t count;
+    uint32_t elem_size;         /* sizeof the element when written */
+} snapshot_section;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+
+    /* State of each source JSON file when the snapshot was taken */
+    int64_t source_mtime[DB_SOURCE_COUNT];
+    int64_t source_size[DB_SOURCE_COUNT];
+
+    /* Database scalars */
+    int64_t updated[DB_SOURCE_COUNT];
+    int32_t season_year;
+    int32_t season_quarter;
+    int32_t cust_id;
+    int32_t reserved;
+
+    snapshot_section sections[SECTION_COUNT];
+} snapshot_header;
+
+static const size_t g_elem_sizes[SECTION_COUNT] = {
+    sizeof(ira_track),
+    sizeof(ira_car),
+    sizeof(ira_car_class),
+    sizeof(ira_series),
+    sizeof(ira_season),
+    sizeof(ira_schedule_week),
+    sizeof(int),
+    sizeof(int),
+    1,
+};
+
+/*
+ * Helpers
+ */
+
+/* Stamp a source file; missing files stamp as size -1 */
+static void stat_source(const char *path, int64_t *mtime, int64_t *size)
+{
+    struct stat st;
+    if (path && stat(path, &st) == 0) {
+        *mtime = (int64_t)st.st_mtime;
+        *size = (int64_t)st.st_size;
+    } else {
+        *mtime = 0;
+        *size = -1;
+    }
+}
+
+static bool sources_match(const snapshot_header *hdr, const char *const *sources)
+{
+    for (int i = 0; i < DB_SOURCE_COUNT; i++) {
+        int64_t mtime, size;
+        stat_source(sources[i], &mtime, &size);
+        if (mtime != hdr->source_mtime[i] || size != hdr->source_size[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void get_updated(const ira_database *db, int64_t updated[DB_SOURCE_COUNT])
+{
+    updated[DB_SOURCE_TRACKS] = (int64_t)db->tracks_updated;
+    updated[DB_SOURCE_CARS] = (int64_t)db->cars_updated;
+    updated[DB_SOURCE_CAR_CLASSES] = (int64_t)db->car_classes_updated;
+    updated[DB_SOURCE_SERIES] = (int64_t)db->series_updated;
+    updated[DB_SOURCE_SEASONS] = (int64_t)db->seasons_updated;
+    updated[DB_SOURCE_OWNED] = (int64_t)db->owned.last_updated;
+}
+
+static bool header_valid(const snapshot_header *hdr, size_t file_size)
+{
+    if (memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != DB_SNAPSHOT_VERSION ||
+        hdr->header_size != sizeof(snapshot_header)) {
+        return false;
+    }
+
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        const snapshot_section *sec = &hdr->sections[i];
+        if (sec->elem_size != g_elem_sizes[i]) {
+            return false;
+        }
+        uint64_t bytes = (uint64_t)sec->count * sec->elem_size;
+        if (sec->offset > file_size || bytes > file_size - sec->offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Read just the header of an existing snapshot */
+static bool read_header(const char *path, snapshot_header *hdr)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    bool ok = fread(hdr, sizeof(*hdr), 1, f) == 1;
+    fclose(f);
+    return ok;
+}
+
+/*
+ * Memory mapping
+ */
+
+typedef struct {
+    const char *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} mapped_file;
+
+static bool map_file(const char *path, mapped_file *map)
+{
+    memset(map, 0, sizeof(*map));
+
+#ifdef _WIN32
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(map->file, &size) || size.QuadPart == 0) {
+        CloseHandle(map->file);
+        return false;
+    }
+
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map->mapping) {
+        CloseHandle(map->file);
+        return false;
+    }
+
+    map->data = (const char *)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) {
+        CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        return false;
+    }
+    map->size = (size_t)size.QuadPart;
+    return true;
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *data = size > 0 ? malloc((size_t)size) : NULL;
+    if (!data || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        free(data);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    map->data = data;
+    map->size = (size_t)size;
+    return true;
+#endif
+}
+
+static void unmap_file(mapped_file *map)
+{
+#ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle(map->mapping);
+    if (map->file && map->file != INVALID_HANDLE_VALUE) CloseHandle(map->file);
+#else
+    free((void *)map->data);
+#endif
+    memset(map, 0, sizeof(*map));
+}
+
+/* Copy a section into a new heap array. count == 0 yields NULL. */
+static void *copy_section(const mapped_file *map, const snapshot_section *sec, bool *ok)
+{
+    if (sec->count == 0) return NULL;
+
+    size_t bytes = (size_t)sec->count * sec->elem_size;
+    void *dst = malloc(bytes);
+    if (!dst) {
+        *ok = false;
+        return NULL;
+    }
+    memcpy(dst, map->data + sec->offset, bytes);
+    return dst;
+}
+
+/*
+ * String references
+ */
+
+/* The strings section as loaded */
+typedef struct {
+    const char *base;
+    size_t size;
+} string_image;
+
+/* Turn a stored string reference back into a pointer */
+static bool load_string(const string_image *img, const char **p)
+{
+    uintptr_t ref = (uintptr_t)*p;
+    if (ref == 0) {
+        *p = "";
+        return true;
+    }
+    if (ref > img->size || !memchr(img->base + ref - 1, '\0', img->size - (ref - 1))) {
+        return false;
+    }
+    *p = img->base + ref - 1;
+    return true;
+}
+
+/* Turn a stored ID list reference back into a pointer */
+static bool load_ids(const string_image *img, const int **p, int count)
+{
+    uintptr_t ref = (uintptr_t)*p;
+    if (count <= 0) {
+        *p = NULL;
+        return count == 0 && ref == 0;
+    }
+    if (ref == 0 || ((ref - 1) & 3) != 0 || ref - 1 > img->size ||
+        (size_t)count > (img->size - (ref - 1)) / sizeof(int)) {
+        return false;
+    }
+    *p = (const int *)(img->base + ref - 1);
+    return true;
+}
+
+static bool load_references(const string_image *img, ira_track *tracks, int track_count,
+                            ira_car *cars, int car_count,
+                            ira_car_class *classes, int class_count,
+                            ira_series *series, int series_count,
+                            ira_season *seasons, int season_count)
+{
+    bool ok = true;
+
+    for (int i = 0; ok && i < track_count; i++) {
+        ok = load_string(img, &tracks[i].track_name) &&
+             load_string(img, &tracks[i].config_name) &&
+             load_string(img, &tracks[i].location);
+    }
+    for (int i = 0; ok && i < car_count; i++) {
+        ok = load_string(img, &cars[i].car_name) &&
+             load_string(img, &cars[i].car_abbrev) &&
+             load_string(img, &cars[i].car_make) &&
+             load_string(img, &cars[i].car_model);
+    }
+    for (int i = 0; ok && i < class_count; i++) {
+        ok = load_string(img, &classes[i].car_class_name) &&
+             load_string(img, &classes[i].short_name) &&
+             load_ids(img, &classes[i].car_ids, classes[i].car_count);
+    }
+    for (int i = 0; ok && i < series_count; i++) {
+        ok = load_string(img, &series[i].series_name) &&
+             load_string(img, &series[i].short_name);
+    }
+    for (int i = 0; ok && i < season_count; i++) {
+        ira_season *season = &seasons[i];
+        ok = load_string(img, &season->season_name) &&
+             load_string(img, &season->short_name);
+        for (int j = 0; ok && j < season->schedule_count; j++) {
+            ira_schedule_week *week = &season->schedule[j];
+            ok = load_string(img, &week->track_name) &&
+                 load_string(img, &week->config_name) &&
+                 load_ids(img, &week->car_ids, week->car_count);
+        }
+    }
+    return ok;
+}
+
+/*
+ * Reference to a string in the pool being written. Offsets stay valid as
+ * the pool grows, since new blocks go at the end of its image. Returns
+ * false if the string could not be stored.
+ */
+static bool store_string(ira_intern *pool, const char **p)
+{
+    const char *s = *p;
+    const char *pooled = intern_string(pool, s);
+    if (!pooled[0]) {
+        *p = NULL;
+        return !s || !s[0];
+    }
+    *p = (const char *)(uintptr_t)(intern_offset(pool, pooled) + 1);
+    return true;
+}
+
+static bool store_ids(ira_intern *pool, const int **p, int count)
+{
+    const int *pooled = intern_ids(pool, *p, count);
+    *p = pooled ? (const int *)(uintptr_t)(intern_offset(pool, pooled) + 1) : NULL;
+    return pooled || count <= 0;
+}
+
+/*
+ * Load
+ */
+
+bool db_snapshot_load(ira_database *db, const char *path, const char *const *sources)
+{
+    if (!db || !path || !sources) return false;
+
+    mapped_file map;
+    if (!map_file(path, &map)) return false;
+
+    if (map.size < sizeof(snapshot_header)) {
+        unmap_file(&map);
+        return false;
+    }
+
+    snapshot_header hdr;
+    memcpy(&hdr, map.data, sizeof(hdr));
+
+    if (!header_valid(&hdr, map.size) || !sources_match(&hdr, sources)) {
+        unmap_file(&map);
+        return false;
+    }
+
+    /* Schedules must account for exactly the stored weeks */
+    const ira_season *stored_seasons =
+        (const ira_season *)(map.data + hdr.sections[SECTION_SEASONS].offset);
+    uint64_t week_total = 0;
+    for (uint32_t i = 0; i < hdr.sections[SECTION_SEASONS].count; i++) {
+        if (stored_seasons[i].schedule_count < 0) {
+            unmap_file(&map);
+            return false;
+        }
+        week_total += (uint64_t)stored_seasons[i].schedule_count;
+    }
+    if (week_total != hdr.sections[SECTION_WEEKS].count) {
+        unmap_file(&map);
+        return false;
+    }
+
+    bool ok = true;
+    ira_track *tracks = copy_section(&map, &hdr.sections[SECTION_TRACKS], &ok);
+    ira_car *cars = copy_section(&map, &hdr.sections[SECTION_CARS], &ok);
+    ira_car_class *classes = copy_section(&map, &hdr.sections[SECTION_CAR_CLASSES], &ok);
+    ira_series *series = copy_section(&map, &hdr.sections[SECTION_SERIES], &ok);
+    ira_season *seasons = copy_section(&map, &hdr.sections[SECTION_SEASONS], &ok);
+    int *owned_cars = copy_section(&map, &hdr.sections[SECTION_OWNED_CARS], &ok);
+    int *owned_tracks = copy_section(&map, &hdr.sections[SECTION_OWNED_TRACKS], &ok);
+    int season_count = (int)hdr.sections[SECTION_SEASONS].count;
+
+    /* Give each season its own schedule allocation, as the JSON loader does */
+    const ira_schedule_week *weeks =
+        (const ira_schedule_week *)(map.data + hdr.sections[SECTION_WEEKS].offset);
+    if (seasons) {
+        for (int i = 0; i < season_count; i++) {
+            seasons[i].schedule = NULL;
+        }
+    }
+    for (int i = 0; ok && i < season_count; i++) {
+        int n = seasons[i].schedule_count;
+        if (n > 0) {
+            seasons[i].schedule = malloc(n * sizeof(ira_schedule_week));
+            if (!seasons[i].schedule) {
+                ok = false;
+                break;
+            }
+            memcpy(seasons[i].schedule, weeks, n * sizeof(ira_schedule_week));
+        }
+        weeks += n;
+    }
+
+    /* The strings section becomes the pool the tables point into */
+    ira_intern strings;
+    memset(&strings, 0, sizeof(strings));
+    string_image img = { NULL, hdr.sections[SECTION_STRINGS].count };
+    if (ok && img.size > 0) {
+        img.base = intern_adopt(&strings, map.data + hdr.sections[SECTION_STRINGS].offset,
+                                img.size);
+        ok = img.base != NULL;
+    }
+    ok = ok && load_references(&img, tracks, (int)hdr.sections[SECTION_TRACKS].count,
+                               cars, (int)hdr.sections[SECTION_CARS].count,
+                               classes, (int)hdr.sections[SECTION_CAR_CLASSES].count,
+                               series, (int)hdr.sections[SECTION_SERIES].count,
+                               seasons, season_count);
+
+    unmap_file(&map);
+
+    if (!ok) {
+        free(tracks);
+        free(cars);
+        free(classes);
+        free(series);
+        for (int i = 0; seasons && i < season_count; i++) {
+            season_free_schedule(&seasons[i]);
+        }
+        free(seasons);
+        free(owned_cars);
+        free(owned_tracks);
+        intern_free(&strings);
+        return false;
+    }
+
+    /* Replace the catalog tables */
+    free(db->tracks);
+    free(db->cars);
+    free(db->car_classes);
+    free(db->series);
+    for (int i = 0; i < db->season_count; i++) {
+        season_free_schedule(&db->seasons[i]);
+    }
+    free(db->seasons);
+    owned_content_free(&db->owned);
+    intern_free(&db->strings);
+
+    db->strings = strings;
+
+    db->tracks = tracks;
+    db->track_count = (int)hdr.sections[SECTION_TRACKS].count;
+    db->tracks_updated = (time_t)hdr.updated[DB_SOURCE_TRACKS];
+
+    db->cars = cars;
+    db->car_count = (int)hdr.sections[SECTION_CARS].count;
+    db->cars_updated = (time_t)hdr.updated[DB_SOURCE_CARS];
+
+    db->car_classes = classes;
+    db->car_class_count = (int)hdr.sections[SECTION_CAR_CLASSES].count;
+    db->car_classes_updated = (time_t)hdr.updated[DB_SOURCE_CAR_CLASSES];
+
+    db->series = series;
+    db->series_count = (int)hdr.sections[SECTION_SERIES].count;
+    db->series_updated = (time_t)hdr.updated[DB_SOURCE_SERIES];
+
+    db->seasons = seasons;
+    db->season_count = season_count;
+    db->season_year = hdr.season_year;
+    db->season_quarter = hdr.season_quarter;
+    db->seasons_updated = (time_t)hdr.updated[DB_SOURCE_SEASONS];
+
+    db->owned.cust_id = hdr.cust_id;
+    db->owned.last_updated = (time_t)hdr.updated[DB_SOURCE_OWNED];
+    db->owned.owned_car_ids = owned_cars;
+    db->owned.owned_car_count = (int)hdr.sections[SECTION_OWNED_CARS].count;
+    db->owned.owned_track_ids = owned_tracks;
+    db->owned.owned_track_count = (int)hdr.sections[SECTION_OWNED_TRACKS].count;
+
+    database_rebuild_indexes(db);
+    return true;
+}
+
+/*
+ * Save
+ */
+
+/* Copies of the tables as written, pointers turned into references */
+typedef struct {
+    ira_intern strings;         /* Only what the tables use */
+    ira_track *tracks;
+    ira_car *cars;
+    ira_car_class *car_classes;
+    ira_series *series;
+    ira_season *seasons;
+    ira_schedule_week *weeks;   /* Every schedule, back to back */
+    int week_count;
+} stored_catalog;
+
+static void *dup_array(const void *src, int count, size_t elem_size, bool *ok)
+{
+    if (!src || count <= 0) return NULL;
+
+    void *copy = malloc((size_t)count * elem_size);
+    if (!copy) {
+        *ok = false;
+        return NULL;
+    }
+    memcpy(copy, src, (size_t)count * elem_size);
+    return copy;
+}
+
+static void free_stored(stored_catalog *sc)
+{
+    free(sc->tracks);
+    free(sc->cars);
+    free(sc->car_classes);
+    free(sc->series);
+    free(sc->seasons);
+    free(sc->weeks);
+    intern_free(&sc->strings);
+}
+
+static bool build_stored(const ira_database *db, stored_catalog *sc)
+{
+    memset(sc, 0, sizeof(*sc));
+
+    bool ok = true;
+    sc->tracks = dup_array(db->tracks, db->track_count, sizeof(ira_track), &ok);
+    sc->cars = dup_array(db->cars, db->car_count, sizeof(ira_car), &ok);
+    sc->car_classes = dup_array(db->car_classes, db->car_class_count, sizeof(ira_car_class), &ok);
+    sc->series = dup_array(db->series, db->series_count, sizeof(ira_series), &ok);
+    sc->seasons = dup_array(db->seasons, db->season_count, sizeof(ira_season), &ok);
+
+    for (int i = 0; i < db->season_count; i++) {
+        if (db->seasons[i].schedule) sc->week_count += db->seasons[i].schedule_count;
+    }
+    if (ok && sc->week_count > 0) {
+        sc->weeks = malloc((size_t)sc->week_count * sizeof(ira_schedule_week));
+        ok = sc->weeks != NULL;
+    }
+
+    ira_intern *pool = &sc->strings;
+
+    for (int i = 0; ok && sc->tracks && i < db->track_count; i++) {
+        ira_track *t = &sc->tracks[i];
+        ok = store_string(pool, &t->track_name) && store_string(pool, &t->config_name) &&
+             store_string(pool, &t->location);
+    }
+    for (int i = 0; ok && sc->cars && i < db->car_count; i++) {
+        ira_car *c = &sc->cars[i];
+        ok = store_string(pool, &c->car_name) && store_string(pool, &c->car_abbrev) &&
+             store_string(pool, &c->car_make) && store_string(pool, &c->car_model);
+    }
+    for (int i = 0; ok && sc->car_classes && i < db->car_class_count; i++) {
+        ira_car_class *cc = &sc->car_classes[i];
+        ok = store_string(pool, &cc->car_class_name) && store_string(pool, &cc->short_name) &&
+             store_ids(pool, &cc->car_ids, cc->car_count);
+    }
+    for (int i = 0; ok && sc->series && i < db->series_count; i++) {
+        ira_series *s = &sc->series[i];
+        ok = store_string(pool, &s->series_name) && store_string(pool, &s->short_name);
+    }
+
+    /* Pointers are meaningless on disk; normalise missing schedules */
+    int w = 0;
+    for (int i = 0; ok && sc->seasons && i < db->season_count; i++) {
+        ira_season *season = &sc->seasons[i];
+        ok = store_string(pool, &season->season_name) && store_string(pool, &season->short_name);
+        if (!season->schedule) season->schedule_count = 0;
+
+        for (int j = 0; ok && j < season->schedule_count; j++) {
+            ira_schedule_week *week = &sc->weeks[w++];
+            *week = season->schedule[j];
+            ok = store_string(pool, &week->track_name) &&
+                 store_string(pool, &week->config_name) &&
+                 store_ids(pool, &week->car_ids, week->car_count);
+        }
+        season->schedule = NULL;
+    }
+
+    if (!ok) free_stored(sc);
+    return ok;
+}
+
+static bool write_padded(FILE *f, const void *data, size_t size, uint64_t *offset)
+{
+    static const char zeros[8] = {0};
+
+    if (size > 0 && fwrite(data, 1, size, f) != size) {
+        return false;
+    }
+    *offset += size;
+
+    size_t pad = (size_t)((8 - (*offset & 7)) & 7);
+    if (pad > 0 && fwrite(zeros, 1, pad, f) != pad) {
+        return false;
+    }
+    *offset += pad;
+    return true;
+}
+
+bool db_snapshot_save(const ira_database *db, const char *path, const char *const *sources)
+{
+    if (!db || !path || !sources) return false;
+
+    stored_catalog sc;
+    if (!build_stored(db, &sc)) return false;
+
+    size_t strings_size = intern_size(&sc.strings);
+    char *strings = strings_size > 0 ? malloc(strings_size) : NULL;
+    if (strings_size > 0 && !strings) {
+        free_stored(&sc);
+        return false;
+    }
+    intern_copy_to(&sc.strings, strings);
+
+    snapshot_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic));
+    hdr.version = DB_SNAPSHOT_VERSION;
+    hdr.header_size = sizeof(snapshot_header);
+
+    for (int i = 0; i < DB_SOURCE_COUNT; i++) {
+        stat_source(sources[i], &hdr.source_mtime[i], &hdr.source_size[i]);
+    }
+    get_updated(db, hdr.updated);
+    hdr.season_year = db->season_year;
+    hdr.season_quarter = db->season_quarter;
+    hdr.cust_id = db->owned.cust_id;
+
+    const void *data[SECTION_COUNT] = {
+        sc.tracks, sc.cars, sc.car_classes, sc.series, sc.seasons,
+        sc.weeks, db->owned.owned_car_ids, db->owned.owned_track_ids, strings,
+    };
+    size_t counts[SECTION_COUNT] = {
+        (size_t)db->track_count, (size_t)db->car_count, (size_t)db->car_class_count,
+        (size_t)db->series_count, (size_t)db->season_count, (size_t)sc.week_count,
+        (size_t)db->owned.owned_car_count, (size_t)db->owned.owned_track_count, strings_size,
+    };
+
+    uint64_t offset = sizeof(snapshot_header);
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        size_t count = data[i] ? counts[i] : 0;
+        hdr.sections[i].offset = offset;
+        hdr.sections[i].count = (uint32_t)count;
+        hdr.sections[i].elem_size = (uint32_t)g_elem_sizes[i];
+        uint64_t bytes = (uint64_t)count * g_elem_sizes[i];
+        offset += (bytes + 7) & ~(uint64_t)7;
+    }
+
+    char tmp_path[MAX_PATH];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        free(strings);
+        free_stored(&sc);
+        return false;
+    }
+
+    offset = 0;
+    bool ok = write_padded(f, &hdr, sizeof(hdr), &offset);
+    for (int i = 0; ok && i < SECTION_COUNT; i++) {
+        ok = write_padded(f, data[i], (size_t)hdr.sections[i].count * g_elem_sizes[i], &offset);
+    }
+
+    if (fclose(f) != 0) ok = false;
+    free(strings);
+    free_stored(&sc);
+
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING)) {
+        remove(tmp_path);
+        return false;
+    }
+#else
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool db_snapshot_current(const ira_database *db, const char *path, const char *const *sources)
+{
+    if (!db || !path || !sources) return false;
+
+    snapshot_header hdr;
+    if (!read_header(path, &hdr) ||
+        memcmp(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != DB_SNAPSHOT_VERSION ||
+        !sources_match(&hdr, sources)) {
+        return false;
+    }
+
+    int64_t updated[DB_SOURCE_COUNT];
+    get_updated(db, updated);
+    return memcmp(updated, hdr.updated, sizeof(updated)) == 0 &&
+           hdr.season_year == db->season_year &&
+           hdr.season_quarter == db->season_quarter &&
+           hdr.cust_id == db->owned.cust_id;
+}
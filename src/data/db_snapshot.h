@@ -0,0 +1,67 @@
+/*
+ * ira - iRacing Application
+ * Database Snapshot - binary startup cache
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_DB_SNAPSHOT_H
+#define IRA_DB_SNAPSHOT_H
+
+#include <stdbool.h>
+
+#include "database.h"
+
+/* Bump when the file layout or any model struct changes */
+#define DB_SNAPSHOT_VERSION 3
+
+/* Default snapshot file name, stored beside the JSON files */
+#define DB_SNAPSHOT_FILE "database.snapshot"
+
+/*
+ * JSON files a snapshot is derived from. A snapshot is only used while
+ * every source still has the modification time and size it had when the
+ * snapshot was written.
+ */
+typedef enum {
+    DB_SOURCE_TRACKS,
+    DB_SOURCE_CARS,
+    DB_SOURCE_CAR_CLASSES,
+    DB_SOURCE_SERIES,
+    DB_SOURCE_SEASONS,
+    DB_SOURCE_OWNED,
+    DB_SOURCE_COUNT
+} db_snapshot_source;
+
+/*
+ * Load the catalog tables (tracks, cars, car classes, series, seasons with
+ * their schedules) and owned content from a snapshot.
+ *
+ * The file is memory-mapped, its model arrays are copied into the database
+ * and the string section becomes the database's string pool. Existing
+ * tables are replaced and the indexes rebuilt. The filter is not part of
+ * the snapshot.
+ *
+ * Parameters:
+ *   db      - Database to fill
+ *   path    - Snapshot file
+ *   sources - DB_SOURCE_COUNT JSON paths, indexed by db_snapshot_source
+ *
+ * Returns false, leaving db untouched, if the file is missing, was written
+ * by a different build layout, or any source file has changed since.
+ */
+bool db_snapshot_load(ira_database *db, const char *path, const char *const *sources);
+
+/*
+ * Write a snapshot of db, stamped with the current state of the sources.
+ * The file is written beside path and renamed into place.
+ */
+bool db_snapshot_save(const ira_database *db, const char *path, const char *const *sources);
+
+/*
+ * Check whether the snapshot at path already matches db: same sources and
+ * the same *_updated timestamps. Used to skip needless rewrites.
+ */
+bool db_snapshot_current(const ira_database *db, const char *path, const char *const *sources);
+
+#endif /* IRA_DB_SNAPSHOT_H */
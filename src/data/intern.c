@@ -0,0 +1,245 @@
+/*
+ * ira - iRacing Application
+ * String Intern Pool Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+/* Block sizing, as the JSON document arena does it */
+#define INTERN_MIN_BLOCK (16 * 1024)
+#define INTERN_MAX_BLOCK (1024 * 1024)
+
+/* Initial hash set size; grown at 3/4 full */
+#define INTERN_MIN_ENTRIES 256
+
+/* Hash seeds, so a string and an ID list with the same bytes stay apart */
+#define HASH_SEED_STRING 2166136261u
+#define HASH_SEED_IDS    0x9e3779b9u
+
+struct ira_intern_block {
+    struct ira_intern_block *next;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+static const char g_empty[] = "";
+
+/* Round up to the 4-byte alignment of ID lists */
+static size_t align4(size_t n)
+{
+    return (n + 3) & ~(size_t)3;
+}
+
+/* FNV-1a; never 0, which marks an empty slot */
+static uint32_t hash_bytes(const void *data, size_t size, uint32_t seed)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint32_t h = seed;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h ? h : 1;
+}
+
+void intern_free(ira_intern *pool)
+{
+    if (!pool) return;
+
+    ira_intern_block *block = pool->blocks;
+    while (block) {
+        ira_intern_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(pool->entries);
+    memset(pool, 0, sizeof(*pool));
+}
+
+/*
+ * Helper: Carve size bytes from the newest block, starting a new one if
+ * it is full. aligned requests start on a 4-byte boundary.
+ */
+static char *pool_alloc(ira_intern *pool, size_t size, bool aligned)
+{
+    ira_intern_block *block = pool->blocks;
+    size_t start = block ? (aligned ? align4(block->used) : block->used) : 0;
+
+    if (!block || start > block->size || block->size - start < size) {
+        size_t block_size = pool->next_block_size ? pool->next_block_size : INTERN_MIN_BLOCK;
+        if (block_size < size) {
+            block_size = align4(size);
+        }
+
+        block = (ira_intern_block *)malloc(sizeof(ira_intern_block) + block_size);
+        if (!block) {
+            return NULL;
+        }
+        block->next = pool->blocks;
+        block->used = 0;
+        block->size = block_size;
+        pool->blocks = block;
+        start = 0;
+
+        pool->next_block_size = block_size < INTERN_MAX_BLOCK ? block_size * 2 : block_size;
+    }
+
+    /* Alignment padding is zeroed so the flat image is deterministic */
+    memset(block->data + block->used, 0, start - block->used);
+    block->used = start + size;
+    return block->data + start;
+}
+
+/* Helper: Double the hash set, or create it */
+static bool grow_entries(ira_intern *pool)
+{
+    uint32_t capacity = pool->entry_capacity ? pool->entry_capacity * 2 : INTERN_MIN_ENTRIES;
+    ira_intern_entry *entries = calloc(capacity, sizeof(ira_intern_entry));
+    if (!entries) return false;
+
+    for (uint32_t i = 0; i < pool->entry_capacity; i++) {
+        const ira_intern_entry *e = &pool->entries[i];
+        if (e->hash == 0) continue;
+
+        uint32_t slot = e->hash & (capacity - 1);
+        while (entries[slot].hash != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot] = *e;
+    }
+
+    free(pool->entries);
+    pool->entries = entries;
+    pool->entry_capacity = capacity;
+    return true;
+}
+
+/*
+ * Helper: Find or add size bytes of data. Returns the pooled copy, or
+ * NULL if memory runs out.
+ */
+static const char *intern_bytes(ira_intern *pool, const void *data, size_t size,
+                                uint32_t seed, bool aligned)
+{
+    if (size > UINT32_MAX) return NULL;
+
+    if ((pool->entry_count + 1) * 4 > pool->entry_capacity * 3 && !grow_entries(pool)) {
+        return NULL;
+    }
+
+    uint32_t hash = hash_bytes(data, size, seed);
+    uint32_t mask = pool->entry_capacity - 1;
+    uint32_t slot = hash & mask;
+
+    for (;;) {
+        ira_intern_entry *e = &pool->entries[slot];
+        if (e->hash == 0) break;
+        if (e->hash == hash && e->size == size && memcmp(e->data, data, size) == 0 &&
+            (!aligned || ((uintptr_t)e->data & 3) == 0)) {
+            return e->data;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    char *copy = pool_alloc(pool, size, aligned);
+    if (!copy) return NULL;
+    memcpy(copy, data, size);
+
+    ira_intern_entry *e = &pool->entries[slot];
+    e->data = copy;
+    e->size = (uint32_t)size;
+    e->hash = hash;
+    pool->entry_count++;
+    return copy;
+}
+
+const char *intern_string(ira_intern *pool, const char *str)
+{
+    if (!pool || !str || !str[0]) return g_empty;
+
+    const char *s = intern_bytes(pool, str, strlen(str) + 1, HASH_SEED_STRING, false);
+    return s ? s : g_empty;
+}
+
+const int *intern_ids(ira_intern *pool, const int *ids, int count)
+{
+    if (!pool || !ids || count <= 0) return NULL;
+
+    return (const int *)intern_bytes(pool, ids, (size_t)count * sizeof(int),
+                                     HASH_SEED_IDS, true);
+}
+
+/*
+ * Flat image. Blocks are laid out oldest first, each padded to 4 bytes so
+ * ID lists stay aligned.
+ */
+
+size_t intern_size(const ira_intern *pool)
+{
+    if (!pool) return 0;
+
+    size_t total = 0;
+    for (const ira_intern_block *block = pool->blocks; block; block = block->next) {
+        total += align4(block->used);
+    }
+    return total;
+}
+
+void intern_copy_to(const ira_intern *pool, char *dst)
+{
+    if (!pool || !dst) return;
+
+    size_t end = intern_size(pool);
+    for (const ira_intern_block *block = pool->blocks; block; block = block->next) {
+        size_t extent = align4(block->used);
+        end -= extent;
+        memcpy(dst + end, block->data, block->used);
+        memset(dst + end + block->used, 0, extent - block->used);
+    }
+}
+
+size_t intern_offset(const ira_intern *pool, const void *p)
+{
+    if (!pool || !p) return (size_t)-1;
+
+    const char *c = (const char *)p;
+    size_t end = intern_size(pool);
+    for (const ira_intern_block *block = pool->blocks; block; block = block->next) {
+        end -= align4(block->used);
+        if (c >= block->data && c < block->data + block->used) {
+            return end + (size_t)(c - block->data);
+        }
+    }
+    return (size_t)-1;
+}
+
+const char *intern_adopt(ira_intern *pool, const void *data, size_t size)
+{
+    if (!pool || !data || size == 0) return NULL;
+
+    ira_intern_block *block = (ira_intern_block *)malloc(sizeof(ira_intern_block) + align4(size));
+    if (!block) return NULL;
+
+    memcpy(block->data, data, size);
+    block->used = size;
+    block->size = align4(size);
+
+    /*
+     * Slot it in behind the newest block, so later interns keep filling
+     * that one rather than a full image.
+     */
+    if (pool->blocks) {
+        block->next = pool->blocks->next;
+        pool->blocks->next = block;
+    } else {
+        block->next = NULL;
+        pool->blocks = block;
+    }
+    return block->data;
+}
@@ -0,0 +1,77 @@
+/*
+ * ira - iRacing Application
+ * String Intern Pool - shared storage for model names and ID lists
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_INTERN_H
+#define IRA_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Each distinct string or ID list is stored once, in blocks that never
+ * move, so model structs hold plain pointers into the pool. Nothing is
+ * freed individually; entries outlive the rows that reference them until
+ * the pool is dropped. database_clone_catalog() re-interns into a fresh
+ * pool, which leaves the garbage behind.
+ *
+ * A zeroed ira_intern is an empty pool. The pool is not thread safe.
+ */
+
+typedef struct ira_intern_block ira_intern_block;
+
+typedef struct {
+    const char *data;
+    uint32_t size;              /* Bytes, including a string's terminator */
+    uint32_t hash;              /* 0 = empty slot */
+} ira_intern_entry;
+
+typedef struct {
+    ira_intern_block *blocks;   /* Newest first */
+    size_t next_block_size;
+    ira_intern_entry *entries;  /* Open addressing, power of two */
+    uint32_t entry_capacity;
+    uint32_t entry_count;
+} ira_intern;
+
+/* Free every block; the pool is empty again afterwards */
+void intern_free(ira_intern *pool);
+
+/*
+ * Intern a string. NULL and "" give a shared "" that is not in the pool.
+ * Never returns NULL: if memory runs out the string is dropped and ""
+ * returned, as a truncated copy would have been before.
+ */
+const char *intern_string(ira_intern *pool, const char *str);
+
+/*
+ * Intern a list of IDs, 4-byte aligned. count <= 0 gives NULL, as does
+ * running out of memory.
+ */
+const int *intern_ids(ira_intern *pool, const int *ids, int count);
+
+/*
+ * Flat image, for the binary snapshot
+ */
+
+/* Bytes needed to copy every block back to back */
+size_t intern_size(const ira_intern *pool);
+
+/* Copy every block into dst, which holds intern_size() bytes */
+void intern_copy_to(const ira_intern *pool, char *dst);
+
+/* Offset of p in the intern_copy_to() image, or (size_t)-1 if p is not in the pool */
+size_t intern_offset(const ira_intern *pool, const void *p);
+
+/*
+ * Take a copy of an image as one more block and return where it landed,
+ * or NULL if memory runs out. Entries in it are not deduplicated against
+ * later interns.
+ */
+const char *intern_adopt(ira_intern *pool, const void *data, size_t size);
+
+#endif /* IRA_INTERN_H */
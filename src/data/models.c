@@ -5,6 +5,7 @@
  * Copyright (c) 2026 Christopher Griffiths
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
@@ -70,6 +71,39 @@ bool category_is_active(race_category cat)
     }
 }
 
+/*
+ * Time conversion
+ */
+
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+static long long days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    int yoe = year - (int)(era * 400);
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+time_t parse_utc_timestamp(const char *str)
+{
+    if (!str) return 0;
+
+    int year, month, day;
+    int hour = 0, min = 0, sec = 0;
+
+    if (sscanf(str, "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &min, &sec) < 3) {
+        return 0;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+
+    return (time_t)(days_from_civil(year, month, day) * 86400LL +
+                    hour * 3600LL + min * 60LL + sec);
+}
+
 /*
  * License conversion
  */
@@ -39,33 +39,40 @@ typedef enum {
     LICENSE_PRO_WC = 7
 } license_level;
 
+/*
+ * Names and ID lists in the catalog structs point into the owning
+ * database's intern pool (ira_database.strings). Names are never NULL;
+ * missing ones are "". Fields the race filter reads come first, display
+ * fields last.
+ */
+
 /*
  * Track Configuration
  */
 typedef struct {
     int track_id;
-    char track_name[128];
-    char config_name[64];
     race_category category;
+    bool retired;
     bool is_oval;
     bool is_dirt;
-    float length_km;
-    int corners;
+    bool free_with_subscription;
+    bool night_lighting;
+    bool ai_enabled;
     int max_cars;
     int grid_stalls;
     int pit_speed_kph;
+    int corners;
+    float length_km;
     float price;
-    bool free_with_subscription;
-    bool retired;
     int package_id;
     int sku;
     /* Location */
-    char location[128];
     float latitude;
     float longitude;
-    /* Features */
-    bool night_lighting;
-    bool ai_enabled;
+    /* Display */
+    const char *track_name;
+    const char *config_name;
+    const char *location;
 } ira_track;
 
 /*
@@ -73,21 +80,22 @@ typedef struct {
  */
 typedef struct {
     int car_id;
-    char car_name[128];
-    char car_abbrev[32];
-    char car_make[64];
-    char car_model[64];
-    int hp;
-    int weight_kg;
-    race_category categories[4];  /* A car can be in multiple categories */
-    int category_count;
-    float price;
     bool free_with_subscription;
     bool retired;
     bool rain_enabled;
     bool ai_enabled;
+    race_category categories[4];  /* A car can be in multiple categories */
+    int category_count;
+    int hp;
+    int weight_kg;
+    float price;
     int package_id;
     int sku;
+    /* Display */
+    const char *car_name;
+    const char *car_abbrev;
+    const char *car_make;
+    const char *car_model;
 } ira_car;
 
 /*
@@ -95,10 +103,10 @@ typedef struct {
  */
 typedef struct {
     int car_class_id;
-    char car_class_name[64];
-    char short_name[32];
-    int car_ids[32];
     int car_count;
+    const int *car_ids;         /* car_count IDs, NULL if none */
+    const char *car_class_name;
+    const char *short_name;
 } ira_car_class;
 
 /*
@@ -106,31 +114,46 @@ typedef struct {
  */
 typedef struct {
     int series_id;
-    char series_name[128];
-    char short_name[64];
     race_category category;
     license_level min_license;
     int min_starters;
     int max_starters;
+    const char *series_name;
+    const char *short_name;
 } ira_series;
 
+/* Maximum fixed session times kept per week */
+#define IRA_MAX_SESSION_TIMES 8
+
 /*
  * Schedule Entry (one race week)
  */
 typedef struct {
-    int race_week_num;          /* 0-indexed */
+    /* Filtering */
     int track_id;
-    char track_name[128];
-    char config_name[64];
-    time_t start_date;
-    time_t end_date;
     int race_time_limit_mins;   /* 0 = lap-based */
     int race_lap_limit;         /* 0 = time-based */
+    int car_count;
+    const int *car_ids;         /* car_count IDs, NULL if none */
+
+    int race_week_num;          /* 0-indexed */
     int practice_mins;
     int qualify_mins;
     int warmup_mins;
-    int car_ids[16];
-    int car_count;
+    time_t start_date;
+    time_t end_date;
+
+    /* Race start times (from race_time_descriptors), all UTC */
+    bool repeating;             /* Sessions every repeat_minutes */
+    unsigned char day_mask;     /* Session days, bit 0 = start_date's day; 0 = all */
+    int first_session_mins;     /* First start, minutes after 00:00 */
+    int repeat_minutes;         /* Interval between repeating starts */
+    int session_time_count;
+    time_t session_times[IRA_MAX_SESSION_TIMES];    /* Fixed starts when not repeating */
+
+    /* Display, usually the same pooled strings as the track's */
+    const char *track_name;
+    const char *config_name;
 } ira_schedule_week;
 
 /*
@@ -139,24 +162,25 @@ typedef struct {
 typedef struct {
     int season_id;
     int series_id;
-    char season_name[128];
-    char short_name[64];
-    int season_year;
-    int season_quarter;         /* 1-4 */
     bool fixed_setup;
     bool official;
     bool active;
     bool complete;
     license_level license_group;
-    int max_weeks;
     int current_week;
+    /* Embedded schedule */
+    ira_schedule_week *schedule;
+    int schedule_count;
+    int max_weeks;
+    int season_year;
+    int season_quarter;         /* 1-4 */
     bool multiclass;
     bool has_supersessions;
     int car_class_ids[8];
     int car_class_count;
-    /* Embedded schedule */
-    ira_schedule_week *schedule;
-    int schedule_count;
+    /* Display */
+    const char *season_name;
+    const char *short_name;
 } ira_season;
 
 /*
@@ -210,6 +234,12 @@ license_level string_to_license(const char *str);
 /* Check if a category is active (non-legacy) */
 bool category_is_active(race_category cat);
 
+/*
+ * Parse an ISO 8601 date or date-time ("2026-03-10", "2026-03-14T17:00:00Z")
+ * as UTC. Returns 0 if the string is not a date.
+ */
+time_t parse_utc_timestamp(const char *str);
+
 /*
  * Memory management
  */
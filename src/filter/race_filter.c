@@ -10,7 +10,15 @@
 #include <stdio.h>
 #include <time.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include "race_filter.h"
+#include "race_schedule.h"
 
 #define INITIAL_CAPACITY 64
 
@@ -158,119 +166,249 @@ static bool owns_any_car(ira_database *db, ira_schedule_week *week)
 }
 
 /*
- * Check a single race week against filter criteria
+ * Filter compilation
  */
-filter_match_flags filter_check_week(
-    ira_database *db,
-    ira_season *season,
-    ira_schedule_week *week)
-{
-    if (!db || !season || !week) return MATCH_RETIRED;
 
-    ira_filter *filter = &db->filter;
-    filter_match_flags flags = MATCH_OK;
+#define BITSET_WORD_BITS 32
 
-    /* Get related data */
-    ira_series *series = database_get_series(db, season->series_id);
-    ira_track *track = database_get_track(db, week->track_id);
+/* Flag if cond holds, without a branch */
+#define FLAG_IF(cond, flag) ((filter_match_flags)(-(int)(cond) & (flag)))
 
-    /* Check if content is retired */
-    if (track && track->retired) {
-        flags |= MATCH_RETIRED;
-    }
+/* Build a bitset from an ID list. Negative IDs are ignored. */
+static bool build_id_bitset(const int *ids, int count, unsigned int **words, int *max_id)
+{
+    *words = NULL;
+    *max_id = -1;
 
-    /* Check series exclusion */
-    if (filter_series_excluded(filter, season->series_id)) {
-        flags |= MATCH_SERIES_EXCLUDED;
+    for (int i = 0; i < count; i++) {
+        if (ids[i] > *max_id) *max_id = ids[i];
     }
+    if (*max_id < 0) return true;
 
-    /* Check track exclusion */
-    if (filter_track_excluded(filter, week->track_id)) {
-        flags |= MATCH_TRACK_EXCLUDED;
+    *words = calloc((size_t)*max_id / BITSET_WORD_BITS + 1, sizeof(unsigned int));
+    if (!*words) {
+        *max_id = -1;
+        return false;
     }
 
-    /* Check category */
-    race_category cat = CATEGORY_UNKNOWN;
-    if (series) {
-        cat = series->category;
-    } else if (track) {
-        cat = track->category;
+    for (int i = 0; i < count; i++) {
+        if (ids[i] >= 0) {
+            (*words)[ids[i] / BITSET_WORD_BITS] |= 1u << (ids[i] % BITSET_WORD_BITS);
+        }
     }
+    return true;
+}
 
-    if (!filter_has_category(filter, cat)) {
-        flags |= MATCH_WRONG_CATEGORY;
-    }
+static inline bool bitset_has(const unsigned int *words, int max_id, int id)
+{
+    return id >= 0 && id <= max_id &&
+           (words[id / BITSET_WORD_BITS] >> (id % BITSET_WORD_BITS)) & 1u;
+}
+
+bool filter_compile(const ira_filter *filter, filter_compiled *compiled)
+{
+    if (!filter || !compiled) return false;
+
+    memset(compiled, 0, sizeof(*compiled));
 
-    /* Check license level */
-    if (series) {
-        if (series->min_license < filter->min_license ||
-            series->min_license > filter->max_license) {
-            flags |= MATCH_WRONG_LICENSE;
+    /* No categories specified = all categories allowed */
+    if (filter->category_count == 0) {
+        compiled->category_mask = ~0u;
+    }
+    for (int i = 0; i < filter->category_count; i++) {
+        race_category cat = filter->categories[i];
+        if ((unsigned int)cat < BITSET_WORD_BITS) {
+            compiled->category_mask |= 1u << cat;
         }
-    } else if (season->license_group != 0) {
-        if (season->license_group < (int)filter->min_license ||
-            season->license_group > (int)filter->max_license) {
-            flags |= MATCH_WRONG_LICENSE;
+
+        /* Handle legacy road -> sports_car/formula mapping */
+        if (cat == CATEGORY_ROAD) {
+            compiled->category_mask |= (1u << CATEGORY_SPORTS_CAR) | (1u << CATEGORY_FORMULA);
         }
     }
 
-    /* Check setup type */
-    if (filter->fixed_setup_only && !season->fixed_setup) {
-        flags |= MATCH_WRONG_SETUP;
+    compiled->min_license = (int)filter->min_license;
+    compiled->max_license = (int)filter->max_license;
+    compiled->min_race_mins = filter->min_race_mins;
+    compiled->max_race_mins = filter->max_race_mins;
+    compiled->owned_content_only = filter->owned_content_only;
+    compiled->fixed_setup_only = filter->fixed_setup_only;
+    compiled->open_setup_only = filter->open_setup_only;
+    compiled->official_only = filter->official_only;
+
+    /* Empty sets until built */
+    compiled->excluded_series_max = -1;
+    compiled->excluded_tracks_max = -1;
+
+    bool ok = true;
+    if (filter->excluded_series) {
+        ok = build_id_bitset(filter->excluded_series, filter->excluded_series_count,
+                             &compiled->excluded_series, &compiled->excluded_series_max);
     }
-    if (filter->open_setup_only && season->fixed_setup) {
-        flags |= MATCH_WRONG_SETUP;
+    if (ok && filter->excluded_tracks) {
+        ok = build_id_bitset(filter->excluded_tracks, filter->excluded_track_count,
+                             &compiled->excluded_tracks, &compiled->excluded_tracks_max);
     }
 
-    /* Check official status */
-    if (filter->official_only && !season->official) {
-        flags |= MATCH_NOT_OFFICIAL;
+    if (!ok) {
+        filter_compiled_free(compiled);
+        return false;
     }
+    return true;
+}
+
+void filter_compiled_free(filter_compiled *compiled)
+{
+    if (!compiled) return;
+
+    free(compiled->excluded_series);
+    free(compiled->excluded_tracks);
+    compiled->excluded_series = NULL;
+    compiled->excluded_tracks = NULL;
+    compiled->excluded_series_max = -1;
+    compiled->excluded_tracks_max = -1;
+}
 
-    /* Check race duration */
+/* Category comes from the series, falling back to the track */
+static race_category week_category(const ira_series *series, const ira_track *track)
+{
+    return series ? series->category : (track ? track->category : CATEGORY_UNKNOWN);
+}
+
+static bool category_allowed(const filter_compiled *cf, race_category cat)
+{
+    return (unsigned int)cat < BITSET_WORD_BITS
+               ? (cf->category_mask >> cat) & 1u
+               : cf->category_mask == ~0u;
+}
+
+/* License from the series, else the season's license group (0 = unknown) */
+static bool license_allowed(const filter_compiled *cf, const ira_series *series,
+                            const ira_season *season)
+{
+    if (!series && season->license_group == 0) return true;
+
+    int license = series ? (int)series->min_license : (int)season->license_group;
+    return license >= cf->min_license && license <= cf->max_license;
+}
+
+/*
+ * Internal: check a week and report ownership, which the caller also
+ * needs for the result entry. Ownership uses the database bitsets.
+ */
+static filter_match_flags check_week(
+    ira_database *db,
+    const filter_compiled *cf,
+    ira_season *season,
+    ira_schedule_week *week,
+    bool *owns_car,
+    bool *owns_track)
+{
+    /* Get related data */
+    ira_series *series = database_get_series(db, season->series_id);
+    ira_track *track = database_get_track(db, week->track_id);
+
+    /* Estimate lap-based race duration (rough estimate, ~2 min per lap) */
     int duration = week->race_time_limit_mins;
     if (duration == 0 && week->race_lap_limit > 0) {
-        /* Estimate lap-based race duration (rough estimate) */
-        duration = week->race_lap_limit * 2;  /* ~2 min per lap average */
+        duration = week->race_lap_limit * 2;
     }
 
-    if (filter->min_race_mins > 0 && duration > 0 && duration < filter->min_race_mins) {
-        flags |= MATCH_TOO_SHORT;
-    }
-    if (filter->max_race_mins > 0 && duration > 0 && duration > filter->max_race_mins) {
-        flags |= MATCH_TOO_LONG;
-    }
+    *owns_track = database_owns_track(db, week->track_id);
+    *owns_car = owns_any_car(db, week);
 
-    /* Check ownership (only if filter requires it) */
-    if (filter->owned_content_only) {
-        if (!database_owns_track(db, week->track_id)) {
-            flags |= MATCH_NO_TRACK;
-        }
-        if (!owns_any_car(db, week)) {
-            flags |= MATCH_NO_CAR;
-        }
-    }
+    filter_match_flags flags = MATCH_OK;
+    flags |= FLAG_IF(track && track->retired, MATCH_RETIRED);
+    flags |= FLAG_IF(bitset_has(cf->excluded_series, cf->excluded_series_max, season->series_id),
+                     MATCH_SERIES_EXCLUDED);
+    flags |= FLAG_IF(bitset_has(cf->excluded_tracks, cf->excluded_tracks_max, week->track_id),
+                     MATCH_TRACK_EXCLUDED);
+    flags |= FLAG_IF(!category_allowed(cf, week_category(series, track)), MATCH_WRONG_CATEGORY);
+    flags |= FLAG_IF(!license_allowed(cf, series, season), MATCH_WRONG_LICENSE);
+    flags |= FLAG_IF((cf->fixed_setup_only && !season->fixed_setup) ||
+                     (cf->open_setup_only && season->fixed_setup), MATCH_WRONG_SETUP);
+    flags |= FLAG_IF(cf->official_only && !season->official, MATCH_NOT_OFFICIAL);
+    flags |= FLAG_IF(cf->min_race_mins > 0 && duration > 0 && duration < cf->min_race_mins,
+                     MATCH_TOO_SHORT);
+    flags |= FLAG_IF(cf->max_race_mins > 0 && duration > 0 && duration > cf->max_race_mins,
+                     MATCH_TOO_LONG);
+    flags |= FLAG_IF(cf->owned_content_only && !*owns_track, MATCH_NO_TRACK);
+    flags |= FLAG_IF(cf->owned_content_only && !*owns_car, MATCH_NO_CAR);
 
     return flags;
 }
 
+filter_match_flags filter_check_week_compiled(
+    ira_database *db,
+    const filter_compiled *compiled,
+    ira_season *season,
+    ira_schedule_week *week)
+{
+    if (!db || !compiled || !season || !week) return MATCH_RETIRED;
+
+    bool owns_car, owns_track;
+    return check_week(db, compiled, season, week, &owns_car, &owns_track);
+}
+
 /*
- * Apply filter to a single season
+ * Check a single race week against filter criteria
  */
-bool filter_season(ira_database *db, ira_season *season, filter_results *results)
+filter_match_flags filter_check_week(
+    ira_database *db,
+    ira_season *season,
+    ira_schedule_week *week)
 {
-    if (!db || !season || !results) return false;
+    if (!db || !season || !week) return MATCH_RETIRED;
+
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return MATCH_RETIRED;
+
+    filter_match_flags flags = filter_check_week_compiled(db, &compiled, season, week);
+    filter_compiled_free(&compiled);
+    return flags;
+}
+
+/*
+ * Internal: add a result to the statistics
+ */
+static void count_match(filter_results *results, filter_match_flags match)
+{
+    if (match == MATCH_OK) {
+        results->passed_count++;
+    } else {
+        if (match & (MATCH_NO_CAR | MATCH_NO_TRACK)) {
+            results->failed_ownership++;
+        } else if (match & MATCH_WRONG_CATEGORY) {
+            results->failed_category++;
+        } else if (match & MATCH_WRONG_LICENSE) {
+            results->failed_license++;
+        } else {
+            results->failed_other++;
+        }
+    }
+}
 
+/* The week a season is filtered on, or NULL if it has none */
+static ira_schedule_week *filtered_week(ira_season *season)
+{
     /* Only filter the current week (or all weeks if desired) */
     int week_idx = season->current_week;
     if (week_idx < 0 || week_idx >= season->schedule_count) {
-        return true;  /* No current week data */
+        return NULL;  /* No current week data */
     }
+    return &season->schedule[week_idx];
+}
 
-    ira_schedule_week *week = &season->schedule[week_idx];
-    results->total_checked++;
+/*
+ * Internal: filter a season's current week with a compiled filter
+ */
+static void season_compiled(ira_database *db, const filter_compiled *compiled,
+                            ira_season *season, filter_results *results)
+{
+    ira_schedule_week *week = filtered_week(season);
+    if (!week) return;
 
-    filter_match_flags match = filter_check_week(db, season, week);
+    results->total_checked++;
 
     /* Create filtered race entry */
     filtered_race race = {0};
@@ -278,9 +416,7 @@ bool filter_season(ira_database *db, ira_season *season, filter_results *results
     race.week = week;
     race.series = database_get_series(db, season->series_id);
     race.track = database_get_track(db, week->track_id);
-    race.match = match;
-    race.owns_car = owns_any_car(db, week);
-    race.owns_track = database_owns_track(db, week->track_id);
+    race.match = check_week(db, compiled, season, week, &race.owns_car, &race.owns_track);
 
     /* Calculate duration */
     if (week->race_time_limit_mins > 0) {
@@ -293,23 +429,24 @@ bool filter_season(ira_database *db, ira_season *season, filter_results *results
     race.next_race_time = filter_next_race_time(season, week);
 
     /* Update statistics */
-    if (match == MATCH_OK) {
-        results->passed_count++;
-    } else {
-        if (match & (MATCH_NO_CAR | MATCH_NO_TRACK)) {
-            results->failed_ownership++;
-        } else if (match & MATCH_WRONG_CATEGORY) {
-            results->failed_category++;
-        } else if (match & MATCH_WRONG_LICENSE) {
-            results->failed_license++;
-        } else {
-            results->failed_other++;
-        }
-    }
+    count_match(results, race.match);
 
     /* Add to results (include failed ones for "show all" mode) */
     add_race(results, &race);
+}
 
+/*
+ * Apply filter to a single season
+ */
+bool filter_season(ira_database *db, ira_season *season, filter_results *results)
+{
+    if (!db || !season || !results) return false;
+
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return false;
+
+    season_compiled(db, &compiled, season, results);
+    filter_compiled_free(&compiled);
     return true;
 }
 
@@ -322,18 +459,183 @@ bool filter_apply(ira_database *db, filter_results *results)
 
     filter_results_clear(results);
 
+    /* Compile once for the whole season list */
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return false;
+
     for (int i = 0; i < db->season_count; i++) {
         ira_season *season = &db->seasons[i];
 
         /* Skip inactive/complete seasons */
         if (!season->active || season->complete) continue;
 
-        filter_season(db, season, results);
+        season_compiled(db, &compiled, season, results);
     }
 
+    filter_compiled_free(&compiled);
+    return true;
+}
+
+/*
+ * Parallel filtering
+ */
+
+/* One contiguous slice of db->seasons */
+typedef struct {
+    ira_database *db;
+    const filter_compiled *compiled;
+    int start;
+    int end;
+    filter_results *results;    /* Private to the slice's thread */
+    bool started;
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} filter_slice;
+
+static void filter_slice_run(filter_slice *slice)
+{
+    for (int i = slice->start; i < slice->end; i++) {
+        ira_season *season = &slice->db->seasons[i];
+
+        /* Skip inactive/complete seasons */
+        if (!season->active || season->complete) continue;
+
+        season_compiled(slice->db, slice->compiled, season, slice->results);
+    }
+}
+
+/*
+ * Helper: Run a slice on its own thread. Returns false if none could be started.
+ */
+#ifdef _WIN32
+static DWORD WINAPI filter_slice_proc(LPVOID param)
+{
+    filter_slice_run((filter_slice *)param);
+    return 0;
+}
+
+static bool start_slice(filter_slice *slice)
+{
+    slice->thread = CreateThread(NULL, 0, filter_slice_proc, slice, 0, NULL);
+    slice->started = (slice->thread != NULL);
+    return slice->started;
+}
+
+static void join_slice(filter_slice *slice)
+{
+    WaitForSingleObject(slice->thread, INFINITE);
+    CloseHandle(slice->thread);
+}
+#else
+static void *filter_slice_proc(void *param)
+{
+    filter_slice_run((filter_slice *)param);
+    return NULL;
+}
+
+static bool start_slice(filter_slice *slice)
+{
+    slice->started = (pthread_create(&slice->thread, NULL, filter_slice_proc, slice) == 0);
+    return slice->started;
+}
+
+static void join_slice(filter_slice *slice)
+{
+    pthread_join(slice->thread, NULL);
+}
+#endif
+
+/* Append a slice's results; slices are merged in season order */
+static bool merge_results(filter_results *dst, const filter_results *src)
+{
+    if (!ensure_capacity(dst, src->race_count)) return false;
+
+    memcpy(&dst->races[dst->race_count], src->races, src->race_count * sizeof(filtered_race));
+    dst->race_count += src->race_count;
+
+    dst->total_checked += src->total_checked;
+    dst->passed_count += src->passed_count;
+    dst->failed_ownership += src->failed_ownership;
+    dst->failed_category += src->failed_category;
+    dst->failed_license += src->failed_license;
+    dst->failed_other += src->failed_other;
     return true;
 }
 
+int filter_default_threads(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count < 1) count = 1;
+    if (count > FILTER_MAX_THREADS) count = FILTER_MAX_THREADS;
+    return count;
+}
+
+bool filter_apply_parallel(ira_database *db, filter_results *results, int thread_count)
+{
+    if (!db || !results) return false;
+
+    if (thread_count <= 0) {
+        thread_count = filter_default_threads();
+        if (thread_count > db->season_count / FILTER_MIN_SEASONS_PER_THREAD) {
+            thread_count = db->season_count / FILTER_MIN_SEASONS_PER_THREAD;
+        }
+    }
+    if (thread_count > FILTER_MAX_THREADS) thread_count = FILTER_MAX_THREADS;
+    if (thread_count > db->season_count) thread_count = db->season_count;
+    if (thread_count <= 1) return filter_apply(db, results);
+
+    filter_results_clear(results);
+
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return false;
+
+    filter_slice slices[FILTER_MAX_THREADS];
+    memset(slices, 0, sizeof(slices));
+
+    bool ok = true;
+    for (int i = 0; i < thread_count; i++) {
+        slices[i].db = db;
+        slices[i].compiled = &compiled;
+        slices[i].start = (int)((long long)db->season_count * i / thread_count);
+        slices[i].end = (int)((long long)db->season_count * (i + 1) / thread_count);
+        slices[i].results = filter_results_create();
+        if (!slices[i].results) ok = false;
+    }
+
+    /* Slice 0 runs on this thread; a slice whose thread fails runs here too */
+    for (int i = 1; ok && i < thread_count; i++) {
+        start_slice(&slices[i]);
+    }
+    if (ok) {
+        filter_slice_run(&slices[0]);
+    }
+
+    for (int i = 1; i < thread_count; i++) {
+        if (slices[i].started) {
+            join_slice(&slices[i]);
+        } else if (ok) {
+            filter_slice_run(&slices[i]);
+        }
+    }
+
+    for (int i = 0; i < thread_count; i++) {
+        if (ok && !merge_results(results, slices[i].results)) ok = false;
+        filter_results_destroy(slices[i].results);
+    }
+
+    filter_compiled_free(&compiled);
+    return ok;
+}
+
 /*
  * Comparison functions for sorting
  */
@@ -343,6 +645,10 @@ static int cmp_by_start_time(const void *a, const void *b)
     const filtered_race *ra = (const filtered_race *)a;
     const filtered_race *rb = (const filtered_race *)b;
 
+    /* Unknown start times (0) sort last */
+    if ((ra->next_race_time == 0) != (rb->next_race_time == 0)) {
+        return ra->next_race_time == 0 ? 1 : -1;
+    }
     if (ra->next_race_time < rb->next_race_time) return -1;
     if (ra->next_race_time > rb->next_race_time) return 1;
     return 0;
@@ -395,6 +701,19 @@ static int cmp_by_duration(const void *a, const void *b)
     return 0;
 }
 
+static int (*sort_comparator(race_sort_order order))(const void *, const void *)
+{
+    switch (order) {
+        case SORT_BY_START_TIME:  return cmp_by_start_time;
+        case SORT_BY_SERIES_NAME: return cmp_by_series_name;
+        case SORT_BY_CATEGORY:    return cmp_by_category;
+        case SORT_BY_LICENSE:     return cmp_by_license;
+        case SORT_BY_DURATION:    return cmp_by_duration;
+        case SORT_BY_POPULARITY:  return cmp_by_start_time;  /* Fallback */
+        default:                  return cmp_by_start_time;
+    }
+}
+
 /*
  * Sort filter results
  */
@@ -402,17 +721,7 @@ void filter_results_sort(filter_results *results, race_sort_order order, bool as
 {
     if (!results || results->race_count < 2) return;
 
-    int (*cmp_func)(const void *, const void *) = NULL;
-
-    switch (order) {
-        case SORT_BY_START_TIME:  cmp_func = cmp_by_start_time; break;
-        case SORT_BY_SERIES_NAME: cmp_func = cmp_by_series_name; break;
-        case SORT_BY_CATEGORY:    cmp_func = cmp_by_category; break;
-        case SORT_BY_LICENSE:     cmp_func = cmp_by_license; break;
-        case SORT_BY_DURATION:    cmp_func = cmp_by_duration; break;
-        case SORT_BY_POPULARITY:  cmp_func = cmp_by_start_time; break;  /* Fallback */
-        default:                  cmp_func = cmp_by_start_time; break;
-    }
+    int (*cmp_func)(const void *, const void *) = sort_comparator(order);
 
     qsort(results->races, results->race_count, sizeof(filtered_race), cmp_func);
 
@@ -427,6 +736,275 @@ void filter_results_sort(filter_results *results, race_sort_order order, bool as
     }
 }
 
+/*
+ * Incremental filtering
+ */
+
+struct filter_incremental {
+    bool valid;
+    filter_compiled compiled;       /* Filter the cached flags were computed with */
+    unsigned int pending;           /* filter_dep bits from invalidate */
+
+    /* Database arrays the cache was built from */
+    const ira_database *db;
+    const ira_season *seasons;
+    int season_count;
+    const ira_series *series;
+    int series_count;
+    const ira_track *tracks;
+    int track_count;
+    const int *owned_cars;
+    int owned_car_count;
+    const int *owned_tracks;
+    int owned_track_count;
+
+    /* Order the results are kept in */
+    bool sorted;
+    race_sort_order order;
+    bool ascending;
+};
+
+filter_incremental *filter_incremental_create(void)
+{
+    filter_incremental *inc = calloc(1, sizeof(filter_incremental));
+    if (!inc) return NULL;
+
+    inc->compiled.excluded_series_max = -1;
+    inc->compiled.excluded_tracks_max = -1;
+    return inc;
+}
+
+void filter_incremental_destroy(filter_incremental *inc)
+{
+    if (!inc) return;
+
+    filter_compiled_free(&inc->compiled);
+    free(inc);
+}
+
+void filter_incremental_invalidate(filter_incremental *inc, unsigned int deps)
+{
+    if (!inc) return;
+    inc->pending |= deps;
+}
+
+static bool bitsets_equal(const unsigned int *a, int a_max, const unsigned int *b, int b_max)
+{
+    int max = a_max > b_max ? a_max : b_max;
+    for (int id = 0; id <= max; id += BITSET_WORD_BITS) {
+        unsigned int wa = id <= a_max ? a[id / BITSET_WORD_BITS] : 0;
+        unsigned int wb = id <= b_max ? b[id / BITSET_WORD_BITS] : 0;
+        if (wa != wb) return false;
+    }
+    return true;
+}
+
+/* Which dependencies differ between two compiled filters */
+static unsigned int filter_changes(const filter_compiled *old, const filter_compiled *cur)
+{
+    unsigned int deps = 0;
+
+    if (old->category_mask != cur->category_mask) {
+        deps |= FILTER_DEP_CATEGORY;
+    }
+    if (old->min_license != cur->min_license || old->max_license != cur->max_license) {
+        deps |= FILTER_DEP_LICENSE;
+    }
+    if (!bitsets_equal(old->excluded_series, old->excluded_series_max,
+                       cur->excluded_series, cur->excluded_series_max) ||
+        !bitsets_equal(old->excluded_tracks, old->excluded_tracks_max,
+                       cur->excluded_tracks, cur->excluded_tracks_max)) {
+        deps |= FILTER_DEP_EXCLUSIONS;
+    }
+    if (old->owned_content_only != cur->owned_content_only) {
+        deps |= FILTER_DEP_OWNERSHIP;
+    }
+    if (old->fixed_setup_only != cur->fixed_setup_only ||
+        old->open_setup_only != cur->open_setup_only ||
+        old->official_only != cur->official_only ||
+        old->min_race_mins != cur->min_race_mins ||
+        old->max_race_mins != cur->max_race_mins) {
+        deps |= FILTER_DEP_OPTIONS;
+    }
+    return deps;
+}
+
+/* Could a change in deps alter this entry's result? */
+static bool entry_affected(const filtered_race *race, unsigned int deps,
+                           const filter_compiled *old, const filter_compiled *cur)
+{
+    if (deps & (FILTER_DEP_OWNERSHIP | FILTER_DEP_OPTIONS | FILTER_DEP_CONTENT)) {
+        return true;
+    }
+
+    if (deps & FILTER_DEP_CATEGORY) {
+        race_category cat = week_category(race->series, race->track);
+        if (category_allowed(old, cat) != category_allowed(cur, cat)) return true;
+    }
+
+    if (deps & FILTER_DEP_LICENSE) {
+        if (license_allowed(old, race->series, race->season) !=
+            license_allowed(cur, race->series, race->season)) {
+            return true;
+        }
+    }
+
+    if (deps & FILTER_DEP_EXCLUSIONS) {
+        int series_id = race->season->series_id;
+        int track_id = race->week->track_id;
+        if (bitset_has(old->excluded_series, old->excluded_series_max, series_id) !=
+            bitset_has(cur->excluded_series, cur->excluded_series_max, series_id) ||
+            bitset_has(old->excluded_tracks, old->excluded_tracks_max, track_id) !=
+            bitset_has(cur->excluded_tracks, cur->excluded_tracks_max, track_id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Do the cached entries still describe the database's current weeks? */
+static bool entries_current(ira_database *db, const filter_results *results)
+{
+    int expected = 0;
+    for (int i = 0; i < db->season_count; i++) {
+        ira_season *season = &db->seasons[i];
+        if (season->active && !season->complete && filtered_week(season)) {
+            expected++;
+        }
+    }
+    if (expected != results->race_count) return false;
+
+    for (int i = 0; i < results->race_count; i++) {
+        const filtered_race *race = &results->races[i];
+        if (race->week != filtered_week(race->season) ||
+            !race->season->active || race->season->complete) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Helper: Insertion sort, linear on the nearly sorted results a refresh
+ * leaves behind
+ */
+static void resort_results(filter_results *results, race_sort_order order, bool ascending)
+{
+    int (*cmp)(const void *, const void *) = sort_comparator(order);
+    int sign = ascending ? 1 : -1;
+
+    for (int i = 1; i < results->race_count; i++) {
+        if (sign * cmp(&results->races[i - 1], &results->races[i]) <= 0) continue;
+
+        filtered_race moving = results->races[i];
+        int j = i;
+        while (j > 0 && sign * cmp(&results->races[j - 1], &moving) > 0) {
+            results->races[j] = results->races[j - 1];
+            j--;
+        }
+        results->races[j] = moving;
+    }
+}
+
+int filter_incremental_update(filter_incremental *inc, ira_database *db,
+                              filter_results *results, race_sort_order order, bool ascending)
+{
+    if (!inc || !db || !results) return -1;
+
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return -1;
+
+    /* Replaced arrays invalidate the entries' pointers */
+    bool rebuild = !inc->valid ||
+                   inc->db != db ||
+                   inc->seasons != db->seasons || inc->season_count != db->season_count ||
+                   inc->series != db->series || inc->series_count != db->series_count ||
+                   inc->tracks != db->tracks || inc->track_count != db->track_count ||
+                   !entries_current(db, results);
+
+    unsigned int deps = inc->pending;
+    if (inc->owned_cars != db->owned.owned_car_ids ||
+        inc->owned_car_count != db->owned.owned_car_count ||
+        inc->owned_tracks != db->owned.owned_track_ids ||
+        inc->owned_track_count != db->owned.owned_track_count) {
+        deps |= FILTER_DEP_OWNERSHIP;
+    }
+
+    int evaluated = 0;
+    bool reorder = false;
+
+    if (rebuild) {
+        filter_results_clear(results);
+        for (int i = 0; i < db->season_count; i++) {
+            ira_season *season = &db->seasons[i];
+
+            /* Skip inactive/complete seasons */
+            if (!season->active || season->complete) continue;
+
+            season_compiled(db, &compiled, season, results);
+        }
+        evaluated = results->race_count;
+        inc->sorted = false;
+    } else {
+        deps |= filter_changes(&inc->compiled, &compiled);
+
+        results->passed_count = 0;
+        results->failed_ownership = 0;
+        results->failed_category = 0;
+        results->failed_license = 0;
+        results->failed_other = 0;
+
+        for (int i = 0; i < results->race_count; i++) {
+            filtered_race *race = &results->races[i];
+
+            if (deps && entry_affected(race, deps, &inc->compiled, &compiled)) {
+                race->match = check_week(db, &compiled, race->season, race->week,
+                                         &race->owns_car, &race->owns_track);
+                evaluated++;
+            }
+
+            /* The clock only moves start times */
+            time_t next = filter_next_race_time(race->season, race->week);
+            if (next != race->next_race_time) {
+                race->next_race_time = next;
+                reorder |= (order == SORT_BY_START_TIME || order == SORT_BY_POPULARITY);
+            }
+
+            count_match(results, race->match);
+        }
+    }
+
+    /* Keep the filter the flags now reflect */
+    filter_compiled_free(&inc->compiled);
+    inc->compiled = compiled;
+    inc->pending = 0;
+    inc->valid = true;
+    inc->db = db;
+    inc->seasons = db->seasons;
+    inc->season_count = db->season_count;
+    inc->series = db->series;
+    inc->series_count = db->series_count;
+    inc->tracks = db->tracks;
+    inc->track_count = db->track_count;
+    inc->owned_cars = db->owned.owned_car_ids;
+    inc->owned_car_count = db->owned.owned_car_count;
+    inc->owned_tracks = db->owned.owned_track_ids;
+    inc->owned_track_count = db->owned.owned_track_count;
+
+    /* A new order needs a full sort; otherwise only fix up what moved */
+    if (!inc->sorted || inc->order != order || inc->ascending != ascending) {
+        filter_results_sort(results, order, ascending);
+    } else if (reorder || (deps & FILTER_DEP_CONTENT)) {
+        resort_results(results, order, ascending);
+    }
+    inc->sorted = true;
+    inc->order = order;
+    inc->ascending = ascending;
+
+    return evaluated;
+}
+
 /*
  * Get human-readable filter failure reason
  */
@@ -448,21 +1026,13 @@ const char *filter_match_to_string(filter_match_flags flags)
 }
 
 /*
- * Calculate next race start time
- * TODO: This needs actual schedule data from the API
+ * Calculate next race start time from the week's race time descriptors
  */
 time_t filter_next_race_time(ira_season *season, ira_schedule_week *week)
 {
     (void)season;
-    (void)week;
-
-    /* For now, return current time as placeholder */
-    /* Real implementation would calculate based on:
-     * - Race start interval (e.g., every 2 hours)
-     * - Current time
-     * - Week start/end dates
-     */
-    return time(NULL);
+
+    return schedule_next_session(week, time(NULL));
 }
 
 /*
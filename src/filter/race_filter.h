@@ -55,7 +55,7 @@ typedef struct {
     ira_track *track;
 
     /* Computed fields */
-    time_t next_race_time;      /* When the next session starts */
+    time_t next_race_time;      /* When the next session starts, 0 if unknown */
     int race_duration_mins;     /* Total race length */
     int registered_count;       /* Number registered (if known) */
     int sof_estimate;           /* Estimated SOF (if known) */
@@ -83,6 +83,27 @@ typedef struct {
     int failed_other;
 } filter_results;
 
+/*
+ * Compiled filter - ira_filter flattened for fast per-week checks.
+ * Category and exclusion lists become bitsets, so each check is a few
+ * bit tests. Compile again whenever the ira_filter changes.
+ */
+typedef struct {
+    unsigned int category_mask;     /* Bit per race_category allowed */
+    unsigned int *excluded_series;  /* Bitset by series ID */
+    int excluded_series_max;        /* Highest ID covered */
+    unsigned int *excluded_tracks;  /* Bitset by track ID */
+    int excluded_tracks_max;
+    int min_license;
+    int max_license;
+    int min_race_mins;
+    int max_race_mins;
+    bool owned_content_only;
+    bool fixed_setup_only;
+    bool open_setup_only;
+    bool official_only;
+} filter_compiled;
+
 /*
  * Lifecycle
  */
@@ -103,6 +124,27 @@ void filter_results_clear(filter_results *results);
 /* Apply filter to all seasons in database, populates results */
 bool filter_apply(ira_database *db, filter_results *results);
 
+/* Upper bound on filter_apply_parallel threads */
+#define FILTER_MAX_THREADS 16
+
+/*
+ * Seasons each thread must get before the default thread count adds it.
+ * A season filters in well under a microsecond, so a full catalog of a
+ * few hundred seasons is faster serial than paying for thread startup.
+ */
+#define FILTER_MIN_SEASONS_PER_THREAD 256
+
+/*
+ * Apply filter with the seasons split across thread_count threads
+ * (0 = one per CPU, capped at FILTER_MAX_THREADS and by
+ * FILTER_MIN_SEASONS_PER_THREAD, so small catalogs run serially).
+ * Results, including their order, are the same as filter_apply.
+ */
+bool filter_apply_parallel(ira_database *db, filter_results *results, int thread_count);
+
+/* Thread count filter_apply_parallel uses for 0 */
+int filter_default_threads(void);
+
 /* Apply filter to a single season */
 bool filter_season(ira_database *db, ira_season *season, filter_results *results);
 
@@ -113,6 +155,60 @@ filter_match_flags filter_check_week(
     ira_schedule_week *week
 );
 
+/* Compile a filter. Returns false on allocation failure. */
+bool filter_compile(const ira_filter *filter, filter_compiled *compiled);
+
+/* Free a compiled filter's bitsets */
+void filter_compiled_free(filter_compiled *compiled);
+
+/* filter_check_week against an already compiled filter */
+filter_match_flags filter_check_week_compiled(
+    ira_database *db,
+    const filter_compiled *compiled,
+    ira_season *season,
+    ira_schedule_week *week
+);
+
+/*
+ * Incremental filtering
+ *
+ * Keeps a filter_results up to date across calls, re-checking only the
+ * entries a change can affect. Filter edits and replaced owned lists are
+ * detected by comparing against the previous call; replaced catalog or
+ * season arrays, or a week rollover, rebuild everything.
+ */
+
+/* Dependencies a cached result can be invalidated by */
+typedef enum {
+    FILTER_DEP_OWNERSHIP  = (1 << 0),  /* Owned content */
+    FILTER_DEP_CATEGORY   = (1 << 1),  /* Category selection */
+    FILTER_DEP_LICENSE    = (1 << 2),  /* License range */
+    FILTER_DEP_EXCLUSIONS = (1 << 3),  /* Excluded series/tracks */
+    FILTER_DEP_OPTIONS    = (1 << 4),  /* Setup, official and duration limits */
+    FILTER_DEP_CONTENT    = (1 << 5),  /* Series/track/season data edited in place */
+    FILTER_DEP_ALL        = 0x3f
+} filter_dep;
+
+/* Incremental filter cache (opaque type) */
+typedef struct filter_incremental filter_incremental;
+
+/* Create an empty cache. Returns NULL on allocation failure. */
+filter_incremental *filter_incremental_create(void);
+
+/* Free a cache (not the results it maintains) */
+void filter_incremental_destroy(filter_incremental *inc);
+
+/* Mark entries stale for changes the cache cannot see (filter_dep bits) */
+void filter_incremental_invalidate(filter_incremental *inc, unsigned int deps);
+
+/*
+ * Bring results up to date with db and keep them in the given order.
+ * results must only be modified through this cache between calls.
+ * Returns the number of entries re-evaluated, or -1 on error.
+ */
+int filter_incremental_update(filter_incremental *inc, ira_database *db,
+                              filter_results *results, race_sort_order order, bool ascending);
+
 /*
  * Sorting
  */
@@ -136,7 +232,7 @@ bool filter_series_excluded(ira_filter *filter, int series_id);
 /* Check if a track is excluded */
 bool filter_track_excluded(ira_filter *filter, int track_id);
 
-/* Calculate next race start time for a series (based on schedule intervals) */
+/* Next race start for a week (from its schedule intervals), 0 if none */
 time_t filter_next_race_time(ira_season *season, ira_schedule_week *week);
 
 /*
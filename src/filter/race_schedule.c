@@ -0,0 +1,297 @@
+/*
+ * ira - iRacing Application
+ * Race Schedule Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "race_schedule.h"
+
+#define SECONDS_PER_DAY 86400
+#define WEEK_SECONDS    (7 * SECONDS_PER_DAY)
+
+/*
+ * Heap entry. In the schedule heap, node is unused; in a query's
+ * candidate heap it is the schedule heap position the entry came from,
+ * or -1 for a later session of an already visited week.
+ */
+typedef struct {
+    time_t start;
+    int season;
+    int week;
+    int node;
+} sched_entry;
+
+struct race_schedule {
+    sched_entry *heap;
+    int count;
+    int capacity;
+
+    /* Season list the heap indexes into */
+    const ira_season *seasons;
+    int season_count;
+    bool built;
+};
+
+/*
+ * Session times
+ */
+
+time_t schedule_next_session(const ira_schedule_week *week, time_t after)
+{
+    if (!week) return 0;
+
+    /* Fixed start times */
+    if (!week->repeating) {
+        time_t best = 0;
+        for (int i = 0; i < week->session_time_count; i++) {
+            time_t t = week->session_times[i];
+            if (t >= after && (best == 0 || t < best)) best = t;
+        }
+        return best;
+    }
+
+    if (week->start_date == 0) return 0;
+
+    time_t end = week->end_date > week->start_date ? week->end_date
+                                                   : week->start_date + WEEK_SECONDS;
+    if (after >= end) return 0;
+
+    long long first_day = after > week->start_date
+                              ? (long long)(after - week->start_date) / SECONDS_PER_DAY : 0;
+    long long days = ((long long)(end - week->start_date) + SECONDS_PER_DAY - 1) / SECONDS_PER_DAY;
+
+    for (long long day = first_day; day < days; day++) {
+        if (week->day_mask && !((week->day_mask >> (day % 7)) & 1u)) continue;
+
+        time_t day_start = week->start_date + (time_t)(day * SECONDS_PER_DAY);
+        time_t first = day_start + (time_t)week->first_session_mins * 60;
+        time_t t;
+
+        if (after <= first) {
+            t = first;
+        } else if (week->repeat_minutes > 0) {
+            long long step = (long long)week->repeat_minutes * 60;
+            t = first + (time_t)((((long long)(after - first)) + step - 1) / step * step);
+            if (t >= day_start + SECONDS_PER_DAY) continue;
+        } else {
+            continue;
+        }
+
+        return t < end ? t : 0;
+    }
+
+    return 0;
+}
+
+/*
+ * Heap helpers
+ */
+
+static bool entry_before(const sched_entry *a, const sched_entry *b)
+{
+    if (a->start != b->start) return a->start < b->start;
+
+    /* Equal starts: keep season order for a stable listing */
+    if (a->season != b->season) return a->season < b->season;
+    return a->week < b->week;
+}
+
+static void sift_up(sched_entry *heap, int pos)
+{
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!entry_before(&heap[pos], &heap[parent])) break;
+
+        sched_entry tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+static void sift_down(sched_entry *heap, int count, int pos)
+{
+    for (;;) {
+        int left = pos * 2 + 1;
+        int right = left + 1;
+        int smallest = pos;
+
+        if (left < count && entry_before(&heap[left], &heap[smallest])) smallest = left;
+        if (right < count && entry_before(&heap[right], &heap[smallest])) smallest = right;
+        if (smallest == pos) break;
+
+        sched_entry tmp = heap[pos];
+        heap[pos] = heap[smallest];
+        heap[smallest] = tmp;
+        pos = smallest;
+    }
+}
+
+static bool heap_push(sched_entry **heap, int *count, int *capacity, const sched_entry *entry)
+{
+    if (*count >= *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 64;
+        sched_entry *grown = realloc(*heap, new_capacity * sizeof(sched_entry));
+        if (!grown) return false;
+        *heap = grown;
+        *capacity = new_capacity;
+    }
+
+    (*heap)[*count] = *entry;
+    sift_up(*heap, (*count)++);
+    return true;
+}
+
+static sched_entry heap_pop(sched_entry *heap, int *count)
+{
+    sched_entry top = heap[0];
+    heap[0] = heap[--(*count)];
+    sift_down(heap, *count, 0);
+    return top;
+}
+
+/*
+ * Lifecycle
+ */
+
+race_schedule *race_schedule_create(void)
+{
+    return calloc(1, sizeof(race_schedule));
+}
+
+void race_schedule_destroy(race_schedule *sched)
+{
+    if (!sched) return;
+
+    free(sched->heap);
+    free(sched);
+}
+
+bool race_schedule_build(race_schedule *sched, ira_database *db, time_t now)
+{
+    if (!sched || !db) return false;
+
+    sched->count = 0;
+    sched->built = false;
+
+    for (int i = 0; i < db->season_count; i++) {
+        const ira_season *season = &db->seasons[i];
+
+        /* Skip inactive/complete seasons */
+        if (!season->active || season->complete) continue;
+
+        for (int j = 0; j < season->schedule_count; j++) {
+            time_t start = schedule_next_session(&season->schedule[j], now);
+            if (start == 0) continue;
+
+            sched_entry entry = { start, i, j, 0 };
+            if (!heap_push(&sched->heap, &sched->count, &sched->capacity, &entry)) {
+                return false;
+            }
+        }
+    }
+
+    sched->seasons = db->seasons;
+    sched->season_count = db->season_count;
+    sched->built = true;
+    return true;
+}
+
+bool race_schedule_stale(const race_schedule *sched, const ira_database *db)
+{
+    return !sched || !db || !sched->built ||
+           sched->seasons != db->seasons || sched->season_count != db->season_count;
+}
+
+/*
+ * Helper: Move every entry that has already started on to its week's
+ * next session, dropping weeks with none left
+ */
+static void advance(race_schedule *sched, ira_database *db, time_t now)
+{
+    while (sched->count > 0 && sched->heap[0].start < now) {
+        sched_entry *top = &sched->heap[0];
+        ira_schedule_week *week = &db->seasons[top->season].schedule[top->week];
+
+        time_t next = schedule_next_session(week, now);
+        if (next) {
+            top->start = next;
+            sift_down(sched->heap, sched->count, 0);
+        } else {
+            heap_pop(sched->heap, &sched->count);
+        }
+    }
+}
+
+/*
+ * Queries
+ */
+
+int race_schedule_next(race_schedule *sched, ira_database *db, const filter_compiled *compiled,
+                       time_t now, int horizon_secs, scheduled_race *out, int max_out)
+{
+    if (!sched || !db || (!out && max_out > 0)) return -1;
+
+    if (race_schedule_stale(sched, db) && !race_schedule_build(sched, db, now)) {
+        return -1;
+    }
+    advance(sched, db, now);
+
+    /*
+     * Walk the schedule heap in order without modifying it: a candidate
+     * heap holds the frontier of unvisited nodes, plus the following
+     * session of each matching week visited so far.
+     */
+    time_t limit = now + horizon_secs;
+    sched_entry *cand = NULL;
+    int cand_count = 0;
+    int cand_capacity = 0;
+    int found = 0;
+    bool ok = true;
+
+    if (sched->count > 0) {
+        sched_entry root = sched->heap[0];
+        root.node = 0;
+        ok = heap_push(&cand, &cand_count, &cand_capacity, &root);
+    }
+
+    while (ok && found < max_out && cand_count > 0) {
+        sched_entry c = heap_pop(cand, &cand_count);
+        if (c.start > limit) break;
+
+        /* Expose this node's children in the schedule heap */
+        if (c.node >= 0) {
+            for (int child = c.node * 2 + 1; ok && child <= c.node * 2 + 2; child++) {
+                if (child >= sched->count) break;
+                sched_entry next = sched->heap[child];
+                next.node = child;
+                ok = heap_push(&cand, &cand_count, &cand_capacity, &next);
+            }
+        }
+
+        ira_season *season = &db->seasons[c.season];
+        ira_schedule_week *week = &season->schedule[c.week];
+        if (compiled && filter_check_week_compiled(db, compiled, season, week) != MATCH_OK) {
+            continue;
+        }
+
+        out[found].start_time = c.start;
+        out[found].season = season;
+        out[found].week = week;
+        found++;
+
+        /* Later sessions of the same week */
+        time_t following = schedule_next_session(week, c.start + 1);
+        if (ok && following && following <= limit) {
+            sched_entry later = { following, c.season, c.week, -1 };
+            ok = heap_push(&cand, &cand_count, &cand_capacity, &later);
+        }
+    }
+
+    free(cand);
+    return ok ? found : -1;
+}
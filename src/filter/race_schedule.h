@@ -0,0 +1,65 @@
+/*
+ * ira - iRacing Application
+ * Race Schedule - time-ordered index of upcoming race sessions
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_RACE_SCHEDULE_H
+#define IRA_RACE_SCHEDULE_H
+
+#include <stdbool.h>
+#include <time.h>
+
+#include "../data/models.h"
+#include "../data/database.h"
+#include "race_filter.h"
+
+/*
+ * An upcoming race session
+ */
+typedef struct {
+    time_t start_time;
+    ira_season *season;
+    ira_schedule_week *week;
+} scheduled_race;
+
+/*
+ * Race schedule (opaque type)
+ * A min-heap holding each schedule week's next session start. Entries
+ * are advanced past the current time lazily, when queried.
+ */
+typedef struct race_schedule race_schedule;
+
+/*
+ * Start of the first session of a week at or after "after", or 0 if the
+ * week has no later session (or no start time data).
+ */
+time_t schedule_next_session(const ira_schedule_week *week, time_t after);
+
+/* Create an empty schedule. Returns NULL on allocation failure. */
+race_schedule *race_schedule_create(void);
+
+/* Free a schedule */
+void race_schedule_destroy(race_schedule *sched);
+
+/*
+ * Index every active season's weeks with a session at or after now.
+ * Call again after the season list is replaced. Returns false on
+ * allocation failure.
+ */
+bool race_schedule_build(race_schedule *sched, ira_database *db, time_t now);
+
+/* True if db's season list is not the one the schedule was built from */
+bool race_schedule_stale(const race_schedule *sched, const ira_database *db);
+
+/*
+ * Find the next races starting in [now, now + horizon_secs], soonest
+ * first. Only weeks passing compiled are returned (NULL = all). Each
+ * result costs O(log n). Returns the number of races written to out,
+ * or -1 on error.
+ */
+int race_schedule_next(race_schedule *sched, ira_database *db, const filter_compiled *compiled,
+                       time_t now, int horizon_secs, scheduled_race *out, int max_out);
+
+#endif /* IRA_RACE_SCHEDULE_H */
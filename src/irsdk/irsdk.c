@@ -11,11 +11,13 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <time.h>
 
 #include "irsdk.h"
+#include "../util/stats.h"
 
 /* Link required Windows libraries */
 #pragma comment(lib, "winmm")
@@ -30,14 +32,50 @@ static const irsdk_Header *g_header = NULL;
 static int g_last_tick_count = INT_MAX;
 static bool g_is_initialized = false;
 
+/*
+ * Variable layout tracking. The quick key is compared every tick; the
+ * variable headers are only hashed again when it changes.
+ */
+static int g_layout_serial = 0;
+static int g_layout_key[4];
+static unsigned int g_layout_hash = 0;
+static bool g_layout_known = false;
+
+typedef struct {
+    irsdk_layout_fn fn;
+    void *user;
+} layout_listener;
+
+static layout_listener g_layout_listeners[IRSDK_MAX_LAYOUT_LISTENERS];
+static int g_layout_listener_count = 0;
+
 static const double TIMEOUT_SECONDS = 30.0;
 static time_t g_last_valid_time = 0;
 
+/*
+ * File replay. g_shared_mem is the mapped .ibt file and g_header a copy of
+ * its header whose single var_buf walks the recorded rows; everything
+ * else reads through them exactly as it does for live data.
+ */
+static bool g_file_mode = false;
+static HANDLE g_file = INVALID_HANDLE_VALUE;
+static irsdk_Header g_file_header;
+static irsdk_replay_pace g_file_pace = IRSDK_REPLAY_FAST;
+static int g_file_rows = 0;
+static int g_file_first_row = 0;    /* buf_offset of row 0 */
+static int g_file_row = -1;         /* Row published, -1 = none yet */
+static LARGE_INTEGER g_file_start;  /* When row 0 was published */
+static double g_file_counts_per_row = 0.0;
+
 /*
  * Initialize connection to iRacing
  */
 bool irsdk_startup(void)
 {
+    if (g_file_mode) {
+        return g_is_initialized;
+    }
+
     if (!g_mem_map_file) {
         g_mem_map_file = OpenFileMappingA(FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
         g_last_tick_count = INT_MAX;
@@ -48,6 +86,7 @@ bool irsdk_startup(void)
             g_shared_mem = (const char *)MapViewOfFile(g_mem_map_file, FILE_MAP_READ, 0, 0, 0);
             g_header = (const irsdk_Header *)g_shared_mem;
             g_last_tick_count = INT_MAX;
+            memset(g_layout_key, 0, sizeof(g_layout_key));
         }
 
         if (g_shared_mem) {
@@ -84,6 +123,12 @@ void irsdk_shutdown(void)
         CloseHandle(g_mem_map_file);
     }
 
+    if (g_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(g_file);
+    }
+    g_file = INVALID_HANDLE_VALUE;
+    g_file_mode = false;
+
     g_data_valid_event = NULL;
     g_shared_mem = NULL;
     g_header = NULL;
@@ -93,44 +138,313 @@ void irsdk_shutdown(void)
     g_last_tick_count = INT_MAX;
 }
 
+/*
+ * Helper: Check every variable of an .ibt lies inside a row, so the
+ * accessors can trust header offsets as they do the sim's
+ */
+static bool file_vars_valid(const irsdk_Header *disk)
+{
+    const irsdk_VarHeader *vars =
+        (const irsdk_VarHeader *)((const char *)disk + disk->var_header_offset);
+
+    for (int i = 0; i < disk->num_vars; i++) {
+        const irsdk_VarHeader *var = &vars[i];
+        if (var->type < 0 || var->type >= IRSDK_TYPE_COUNT ||
+            var->count <= 0 || var->offset < 0 ||
+            var->offset + (long long)var->count * irsdk_var_type_bytes[var->type] > disk->buf_len) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Replay an .ibt file
+ */
+bool irsdk_startup_file(const char *path, irsdk_replay_pace pace)
+{
+    if (!path) {
+        return false;
+    }
+    irsdk_shutdown();
+
+    g_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (g_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(g_file, &size) ||
+        size.QuadPart < (LONGLONG)(sizeof(irsdk_Header) + sizeof(irsdk_DiskSubHeader)) ||
+        size.QuadPart > INT_MAX) {
+        irsdk_shutdown();
+        return false;
+    }
+
+    g_mem_map_file = CreateFileMappingA(g_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    g_shared_mem = g_mem_map_file ?
+        (const char *)MapViewOfFile(g_mem_map_file, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!g_shared_mem) {
+        irsdk_shutdown();
+        return false;
+    }
+
+    /* Check the layout fits inside the file before trusting any offset */
+    const irsdk_Header *disk = (const irsdk_Header *)g_shared_mem;
+    const irsdk_DiskSubHeader *sub = (const irsdk_DiskSubHeader *)(disk + 1);
+    long long file_size = size.QuadPart;
+    long long first_row = disk->var_buf[0].buf_offset;
+
+    if (disk->ver != IRSDK_VER || disk->num_vars <= 0 || disk->buf_len <= 0 ||
+        disk->tick_rate <= 0 || disk->var_header_offset < 0 ||
+        disk->var_header_offset + (long long)disk->num_vars * (long long)sizeof(irsdk_VarHeader) > file_size ||
+        disk->session_info_offset < 0 ||
+        disk->session_info_offset + (long long)disk->session_info_len > file_size ||
+        first_row <= 0 || first_row > file_size ||
+        !file_vars_valid(disk)) {
+        irsdk_shutdown();
+        return false;
+    }
+
+    /* The record count is 0 in files whose recording was cut short */
+    long long rows = (file_size - first_row) / disk->buf_len;
+    if (sub->session_record_count > 0 && sub->session_record_count < rows) {
+        rows = sub->session_record_count;
+    }
+
+    g_file_header = *disk;
+    g_file_header.status = IRSDK_ST_CONNECTED;
+    g_file_header.num_buf = 1;
+    g_file_header.var_buf[0].tick_count = -1;
+    g_file_header.var_buf[0].buf_offset = (int)first_row;
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    g_file_counts_per_row = (double)freq.QuadPart / disk->tick_rate;
+
+    g_header = &g_file_header;
+    g_file_mode = true;
+    g_file_pace = pace;
+    g_file_rows = (int)rows;
+    g_file_first_row = (int)first_row;
+    g_file_row = -1;
+    g_last_tick_count = -1;     /* Deliver row 0 rather than syncing past it */
+    g_last_valid_time = time(NULL);
+    memset(g_layout_key, 0, sizeof(g_layout_key));
+    g_is_initialized = true;
+    return true;
+}
+
+/*
+ * Publish the next replay row when it is due. Fast replays wait for the
+ * caller to take each row; real-time ones skip rows a slow caller missed,
+ * as the sim would.
+ */
+static void file_advance(void)
+{
+    int next = g_file_row + 1;
+
+    if (g_file_pace == IRSDK_REPLAY_REALTIME && g_file_row >= 0) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        next = (int)((double)(now.QuadPart - g_file_start.QuadPart) / g_file_counts_per_row);
+        if (next <= g_file_row) {
+            return;
+        }
+    } else if (g_file_row >= 0 && g_last_tick_count < g_file_row) {
+        return;
+    }
+
+    if (next >= g_file_rows) {
+        g_file_header.status = 0;
+        return;
+    }
+
+    if (g_file_row < 0) {
+        QueryPerformanceCounter(&g_file_start);
+    }
+
+    g_file_row = next;
+    g_file_header.var_buf[0].tick_count = next;
+    g_file_header.var_buf[0].buf_offset = g_file_first_row + next * g_file_header.buf_len;
+}
+
+/*
+ * Wait for the next replay row, at most timeout_ms
+ */
+static void file_wait(int timeout_ms)
+{
+    if (g_file_pace != IRSDK_REPLAY_REALTIME || g_file_row < 0 || timeout_ms <= 0) {
+        return;
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    double due = (double)(g_file_row + 1) * g_file_counts_per_row -
+                 (double)(now.QuadPart - g_file_start.QuadPart);
+    int ms = (int)(due * 1000.0 / (g_file_counts_per_row * g_file_header.tick_rate));
+
+    if (ms > timeout_ms) ms = timeout_ms;
+    Sleep(ms > 0 ? ms : 0);
+}
+
+bool irsdk_is_replay(void)
+{
+    return g_file_mode;
+}
+
+bool irsdk_replay_finished(void)
+{
+    return g_file_mode && !(g_file_header.status & IRSDK_ST_CONNECTED);
+}
+
+void irsdk_get_replay_progress(int *row, int *rows)
+{
+    if (row) *row = g_file_mode ? g_file_row + 1 : 0;
+    if (rows) *rows = g_file_mode ? g_file_rows : 0;
+}
+
+/*
+ * Find the var_buf slot holding the newest tick
+ */
+static int find_latest_buf(void)
+{
+    int latest = 0;
+    for (int i = 1; i < g_header->num_buf; i++) {
+        if (g_header->var_buf[latest].tick_count < g_header->var_buf[i].tick_count) {
+            latest = i;
+        }
+    }
+    return latest;
+}
+
+/*
+ * Read a slot's tick count straight from shared memory
+ */
+static int read_buf_tick(int index)
+{
+    MemoryBarrier();
+    return ((volatile const irsdk_VarBuf *)&g_header->var_buf[index])->tick_count;
+}
+
+/*
+ * Hash the parts of the variable headers that offsets depend on
+ */
+static unsigned int hash_layout(void)
+{
+    unsigned int hash = 2166136261u;  /* FNV-1a */
+    const irsdk_VarHeader *headers = irsdk_get_var_headers();
+
+    for (int i = 0; i < g_header->num_vars; i++) {
+        const irsdk_VarHeader *var = &headers[i];
+        int fields[3] = { var->type, var->offset, var->count };
+
+        const unsigned char *p = (const unsigned char *)fields;
+        for (size_t j = 0; j < sizeof(fields); j++) {
+            hash = (hash ^ p[j]) * 16777619u;
+        }
+        for (int j = 0; j < IRSDK_MAX_STRING && var->name[j]; j++) {
+            hash = (hash ^ (unsigned char)var->name[j]) * 16777619u;
+        }
+    }
+
+    return hash ^ (unsigned int)g_header->buf_len;
+}
+
+/*
+ * Check the variable layout against the last tick's.
+ * Returns false, after telling the listeners, if it changed.
+ */
+static bool check_layout(void)
+{
+    int key[4] = {
+        g_header->num_vars,
+        g_header->buf_len,
+        g_header->var_header_offset,
+        g_header->session_info_update
+    };
+
+    if (memcmp(key, g_layout_key, sizeof(key)) == 0) {
+        return true;
+    }
+    memcpy(g_layout_key, key, sizeof(key));
+
+    unsigned int hash = hash_layout();
+    if (g_layout_known && hash == g_layout_hash) {
+        return true;
+    }
+
+    g_layout_hash = hash;
+    g_layout_known = true;
+    g_layout_serial++;
+
+    for (int i = 0; i < g_layout_listener_count; i++) {
+        g_layout_listeners[i].fn(g_layout_listeners[i].user);
+    }
+    return false;
+}
+
+/*
+ * Helper: Count a delivered tick, and any since the last one the caller
+ * never saw
+ */
+static void count_tick(int tick)
+{
+    if (g_last_tick_count != INT_MAX && tick > g_last_tick_count + 1) {
+        stats_add(STAT_TICKS_MISSED, (long long)tick - g_last_tick_count - 1);
+    }
+    stats_add(STAT_TICKS_RECEIVED, 1);
+}
+
 /*
  * Check for new data
  */
 bool irsdk_get_new_data(char *data)
 {
     if (g_is_initialized || irsdk_startup()) {
+        if (g_file_mode) {
+            file_advance();
+        }
+
         /* If sim is not active, no new data */
         if (!(g_header->status & IRSDK_ST_CONNECTED)) {
             g_last_tick_count = INT_MAX;
             return false;
         }
 
-        /* Find the latest buffer */
-        int latest = 0;
-        for (int i = 1; i < g_header->num_buf; i++) {
-            if (g_header->var_buf[latest].tick_count < g_header->var_buf[i].tick_count) {
-                latest = i;
-            }
+        /* The caller's buffer may be for the old layout; let it catch up first */
+        if (!check_layout()) {
+            return false;
         }
 
+        /* Find the latest buffer */
+        int latest = find_latest_buf();
+
         /* If newer than last received, report new data */
         if (g_last_tick_count < g_header->var_buf[latest].tick_count) {
             if (data) {
                 /* Try twice to get consistent data */
                 for (int count = 0; count < 2; count++) {
-                    int cur_tick = g_header->var_buf[latest].tick_count;
+                    int cur_tick = read_buf_tick(latest);
                     memcpy(data, g_shared_mem + g_header->var_buf[latest].buf_offset, g_header->buf_len);
 
                     /* Verify data didn't change during copy */
-                    if (cur_tick == g_header->var_buf[latest].tick_count) {
+                    if (cur_tick == read_buf_tick(latest)) {
+                        count_tick(cur_tick);
                         g_last_tick_count = cur_tick;
                         g_last_valid_time = time(NULL);
                         return true;
                     }
+
+                    /* The sim moved on; retry from whichever slot is newest now */
+                    stats_add(count == 0 ? STAT_COPY_RETRIES : STAT_COPY_FAILURES, 1);
+                    latest = find_latest_buf();
                 }
                 /* Data changed during copy */
                 return false;
             } else {
+                count_tick(g_header->var_buf[latest].tick_count);
                 g_last_tick_count = g_header->var_buf[latest].tick_count;
                 g_last_valid_time = time(NULL);
                 return true;
@@ -146,6 +460,129 @@ bool irsdk_get_new_data(char *data)
     return false;
 }
 
+/*
+ * Point a view at the newest buffer
+ */
+static void fill_data_view(irsdk_data_view *view, int index)
+{
+    view->buf_index = index;
+    view->tick_count = read_buf_tick(index);
+    view->data = g_shared_mem + g_header->var_buf[index].buf_offset;
+}
+
+/*
+ * Check for new data without copying it
+ */
+bool irsdk_get_new_data_view(irsdk_data_view *view)
+{
+    if (!view) {
+        return false;
+    }
+
+    if (g_is_initialized || irsdk_startup()) {
+        if (g_file_mode) {
+            file_advance();
+        }
+
+        if (!(g_header->status & IRSDK_ST_CONNECTED)) {
+            g_last_tick_count = INT_MAX;
+            return false;
+        }
+
+        if (!check_layout()) {
+            return false;
+        }
+
+        int latest = find_latest_buf();
+        int tick = g_header->var_buf[latest].tick_count;
+
+        if (g_last_tick_count < tick) {
+            fill_data_view(view, latest);
+            count_tick(view->tick_count);
+            g_last_tick_count = view->tick_count;
+            g_last_valid_time = time(NULL);
+            return true;
+        } else if (g_last_tick_count > tick) {
+            g_last_tick_count = tick;
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Wait for new data without copying it
+ */
+bool irsdk_wait_for_data_view(int timeout_ms, irsdk_data_view *view)
+{
+    if (g_is_initialized || irsdk_startup()) {
+        int serial = g_layout_serial;
+        if (irsdk_get_new_data_view(view)) {
+            return true;
+        }
+        if (serial != g_layout_serial) {
+            return false;
+        }
+
+        if (g_file_mode) {
+            file_wait(timeout_ms);
+        } else {
+            WaitForSingleObject(g_data_valid_event, timeout_ms);
+        }
+
+        if (irsdk_get_new_data_view(view)) {
+            return true;
+        }
+        /* The wait above already used the timeout */
+        return false;
+    }
+
+    /* No sim to wait on; don't let the caller spin */
+    if (timeout_ms > 0) {
+        Sleep(timeout_ms);
+    }
+
+    return false;
+}
+
+/*
+ * Check that a view's slot has not been reused since it was taken
+ */
+bool irsdk_data_view_valid(const irsdk_data_view *view)
+{
+    if (!view || !view->data || !g_is_initialized || !g_header) {
+        return false;
+    }
+
+    if (view->buf_index < 0 || view->buf_index >= g_header->num_buf) {
+        return false;
+    }
+
+    return read_buf_tick(view->buf_index) == view->tick_count;
+}
+
+/*
+ * Re-point a view at the newest buffer after a failed validation
+ */
+bool irsdk_data_view_refresh(irsdk_data_view *view)
+{
+    if (!view || !g_is_initialized || !g_header) {
+        return false;
+    }
+
+    if (!(g_header->status & IRSDK_ST_CONNECTED)) {
+        return false;
+    }
+
+    fill_data_view(view, find_latest_buf());
+    if (view->tick_count > g_last_tick_count || g_last_tick_count == INT_MAX) {
+        g_last_tick_count = view->tick_count;
+    }
+    g_last_valid_time = time(NULL);
+    return true;
+}
+
 /*
  * Wait for new data with timeout
  */
@@ -153,20 +590,32 @@ bool irsdk_wait_for_data(int timeout_ms, char *data)
 {
     if (g_is_initialized || irsdk_startup()) {
         /* Check before sleeping */
+        int serial = g_layout_serial;
         if (irsdk_get_new_data(data)) {
             return true;
         }
 
+        /* Listeners may have replaced data; the caller must pass it again */
+        if (serial != g_layout_serial) {
+            return false;
+        }
+
         /* Wait for signal */
-        WaitForSingleObject(g_data_valid_event, timeout_ms);
+        if (g_file_mode) {
+            file_wait(timeout_ms);
+        } else {
+            WaitForSingleObject(g_data_valid_event, timeout_ms);
+        }
 
         /* Check again after waking */
         if (irsdk_get_new_data(data)) {
             return true;
         }
+        /* The wait above already used the timeout */
+        return false;
     }
 
-    /* Sleep on error */
+    /* No sim to wait on; don't let the caller spin */
     if (timeout_ms > 0) {
         Sleep(timeout_ms);
     }
@@ -219,6 +668,14 @@ int irsdk_get_session_info_update(void)
     return -1;
 }
 
+/*
+ * Get the tick of the last data returned
+ */
+int irsdk_get_tick_count(void)
+{
+    return g_last_tick_count == INT_MAX ? -1 : g_last_tick_count;
+}
+
 /*
  * Get variable headers array
  */
@@ -282,6 +739,36 @@ int irsdk_var_name_to_offset(const char *name)
     return -1;
 }
 
+/*
+ * Layout change listeners
+ */
+bool irsdk_add_layout_listener(irsdk_layout_fn fn, void *user)
+{
+    if (!fn || g_layout_listener_count >= IRSDK_MAX_LAYOUT_LISTENERS) {
+        return false;
+    }
+
+    g_layout_listeners[g_layout_listener_count].fn = fn;
+    g_layout_listeners[g_layout_listener_count].user = user;
+    g_layout_listener_count++;
+    return true;
+}
+
+void irsdk_remove_layout_listener(irsdk_layout_fn fn, void *user)
+{
+    for (int i = 0; i < g_layout_listener_count; i++) {
+        if (g_layout_listeners[i].fn == fn && g_layout_listeners[i].user == user) {
+            g_layout_listeners[i] = g_layout_listeners[--g_layout_listener_count];
+            return;
+        }
+    }
+}
+
+int irsdk_get_layout_serial(void)
+{
+    return g_layout_serial;
+}
+
 /*
  * Get the data buffer length
  */
@@ -293,6 +780,203 @@ int irsdk_get_buf_len(void)
     return 0;
 }
 
+/*
+ * Variable views
+ */
+
+/* Destination arrays, by the storage size of the type */
+enum {
+    VIEW_BOOLS = 0,
+    VIEW_INTS,
+    VIEW_FLOATS,
+    VIEW_DOUBLES,
+    VIEW_ARRAY_COUNT
+};
+
+static const int view_array_of_type[IRSDK_TYPE_COUNT] = {
+    VIEW_BOOLS,     /* IRSDK_TYPE_CHAR */
+    VIEW_BOOLS,     /* IRSDK_TYPE_BOOL */
+    VIEW_INTS,      /* IRSDK_TYPE_INT */
+    VIEW_INTS,      /* IRSDK_TYPE_BITFIELD */
+    VIEW_FLOATS,    /* IRSDK_TYPE_FLOAT */
+    VIEW_DOUBLES    /* IRSDK_TYPE_DOUBLE */
+};
+
+/* What the caller asked for */
+typedef struct {
+    char name[IRSDK_MAX_STRING];
+    int type;
+    int count;
+    int slot;
+} view_request;
+
+/* Resolved copy, packed for irsdk_var_view_gather() */
+typedef struct {
+    int src;                /* Byte offset in the data buffer */
+    int dest;               /* Byte offset in the destination array */
+    int copy_bytes;         /* 0 if the variable was not found */
+    int zero_bytes;         /* Entries the sim does not have */
+    int array;              /* VIEW_* */
+} view_entry;
+
+struct irsdk_var_view {
+    view_request *requests;
+    view_entry *entries;
+    int var_count;
+    int capacity;
+    int sizes[VIEW_ARRAY_COUNT];
+    int layout_serial;      /* g_layout_serial at the last resolve, 0 = never */
+};
+
+irsdk_var_view *irsdk_var_view_create(void)
+{
+    return (irsdk_var_view *)calloc(1, sizeof(irsdk_var_view));
+}
+
+void irsdk_var_view_destroy(irsdk_var_view *view)
+{
+    if (!view) {
+        return;
+    }
+
+    free(view->requests);
+    free(view->entries);
+    free(view);
+}
+
+int irsdk_var_view_add(irsdk_var_view *view, const char *name, irsdk_VarType type, int count)
+{
+    if (!view || !name || (int)type < 0 || type >= IRSDK_TYPE_COUNT || count < 1 ||
+        strlen(name) >= IRSDK_MAX_STRING) {
+        return -1;
+    }
+
+    if (view->var_count >= view->capacity) {
+        int new_capacity = view->capacity ? view->capacity * 2 : 16;
+        view_request *requests = (view_request *)realloc(view->requests,
+                                                         new_capacity * sizeof(view_request));
+        if (!requests) {
+            return -1;
+        }
+        view->requests = requests;
+
+        view_entry *entries = (view_entry *)realloc(view->entries,
+                                                    new_capacity * sizeof(view_entry));
+        if (!entries) {
+            return -1;
+        }
+        view->entries = entries;
+        view->capacity = new_capacity;
+    }
+
+    int array = view_array_of_type[type];
+    view_request *req = &view->requests[view->var_count];
+    strcpy(req->name, name);
+    req->type = type;
+    req->count = count;
+    req->slot = view->sizes[array];
+    view->sizes[array] += count;
+
+    /* Gathers zeros until resolved */
+    view_entry *entry = &view->entries[view->var_count];
+    entry->src = 0;
+    entry->dest = req->slot * irsdk_var_type_bytes[type];
+    entry->copy_bytes = 0;
+    entry->zero_bytes = count * irsdk_var_type_bytes[type];
+    entry->array = array;
+
+    return view->var_count++;
+}
+
+int irsdk_var_view_slot(const irsdk_var_view *view, int var)
+{
+    if (!view || var < 0 || var >= view->var_count) {
+        return -1;
+    }
+    return view->requests[var].slot;
+}
+
+int irsdk_var_view_size(const irsdk_var_view *view, irsdk_VarType type)
+{
+    if (!view || (int)type < 0 || type >= IRSDK_TYPE_COUNT) {
+        return 0;
+    }
+    return view->sizes[view_array_of_type[type]];
+}
+
+int irsdk_var_view_resolve(irsdk_var_view *view)
+{
+    if (!view) {
+        return 0;
+    }
+
+    int found = 0;
+    for (int i = 0; i < view->var_count; i++) {
+        const view_request *req = &view->requests[i];
+        view_entry *entry = &view->entries[i];
+        int width = irsdk_var_type_bytes[req->type];
+
+        const irsdk_VarHeader *header = irsdk_get_var_header(irsdk_var_name_to_index(req->name));
+        int entries = 0;
+        if (header && header->type >= 0 && header->type < IRSDK_TYPE_COUNT &&
+            view_array_of_type[header->type] == entry->array) {
+            entries = header->count < req->count ? header->count : req->count;
+            found++;
+        }
+
+        entry->src = header ? header->offset : 0;
+        entry->copy_bytes = entries * width;
+        entry->zero_bytes = (req->count - entries) * width;
+    }
+
+    view->layout_serial = g_layout_serial;
+    return found;
+}
+
+bool irsdk_var_view_found(const irsdk_var_view *view, int var)
+{
+    if (!view || var < 0 || var >= view->var_count) {
+        return false;
+    }
+    return view->entries[var].copy_bytes > 0;
+}
+
+bool irsdk_var_view_stale(const irsdk_var_view *view)
+{
+    return view && view->layout_serial != g_layout_serial;
+}
+
+void irsdk_var_view_gather(const irsdk_var_view *view, const char *data,
+                           const irsdk_view_values *values)
+{
+    if (!view || !data || !values) {
+        return;
+    }
+
+    char *dest[VIEW_ARRAY_COUNT] = {
+        (char *)values->bools,
+        (char *)values->ints,
+        (char *)values->floats,
+        (char *)values->doubles
+    };
+
+    for (int i = 0; i < view->var_count; i++) {
+        const view_entry *entry = &view->entries[i];
+        char *out = dest[entry->array];
+        if (!out) {
+            continue;
+        }
+
+        out += entry->dest;
+        if (entry->copy_bytes) {
+            memcpy(out, data + entry->src, entry->copy_bytes);
+        }
+        if (entry->zero_bytes) {
+            memset(out + entry->copy_bytes, 0, entry->zero_bytes);
+        }
+    }
+}
+
 /*
  * Variable value helpers
  */
@@ -364,6 +1048,11 @@ void irsdk_broadcast_msg_float(irsdk_BroadcastMsg msg, int var1, float var2)
  */
 void irsdk_broadcast_msg_int(irsdk_BroadcastMsg msg, int var1, int var2)
 {
+    /* A replay has no sim to control */
+    if (g_file_mode) {
+        return;
+    }
+
     unsigned int msg_id = get_broadcast_msg_id();
 
     if (msg_id && msg >= 0 && msg < IRSDK_BROADCAST_LAST) {
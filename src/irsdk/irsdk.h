@@ -21,6 +21,31 @@ bool irsdk_startup(void);
 /* Shutdown and cleanup resources */
 void irsdk_shutdown(void);
 
+/*
+ * File replay
+ *
+ * Reads a recorded .ibt file through the same calls as live data: each
+ * irsdk_get_new_data() returns the next row, the session info comes from
+ * the file, and irsdk_is_connected() turns false after the last row.
+ * Replaces the live source until irsdk_shutdown().
+ */
+typedef enum {
+    IRSDK_REPLAY_FAST,          /* Next row whenever the caller asks */
+    IRSDK_REPLAY_REALTIME       /* Rows at the recorded tick rate */
+} irsdk_replay_pace;
+
+/* Open an .ibt file. Returns false if it is missing or malformed. */
+bool irsdk_startup_file(const char *path, irsdk_replay_pace pace);
+
+/* Check if data comes from a file */
+bool irsdk_is_replay(void);
+
+/* Check if a replay has returned its last row */
+bool irsdk_replay_finished(void);
+
+/* Rows returned so far and rows in the file */
+void irsdk_get_replay_progress(int *row, int *rows);
+
 /*
  * Connection status
  */
@@ -46,6 +71,34 @@ bool irsdk_wait_for_data(int timeout_ms, char *data);
  */
 bool irsdk_get_new_data(char *data);
 
+/*
+ * Zero-copy data access
+ *
+ * A view points straight into the newest shared memory buffer instead of
+ * copying it out. The sim rotates through IRSDK_MAX_BUFS buffers, so the
+ * bytes stay put until it comes back around to the same slot. Read the
+ * variables you need, then call irsdk_data_view_valid(); if it fails, the
+ * slot was overwritten mid-read and irsdk_data_view_refresh() re-points the
+ * view at the newest buffer for a retry.
+ */
+typedef struct {
+    const char *data;       /* Read-only pointer into shared memory */
+    int tick_count;         /* Tick the slot held when the view was taken */
+    int buf_index;          /* var_buf[] slot the view points at */
+} irsdk_data_view;
+
+/* Check for new data without copying. Returns true and fills view if new. */
+bool irsdk_get_new_data_view(irsdk_data_view *view);
+
+/* Wait for new data without copying. Returns true and fills view if new. */
+bool irsdk_wait_for_data_view(int timeout_ms, irsdk_data_view *view);
+
+/* Check the view's slot still holds the tick it was taken at */
+bool irsdk_data_view_valid(const irsdk_data_view *view);
+
+/* Re-point the view at the newest buffer. Returns false if not connected. */
+bool irsdk_data_view_refresh(irsdk_data_view *view);
+
 /* Get pointer to the header structure. Returns NULL if not connected. */
 const irsdk_Header *irsdk_get_header(void);
 
@@ -55,6 +108,9 @@ const char *irsdk_get_session_info(void);
 /* Get the session info update counter (increments when session info changes) */
 int irsdk_get_session_info_update(void);
 
+/* Get the tick count of the data last returned, or -1 if none yet */
+int irsdk_get_tick_count(void);
+
 /*
  * Variable access
  */
@@ -71,6 +127,85 @@ int irsdk_var_name_to_index(const char *name);
 /* Find variable offset by name. Returns -1 if not found. */
 int irsdk_var_name_to_offset(const char *name);
 
+/*
+ * Layout changes
+ *
+ * The sim can republish its variables with new offsets, or a bigger
+ * buf_len, without the shared memory going away (switching from a replay
+ * to a live session, say). Each data call checks the layout first; when
+ * it changed, the listeners run on the calling thread, and that call
+ * returns false without touching the caller's buffer. Listeners resolve
+ * their offsets again and grow any buffer to irsdk_get_buf_len().
+ */
+#define IRSDK_MAX_LAYOUT_LISTENERS 8
+
+typedef void (*irsdk_layout_fn)(void *user);
+
+/* Register a layout listener. Returns false if the table is full. */
+bool irsdk_add_layout_listener(irsdk_layout_fn fn, void *user);
+
+/* Unregister a layout listener */
+void irsdk_remove_layout_listener(irsdk_layout_fn fn, void *user);
+
+/* Counter bumped on every layout change */
+int irsdk_get_layout_serial(void);
+
+/*
+ * Variable views
+ *
+ * A view resolves a list of variable names once into a packed table of
+ * offsets, then copies all of them out of a data buffer in one call. Each
+ * variable lands in the caller's array for its declared type, so callers
+ * index plain arrays instead of going through irsdk_get_var_*() per value.
+ * Arrays such as CarIdxLapDistPct are copied as one block.
+ *
+ * Resolve after connecting, and again whenever irsdk_var_view_stale()
+ * reports the sim's variable layout has changed.
+ */
+typedef struct irsdk_var_view irsdk_var_view;
+
+/* Destination arrays; size each with irsdk_var_view_size() */
+typedef struct {
+    bool *bools;            /* IRSDK_TYPE_BOOL and IRSDK_TYPE_CHAR */
+    int *ints;              /* IRSDK_TYPE_INT and IRSDK_TYPE_BITFIELD */
+    float *floats;          /* IRSDK_TYPE_FLOAT */
+    double *doubles;        /* IRSDK_TYPE_DOUBLE */
+} irsdk_view_values;
+
+/* Create an empty view. Returns NULL on allocation failure. */
+irsdk_var_view *irsdk_var_view_create(void);
+
+/* Free a view */
+void irsdk_var_view_destroy(irsdk_var_view *view);
+
+/*
+ * Add a variable of the expected type with count entries (1 for scalars).
+ * Returns its index in the view, or -1 on error.
+ */
+int irsdk_var_view_add(irsdk_var_view *view, const char *name, irsdk_VarType type, int count);
+
+/* First entry of a variable within the destination array for its type */
+int irsdk_var_view_slot(const irsdk_var_view *view, int var);
+
+/* Entries the destination array for a type must hold */
+int irsdk_var_view_size(const irsdk_var_view *view, irsdk_VarType type);
+
+/*
+ * Look the variables up in the connected sim. Variables that are missing
+ * or have a different type gather as zeros. Returns the number found.
+ */
+int irsdk_var_view_resolve(irsdk_var_view *view);
+
+/* Check if a variable was found by the last resolve */
+bool irsdk_var_view_found(const irsdk_var_view *view, int var);
+
+/* Check if the sim's variable layout changed since the last resolve */
+bool irsdk_var_view_stale(const irsdk_var_view *view);
+
+/* Copy every variable in the view out of a data buffer */
+void irsdk_var_view_gather(const irsdk_var_view *view, const char *data,
+                           const irsdk_view_values *values);
+
 /*
  * Helper functions for reading variable values from a data buffer
  */
@@ -10,6 +10,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include "yaml_parser.h"
 
@@ -159,6 +160,28 @@ bool yaml_parse(const char *data, const char *path, const char **val, int *len)
     return false;
 }
 
+/*
+ * Helper: Copy a value into a null-terminated buffer
+ */
+static bool value_to_string(const char *val, int len, char *buf, int buf_size)
+{
+    if (val && len > 0) {
+        int copy_len = (len < buf_size - 1) ? len : (buf_size - 1);
+        strncpy(buf, val, copy_len);
+        buf[copy_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Helper: Copy a value into a temporary for numeric conversion
+ */
+static bool value_to_temp(const char *val, int len, char temp[64])
+{
+    return value_to_string(val, len, temp, 64);
+}
+
 /*
  * Parse YAML value into string buffer
  */
@@ -173,16 +196,7 @@ bool yaml_parse_string(const char *data, const char *path, char *buf, int buf_si
 
     buf[0] = '\0';
 
-    if (yaml_parse(data, path, &val, &len)) {
-        if (val && len > 0) {
-            int copy_len = (len < buf_size - 1) ? len : (buf_size - 1);
-            strncpy(buf, val, copy_len);
-            buf[copy_len] = '\0';
-            return true;
-        }
-    }
-
-    return false;
+    return yaml_parse(data, path, &val, &len) && value_to_string(val, len, buf, buf_size);
 }
 
 /*
@@ -192,6 +206,7 @@ bool yaml_parse_int(const char *data, const char *path, int *value)
 {
     const char *val = NULL;
     int len = 0;
+    char temp[64];
 
     if (!value) {
         return false;
@@ -199,16 +214,9 @@ bool yaml_parse_int(const char *data, const char *path, int *value)
 
     *value = 0;
 
-    if (yaml_parse(data, path, &val, &len)) {
-        if (val && len > 0) {
-            /* Create temporary null-terminated string */
-            char temp[64];
-            int copy_len = (len < 63) ? len : 63;
-            strncpy(temp, val, copy_len);
-            temp[copy_len] = '\0';
-            *value = atoi(temp);
-            return true;
-        }
+    if (yaml_parse(data, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = atoi(temp);
+        return true;
     }
 
     return false;
@@ -221,6 +229,7 @@ bool yaml_parse_float(const char *data, const char *path, float *value)
 {
     const char *val = NULL;
     int len = 0;
+    char temp[64];
 
     if (!value) {
         return false;
@@ -228,15 +237,9 @@ bool yaml_parse_float(const char *data, const char *path, float *value)
 
     *value = 0.0f;
 
-    if (yaml_parse(data, path, &val, &len)) {
-        if (val && len > 0) {
-            char temp[64];
-            int copy_len = (len < 63) ? len : 63;
-            strncpy(temp, val, copy_len);
-            temp[copy_len] = '\0';
-            *value = (float)atof(temp);
-            return true;
-        }
+    if (yaml_parse(data, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = (float)atof(temp);
+        return true;
     }
 
     return false;
@@ -249,6 +252,7 @@ bool yaml_parse_double(const char *data, const char *path, double *value)
 {
     const char *val = NULL;
     int len = 0;
+    char temp[64];
 
     if (!value) {
         return false;
@@ -256,16 +260,653 @@ bool yaml_parse_double(const char *data, const char *path, double *value)
 
     *value = 0.0;
 
-    if (yaml_parse(data, path, &val, &len)) {
-        if (val && len > 0) {
-            char temp[64];
-            int copy_len = (len < 63) ? len : 63;
-            strncpy(temp, val, copy_len);
-            temp[copy_len] = '\0';
-            *value = atof(temp);
+    if (yaml_parse(data, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = atof(temp);
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Indexed Lookup
+ */
+
+#define YAML_MAX_PATH 512
+#define YAML_MAX_NESTING 32
+#define YAML_INITIAL_CAPACITY 256
+
+/* One "key: value" line */
+typedef struct {
+    const char *key;
+    int key_len;
+    const char *value;
+    int value_len;
+    int depth;
+    int item;                   /* Innermost enclosing list item, -1 if none */
+} yaml_entry;
+
+/* One "- key: value" list item and the lines under it */
+typedef struct {
+    int depth;                  /* Indent of the item's own keys */
+    int first_entry;
+    int next;                   /* Next item of the same list, -1 at the end */
+} yaml_item;
+
+typedef struct {
+    int path;                   /* Slot holding the list's path */
+    int first_item;
+    int last_item;
+} yaml_list;
+
+/* Hashed path, pointing at an entry */
+typedef struct {
+    uint32_t hash;
+    int path_off;               /* Into the path arena */
+    int path_len;
+    int entry;
+} yaml_slot;
+
+struct yaml_index {
+    const char *data;
+    int update_count;
+    bool built;
+
+    yaml_entry *entries;
+    int entry_count;
+    int entry_capacity;
+
+    yaml_item *items;
+    int item_count;
+    int item_capacity;
+
+    yaml_list *lists;
+    int list_count;
+    int list_capacity;
+
+    yaml_slot *slots;
+    int slot_count;
+    int slot_capacity;
+
+    int *table;                 /* Open-addressed slot indices, -1 = empty */
+    int table_size;
+
+    char *paths;
+    int paths_len;
+    int paths_capacity;
+};
+
+/* Builder nesting frame: a key with children, or a list item */
+typedef struct {
+    int depth;
+    bool is_item;
+    int item;
+    int canon_len;              /* Path lengths including this frame */
+    int plain_len;
+} yaml_frame;
+
+/* FNV-1a */
+static uint32_t hash_path(const char *path, int len)
+{
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        h ^= (unsigned char)path[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Helper: Grow a dynamic array to hold at least one more element
+ */
+static bool grow(void **array, int *capacity, int count, size_t elem_size)
+{
+    if (count < *capacity) return true;
+
+    int new_capacity = *capacity ? *capacity * 2 : YAML_INITIAL_CAPACITY;
+    void *grown = realloc(*array, (size_t)new_capacity * elem_size);
+    if (!grown) return false;
+
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static int find_slot(const yaml_index *index, const char *path, int len, uint32_t hash)
+{
+    if (!index->table_size) return -1;
+
+    uint32_t mask = (uint32_t)index->table_size - 1;
+    for (uint32_t i = hash & mask; ; i = (i + 1) & mask) {
+        int s = index->table[i];
+        if (s < 0) return -1;
+
+        const yaml_slot *slot = &index->slots[s];
+        if (slot->hash == hash && slot->path_len == len &&
+            memcmp(index->paths + slot->path_off, path, len) == 0) {
+            return s;
+        }
+    }
+}
+
+static bool rehash(yaml_index *index, int size)
+{
+    int *table = realloc(index->table, (size_t)size * sizeof(int));
+    if (!table) return false;
+
+    index->table = table;
+    index->table_size = size;
+    memset(table, 0xff, (size_t)size * sizeof(int));
+
+    uint32_t mask = (uint32_t)size - 1;
+    for (int s = 0; s < index->slot_count; s++) {
+        uint32_t i = index->slots[s].hash & mask;
+        while (table[i] >= 0) i = (i + 1) & mask;
+        table[i] = s;
+    }
+    return true;
+}
+
+/*
+ * Helper: Map a path to an entry. The first occurrence wins, as with
+ * yaml_parse(). Returns the slot index, or -1 on allocation failure.
+ */
+static int add_path(yaml_index *index, const char *path, int len, int entry)
+{
+    uint32_t hash = hash_path(path, len);
+    int existing = find_slot(index, path, len, hash);
+    if (existing >= 0) return existing;
+
+    /* Keep the table at most half full */
+    if ((index->slot_count + 1) * 2 > index->table_size) {
+        if (!rehash(index, index->table_size ? index->table_size * 2 : YAML_INITIAL_CAPACITY * 2)) {
+            return -1;
+        }
+    }
+
+    if (!grow((void **)&index->slots, &index->slot_capacity, index->slot_count, sizeof(yaml_slot))) {
+        return -1;
+    }
+
+    while (index->paths_len + len > index->paths_capacity) {
+        int new_capacity = index->paths_capacity ? index->paths_capacity * 2 : 16384;
+        char *grown = realloc(index->paths, new_capacity);
+        if (!grown) return -1;
+        index->paths = grown;
+        index->paths_capacity = new_capacity;
+    }
+
+    int s = index->slot_count++;
+    yaml_slot *slot = &index->slots[s];
+    slot->hash = hash;
+    slot->path_off = index->paths_len;
+    slot->path_len = len;
+    slot->entry = entry;
+
+    memcpy(index->paths + index->paths_len, path, len);
+    index->paths_len += len;
+
+    uint32_t mask = (uint32_t)index->table_size - 1;
+    uint32_t i = hash & mask;
+    while (index->table[i] >= 0) i = (i + 1) & mask;
+    index->table[i] = s;
+
+    return s;
+}
+
+/*
+ * Helper: Find or create the list whose items sit under path
+ */
+static int get_list(yaml_index *index, const char *path, int len)
+{
+    int slot = find_slot(index, path, len, hash_path(path, len));
+
+    for (int i = 0; slot >= 0 && i < index->list_count; i++) {
+        if (index->lists[i].path == slot) return i;
+    }
+
+    /* The parent key normally has an entry already; lists at the root don't */
+    if (slot < 0) {
+        slot = add_path(index, path, len, -1);
+        if (slot < 0) return -1;
+    }
+
+    if (!grow((void **)&index->lists, &index->list_capacity, index->list_count, sizeof(yaml_list))) {
+        return -1;
+    }
+
+    yaml_list *list = &index->lists[index->list_count];
+    list->path = slot;
+    list->first_item = -1;
+    list->last_item = -1;
+    return index->list_count++;
+}
+
+/*
+ * Helper: Append ":key" (or "key" after a selector) to a path buffer.
+ * Returns the new length, or -1 if it would not fit.
+ */
+static int append_key(char *path, int len, const char *key, int key_len)
+{
+    int sep = (len > 0 && path[len - 1] != '}') ? 1 : 0;
+    if (len + sep + key_len >= YAML_MAX_PATH) return -1;
+
+    if (sep) path[len++] = ':';
+    memcpy(path + len, key, key_len);
+    return len + key_len;
+}
+
+yaml_index *yaml_index_create(void)
+{
+    return calloc(1, sizeof(yaml_index));
+}
+
+void yaml_index_destroy(yaml_index *index)
+{
+    if (!index) return;
+
+    free(index->entries);
+    free(index->items);
+    free(index->lists);
+    free(index->slots);
+    free(index->table);
+    free(index->paths);
+    free(index);
+}
+
+bool yaml_index_build(yaml_index *index, const char *data)
+{
+    if (!index || !data) return false;
+
+    index->data = data;
+    index->built = false;
+    index->entry_count = 0;
+    index->item_count = 0;
+    index->list_count = 0;
+    index->slot_count = 0;
+    index->paths_len = 0;
+    if (index->table) {
+        memset(index->table, 0xff, (size_t)index->table_size * sizeof(int));
+    }
+
+    /* Canonical paths carry list selectors, plain paths do not */
+    char canon[YAML_MAX_PATH];
+    char plain[YAML_MAX_PATH];
+    yaml_frame stack[YAML_MAX_NESTING];
+    int sp = 0;
+
+    const char *p = data;
+    while (*p) {
+        /* Indent: spaces and list dashes both count, as in yaml_parse() */
+        int depth = 0;
+        bool dash = false;
+        while (*p == ' ' || *p == '-') {
+            if (*p == '-') dash = true;
+            depth++;
+            p++;
+        }
+
+        /* Key runs up to the first ':' */
+        const char *key = p;
+        while (*p && *p != ':' && *p != '\n' && *p != '\r') p++;
+        int key_len = (int)(p - key);
+
+        if (*p != ':' || key_len == 0) {
+            /* Document markers, blank lines */
+            while (*p && *p != '\n' && *p != '\r') p++;
+            while (*p == '\n' || *p == '\r') p++;
+            continue;
+        }
+        p++;
+
+        while (*p == ' ') p++;
+        const char *value = p;
+        while (*p && *p != '\n' && *p != '\r') p++;
+        int value_len = (int)(p - value);
+        while (*p == '\n' || *p == '\r') p++;
+
+        /* Close frames this line is not nested in. A dash at an item's own
+         * depth starts the next item; other keys there are its siblings. */
+        while (sp > 0) {
+            const yaml_frame *top = &stack[sp - 1];
+            if (top->depth < depth || (top->depth == depth && top->is_item && !dash)) break;
+            sp--;
+        }
+
+        int canon_len = sp ? stack[sp - 1].canon_len : 0;
+        int plain_len = sp ? stack[sp - 1].plain_len : 0;
+        int item = -1;
+        for (int i = sp - 1; i >= 0; i--) {
+            if (stack[i].is_item) {
+                item = stack[i].item;
+                break;
+            }
+        }
+
+        if (dash && sp < YAML_MAX_NESTING) {
+            /* New list item, selected by its first key: "List:Key:{value}" */
+            int list = get_list(index, canon, canon_len);
+            if (list < 0) return false;
+
+            if (!grow((void **)&index->items, &index->item_capacity, index->item_count,
+                      sizeof(yaml_item))) {
+                return false;
+            }
+
+            item = index->item_count++;
+            index->items[item].depth = depth;
+            index->items[item].first_entry = index->entry_count;
+            index->items[item].next = -1;
+
+            yaml_list *l = &index->lists[list];
+            if (l->last_item >= 0) {
+                index->items[l->last_item].next = item;
+            } else {
+                l->first_item = item;
+            }
+            l->last_item = item;
+
+            int len = append_key(canon, canon_len, key, key_len);
+            if (len < 0 || len + value_len + 3 >= YAML_MAX_PATH) continue;
+            canon[len++] = ':';
+            canon[len++] = '{';
+            memcpy(canon + len, value, value_len);
+            len += value_len;
+            canon[len++] = '}';
+
+            stack[sp].depth = depth;
+            stack[sp].is_item = true;
+            stack[sp].item = item;
+            stack[sp].canon_len = len;
+            stack[sp].plain_len = plain_len;
+            sp++;
+            canon_len = len;
+        }
+
+        if (!grow((void **)&index->entries, &index->entry_capacity, index->entry_count,
+                  sizeof(yaml_entry))) {
+            return false;
+        }
+
+        int entry = index->entry_count++;
+        yaml_entry *e = &index->entries[entry];
+        e->key = key;
+        e->key_len = key_len;
+        e->value = value;
+        e->value_len = value_len;
+        e->depth = depth;
+        e->item = item;
+
+        int entry_canon = append_key(canon, canon_len, key, key_len);
+        int entry_plain = append_key(plain, plain_len, key, key_len);
+        if (entry_canon < 0 || entry_plain < 0) continue;
+
+        if (add_path(index, canon, entry_canon, entry) < 0) return false;
+        if (item >= 0 && add_path(index, plain, entry_plain, entry) < 0) return false;
+
+        /* A key without a value opens a nested block */
+        if (value_len == 0 && sp < YAML_MAX_NESTING) {
+            stack[sp].depth = depth;
+            stack[sp].is_item = false;
+            stack[sp].item = -1;
+            stack[sp].canon_len = entry_canon;
+            stack[sp].plain_len = entry_plain;
+            sp++;
+        }
+    }
+
+    index->built = true;
+    return true;
+}
+
+bool yaml_index_update(yaml_index *index, const char *data, int update_count)
+{
+    if (!index || !data) return false;
+
+    if (index->built && index->data == data && index->update_count == update_count) {
+        return false;
+    }
+
+    index->update_count = update_count;
+    return yaml_index_build(index, data);
+}
+
+/*
+ * Helper: Resolve a path to its slot, ignoring a trailing ':'
+ */
+static int lookup_path(const yaml_index *index, const char *path)
+{
+    int len = (int)strlen(path);
+    if (len > 0 && path[len - 1] == ':') len--;
+    return find_slot(index, path, len, hash_path(path, len));
+}
+
+bool yaml_index_find(const yaml_index *index, const char *path, const char **val, int *len)
+{
+    if (!index || !path || !val || !len) return false;
+
+    *val = NULL;
+    *len = 0;
+    if (!index->built) return false;
+
+    int s = lookup_path(index, path);
+    if (s >= 0 && index->slots[s].entry >= 0) {
+        const yaml_entry *e = &index->entries[index->slots[s].entry];
+        *val = e->value;
+        *len = e->value_len;
+        return true;
+    }
+
+    /* Only selectors on an item's first key are indexed */
+    if (!strchr(path, '{')) return false;
+
+    char sdk_path[YAML_MAX_PATH];
+    int path_len = (int)strlen(path);
+    if (path_len + 2 > YAML_MAX_PATH) return false;
+    memcpy(sdk_path, path, path_len);
+    if (path_len == 0 || path[path_len - 1] != ':') sdk_path[path_len++] = ':';
+    sdk_path[path_len] = '\0';
+
+    return yaml_parse(index->data, sdk_path, val, len);
+}
+
+bool yaml_index_string(const yaml_index *index, const char *path, char *buf, int buf_size)
+{
+    const char *val = NULL;
+    int len = 0;
+
+    if (!buf || buf_size <= 0) {
+        return false;
+    }
+
+    buf[0] = '\0';
+
+    return yaml_index_find(index, path, &val, &len) && value_to_string(val, len, buf, buf_size);
+}
+
+bool yaml_index_int(const yaml_index *index, const char *path, int *value)
+{
+    const char *val = NULL;
+    int len = 0;
+    char temp[64];
+
+    if (!value) {
+        return false;
+    }
+
+    *value = 0;
+
+    if (yaml_index_find(index, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = atoi(temp);
+        return true;
+    }
+
+    return false;
+}
+
+bool yaml_index_float(const yaml_index *index, const char *path, float *value)
+{
+    const char *val = NULL;
+    int len = 0;
+    char temp[64];
+
+    if (!value) {
+        return false;
+    }
+
+    *value = 0.0f;
+
+    if (yaml_index_find(index, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = (float)atof(temp);
+        return true;
+    }
+
+    return false;
+}
+
+bool yaml_index_double(const yaml_index *index, const char *path, double *value)
+{
+    const char *val = NULL;
+    int len = 0;
+    char temp[64];
+
+    if (!value) {
+        return false;
+    }
+
+    *value = 0.0;
+
+    if (yaml_index_find(index, path, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = atof(temp);
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * List Iteration
+ */
+
+bool yaml_index_list(const yaml_index *index, const char *path, yaml_list_iter *iter)
+{
+    if (!index || !path || !iter || !index->built) return false;
+
+    iter->index = index;
+    iter->list = -1;
+    iter->item = -1;
+
+    int s = lookup_path(index, path);
+    if (s < 0) return false;
+
+    for (int i = 0; i < index->list_count; i++) {
+        if (index->lists[i].path == s) {
+            iter->list = i;
             return true;
         }
     }
+    return false;
+}
+
+bool yaml_list_next(yaml_list_iter *iter)
+{
+    if (!iter || iter->list < 0) return false;
+
+    const yaml_index *index = iter->index;
+    if (iter->item < 0) {
+        iter->item = index->lists[iter->list].first_item;
+    } else {
+        iter->item = index->items[iter->item].next;
+    }
+
+    if (iter->item < 0) {
+        iter->list = -1;
+        return false;
+    }
+    return true;
+}
+
+bool yaml_list_find(const yaml_list_iter *iter, const char *key, const char **val, int *len)
+{
+    if (!iter || !key || !val || !len || iter->item < 0) return false;
+
+    *val = NULL;
+    *len = 0;
+
+    const yaml_index *index = iter->index;
+    const yaml_item *item = &index->items[iter->item];
+    int key_len = (int)strlen(key);
+    if (key_len > 0 && key[key_len - 1] == ':') key_len--;
+
+    /* The item's lines follow its first one; they end where it does */
+    for (int i = item->first_entry; i < index->entry_count; i++) {
+        const yaml_entry *e = &index->entries[i];
+        if (e->depth < item->depth) break;
+        if (e->item != iter->item) {
+            /* Nested items are skipped; the next sibling item ends this one */
+            if (e->depth == item->depth) break;
+            continue;
+        }
+        if (e->depth == item->depth && e->key_len == key_len &&
+            memcmp(e->key, key, key_len) == 0) {
+            *val = e->value;
+            *len = e->value_len;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool yaml_list_string(const yaml_list_iter *iter, const char *key, char *buf, int buf_size)
+{
+    const char *val = NULL;
+    int len = 0;
+
+    if (!buf || buf_size <= 0) {
+        return false;
+    }
+
+    buf[0] = '\0';
+
+    return yaml_list_find(iter, key, &val, &len) && value_to_string(val, len, buf, buf_size);
+}
+
+bool yaml_list_int(const yaml_list_iter *iter, const char *key, int *value)
+{
+    const char *val = NULL;
+    int len = 0;
+    char temp[64];
+
+    if (!value) {
+        return false;
+    }
+
+    *value = 0;
+
+    if (yaml_list_find(iter, key, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = atoi(temp);
+        return true;
+    }
+
+    return false;
+}
+
+bool yaml_list_float(const yaml_list_iter *iter, const char *key, float *value)
+{
+    const char *val = NULL;
+    int len = 0;
+    char temp[64];
+
+    if (!value) {
+        return false;
+    }
+
+    *value = 0.0f;
+
+    if (yaml_list_find(iter, key, &val, &len) && value_to_temp(val, len, temp)) {
+        *value = (float)atof(temp);
+        return true;
+    }
 
     return false;
 }
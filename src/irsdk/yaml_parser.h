@@ -63,4 +63,73 @@ bool yaml_parse_float(const char *data, const char *path, float *value);
  */
 bool yaml_parse_double(const char *data, const char *path, double *value);
 
+/*
+ * Indexed Lookup
+ *
+ * The functions above scan the whole document on every call. A yaml_index
+ * tokenizes the document once and hashes every key path, so each lookup
+ * afterwards costs one hash probe. Paths use the same format as
+ * yaml_parse(); the trailing ':' of the SDK form is optional.
+ *
+ * List items are keyed by their first key, which is how the session info
+ * lays out its lists ("- CarIdx: 5"). Selectors on any other key fall back
+ * to a full yaml_parse() scan.
+ *
+ * The index points into the document, which must stay valid.
+ */
+typedef struct yaml_index yaml_index;
+
+/* Create an empty index. Returns NULL on allocation failure. */
+yaml_index *yaml_index_create(void);
+
+/* Destroy an index. */
+void yaml_index_destroy(yaml_index *index);
+
+/*
+ * Index a document in a single pass, replacing any previous contents.
+ * Storage is kept between builds. Returns false on allocation failure.
+ */
+bool yaml_index_build(yaml_index *index, const char *data);
+
+/*
+ * Rebuild only if data or its update counter changed since the last build.
+ * Returns true if the index was rebuilt.
+ */
+bool yaml_index_update(yaml_index *index, const char *data, int update_count);
+
+/* Indexed equivalents of yaml_parse() and its typed variants. */
+bool yaml_index_find(const yaml_index *index, const char *path, const char **val, int *len);
+bool yaml_index_string(const yaml_index *index, const char *path, char *buf, int buf_size);
+bool yaml_index_int(const yaml_index *index, const char *path, int *value);
+bool yaml_index_float(const yaml_index *index, const char *path, float *value);
+bool yaml_index_double(const yaml_index *index, const char *path, double *value);
+
+/*
+ * Iterator over the items of a list such as "DriverInfo:Drivers".
+ *
+ *   yaml_list_iter it;
+ *   if (yaml_index_list(index, "DriverInfo:Drivers", &it)) {
+ *       while (yaml_list_next(&it)) {
+ *           yaml_list_int(&it, "CarIdx", &car_idx);
+ *       }
+ *   }
+ */
+typedef struct {
+    const yaml_index *index;
+    int list;
+    int item;                   /* Current item, -1 before the first */
+} yaml_list_iter;
+
+/* Start iterating a list. Returns false if path is not a list. */
+bool yaml_index_list(const yaml_index *index, const char *path, yaml_list_iter *iter);
+
+/* Advance to the next item. Returns false past the last one. */
+bool yaml_list_next(yaml_list_iter *iter);
+
+/* Look up a key directly inside the current item. */
+bool yaml_list_find(const yaml_list_iter *iter, const char *key, const char **val, int *len);
+bool yaml_list_string(const yaml_list_iter *iter, const char *key, char *buf, int buf_size);
+bool yaml_list_int(const yaml_list_iter *iter, const char *key, int *value);
+bool yaml_list_float(const yaml_list_iter *iter, const char *key, float *value);
+
 #endif /* IRA_YAML_PARSER_H */
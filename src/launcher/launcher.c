@@ -13,6 +13,7 @@
 
 #include "launcher.h"
 #include "../util/json.h"
+#include "../util/stats.h"
 
 /* Initial capacity for app list */
 #define INITIAL_CAPACITY 8
@@ -110,6 +111,188 @@ static void filter_cleanup(content_filter *filter)
     filter->mode = FILTER_NONE;
 }
 
+/*
+ * Process monitor
+ */
+
+/* Find the running app that owns a process. Call with the lock held. */
+static app_profile *find_app_by_pid(app_launcher *launcher, DWORD pid)
+{
+    if (pid == 0) return NULL;
+
+    for (int i = 0; i < launcher->app_count; i++) {
+        if (launcher->apps[i].process_id == pid && launcher->apps[i].process_handle) {
+            return &launcher->apps[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Record that an app's process has exited. Call with the lock held. */
+static void mark_exited(app_profile *app, DWORD exit_code)
+{
+    if (app->process_handle) {
+        CloseHandle(app->process_handle);
+        app->process_handle = NULL;
+    }
+    app->process_id = 0;
+    app->is_running = false;
+    app->exit_code = exit_code;
+}
+
+/* Create the app's process. Call with the lock held. */
+static bool spawn_process(app_profile *app)
+{
+    /* Build command line */
+    char cmdline[MAX_PATH + 256 + 4];
+    if (app->args[0] != '\0') {
+        snprintf(cmdline, sizeof(cmdline), "\"%s\" %s", app->exe_path, app->args);
+    } else {
+        snprintf(cmdline, sizeof(cmdline), "\"%s\"", app->exe_path);
+    }
+
+    /* Set up working directory */
+    const char *work_dir = NULL;
+    if (app->working_dir[0] != '\0') {
+        work_dir = app->working_dir;
+    }
+
+    /* Create process */
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    memset(&pi, 0, sizeof(pi));
+
+    long long start = stats_now();
+    BOOL success = CreateProcessA(
+        NULL,           /* Application name (use command line) */
+        cmdline,        /* Command line */
+        NULL,           /* Process security attributes */
+        NULL,           /* Thread security attributes */
+        FALSE,          /* Inherit handles */
+        CREATE_NEW_CONSOLE, /* Creation flags */
+        NULL,           /* Environment */
+        work_dir,       /* Working directory */
+        &si,            /* Startup info */
+        &pi             /* Process information */
+    );
+
+    if (!success) {
+        return false;
+    }
+    stats_span_end(STAT_SPAN_APP_START, start);
+
+    /* Store process info */
+    app->process_handle = pi.hProcess;
+    app->process_id = pi.dwProcessId;
+    app->is_running = true;
+    app->stopping = false;
+
+    /* Don't need the thread handle */
+    CloseHandle(pi.hThread);
+
+    return true;
+}
+
+/*
+ * Helper: Handle a process exit seen by the monitor thread.
+ * Apps that crash are relaunched here when restart_on_crash allows it.
+ */
+static void handle_process_exit(app_launcher *launcher, DWORD pid, HANDLE process)
+{
+    DWORD exit_code = 0;
+    GetExitCodeProcess(process, &exit_code);
+
+    char name[64] = "";
+    bool notify = false;
+    bool restarted = false;
+
+    EnterCriticalSection(&launcher->lock);
+    app_profile *app = find_app_by_pid(launcher, pid);
+    if (app) {
+        /* Deliberate stops are finished by launcher_stop_app */
+        bool deliberate = app->stopping;
+        mark_exited(app, exit_code);
+
+        if (!deliberate) {
+            notify = true;
+            strncpy(name, app->name, sizeof(name) - 1);
+
+            if (app->restart_on_crash && exit_code != 0 &&
+                app->restart_count < app->max_restarts && spawn_process(app)) {
+                app->restart_count++;
+                restarted = true;
+            }
+        }
+    }
+    launcher_exit_fn on_exit = launcher->on_exit;
+    void *user = launcher->on_exit_user;
+    LeaveCriticalSection(&launcher->lock);
+
+    if (notify && on_exit) {
+        on_exit(user, name, exit_code, restarted);
+    }
+}
+
+/*
+ * Monitor thread: block on the wake event plus a duplicate of every
+ * running app's process handle. Duplicates keep the wait valid while
+ * other threads close the originals. The set is rebuilt after each wake.
+ */
+static DWORD WINAPI monitor_thread_proc(LPVOID param)
+{
+    app_launcher *launcher = (app_launcher *)param;
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    DWORD pids[MAXIMUM_WAIT_OBJECTS];
+
+    for (;;) {
+        DWORD count = 0;
+        handles[count] = launcher->monitor_wake;
+        pids[count] = 0;
+        count++;
+
+        EnterCriticalSection(&launcher->lock);
+        bool stop = launcher->monitor_stop;
+        for (int i = 0; !stop && i < launcher->app_count && count < MAXIMUM_WAIT_OBJECTS; i++) {
+            app_profile *app = &launcher->apps[i];
+            if (!app->is_running || !app->process_handle) continue;
+
+            if (DuplicateHandle(GetCurrentProcess(), app->process_handle,
+                                GetCurrentProcess(), &handles[count],
+                                0, FALSE, DUPLICATE_SAME_ACCESS)) {
+                pids[count] = app->process_id;
+                count++;
+            }
+        }
+        LeaveCriticalSection(&launcher->lock);
+
+        if (stop) break;
+
+        DWORD result = WaitForMultipleObjects(count, handles, FALSE, INFINITE);
+        if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + count) {
+            DWORD index = result - WAIT_OBJECT_0;
+            handle_process_exit(launcher, pids[index], handles[index]);
+        }
+
+        for (DWORD i = 1; i < count; i++) {
+            CloseHandle(handles[i]);
+        }
+
+        if (result == WAIT_FAILED) break;
+    }
+
+    return 0;
+}
+
+/* Tell the monitor thread the set of running processes has changed */
+static void monitor_wake(app_launcher *launcher)
+{
+    SetEvent(launcher->monitor_wake);
+}
+
 /*
  * Lifecycle functions
  */
@@ -130,6 +313,20 @@ app_launcher *launcher_create(void)
     launcher->app_count = 0;
     launcher->app_capacity = INITIAL_CAPACITY;
 
+    InitializeCriticalSection(&launcher->lock);
+    launcher->monitor_wake = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (launcher->monitor_wake) {
+        launcher->monitor_thread = CreateThread(NULL, 0, monitor_thread_proc, launcher, 0, NULL);
+    }
+
+    if (!launcher->monitor_thread) {
+        if (launcher->monitor_wake) CloseHandle(launcher->monitor_wake);
+        DeleteCriticalSection(&launcher->lock);
+        free(launcher->apps);
+        free(launcher);
+        return NULL;
+    }
+
     return launcher;
 }
 
@@ -140,6 +337,16 @@ void launcher_destroy(app_launcher *launcher)
     /* Stop all running apps that should close on ira exit */
     launcher_stop_all(launcher, CLOSE_ON_IRA_EXIT);
 
+    /* Stop the monitor before releasing the handles it watches */
+    EnterCriticalSection(&launcher->lock);
+    launcher->monitor_stop = true;
+    LeaveCriticalSection(&launcher->lock);
+    monitor_wake(launcher);
+
+    WaitForSingleObject(launcher->monitor_thread, INFINITE);
+    CloseHandle(launcher->monitor_thread);
+    CloseHandle(launcher->monitor_wake);
+
     /* Close any remaining process handles and free filter resources */
     for (int i = 0; i < launcher->app_count; i++) {
         if (launcher->apps[i].process_handle) {
@@ -150,10 +357,21 @@ void launcher_destroy(app_launcher *launcher)
         filter_cleanup(&launcher->apps[i].track_filter);
     }
 
+    DeleteCriticalSection(&launcher->lock);
     free(launcher->apps);
     free(launcher);
 }
 
+void launcher_set_exit_callback(app_launcher *launcher, launcher_exit_fn fn, void *user)
+{
+    if (!launcher) return;
+
+    EnterCriticalSection(&launcher->lock);
+    launcher->on_exit = fn;
+    launcher->on_exit_user = user;
+    LeaveCriticalSection(&launcher->lock);
+}
+
 /*
  * Profile management
  */
@@ -162,8 +380,11 @@ bool launcher_add_app(app_launcher *launcher, const app_profile *profile)
 {
     if (!launcher || !profile) return false;
 
+    EnterCriticalSection(&launcher->lock);
+
     /* Check for duplicate name */
     if (launcher_get_app(launcher, profile->name)) {
+        LeaveCriticalSection(&launcher->lock);
         return false;
     }
 
@@ -173,6 +394,7 @@ bool launcher_add_app(app_launcher *launcher, const app_profile *profile)
         app_profile *new_apps = (app_profile *)realloc(
             launcher->apps, new_capacity * sizeof(app_profile));
         if (!new_apps) {
+            LeaveCriticalSection(&launcher->lock);
             return false;
         }
         launcher->apps = new_apps;
@@ -186,8 +408,13 @@ bool launcher_add_app(app_launcher *launcher, const app_profile *profile)
     launcher->apps[launcher->app_count].process_handle = NULL;
     launcher->apps[launcher->app_count].process_id = 0;
     launcher->apps[launcher->app_count].is_running = false;
+    launcher->apps[launcher->app_count].stopping = false;
+    launcher->apps[launcher->app_count].exit_code = 0;
+    launcher->apps[launcher->app_count].restart_count = 0;
+    launcher->apps[launcher->app_count].launch_ms = 0;
 
     launcher->app_count++;
+    LeaveCriticalSection(&launcher->lock);
     return true;
 }
 
@@ -195,13 +422,14 @@ bool launcher_remove_app(app_launcher *launcher, const char *name)
 {
     if (!launcher || !name) return false;
 
+    /* Stop the app if running */
+    if (launcher_is_running(launcher, name)) {
+        launcher_stop_app(launcher, name);
+    }
+
+    EnterCriticalSection(&launcher->lock);
     for (int i = 0; i < launcher->app_count; i++) {
         if (strcmp(launcher->apps[i].name, name) == 0) {
-            /* Stop the app if running */
-            if (launcher->apps[i].is_running) {
-                launcher_stop_app(launcher, name);
-            }
-
             /* Close handle if open */
             if (launcher->apps[i].process_handle) {
                 CloseHandle(launcher->apps[i].process_handle);
@@ -216,9 +444,11 @@ bool launcher_remove_app(app_launcher *launcher, const char *name)
                 launcher->apps[j] = launcher->apps[j + 1];
             }
             launcher->app_count--;
+            LeaveCriticalSection(&launcher->lock);
             return true;
         }
     }
+    LeaveCriticalSection(&launcher->lock);
 
     return false;
 }
@@ -255,64 +485,21 @@ int launcher_get_app_count(const app_launcher *launcher)
 
 bool launcher_start_app(app_launcher *launcher, const char *name)
 {
-    app_profile *app = launcher_get_app(launcher, name);
-    if (!app) return false;
-
-    /* Don't start if disabled */
-    if (!app->enabled) return false;
-
-    /* Check if already running */
-    launcher_update_status(launcher);
-    if (app->is_running) return true;
+    if (!launcher) return false;
 
-    /* Build command line */
-    char cmdline[MAX_PATH + 256 + 4];
-    if (app->args[0] != '\0') {
-        snprintf(cmdline, sizeof(cmdline), "\"%s\" %s", app->exe_path, app->args);
-    } else {
-        snprintf(cmdline, sizeof(cmdline), "\"%s\"", app->exe_path);
-    }
-
-    /* Set up working directory */
-    const char *work_dir = NULL;
-    if (app->working_dir[0] != '\0') {
-        work_dir = app->working_dir;
-    }
-
-    /* Create process */
-    STARTUPINFOA si;
-    PROCESS_INFORMATION pi;
-
-    memset(&si, 0, sizeof(si));
-    si.cb = sizeof(si);
-    memset(&pi, 0, sizeof(pi));
-
-    BOOL success = CreateProcessA(
-        NULL,           /* Application name (use command line) */
-        cmdline,        /* Command line */
-        NULL,           /* Process security attributes */
-        NULL,           /* Thread security attributes */
-        FALSE,          /* Inherit handles */
-        CREATE_NEW_CONSOLE, /* Creation flags */
-        NULL,           /* Environment */
-        work_dir,       /* Working directory */
-        &si,            /* Startup info */
-        &pi             /* Process information */
-    );
+    EnterCriticalSection(&launcher->lock);
+    app_profile *app = launcher_get_app(launcher, name);
 
-    if (!success) {
-        return false;
+    /* Don't start if missing or disabled; already running counts as started */
+    bool success = app && app->enabled;
+    if (success && !app->is_running) {
+        success = spawn_process(app);
+        if (success) app->restart_count = 0;
     }
+    LeaveCriticalSection(&launcher->lock);
 
-    /* Store process info */
-    app->process_handle = pi.hProcess;
-    app->process_id = pi.dwProcessId;
-    app->is_running = true;
-
-    /* Don't need the thread handle */
-    CloseHandle(pi.hThread);
-
-    return true;
+    if (success) monitor_wake(launcher);
+    return success;
 }
 
 /* Callback for EnumWindows to find main window of a process */
@@ -339,54 +526,246 @@ static BOOL CALLBACK find_main_window_callback(HWND hwnd, LPARAM lparam)
 
 bool launcher_stop_app(app_launcher *launcher, const char *name)
 {
-    app_profile *app = launcher_get_app(launcher, name);
-    if (!app) return false;
+    if (!launcher) return false;
 
-    /* Update status first */
-    launcher_update_status(launcher);
+    EnterCriticalSection(&launcher->lock);
+    app_profile *app = launcher_get_app(launcher, name);
+    if (!app) {
+        LeaveCriticalSection(&launcher->lock);
+        return false;
+    }
 
     if (!app->is_running || !app->process_handle) {
+        LeaveCriticalSection(&launcher->lock);
         return true; /* Already stopped */
     }
 
+    /* Keep our own handle so the wait below can run without the lock */
+    HANDLE process = NULL;
+    DWORD pid = app->process_id;
+    if (!DuplicateHandle(GetCurrentProcess(), app->process_handle,
+                         GetCurrentProcess(), &process, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        LeaveCriticalSection(&launcher->lock);
+        return false;
+    }
+    app->stopping = true;
+    LeaveCriticalSection(&launcher->lock);
+
+    long long start = stats_now();
+
     /* Try graceful shutdown first: send WM_CLOSE to main window */
-    find_window_data data = { app->process_id, NULL };
+    find_window_data data = { pid, NULL };
     EnumWindows(find_main_window_callback, (LPARAM)&data);
 
+    bool exited = false;
     if (data.main_window) {
         PostMessageA(data.main_window, WM_CLOSE, 0, 0);
 
         /* Wait for graceful exit (up to 3 seconds) */
-        if (WaitForSingleObject(app->process_handle, 3000) == WAIT_OBJECT_0) {
-            CloseHandle(app->process_handle);
-            app->process_handle = NULL;
-            app->process_id = 0;
-            app->is_running = false;
-            return true;
-        }
+        exited = (WaitForSingleObject(process, 3000) == WAIT_OBJECT_0);
     }
 
     /* Graceful shutdown failed - force terminate */
-    TerminateProcess(app->process_handle, 0);
-    WaitForSingleObject(app->process_handle, 1000);
+    if (!exited) {
+        TerminateProcess(process, 0);
+        WaitForSingleObject(process, 1000);
+    }
 
-    CloseHandle(app->process_handle);
-    app->process_handle = NULL;
-    app->process_id = 0;
-    app->is_running = false;
+    DWORD exit_code = 0;
+    GetExitCodeProcess(process, &exit_code);
+    CloseHandle(process);
+    stats_span_end(STAT_SPAN_APP_STOP, start);
+
+    /* The monitor may already have recorded the exit */
+    EnterCriticalSection(&launcher->lock);
+    app = find_app_by_pid(launcher, pid);
+    if (app) {
+        mark_exited(app, exit_code);
+    }
+    LeaveCriticalSection(&launcher->lock);
 
+    monitor_wake(launcher);
     return true;
 }
 
+/*
+ * Parallel start batches
+ */
+
+/* One app in a start batch; each runs on its own thread */
+typedef struct start_job {
+    app_launcher *launcher;
+    struct start_job *batch;    /* First job of the batch */
+    char name[64];
+    char depends_on[64];
+    int dep;                    /* Job to wait for, or -1 */
+    HANDLE ready;               /* Manual-reset: started and ready, or given up */
+    HANDLE thread;
+    bool ok;                    /* Running when ready was set */
+    bool launched;              /* A new process was created */
+} start_job;
+
+static DWORD WINAPI start_job_proc(LPVOID param)
+{
+    start_job *job = (start_job *)param;
+    app_launcher *launcher = job->launcher;
+
+    /* Dependents of an app that failed to start are skipped */
+    if (job->dep >= 0) {
+        start_job *dep = &job->batch[job->dep];
+        WaitForSingleObject(dep->ready, INFINITE);
+        if (!dep->ok) {
+            SetEvent(job->ready);
+            return 0;
+        }
+    }
+
+    ULONGLONG start_time = GetTickCount64();
+    HANDLE process = NULL;
+    DWORD pid = 0;
+
+    EnterCriticalSection(&launcher->lock);
+    app_profile *app = launcher_get_app(launcher, job->name);
+    job->ok = app && app->enabled;
+    if (job->ok && !app->is_running) {
+        job->ok = spawn_process(app);
+        if (job->ok) {
+            app->restart_count = 0;
+            pid = app->process_id;
+            job->launched = true;
+            if (!DuplicateHandle(GetCurrentProcess(), app->process_handle,
+                                 GetCurrentProcess(), &process, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+                process = NULL;
+            }
+        }
+    }
+    LeaveCriticalSection(&launcher->lock);
+
+    if (process) {
+        monitor_wake(launcher);
+
+        /* Ready once the app is waiting for input; console apps return at once */
+        WaitForInputIdle(process, LAUNCHER_READY_TIMEOUT_MS);
+        DWORD elapsed = (DWORD)(GetTickCount64() - start_time);
+        CloseHandle(process);
+
+        EnterCriticalSection(&launcher->lock);
+        app = find_app_by_pid(launcher, pid);
+        if (app) {
+            app->launch_ms = elapsed;
+        } else {
+            job->ok = false;    /* Exited before becoming ready */
+        }
+        LeaveCriticalSection(&launcher->lock);
+    }
+
+    SetEvent(job->ready);
+    return 0;
+}
+
+/* Does following job's dependency chain lead back to it? */
+static bool dependency_cycles(const start_job *jobs, int count, int job)
+{
+    int cur = jobs[job].dep;
+    for (int steps = 0; cur >= 0 && steps < count; steps++) {
+        if (cur == job) return true;
+        cur = jobs[cur].dep;
+    }
+    return cur == job;
+}
+
+/*
+ * Helper: Start a batch of apps in parallel, honouring depends_on within
+ * the batch. Dependencies outside the batch are not waited for, and
+ * cycles are broken. Returns the number of apps launched.
+ */
+static int run_start_batch(app_launcher *launcher, start_job *jobs, int count)
+{
+    for (int i = 0; i < count; i++) {
+        jobs[i].launcher = launcher;
+        jobs[i].batch = jobs;
+        jobs[i].dep = -1;
+        for (int j = 0; j < count && jobs[i].depends_on[0] != '\0'; j++) {
+            if (j != i && strcmp(jobs[i].depends_on, jobs[j].name) == 0) {
+                jobs[i].dep = j;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (dependency_cycles(jobs, count, i)) {
+            jobs[i].dep = -1;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        jobs[i].ready = CreateEventA(NULL, TRUE, FALSE, NULL);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].ready) {
+            jobs[i].thread = CreateThread(NULL, 0, start_job_proc, &jobs[i], 0, NULL);
+        }
+        if (!jobs[i].thread) {
+            /*
+             * No thread: fail the job rather than start it inline, which
+             * would block here on a dependency not yet given its thread.
+             * Dependents see it failed and are skipped.
+             */
+            jobs[i].ok = false;
+            if (jobs[i].ready) {
+                SetEvent(jobs[i].ready);
+            }
+        }
+    }
+
+    int launched = 0;
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].thread) {
+            WaitForSingleObject(jobs[i].thread, INFINITE);
+            CloseHandle(jobs[i].thread);
+        }
+        if (jobs[i].ready) {
+            CloseHandle(jobs[i].ready);
+        }
+        if (jobs[i].launched && jobs[i].ok) {
+            launched++;
+        }
+    }
+
+    return launched;
+}
+
+/* Add an app to a start batch. Call with the lock held. */
+static void add_start_job(start_job *jobs, int *count, const app_profile *app)
+{
+    start_job *job = &jobs[(*count)++];
+    memset(job, 0, sizeof(*job));
+    strncpy(job->name, app->name, sizeof(job->name) - 1);
+    strncpy(job->depends_on, app->depends_on, sizeof(job->depends_on) - 1);
+}
+
 void launcher_start_all(app_launcher *launcher, launch_trigger trigger)
 {
     if (!launcher) return;
 
-    for (int i = 0; i < launcher->app_count; i++) {
-        if (launcher->apps[i].enabled && launcher->apps[i].trigger == trigger) {
-            launcher_start_app(launcher, launcher->apps[i].name);
+    EnterCriticalSection(&launcher->lock);
+    start_job *jobs = (start_job *)calloc(launcher->app_count > 0 ? launcher->app_count : 1,
+                                          sizeof(start_job));
+    int count = 0;
+    for (int i = 0; jobs && i < launcher->app_count; i++) {
+        const app_profile *app = &launcher->apps[i];
+        if (app->enabled && app->trigger == trigger && !app->is_running) {
+            add_start_job(jobs, &count, app);
         }
     }
+    LeaveCriticalSection(&launcher->lock);
+
+    if (jobs) {
+        run_start_batch(launcher, jobs, count);
+        free(jobs);
+    }
 }
 
 void launcher_stop_all(app_launcher *launcher, close_behavior behavior)
@@ -422,9 +801,15 @@ int launcher_update_for_session(app_launcher *launcher, int car_id, int track_id
     if (!launcher) return 0;
 
     int changes = 0;
-    launcher_update_status(launcher);
 
-    for (int i = 0; i < launcher->app_count; i++) {
+    EnterCriticalSection(&launcher->lock);
+    int capacity = launcher->app_count > 0 ? launcher->app_count : 1;
+    start_job *jobs = (start_job *)calloc(capacity, sizeof(start_job));
+    char (*stop_names)[64] = calloc(capacity, sizeof(*stop_names));
+    int start_count = 0;
+    int stop_count = 0;
+
+    for (int i = 0; jobs && stop_names && i < launcher->app_count; i++) {
         app_profile *app = &launcher->apps[i];
 
         /* Only consider enabled apps with session triggers */
@@ -436,18 +821,26 @@ int launcher_update_for_session(app_launcher *launcher, int car_id, int track_id
         bool is_running = app->is_running;
 
         if (should_run && !is_running) {
-            /* Start the app */
-            if (launcher_start_app(launcher, app->name)) {
-                changes++;
-            }
+            add_start_job(jobs, &start_count, app);
         } else if (!should_run && is_running) {
-            /* Stop the app */
-            if (launcher_stop_app(launcher, app->name)) {
-                changes++;
-            }
+            strncpy(stop_names[stop_count++], app->name, 63);
+        }
+    }
+    LeaveCriticalSection(&launcher->lock);
+
+    /* Stop apps that no longer match, then start the new set together */
+    for (int i = 0; i < stop_count; i++) {
+        if (launcher_stop_app(launcher, stop_names[i])) {
+            changes++;
         }
     }
 
+    if (jobs) {
+        changes += run_start_batch(launcher, jobs, start_count);
+    }
+
+    free(jobs);
+    free(stop_names);
     return changes;
 }
 
@@ -457,52 +850,15 @@ int launcher_update_for_session(app_launcher *launcher, int car_id, int track_id
 
 bool launcher_is_running(app_launcher *launcher, const char *name)
 {
-    app_profile *app = launcher_get_app(launcher, name);
-    if (!app) return false;
-
-    /* Update status before returning */
-    if (app->process_handle) {
-        DWORD exit_code;
-        if (GetExitCodeProcess(app->process_handle, &exit_code)) {
-            app->is_running = (exit_code == STILL_ACTIVE);
-        } else {
-            app->is_running = false;
-        }
-
-        /* Clean up handle if process has exited */
-        if (!app->is_running) {
-            CloseHandle(app->process_handle);
-            app->process_handle = NULL;
-            app->process_id = 0;
-        }
-    }
-
-    return app->is_running;
-}
-
-void launcher_update_status(app_launcher *launcher)
-{
-    if (!launcher) return;
+    if (!launcher) return false;
 
-    for (int i = 0; i < launcher->app_count; i++) {
-        app_profile *app = &launcher->apps[i];
-
-        if (app->process_handle) {
-            DWORD exit_code;
-            if (GetExitCodeProcess(app->process_handle, &exit_code)) {
-                app->is_running = (exit_code == STILL_ACTIVE);
-            } else {
-                app->is_running = false;
-            }
+    /* State is kept current by the monitor thread */
+    EnterCriticalSection(&launcher->lock);
+    app_profile *app = launcher_get_app(launcher, name);
+    bool running = app && app->is_running;
+    LeaveCriticalSection(&launcher->lock);
 
-            /* Clean up handle if process has exited */
-            if (!app->is_running) {
-                CloseHandle(app->process_handle);
-                app->process_handle = NULL;
-                app->process_id = 0;
-            }
-        }
-    }
+    return running;
 }
 
 /*
@@ -586,6 +942,25 @@ bool launcher_load_config(app_launcher *launcher, const char *filename)
             profile.enabled = true;
         }
 
+        val = json_object_get(app_obj, "restart_on_crash");
+        if (val && json_get_type(val) == JSON_BOOL) {
+            profile.restart_on_crash = json_get_bool(val);
+        }
+
+        val = json_object_get(app_obj, "max_restarts");
+        if (val && json_get_type(val) == JSON_NUMBER) {
+            profile.max_restarts = json_get_int(val);
+        } else {
+            profile.max_restarts = LAUNCHER_DEFAULT_MAX_RESTARTS;
+        }
+
+        /* "after" is accepted as an alias of "depends_on" */
+        val = json_object_get(app_obj, "depends_on");
+        if (!val) val = json_object_get(app_obj, "after");
+        if (val && json_get_type(val) == JSON_STRING) {
+            strncpy(profile.depends_on, json_get_string(val), sizeof(profile.depends_on) - 1);
+        }
+
         /* Parse car filter */
         json_value *car_filter = json_object_get(app_obj, "car_filter");
         if (car_filter && json_get_type(car_filter) == JSON_OBJECT) {
@@ -677,6 +1052,11 @@ bool launcher_save_config(const app_launcher *launcher, const char *filename)
         json_object_set(app_obj, "on_close",
                        json_new_string(launcher_close_to_string(app->on_close)));
         json_object_set(app_obj, "enabled", json_new_bool(app->enabled));
+        json_object_set(app_obj, "restart_on_crash", json_new_bool(app->restart_on_crash));
+        json_object_set(app_obj, "max_restarts", json_new_number(app->max_restarts));
+        if (app->depends_on[0] != '\0') {
+            json_object_set(app_obj, "depends_on", json_new_string(app->depends_on));
+        }
 
         /* Write car filter */
         json_value *car_filter_obj = json_new_object();
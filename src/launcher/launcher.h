@@ -49,6 +49,9 @@ typedef struct {
     launch_trigger trigger;
     close_behavior on_close;
     bool enabled;
+    bool restart_on_crash;      /* Relaunch after a non-zero exit */
+    int max_restarts;           /* Crash restarts allowed per launch */
+    char depends_on[64];        /* Start after this app is ready (optional) */
 
     /* Content filters for conditional launching */
     content_filter car_filter;
@@ -58,13 +61,44 @@ typedef struct {
     HANDLE process_handle;
     DWORD process_id;
     bool is_running;
+    bool stopping;              /* Exit was requested by ira */
+    DWORD exit_code;            /* Exit code of the last run */
+    int restart_count;          /* Crash restarts since the last launch */
+    DWORD launch_ms;            /* Launch to ready time of the last batch start */
 } app_profile;
 
-/* Application launcher manager */
+/* Default restart limit when restart_on_crash is set */
+#define LAUNCHER_DEFAULT_MAX_RESTARTS 3
+
+/* Longest wait for an app to become ready before its dependents start */
+#define LAUNCHER_READY_TIMEOUT_MS 10000
+
+/*
+ * Exit notification, called on the monitor thread when an app exits on
+ * its own (not for apps stopped by ira). restarted is true when the app
+ * was relaunched by restart_on_crash.
+ */
+typedef void (*launcher_exit_fn)(void *user, const char *name, DWORD exit_code, bool restarted);
+
+/*
+ * Application launcher manager
+ *
+ * A monitor thread waits on the process handles of running apps, so
+ * is_running and exit_code are updated as soon as a process exits.
+ * App state is guarded by lock.
+ */
 typedef struct {
     app_profile *apps;
     int app_count;
     int app_capacity;
+
+    /* Process monitor */
+    CRITICAL_SECTION lock;
+    HANDLE monitor_thread;
+    HANDLE monitor_wake;        /* Auto-reset: watched set changed or stopping */
+    bool monitor_stop;
+    launcher_exit_fn on_exit;
+    void *on_exit_user;
 } app_launcher;
 
 /*
@@ -106,7 +140,12 @@ bool launcher_start_app(app_launcher *launcher, const char *name);
 /* Stop a specific app by name. Returns true on success. */
 bool launcher_stop_app(app_launcher *launcher, const char *name);
 
-/* Start all enabled apps matching the given trigger. */
+/*
+ * Start all enabled apps matching the given trigger.
+ * Apps are launched in parallel; an app whose depends_on names another app
+ * in the same batch waits until that app is ready (input idle).
+ * Returns once every app in the batch is ready or has timed out.
+ */
 void launcher_start_all(app_launcher *launcher, launch_trigger trigger);
 
 /* Stop all enabled apps matching the given close behavior. */
@@ -115,7 +154,10 @@ void launcher_stop_all(app_launcher *launcher, close_behavior behavior);
 /* Check if app should run given current car/track IDs */
 bool launcher_app_matches_session(const app_profile *app, int car_id, int track_id);
 
-/* Evaluate all apps and start/stop based on session. Returns count of changes. */
+/*
+ * Evaluate all apps and start/stop based on session. Starts are batched
+ * like launcher_start_all. Returns count of changes.
+ */
 int launcher_update_for_session(app_launcher *launcher, int car_id, int track_id);
 
 /*
@@ -125,8 +167,8 @@ int launcher_update_for_session(app_launcher *launcher, int car_id, int track_id
 /* Check if a specific app is running. */
 bool launcher_is_running(app_launcher *launcher, const char *name);
 
-/* Update the running status of all apps (poll process state). */
-void launcher_update_status(app_launcher *launcher);
+/* Set (or clear with NULL) the exit notification callback. */
+void launcher_set_exit_callback(app_launcher *launcher, launcher_exit_fn fn, void *user);
 
 /*
  * Persistence (JSON config)
@@ -11,16 +11,23 @@
 #include <stdlib.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "irsdk/irsdk.h"
 #include "irsdk/yaml_parser.h"
 #include "util/config.h"
+#include "util/worker.h"
+#include "util/stats.h"
 #include "telemetry/telemetry_log.h"
+#include "telemetry/telemetry_hub.h"
+#include "telemetry/lap_store.h"
+#include "telemetry/telemetry_timing.h"
 #include "launcher/launcher.h"
 #include "data/database.h"
 #include "data/models.h"
 #include "filter/race_filter.h"
+#include "filter/race_schedule.h"
 #include "api/iracing_api.h"
 
 /* Version info */
@@ -39,6 +46,28 @@ static void signal_handler(int sig)
     printf("\nShutting down...\n");
 }
 
+/* Runtime statistics file written on exit, from --stats-dump */
+static const char *g_stats_dump_path = NULL;
+
+/* atexit handler, so every command's exit path writes the dump */
+static void write_stats_dump(void)
+{
+    if (g_stats_dump_path && !stats_dump_json(g_stats_dump_path)) {
+        printf("Warning: Could not write statistics to %s\n", g_stats_dump_path);
+    }
+}
+
+/* Report apps that exit on their own; called on the launcher's monitor thread */
+static void on_app_exit(void *user, const char *name, DWORD exit_code, bool restarted)
+{
+    (void)user;
+    if (restarted) {
+        printf("\n'%s' exited with code %lu - restarted.\n", name, (unsigned long)exit_code);
+    } else {
+        printf("\n'%s' exited (code %lu).\n", name, (unsigned long)exit_code);
+    }
+}
+
 /*
  * Console input functions using Windows API
  */
@@ -132,68 +161,101 @@ typedef struct {
     float track_length_km;
     int car_id;
     int track_id;
+    int field_size;             /* Drivers in the session, excluding the pace car */
 } SessionInfo;
 
-/* Telemetry variable offsets (cached for performance) */
+/* Console telemetry, gathered each tick through one var view */
 typedef struct {
+    irsdk_var_view *view;
+    int required[3];            /* Speed, RPM and Gear must exist */
+
+    /* Slots in the arrays below */
     int speed;
     int rpm;
-    int gear;
     int throttle;
     int brake;
     int clutch;
-    int lap;
     int lap_dist_pct;
-    int session_time;
     int fuel_level;
+    int gear;
+    int lap;
+    int session_time;
     int is_on_track;
-} TelemetryOffsets;
 
-/* Parse session info from YAML */
-static bool parse_session_info(SessionInfo *info)
+    float floats[7];
+    int ints[2];
+    double doubles[1];
+    bool bools[1];
+} TelemetryView;
+
+/* Session info index, owned by the session worker */
+static yaml_index *g_session_index = NULL;
+
+/* Parse session info from a YAML snapshot */
+static bool parse_session_info(SessionInfo *info, const char *yaml)
 {
-    const char *yaml = irsdk_get_session_info();
     if (!yaml) {
         return false;
     }
 
+    if (!g_session_index) {
+        g_session_index = yaml_index_create();
+        if (!g_session_index) return false;
+    }
+    long long start = stats_now();
+    if (!yaml_index_build(g_session_index, yaml)) {
+        return false;
+    }
+    stats_span_end(STAT_SPAN_YAML_PARSE, start);
+    const yaml_index *idx = g_session_index;
+
     memset(info, 0, sizeof(SessionInfo));
 
     /* Parse track info */
-    yaml_parse_string(yaml, "WeekendInfo:TrackDisplayName", info->track_name, sizeof(info->track_name));
+    yaml_index_string(idx, "WeekendInfo:TrackDisplayName", info->track_name, sizeof(info->track_name));
     if (info->track_name[0] == '\0') {
-        yaml_parse_string(yaml, "WeekendInfo:TrackName", info->track_name, sizeof(info->track_name));
+        yaml_index_string(idx, "WeekendInfo:TrackName", info->track_name, sizeof(info->track_name));
     }
-    yaml_parse_string(yaml, "WeekendInfo:TrackConfigName", info->track_config, sizeof(info->track_config));
+    yaml_index_string(idx, "WeekendInfo:TrackConfigName", info->track_config, sizeof(info->track_config));
 
     /* Parse track length */
     char track_len_str[32];
-    if (yaml_parse_string(yaml, "WeekendInfo:TrackLength", track_len_str, sizeof(track_len_str))) {
+    if (yaml_index_string(idx, "WeekendInfo:TrackLength", track_len_str, sizeof(track_len_str))) {
         /* Format is usually "X.XX km" */
         info->track_length_km = (float)atof(track_len_str);
     }
 
     /* Parse driver info */
-    yaml_parse_int(yaml, "DriverInfo:DriverCarIdx", &info->driver_car_idx);
+    yaml_index_int(idx, "DriverInfo:DriverCarIdx", &info->driver_car_idx);
 
     /* Build path for driver-specific info */
     char path[128];
     snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}UserName", info->driver_car_idx);
-    yaml_parse_string(yaml, path, info->driver_name, sizeof(info->driver_name));
+    yaml_index_string(idx, path, info->driver_name, sizeof(info->driver_name));
 
     snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}CarScreenName", info->driver_car_idx);
-    yaml_parse_string(yaml, path, info->car_name, sizeof(info->car_name));
+    yaml_index_string(idx, path, info->car_name, sizeof(info->car_name));
     if (info->car_name[0] == '\0') {
         snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}CarPath", info->driver_car_idx);
-        yaml_parse_string(yaml, path, info->car_name, sizeof(info->car_name));
+        yaml_index_string(idx, path, info->car_name, sizeof(info->car_name));
     }
 
     /* Parse car ID */
     snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}CarID", info->driver_car_idx);
-    yaml_parse_int(yaml, path, &info->car_id);
+    yaml_index_int(idx, path, &info->car_id);
 
     /* Parse track ID */
-    yaml_parse_int(yaml, "WeekendInfo:TrackID", &info->track_id);
+    yaml_index_int(idx, "WeekendInfo:TrackID", &info->track_id);
+
+    /* Count the field, leaving out the pace car */
+    yaml_list_iter drivers;
+    if (yaml_index_list(idx, "DriverInfo:Drivers", &drivers)) {
+        while (yaml_list_next(&drivers)) {
+            int pace_car = 0;
+            yaml_list_int(&drivers, "CarIsPaceCar", &pace_car);
+            if (!pace_car) info->field_size++;
+        }
+    }
 
     return info->track_name[0] != '\0';
 }
@@ -217,43 +279,247 @@ static void display_session_info(const SessionInfo *info)
     if (info->driver_name[0] != '\0') {
         printf("Driver: %s\n", info->driver_name);
     }
+    if (info->field_size > 0) {
+        printf("Field: %d cars\n", info->field_size);
+    }
     printf("----------------------------------------\n\n");
 }
 
-/* Initialize telemetry offsets */
-static bool init_telemetry_offsets(TelemetryOffsets *offsets)
+/*
+ * Session Worker
+ *
+ * Session info parsing, app launching and the console output that goes with
+ * them run here, so the telemetry loop only samples and publishes.
+ */
+
+/* Messages posted to the session worker */
+enum {
+    SESSION_MSG_CONNECTED,      /* Start LAUNCH_ON_CONNECT apps */
+    SESSION_MSG_STARTED,        /* Start LAUNCH_ON_SESSION apps */
+    SESSION_MSG_UPDATE,         /* Payload: session_update_msg */
+    SESSION_MSG_DISCONNECTED    /* Stop CLOSE_ON_IRACING_EXIT apps */
+};
+
+/* SESSION_MSG_UPDATE payload; the YAML text follows the header */
+typedef struct {
+    bool initial;               /* First parse after (re)connecting */
+    char yaml[];
+} session_update_msg;
+
+/* Worker state; only touched by the worker thread between flushes */
+typedef struct {
+    app_launcher *launcher;
+    car_switch_mode car_switch_behavior;
+    SessionInfo info;
+    int last_car_id;
+    int last_track_id;
+} session_worker_state;
+
+static void handle_session_update(session_worker_state *st, const session_update_msg *msg)
 {
-    offsets->speed = irsdk_var_name_to_offset("Speed");
-    offsets->rpm = irsdk_var_name_to_offset("RPM");
-    offsets->gear = irsdk_var_name_to_offset("Gear");
-    offsets->throttle = irsdk_var_name_to_offset("Throttle");
-    offsets->brake = irsdk_var_name_to_offset("Brake");
-    offsets->clutch = irsdk_var_name_to_offset("Clutch");
-    offsets->lap = irsdk_var_name_to_offset("Lap");
-    offsets->lap_dist_pct = irsdk_var_name_to_offset("LapDistPct");
-    offsets->session_time = irsdk_var_name_to_offset("SessionTime");
-    offsets->fuel_level = irsdk_var_name_to_offset("FuelLevel");
-    offsets->is_on_track = irsdk_var_name_to_offset("IsOnTrack");
-
-    /* Check that essential variables were found */
-    if (offsets->speed < 0 || offsets->rpm < 0 || offsets->gear < 0) {
+    if (!msg->initial) {
+        printf("\n\nSession info updated!\n");
+    }
+
+    if (!parse_session_info(&st->info, msg->yaml)) {
+        return;
+    }
+    display_session_info(&st->info);
+
+    const SessionInfo *info = &st->info;
+
+    if (msg->initial) {
+        /* Initial filter evaluation for session apps */
+        if (st->launcher && info->car_id > 0) {
+            int changes = launcher_update_for_session(st->launcher, info->car_id, info->track_id);
+            if (changes > 0) {
+                printf("Launched/stopped %d app(s) based on car/track filters.\n\n", changes);
+            }
+        }
+    } else {
+        /* Check for car/track changes */
+        bool car_changed = (info->car_id != st->last_car_id && info->car_id > 0);
+        bool track_changed = (info->track_id != st->last_track_id && info->track_id > 0);
+
+        if ((car_changed || track_changed) && st->launcher) {
+            if (st->car_switch_behavior == CAR_SWITCH_AUTO) {
+                int changes = launcher_update_for_session(st->launcher, info->car_id, info->track_id);
+                if (changes > 0) {
+                    printf("Switched %d app(s) for new car/track.\n", changes);
+                }
+            } else if (st->car_switch_behavior == CAR_SWITCH_PROMPT) {
+                printf("Car/track changed. Press Enter to update apps, or continue driving...\n");
+                /* Note: Non-blocking prompt would require more complex handling */
+                /* For now, auto-switch after displaying the message */
+                int changes = launcher_update_for_session(st->launcher, info->car_id, info->track_id);
+                if (changes > 0) {
+                    printf("Switched %d app(s) for new car/track.\n", changes);
+                }
+            }
+            /* CAR_SWITCH_DISABLED: do nothing */
+        }
+    }
+
+    st->last_car_id = info->car_id;
+    st->last_track_id = info->track_id;
+}
+
+static void session_worker_handler(void *ctx, int type, const void *payload, size_t size)
+{
+    session_worker_state *st = (session_worker_state *)ctx;
+    (void)size;
+
+    switch (type) {
+    case SESSION_MSG_CONNECTED:
+        if (st->launcher) launcher_start_all(st->launcher, LAUNCH_ON_CONNECT);
+        break;
+    case SESSION_MSG_STARTED:
+        if (st->launcher) launcher_start_all(st->launcher, LAUNCH_ON_SESSION);
+        break;
+    case SESSION_MSG_UPDATE:
+        handle_session_update(st, (const session_update_msg *)payload);
+        break;
+    case SESSION_MSG_DISCONNECTED:
+        if (st->launcher) launcher_stop_all(st->launcher, CLOSE_ON_IRACING_EXIT);
+        break;
+    }
+}
+
+/*
+ * Snapshot the session info and hand it to the worker.
+ * The copy lets iRacing rewrite its buffer while the worker parses.
+ */
+static bool post_session_update(worker *w, bool initial)
+{
+    const char *yaml = irsdk_get_session_info();
+    if (!yaml) {
+        return false;
+    }
+
+    /* The YAML is copied once, straight into the queued message */
+    session_update_msg head = { .initial = initial };
+    return worker_post_parts(w, SESSION_MSG_UPDATE, &head, offsetof(session_update_msg, yaml),
+                             yaml, strlen(yaml) + 1);
+}
+
+/* Helper: add one scalar to the view and return its slot */
+static int add_view_var(irsdk_var_view *view, const char *name, irsdk_VarType type, int *var)
+{
+    int index = irsdk_var_view_add(view, name, type, 1);
+    if (var) {
+        *var = index;
+    }
+    return irsdk_var_view_slot(view, index);
+}
+
+/* Build the console telemetry view. Returns false on allocation failure. */
+static bool create_telemetry_view(TelemetryView *tv)
+{
+    memset(tv, 0, sizeof(*tv));
+    tv->view = irsdk_var_view_create();
+    if (!tv->view) {
+        return false;
+    }
+
+    tv->speed = add_view_var(tv->view, "Speed", IRSDK_TYPE_FLOAT, &tv->required[0]);
+    tv->rpm = add_view_var(tv->view, "RPM", IRSDK_TYPE_FLOAT, &tv->required[1]);
+    tv->gear = add_view_var(tv->view, "Gear", IRSDK_TYPE_INT, &tv->required[2]);
+    tv->throttle = add_view_var(tv->view, "Throttle", IRSDK_TYPE_FLOAT, NULL);
+    tv->brake = add_view_var(tv->view, "Brake", IRSDK_TYPE_FLOAT, NULL);
+    tv->clutch = add_view_var(tv->view, "Clutch", IRSDK_TYPE_FLOAT, NULL);
+    tv->lap = add_view_var(tv->view, "Lap", IRSDK_TYPE_INT, NULL);
+    tv->lap_dist_pct = add_view_var(tv->view, "LapDistPct", IRSDK_TYPE_FLOAT, NULL);
+    tv->session_time = add_view_var(tv->view, "SessionTime", IRSDK_TYPE_DOUBLE, NULL);
+    tv->fuel_level = add_view_var(tv->view, "FuelLevel", IRSDK_TYPE_FLOAT, NULL);
+    tv->is_on_track = add_view_var(tv->view, "IsOnTrack", IRSDK_TYPE_BOOL, NULL);
+
+    /* A failed add leaves its slot -1, which would index the gathered values */
+    const int slots[] = {
+        tv->speed, tv->rpm, tv->gear, tv->throttle, tv->brake, tv->clutch,
+        tv->lap, tv->lap_dist_pct, tv->session_time, tv->fuel_level, tv->is_on_track
+    };
+    bool added = true;
+    for (int i = 0; i < (int)(sizeof(slots) / sizeof(slots[0])); i++) {
+        if (slots[i] < 0) {
+            added = false;
+        }
+    }
+
+    if (!added ||
+        irsdk_var_view_size(tv->view, IRSDK_TYPE_FLOAT) > (int)(sizeof(tv->floats) / sizeof(tv->floats[0])) ||
+        irsdk_var_view_size(tv->view, IRSDK_TYPE_INT) > (int)(sizeof(tv->ints) / sizeof(tv->ints[0])) ||
+        irsdk_var_view_size(tv->view, IRSDK_TYPE_DOUBLE) > (int)(sizeof(tv->doubles) / sizeof(tv->doubles[0])) ||
+        irsdk_var_view_size(tv->view, IRSDK_TYPE_BOOL) > (int)(sizeof(tv->bools) / sizeof(tv->bools[0]))) {
+        irsdk_var_view_destroy(tv->view);
+        tv->view = NULL;
         return false;
     }
 
     return true;
 }
 
+/* Resolve the view against the sim. Returns false if essentials are missing. */
+static bool resolve_telemetry_view(TelemetryView *tv)
+{
+    irsdk_var_view_resolve(tv->view);
+
+    for (int i = 0; i < (int)(sizeof(tv->required) / sizeof(tv->required[0])); i++) {
+        if (!irsdk_var_view_found(tv->view, tv->required[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Everything holding variable offsets, rebound when the sim's layout changes */
+typedef struct {
+    char **data;
+    TelemetryView *view;
+    telem_logger **logger;
+    telem_hub *hub;
+    lap_store *laps;
+} LayoutBindings;
+
+/* Layout listener: grow the data buffer and resolve every accessor again */
+static void on_layout_change(void *user)
+{
+    LayoutBindings *b = (LayoutBindings *)user;
+
+    int buf_len = irsdk_get_buf_len();
+    if (buf_len > 0) {
+        char *data = (char *)realloc(*b->data, buf_len);
+        if (!data) {
+            printf("\nError: Could not resize the telemetry buffer\n");
+            g_running = false;
+            return;
+        }
+        *b->data = data;
+    }
+
+    if (!resolve_telemetry_view(b->view)) {
+        printf("\nWarning: Telemetry variables missing after a layout change\n");
+    }
+    telem_log_rebind(*b->logger);
+    telem_hub_rebind(b->hub);
+    lap_store_rebind(b->laps);
+}
+
 /* Display telemetry data */
-static void display_telemetry(const char *data, const TelemetryOffsets *offsets, bool use_metric)
+static void display_telemetry(const char *data, TelemetryView *tv, bool use_metric,
+                              const lap_store *laps)
 {
-    float speed_mps = irsdk_get_var_float(data, offsets->speed, 0);
-    float rpm = irsdk_get_var_float(data, offsets->rpm, 0);
-    int gear = irsdk_get_var_int(data, offsets->gear, 0);
-    float throttle = irsdk_get_var_float(data, offsets->throttle, 0);
-    float brake = irsdk_get_var_float(data, offsets->brake, 0);
-    int lap = irsdk_get_var_int(data, offsets->lap, 0);
-    float lap_pct = irsdk_get_var_float(data, offsets->lap_dist_pct, 0);
-    float fuel = irsdk_get_var_float(data, offsets->fuel_level, 0);
+    irsdk_view_values values = { tv->bools, tv->ints, tv->floats, tv->doubles };
+    irsdk_var_view_gather(tv->view, data, &values);
+
+    float speed_mps = tv->floats[tv->speed];
+    float rpm = tv->floats[tv->rpm];
+    int gear = tv->ints[tv->gear];
+    float throttle = tv->floats[tv->throttle];
+    float brake = tv->floats[tv->brake];
+    int lap = tv->ints[tv->lap];
+    float lap_pct = tv->floats[tv->lap_dist_pct];
+    float fuel = tv->floats[tv->fuel_level];
 
     /* Convert speed */
     float speed_display;
@@ -282,11 +548,139 @@ static void display_telemetry(const char *data, const TelemetryOffsets *offsets,
            speed_display, speed_unit, rpm, gear_str);
     printf("Throttle: %3.0f%% | Brake: %3.0f%% | ",
            throttle * 100.0f, brake * 100.0f);
-    printf("Lap: %d (%.1f%%) | Fuel: %.1fL   ",
+    printf("Lap: %d (%.1f%%) | Fuel: %.1fL",
            lap, lap_pct * 100.0f, fuel);
+
+    float delta;
+    if (lap_store_delta_to_best(laps, &delta)) {
+        printf(" | Delta: %+.2fs", delta);
+    }
+    printf("   ");
     fflush(stdout);
 }
 
+/* Create and start a telemetry logger. Returns NULL on failure. */
+static telem_logger *start_logger(const char *log_dir, const char *session_name,
+                                  const ira_config *cfg)
+{
+    telem_logger *logger = telem_log_create(log_dir, session_name);
+    if (!logger) {
+        return NULL;
+    }
+
+    telem_log_set_format(logger, cfg->telemetry_log_binary ?
+                         TELEM_LOG_FORMAT_BINARY : TELEM_LOG_FORMAT_CSV);
+    if (cfg->telemetry_log_all_vars) {
+        int added = telem_log_add_all(logger);
+        telem_log_apply_default_rates(logger);
+        printf("Logging all %d telemetry variables\n", added);
+    } else {
+        telem_log_add_defaults(logger);
+    }
+
+    if (!telem_log_start(logger)) {
+        telem_log_destroy(logger);
+        return NULL;
+    }
+
+    printf("Logging telemetry to: %s\n\n", telem_log_get_filepath(logger));
+    return logger;
+}
+
+/* Stop and destroy a telemetry logger, reporting what it wrote */
+static void stop_logger(telem_logger *logger)
+{
+    telem_log_stop(logger);
+
+    telem_log_stats stats;
+    telem_log_get_stats(logger, &stats);
+
+    printf("Logged %d samples to: %s\n",
+           stats.samples_written, telem_log_get_filepath(logger));
+    if (stats.samples_dropped > 0 || stats.write_failed) {
+        printf("Warning: %d samples dropped%s (ring peak %d/%d)\n",
+               stats.samples_dropped, stats.write_failed ? ", write error" : "",
+               stats.ring_high_water, stats.ring_capacity);
+    }
+
+    telem_log_destroy(logger);
+}
+
+/* Print tick latency; the histogram only when asked for low latency timing */
+static void print_latency_report(const telem_timing *timing, bool histogram)
+{
+    telem_timing_stats stats;
+    telem_timing_get_stats(timing, &stats);
+    if (stats.ticks == 0) {
+        return;
+    }
+
+    printf("Tick latency: mean %.0fus, p50 <= %dus, p99 <= %dus, max %.0fus",
+           stats.mean_us, stats.p50_us, stats.p99_us, stats.max_us);
+    printf(" (%d ticks, %d over a frame, %d missed)\n",
+           stats.ticks, stats.late_ticks, stats.missed_ticks);
+
+    if (!histogram) {
+        return;
+    }
+
+    for (int i = 0; i < TELEM_TIMING_BUCKETS; i++) {
+        int limit = telem_timing_bucket_limit_us(i);
+        if (limit >= 0) {
+            printf("  <= %6dus: %d\n", limit, stats.buckets[i]);
+        } else {
+            printf("  >  %6dus: %d\n", telem_timing_bucket_limit_us(i - 1), stats.buckets[i]);
+        }
+    }
+}
+
+/* Create and start the telemetry hub from the configuration */
+static telem_hub *start_hub(const ira_config *cfg)
+{
+    telem_hub *hub = telem_hub_create();
+    if (!hub) {
+        return NULL;
+    }
+
+    if (cfg->telemetry_hub_vars[0]) {
+        telem_hub_add_list(hub, cfg->telemetry_hub_vars);
+    } else {
+        telem_hub_add_defaults(hub);
+    }
+
+    /* "host[:port]" */
+    if (cfg->telemetry_hub_udp[0]) {
+        char host[128];
+        int port = TELEM_HUB_DEFAULT_PORT;
+        strncpy(host, cfg->telemetry_hub_udp, sizeof(host) - 1);
+        host[sizeof(host) - 1] = '\0';
+
+        char *colon = strrchr(host, ':');
+        if (colon) {
+            *colon = '\0';
+            port = atoi(colon + 1);
+        }
+        if (!telem_hub_set_udp_target(hub, host, port)) {
+            printf("Warning: Invalid telemetry hub target %s\n", cfg->telemetry_hub_udp);
+        }
+    }
+
+    if (!telem_hub_start(hub)) {
+        telem_hub_destroy(hub);
+        return NULL;
+    }
+
+    telem_hub_stats stats;
+    telem_hub_get_stats(hub, &stats);
+    printf("Telemetry hub: publishing %d variables (%d bytes/tick) to %s",
+           stats.var_count, stats.row_bytes, TELEM_HUB_MEMMAPNAME);
+    if (stats.udp_active) {
+        printf(" and udp://%s", cfg->telemetry_hub_udp);
+    }
+    printf("\n\n");
+    return hub;
+}
+
 /* Print usage information */
 static void print_usage(const char *program_name)
 {
@@ -297,6 +691,17 @@ static void print_usage(const char *program_name)
     printf("  -m, --metric            Use metric units (default)\n");
     printf("  -i, --imperial          Use imperial units\n");
     printf("  --log-dir <path>        Set telemetry log directory\n");
+    printf("  --log-format <fmt>      Telemetry log format: csv or binary\n");
+    printf("  --log-all               Log every telemetry variable\n");
+    printf("  --convert-log <in> <out> Convert a binary telemetry log to CSV\n");
+    printf("  --replay <file.ibt>     Read telemetry from a recorded session instead of iRacing\n");
+    printf("  --replay-realtime       Replay at the recorded rate (default: as fast as possible)\n");
+    printf("  --hub                   Republish telemetry for overlays (shared memory)\n");
+    printf("  --hub-udp <host[:port]> Also stream telemetry to a remote dashboard\n");
+    printf("  --low-latency           1ms timer resolution and a latency histogram on exit\n");
+    printf("  --high-priority         Raise the telemetry thread's priority\n");
+    printf("  --cpu <n>               Pin the telemetry thread to CPU n\n");
+    printf("  --stats-dump <file>     Write runtime statistics to a JSON file on exit\n");
     printf("  --menu                  Open interactive configuration menu\n");
     printf("\n");
     printf("App Launcher:\n");
@@ -329,13 +734,20 @@ static void list_apps(app_launcher *launcher)
         app_profile *app = launcher_get_app_at(launcher, i);
         if (!app) continue;
 
-        launcher_update_status(launcher);
-
         printf("%d. %s\n", i + 1, app->name);
         printf("   Path:    %s\n", app->exe_path);
         printf("   Trigger: %s\n", launcher_trigger_to_string(app->trigger));
         printf("   Close:   %s\n", launcher_close_to_string(app->on_close));
         printf("   Enabled: %s\n", app->enabled ? "yes" : "no");
+        if (app->depends_on[0] != '\0') {
+            printf("   After:   %s\n", app->depends_on);
+        }
+        if (app->launch_ms > 0) {
+            printf("   Launch:  %lu ms to ready\n", (unsigned long)app->launch_ms);
+        }
+        if (app->restart_on_crash) {
+            printf("   Restart: on crash (up to %d)\n", app->max_restarts);
+        }
         printf("   Status:  %s\n", app->is_running ? "RUNNING" : "stopped");
         printf("\n");
     }
@@ -521,8 +933,59 @@ static void show_filter_status(ira_database *db)
     printf("Config file: %s\n", database_get_filter_path());
 }
 
-/* Display filtered races */
-static void show_races(ira_database *db, bool show_all)
+/*
+ * Race list kept between menu visits, so re-showing it after a filter
+ * tweak only re-checks the affected races. Tied to the menu database.
+ */
+static filter_incremental *g_race_cache = NULL;
+static filter_results *g_race_results = NULL;
+static race_schedule *g_race_schedule = NULL;
+
+static void release_race_cache(void)
+{
+    filter_incremental_destroy(g_race_cache);
+    filter_results_destroy(g_race_results);
+    race_schedule_destroy(g_race_schedule);
+    g_race_cache = NULL;
+    g_race_results = NULL;
+    g_race_schedule = NULL;
+}
+
+/* Number of upcoming races listed, and how far ahead to look */
+#define UPCOMING_RACE_COUNT 5
+#define UPCOMING_RACE_HOURS 2
+
+/* List the next races passing the filter */
+static void show_upcoming_races(ira_database *db, race_schedule *sched)
+{
+    filter_compiled compiled;
+    if (!filter_compile(&db->filter, &compiled)) return;
+
+    scheduled_race upcoming[UPCOMING_RACE_COUNT];
+    int count = race_schedule_next(sched, db, &compiled, time(NULL),
+                                   UPCOMING_RACE_HOURS * 3600, upcoming, UPCOMING_RACE_COUNT);
+    filter_compiled_free(&compiled);
+
+    if (count <= 0) return;
+
+    printf("\nStarting soon (next %dh)\n", UPCOMING_RACE_HOURS);
+    printf("----------------------------------------\n");
+    for (int i = 0; i < count; i++) {
+        ira_series *series = database_get_series(db, upcoming[i].season->series_id);
+        char when[32];
+        filter_format_time_until(upcoming[i].start_time, when, sizeof(when));
+        printf("  %-12s %s - %s\n", when,
+               series ? series->series_name : upcoming[i].season->season_name,
+               upcoming[i].week->track_name);
+    }
+}
+
+/*
+ * Display filtered races. With a cache (menu use), results are refreshed
+ * incrementally and kept; otherwise they are computed from scratch.
+ */
+static void show_races(ira_database *db, bool show_all, filter_incremental *cache,
+                       filter_results *cached_results)
 {
     if (!db) {
         printf("Error: Database not initialized\n");
@@ -537,7 +1000,8 @@ static void show_races(ira_database *db, bool show_all)
     }
 
     /* Create filter results */
-    filter_results *results = filter_results_create();
+    bool use_cache = cache && cached_results;
+    filter_results *results = use_cache ? cached_results : filter_results_create();
     if (!results) {
         printf("Error: Could not create filter results\n");
         return;
@@ -558,17 +1022,19 @@ static void show_races(ira_database *db, bool show_all)
         db->filter.max_race_mins = 0;
     }
 
-    /* Apply filter */
-    filter_apply(db, results);
+    /* Apply filter, grouped by category */
+    if (use_cache) {
+        filter_incremental_update(cache, db, results, SORT_BY_CATEGORY, true);
+    } else {
+        filter_apply_parallel(db, results, 0);
+        filter_results_sort(results, SORT_BY_CATEGORY, true);
+    }
 
     /* Restore filter if we modified it */
     if (show_all) {
         db->filter = saved_filter;
     }
 
-    /* Sort by series name */
-    filter_results_sort(results, SORT_BY_CATEGORY, true);
-
     /* Display results */
     printf("Races for Current Week\n");
     printf("========================================\n");
@@ -629,6 +1095,13 @@ static void show_races(ira_database *db, bool show_all)
                 printf("  Setup:    %s\n", race->season->fixed_setup ? "Fixed" : "Open");
             }
 
+            /* Next session start */
+            if (race->next_race_time > 0) {
+                char when[32];
+                filter_format_time_until(race->next_race_time, when, sizeof(when));
+                printf("  Next:     %s\n", when);
+            }
+
             /* Ownership status */
             printf("  Owned:    Car: %s, Track: %s\n",
                    race->owns_car ? "yes" : "NO",
@@ -641,6 +1114,20 @@ static void show_races(ira_database *db, bool show_all)
         }
     }
 
+    /* Soonest matching sessions across all series */
+    if (!show_all) {
+        race_schedule *sched = g_race_schedule;
+        if (!use_cache || !sched) sched = race_schedule_create();
+        if (sched) {
+            show_upcoming_races(db, sched);
+            if (use_cache) {
+                g_race_schedule = sched;
+            } else {
+                race_schedule_destroy(sched);
+            }
+        }
+    }
+
     printf("\n========================================\n");
     printf("Total: %d checked, %d passed filter\n",
            results->total_checked, results->passed_count);
@@ -658,7 +1145,111 @@ static void show_races(ira_database *db, bool show_all)
         printf("  %d failed: other reasons\n", results->failed_other);
     }
 
-    filter_results_destroy(results);
+    if (!use_cache) {
+        filter_results_destroy(results);
+    }
+}
+
+/*
+ * iRacing API client, shared by every sync. Created at startup when an
+ * OAuth client id is configured, so a saved token can be refreshed while
+ * the database loads and the menu comes up.
+ */
+static iracing_api *g_api = NULL;
+
+/* atexit handler; any sync has been finished by then */
+static void close_api(void)
+{
+    api_destroy(g_api);
+    g_api = NULL;
+}
+
+/*
+ * Helper: Create the API client. With saved tokens, authentication starts
+ * right away in the background; a first login opens the browser, so that
+ * waits until a sync asks for it.
+ */
+static void open_api(const ira_config *cfg)
+{
+    if (!cfg->api_client_id[0]) return;
+
+    g_api = api_create();
+    if (!g_api) return;
+    atexit(close_api);
+
+    api_set_oauth(g_api, cfg->api_client_id,
+                  cfg->api_client_secret[0] ? cfg->api_client_secret : NULL);
+
+    /* Syncs revalidate what is already cached */
+    api_load_cache(g_api, API_CACHE_FILE);
+
+    if (api_load_tokens(g_api, API_TOKEN_FILE)) {
+        api_auth_start(g_api);
+    }
+}
+
+/*
+ * Helper: Start syncing db in the background. The job waits for
+ * authentication itself, so this returns at once. Returns NULL on error.
+ */
+static api_sync_job *begin_sync(ira_database *db)
+{
+    if (!g_api) {
+        printf("Error: No iRacing API client configured\n");
+        printf("\nNote: iRacing API access requires OAuth approval.\n");
+        printf("Once approved, set client_id in the api section of %s\n",
+               config_get_default_path());
+        return NULL;
+    }
+
+    /* Requests queue in the job until authentication settles */
+    if (!api_auth_start(g_api)) {
+        printf("Error: Could not start authentication\n");
+        return NULL;
+    }
+
+    api_sync_job *job = api_sync_start(g_api, db, NULL, NULL);
+    if (!job) {
+        printf("Error: Could not start sync\n");
+        return NULL;
+    }
+
+    return job;
+}
+
+/*
+ * Helper: Apply a sync's results to db and save them.
+ * Blocks until the job has finished.
+ */
+static void end_sync(api_sync_job *job, ira_database *db)
+{
+    api_error err = api_sync_finish(job, db);
+
+    if (err == API_ERROR_CANCELLED) {
+        printf("Sync cancelled, data unchanged.\n");
+        return;
+    }
+
+    /* Anything else swapped the catalog; cached race lists point into the old tables */
+    release_race_cache();
+
+    if (err != API_OK) {
+        printf("  %s\n", api_get_last_error(g_api));
+        if (!api_is_authenticated(g_api)) {
+            printf("\nNot signed in to iRacing; the next sync tries again.\n");
+            return;
+        }
+    } else {
+        printf("  %s\n", g_api->not_modified ? "OK (catalog unchanged)" : "OK");
+    }
+
+    api_save_cache(g_api, API_CACHE_FILE);
+
+    /* Save data */
+    printf("\nSaving data...\n");
+    database_save_all(db);
+
+    printf("\nSync complete.\n");
 }
 
 /* Sync data from iRacing API */
@@ -671,56 +1262,55 @@ static void sync_data(ira_database *db)
 
     printf("Syncing data from iRacing API...\n\n");
 
-    iracing_api *api = api_create();
-    if (!api) {
-        printf("Error: Could not create API client\n");
-        return;
-    }
+    api_sync_job *job = begin_sync(db);
+    if (!job) return;
 
-    /* Try to load saved tokens */
-    /* TODO: token file path */
+    printf("Fetching cars, tracks, series, seasons and owned content...\n");
+    printf("(press Esc to cancel)\n");
 
-    /* Authenticate */
-    api_error err = api_authenticate(api);
-    if (err != API_OK) {
-        printf("Authentication: %s\n", api_get_last_error(api));
-        printf("\nNote: iRacing API access requires OAuth approval.\n");
-        printf("Once approved, credentials can be set via config file.\n");
-        api_destroy(api);
-        return;
-    }
+    api_sync_progress progress;
+    const char *last_stage = NULL;
+    bool cancelled = false;
 
-    /* Fetch data */
-    printf("Fetching cars...\n");
-    err = api_fetch_cars(api, db);
-    printf("  %s\n", err == API_OK ? "OK" : api_error_string(err));
+    for (;;) {
+        bool done = api_sync_wait(job, 100, &progress);
 
-    printf("Fetching tracks...\n");
-    err = api_fetch_tracks(api, db);
-    printf("  %s\n", err == API_OK ? "OK" : api_error_string(err));
+        if (progress.stage != last_stage) {
+            printf("  [%d/%d] %s\n", progress.step, progress.total, progress.stage);
+            last_stage = progress.stage;
+        }
+        if (done) break;
 
-    printf("Fetching series...\n");
-    err = api_fetch_series(api, db);
-    printf("  %s\n", err == API_OK ? "OK" : api_error_string(err));
+        if (!cancelled && console_input_available() && console_read_key() == 27) {
+            printf("  Cancelling...\n");
+            api_sync_cancel(job);
+            cancelled = true;
+        }
+    }
 
-    printf("Fetching seasons...\n");
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
-    int year = tm->tm_year + 1900;
-    int quarter = (tm->tm_mon / 3) + 1;
-    err = api_fetch_seasons(api, db, year, quarter);
-    printf("  %s\n", err == API_OK ? "OK" : api_error_string(err));
+    end_sync(job, db);
+}
 
-    printf("Fetching owned content...\n");
-    err = api_fetch_owned_content(api, db);
-    printf("  %s\n", err == API_OK ? "OK" : api_error_string(err));
+/* Sync started from the menu, applied when it finishes */
+static api_sync_job *g_sync_job = NULL;
 
-    /* Save data */
-    printf("\nSaving data...\n");
-    database_save_all(db);
+/*
+ * Apply the background sync to db once it has finished. With cancel,
+ * stop it first and wait for it.
+ */
+static void poll_background_sync(ira_database *db, bool cancel)
+{
+    if (!g_sync_job) return;
 
-    api_destroy(api);
-    printf("\nSync complete.\n");
+    if (cancel) {
+        api_sync_cancel(g_sync_job);
+    } else if (!api_sync_wait(g_sync_job, 0, NULL)) {
+        return;
+    }
+
+    printf("\nBackground sync finished:\n");
+    end_sync(g_sync_job, db);
+    g_sync_job = NULL;
 }
 
 /*
@@ -751,6 +1341,8 @@ static void show_menu(void)
     printf("  [6] View settings\n");
     printf("  [7] Show filter status\n");
     printf("  [8] Show races\n");
+    printf("  [9] Sync data from iRacing%s\n", g_sync_job ? " (running)" : "");
+    printf("  [0] Runtime statistics\n");
     printf("  [q] Exit menu\n");
     printf("----------------------------------------\n");
     printf("Select option: ");
@@ -935,8 +1527,6 @@ static void menu_launch_stop_app(app_launcher *launcher)
         return;
     }
 
-    launcher_update_status(launcher);
-
     printf("\n--- Launch/Stop App ---\n");
     for (int i = 0; i < count; i++) {
         app_profile *app = launcher_get_app_at(launcher, i);
@@ -993,6 +1583,17 @@ static void menu_view_settings(const ira_config *cfg)
     printf("Units:                %s\n", cfg->use_metric_units ? "metric" : "imperial");
     printf("Telemetry logging:    %s\n", cfg->telemetry_logging_enabled ? "enabled" : "disabled");
     printf("Log path:             %s\n", cfg->telemetry_log_path);
+    printf("Log format:           %s\n", cfg->telemetry_log_binary ? "binary" : "csv");
+    printf("Log all variables:    %s\n", cfg->telemetry_log_all_vars ? "yes" : "no");
+    printf("Telemetry hub:        %s\n", cfg->telemetry_hub_enabled ? "enabled" : "disabled");
+    if (cfg->telemetry_hub_udp[0]) {
+        printf("Hub UDP target:       %s\n", cfg->telemetry_hub_udp);
+    }
+    printf("Low latency timing:   %s\n", cfg->telemetry_low_latency ? "enabled" : "disabled");
+    printf("High priority:        %s\n", cfg->telemetry_high_priority ? "yes" : "no");
+    if (cfg->telemetry_cpu >= 0) {
+        printf("Telemetry CPU:        %d\n", cfg->telemetry_cpu);
+    }
 
     const char *switch_str;
     switch (cfg->car_switch_behavior) {
@@ -1044,8 +1645,45 @@ static void menu_show_races(ira_database **db_ptr)
         return;
     }
 
+    if (!g_race_cache) {
+        g_race_cache = filter_incremental_create();
+        g_race_results = filter_results_create();
+    }
+
     printf("\n");
-    show_races(*db_ptr, false);
+    show_races(*db_ptr, false, g_race_cache, g_race_results);
+}
+
+/* Start a background sync, or report on the one running */
+static void menu_sync_data(ira_database **db_ptr)
+{
+    if (g_sync_job) {
+        api_sync_progress progress;
+        api_sync_wait(g_sync_job, 0, &progress);
+        printf("\nSync in progress: [%d/%d] %s\n",
+               progress.step, progress.total, progress.stage);
+        return;
+    }
+
+    if (!*db_ptr) {
+        printf("\nLoading database...\n");
+        *db_ptr = database_create();
+        if (*db_ptr) {
+            database_load_all(*db_ptr);
+        }
+    }
+
+    if (!*db_ptr) {
+        printf("Error: Could not load database.\n");
+        return;
+    }
+
+    printf("\n");
+    g_sync_job = begin_sync(*db_ptr);
+    if (g_sync_job) {
+        printf("Sync started in the background; the menu stays usable.\n");
+        printf("Results are applied when it finishes.\n");
+    }
 }
 
 /* Main menu handler */
@@ -1057,6 +1695,7 @@ static void handle_menu(app_launcher *launcher, ira_config *cfg, ira_database **
     console_flush_input();
 
     while (in_menu && g_running) {
+        poll_background_sync(*db_ptr, false);
         show_menu();
         int choice = console_read_key();
         printf("%c\n", choice);  /* Echo the character */
@@ -1087,6 +1726,12 @@ static void handle_menu(app_launcher *launcher, ira_config *cfg, ira_database **
             case '8':
                 menu_show_races(db_ptr);
                 break;
+            case '9':
+                menu_sync_data(db_ptr);
+                break;
+            case '0':
+                stats_print();
+                break;
             case 'q':
             case 'Q':
                 in_menu = false;
@@ -1125,6 +1770,10 @@ int main(int argc, char *argv[])
     bool do_menu = false;
     const char *add_app_name = NULL;
     const char *add_app_path = NULL;
+    const char *convert_in = NULL;
+    const char *convert_out = NULL;
+    const char *replay_path = NULL;
+    bool replay_realtime = false;
     char log_dir[260];
     strncpy(log_dir, cfg.telemetry_log_path, sizeof(log_dir) - 1);
 
@@ -1140,6 +1789,30 @@ int main(int argc, char *argv[])
             cfg.use_metric_units = false;
         } else if (strcmp(argv[i], "--log-dir") == 0 && i + 1 < argc) {
             strncpy(log_dir, argv[++i], sizeof(log_dir) - 1);
+        } else if (strcmp(argv[i], "--log-all") == 0) {
+            cfg.telemetry_log_all_vars = true;
+        } else if (strcmp(argv[i], "--log-format") == 0 && i + 1 < argc) {
+            cfg.telemetry_log_binary = (strcmp(argv[++i], "binary") == 0);
+        } else if (strcmp(argv[i], "--hub") == 0) {
+            cfg.telemetry_hub_enabled = true;
+        } else if (strcmp(argv[i], "--hub-udp") == 0 && i + 1 < argc) {
+            cfg.telemetry_hub_enabled = true;
+            strncpy(cfg.telemetry_hub_udp, argv[++i], sizeof(cfg.telemetry_hub_udp) - 1);
+        } else if (strcmp(argv[i], "--low-latency") == 0) {
+            cfg.telemetry_low_latency = true;
+        } else if (strcmp(argv[i], "--high-priority") == 0) {
+            cfg.telemetry_high_priority = true;
+        } else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            cfg.telemetry_cpu = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--convert-log") == 0 && i + 2 < argc) {
+            convert_in = argv[++i];
+            convert_out = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay-realtime") == 0) {
+            replay_realtime = true;
+        } else if (strcmp(argv[i], "--stats-dump") == 0 && i + 1 < argc) {
+            g_stats_dump_path = argv[++i];
         } else if (strcmp(argv[i], "--menu") == 0) {
             do_menu = true;
         } else if (strcmp(argv[i], "--launch-apps") == 0) {
@@ -1161,6 +1834,21 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (g_stats_dump_path) {
+        atexit(write_stats_dump);
+    }
+
+    /* Handle --convert-log command */
+    if (convert_in) {
+        printf("Converting %s -> %s\n", convert_in, convert_out);
+        if (!telem_log_convert_to_csv(convert_in, convert_out)) {
+            printf("Error: Could not convert telemetry log\n");
+            return 1;
+        }
+        printf("Done.\n");
+        return 0;
+    }
+
     /* Create default apps config if it doesn't exist */
     create_default_apps_config();
 
@@ -1168,14 +1856,18 @@ int main(int argc, char *argv[])
     app_launcher *launcher = launcher_create();
     if (launcher) {
         launcher_load_config(launcher, config_get_apps_path());
+        launcher_set_exit_callback(launcher, on_app_exit, NULL);
     }
 
     /* Handle --menu command */
     if (do_menu) {
         if (launcher) {
             ira_database *menu_db = NULL;
+            open_api(&cfg);
             g_running = true;  /* Ensure menu loop can run */
             handle_menu(launcher, &cfg, &menu_db);
+            poll_background_sync(menu_db, true);
+            release_race_cache();
             if (menu_db) {
                 database_destroy(menu_db);
             }
@@ -1229,7 +1921,10 @@ int main(int argc, char *argv[])
             return 1;
         }
 
-        /* Load cached data */
+        /* Load cached data, refreshing the token meanwhile */
+        if (do_sync) {
+            open_api(&cfg);
+        }
         database_load_all(db);
 
         if (do_filter_status) {
@@ -1237,7 +1932,7 @@ int main(int argc, char *argv[])
         } else if (do_sync) {
             sync_data(db);
         } else if (do_show_races || do_show_races_all) {
-            show_races(db, do_show_races_all);
+            show_races(db, do_show_races_all, NULL, NULL);
         }
 
         database_destroy(db);
@@ -1255,9 +1950,27 @@ int main(int argc, char *argv[])
     /* Initialize state tracking for launcher */
     ira_state current_state = STATE_WAITING;
 
+    /* A recorded session stands in for the sim; the wait below ends at once */
+    if (replay_path) {
+        irsdk_replay_pace pace = replay_realtime ? IRSDK_REPLAY_REALTIME : IRSDK_REPLAY_FAST;
+        if (!irsdk_startup_file(replay_path, pace)) {
+            printf("Error: Could not open telemetry file %s\n", replay_path);
+            launcher_destroy(launcher);
+            return 1;
+        }
+
+        int rows;
+        irsdk_get_replay_progress(NULL, &rows);
+        printf("Replaying %s (%d samples, %s)\n", replay_path, rows,
+               replay_realtime ? "real time" : "as fast as possible");
+    }
+
     /* Database pointer for lazy loading in menu */
     ira_database *menu_db = NULL;
 
+    /* Ready for a menu sync, without holding up the wait below */
+    open_api(&cfg);
+
     printf("Waiting for iRacing... (press any key for menu)\n");
 
     /* Clear any pending input */
@@ -1279,12 +1992,17 @@ int main(int argc, char *argv[])
             printf("\nWaiting for iRacing... (press any key for menu)\n");
         }
 
+        /* Apply a menu-started sync as soon as it is done */
+        poll_background_sync(menu_db, false);
+
         Sleep(200);
         printf(".");
         fflush(stdout);
     }
 
     /* Clean up lazy-loaded database if used */
+    poll_background_sync(menu_db, true);
+    release_race_cache();
     if (menu_db) {
         database_destroy(menu_db);
         menu_db = NULL;
@@ -1297,18 +2015,37 @@ int main(int argc, char *argv[])
 
     printf("\nConnected to iRacing!\n");
 
+    /* From here on the launcher belongs to the session worker */
+    session_worker_state session = {0};
+    session.launcher = replay_path ? NULL : launcher;     /* No apps for a replay */
+    session.car_switch_behavior = cfg.car_switch_behavior;
+    session.last_car_id = -1;
+    session.last_track_id = -1;
+
+    worker *session_worker = worker_create(session_worker_handler, &session);
+    if (!session_worker) {
+        printf("Error: Could not start session worker\n");
+        irsdk_shutdown();
+        launcher_destroy(launcher);
+        return 1;
+    }
+
     /* State transition: WAITING -> CONNECTED */
     current_state = STATE_CONNECTED;
-    if (launcher) {
-        launcher_start_all(launcher, LAUNCH_ON_CONNECT);
-    }
+    worker_post(session_worker, SESSION_MSG_CONNECTED, NULL, 0);
 
     printf("Waiting for session data (enter a session with a car)...\n");
 
     /* Wait for data to be available - need actual telemetry data */
     char *data = NULL;
     int buf_len = 0;
-    TelemetryOffsets offsets = {0};
+    TelemetryView telemetry;
+    if (!create_telemetry_view(&telemetry)) {
+        printf("Error: Could not allocate telemetry view\n");
+        worker_destroy(session_worker);
+        irsdk_shutdown();
+        return 1;
+    }
 
     while (g_running) {
         /* Wait for data */
@@ -1329,13 +2066,15 @@ int main(int argc, char *argv[])
             data = (char *)malloc(buf_len);
             if (!data) {
                 printf("Error: Could not allocate data buffer\n");
+                irsdk_var_view_destroy(telemetry.view);
+                worker_destroy(session_worker);
                 irsdk_shutdown();
                 return 1;
             }
         }
 
-        /* Try to initialize telemetry offsets */
-        if (init_telemetry_offsets(&offsets)) {
+        /* Try to resolve the telemetry variables */
+        if (resolve_telemetry_view(&telemetry)) {
             break; /* Success! Variables are available */
         }
 
@@ -1345,6 +2084,8 @@ int main(int argc, char *argv[])
     }
 
     if (!g_running) {
+        irsdk_var_view_destroy(telemetry.view);
+        worker_destroy(session_worker);
         free(data);
         irsdk_shutdown();
         launcher_destroy(launcher);
@@ -1355,121 +2096,100 @@ int main(int argc, char *argv[])
 
     /* State transition: CONNECTED -> IN_SESSION */
     current_state = STATE_IN_SESSION;
-    if (launcher) {
-        launcher_start_all(launcher, LAUNCH_ON_SESSION);
-    }
-
-    /* Parse and display session info */
-    SessionInfo session_info = {0};
-    int last_session_update = -1;
-    int current_session_update = irsdk_get_session_info_update();
-    int last_car_id = -1;
-    int last_track_id = -1;
+    worker_post(session_worker, SESSION_MSG_STARTED, NULL, 0);
 
-    if (current_session_update != last_session_update) {
-        if (parse_session_info(&session_info)) {
-            display_session_info(&session_info);
-            last_car_id = session_info.car_id;
-            last_track_id = session_info.track_id;
-
-            /* Initial filter evaluation for session apps */
-            if (launcher && session_info.car_id > 0) {
-                int changes = launcher_update_for_session(launcher, session_info.car_id, session_info.track_id);
-                if (changes > 0) {
-                    printf("Launched/stopped %d app(s) based on car/track filters.\n\n", changes);
-                }
-            }
-        }
-        last_session_update = current_session_update;
-    }
+    /* Parse and display session info; wait for it, the logger is named after the track */
+    int last_session_update = irsdk_get_session_info_update();
+    post_session_update(session_worker, true);
+    worker_flush(session_worker);
 
     /* Set up telemetry logger if enabled */
     telem_logger *logger = NULL;
     if (enable_logging) {
         /* Use track name as session name if available */
-        const char *session_name = session_info.track_name[0] ? session_info.track_name : "telemetry";
-        logger = telem_log_create(log_dir, session_name);
+        const char *session_name = session.info.track_name[0] ? session.info.track_name : "telemetry";
+        logger = start_logger(log_dir, session_name, &cfg);
+        if (!logger) {
+            printf("Warning: Could not start telemetry logging\n\n");
+        }
+    }
 
-        if (logger) {
-            telem_log_add_defaults(logger);
-            if (telem_log_start(logger)) {
-                printf("Logging telemetry to: %s\n\n", telem_log_get_filepath(logger));
-            } else {
-                printf("Warning: Could not start telemetry logging\n\n");
-                telem_log_destroy(logger);
-                logger = NULL;
-            }
+    /* Republish for overlays; kept across reconnects so consumers stay attached */
+    telem_hub *hub = NULL;
+    if (cfg.telemetry_hub_enabled) {
+        hub = start_hub(&cfg);
+        if (!hub) {
+            printf("Warning: Could not start telemetry hub\n\n");
+        }
+    }
+
+    /* Keep recent laps in memory for the delta to the best lap */
+    lap_store *laps = lap_store_create(0);
+    if (laps) {
+        lap_store_add_defaults(laps);
+        if (!lap_store_start(laps)) {
+            lap_store_destroy(laps);
+            laps = NULL;
         }
     }
 
+    /* Rebind in place when the sim republishes its variables */
+    LayoutBindings bindings = { &data, &telemetry, &logger, hub, laps };
+    irsdk_add_layout_listener(on_layout_change, &bindings);
+    if (irsdk_var_view_stale(telemetry.view)) {
+        on_layout_change(&bindings);
+    }
+
+    /* This thread runs the telemetry loop from here on */
+    telem_timing_config timing_cfg = {
+        cfg.telemetry_low_latency, cfg.telemetry_high_priority, cfg.telemetry_cpu
+    };
+    telem_timing *timing = telem_timing_create(&timing_cfg);
+
     printf("Receiving telemetry data (Ctrl+C to exit):\n\n");
 
     /* Main loop */
     while (g_running) {
         /* Wait for new data (16ms = ~60Hz) */
         if (irsdk_wait_for_data(16, data)) {
-            display_telemetry(data, &offsets, cfg.use_metric_units);
+            telem_timing_tick_begin(timing, irsdk_get_tick_count());
+            lap_store_sample(laps, data);
+            /* A fast replay would spend its time redrawing the line */
+            if (!replay_path || replay_realtime || irsdk_get_tick_count() % 60 == 0) {
+                display_telemetry(data, &telemetry, cfg.use_metric_units, laps);
+            }
 
             /* Log telemetry if enabled */
             if (logger) {
                 telem_log_sample(logger, data);
             }
 
-            /* Check for session info updates */
-            current_session_update = irsdk_get_session_info_update();
-            if (current_session_update != last_session_update) {
-                printf("\n\nSession info updated!\n");
-                if (parse_session_info(&session_info)) {
-                    display_session_info(&session_info);
-
-                    /* Check for car/track changes */
-                    bool car_changed = (session_info.car_id != last_car_id && session_info.car_id > 0);
-                    bool track_changed = (session_info.track_id != last_track_id && session_info.track_id > 0);
-
-                    if ((car_changed || track_changed) && launcher) {
-                        if (cfg.car_switch_behavior == CAR_SWITCH_AUTO) {
-                            int changes = launcher_update_for_session(launcher, session_info.car_id, session_info.track_id);
-                            if (changes > 0) {
-                                printf("Switched %d app(s) for new car/track.\n", changes);
-                            }
-                        } else if (cfg.car_switch_behavior == CAR_SWITCH_PROMPT) {
-                            printf("Car/track changed. Press Enter to update apps, or continue driving...\n");
-                            /* Note: Non-blocking prompt would require more complex handling */
-                            /* For now, auto-switch after displaying the message */
-                            int changes = launcher_update_for_session(launcher, session_info.car_id, session_info.track_id);
-                            if (changes > 0) {
-                                printf("Switched %d app(s) for new car/track.\n", changes);
-                            }
-                        }
-                        /* CAR_SWITCH_DISABLED: do nothing */
-                    }
+            if (hub) {
+                telem_hub_publish(hub, data, irsdk_get_tick_count());
+            }
+            telem_timing_tick_end(timing);
 
-                    last_car_id = session_info.car_id;
-                    last_track_id = session_info.track_id;
-                }
+            /* Hand session info updates to the worker */
+            int current_session_update = irsdk_get_session_info_update();
+            if (current_session_update != last_session_update) {
+                post_session_update(session_worker, false);
                 last_session_update = current_session_update;
             }
         }
 
         /* Check if still connected */
+        if (irsdk_replay_finished()) {
+            int rows;
+            irsdk_get_replay_progress(&rows, NULL);
+            printf("\n\nReplay finished after %d samples.\n", rows);
+            break;
+        }
         if (!irsdk_is_connected()) {
             printf("\n\nDisconnected from iRacing. Waiting to reconnect...\n");
 
             /* State transition: IN_SESSION/CONNECTED -> WAITING */
             current_state = STATE_WAITING;
-            if (launcher) {
-                launcher_stop_all(launcher, CLOSE_ON_IRACING_EXIT);
-            }
-
-            /* Stop logging during disconnect */
-            if (logger) {
-                telem_log_stop(logger);
-                printf("Logged %d samples to: %s\n",
-                       telem_log_get_sample_count(logger),
-                       telem_log_get_filepath(logger));
-                telem_log_destroy(logger);
-                logger = NULL;
-            }
+            worker_post(session_worker, SESSION_MSG_DISCONNECTED, NULL, 0);
 
             /* Wait for reconnection */
             while (g_running && !irsdk_is_connected()) {
@@ -1478,47 +2198,26 @@ int main(int argc, char *argv[])
 
                     /* State transition: WAITING -> CONNECTED */
                     current_state = STATE_CONNECTED;
-                    if (launcher) {
-                        launcher_start_all(launcher, LAUNCH_ON_CONNECT);
-                    }
+                    worker_post(session_worker, SESSION_MSG_CONNECTED, NULL, 0);
 
-                    /* Reinitialize offsets in case variables changed */
-                    if (!init_telemetry_offsets(&offsets)) {
-                        printf("Error: Could not reinitialize telemetry offsets\n");
-                        break;
-                    }
+                    /* Offsets are rebound by on_layout_change() if the variables moved */
 
                     /* State transition: CONNECTED -> IN_SESSION */
                     current_state = STATE_IN_SESSION;
 
-                    /* Re-parse session info */
-                    if (parse_session_info(&session_info)) {
-                        display_session_info(&session_info);
-                        last_car_id = session_info.car_id;
-                        last_track_id = session_info.track_id;
-
-                        /* Start session apps with filter evaluation */
-                        if (launcher && session_info.car_id > 0) {
-                            int changes = launcher_update_for_session(launcher, session_info.car_id, session_info.track_id);
-                            if (changes > 0) {
-                                printf("Launched %d app(s) based on car/track filters.\n", changes);
-                            }
-                        }
-                    }
+                    /* Re-parse session info, starting session apps with filter evaluation */
                     last_session_update = irsdk_get_session_info_update();
-
-                    /* Restart logging */
-                    if (enable_logging) {
-                        const char *session_name = session_info.track_name[0] ?
-                                                   session_info.track_name : "telemetry";
-                        logger = telem_log_create(log_dir, session_name);
-                        if (logger) {
-                            telem_log_add_defaults(logger);
-                            if (telem_log_start(logger)) {
-                                printf("Logging telemetry to: %s\n\n",
-                                       telem_log_get_filepath(logger));
-                            }
-                        }
+                    post_session_update(session_worker, true);
+
+                    /*
+                     * The log stays open across reconnects; retry if it never
+                     * started. Only then wait for the parse, for the track name.
+                     */
+                    if (enable_logging && !logger) {
+                        worker_flush(session_worker);
+                        const char *session_name = session.info.track_name[0] ?
+                                                   session.info.track_name : "telemetry";
+                        logger = start_logger(log_dir, session_name, &cfg);
                     }
                 }
             }
@@ -1527,14 +2226,18 @@ int main(int argc, char *argv[])
 
     /* Cleanup */
     printf("\n\nCleaning up...\n");
+    irsdk_remove_layout_listener(on_layout_change, &bindings);
+    print_latency_report(timing, cfg.telemetry_low_latency);
+    telem_timing_destroy(timing);
 
     if (logger) {
-        telem_log_stop(logger);
-        printf("Logged %d samples to: %s\n",
-               telem_log_get_sample_count(logger),
-               telem_log_get_filepath(logger));
-        telem_log_destroy(logger);
+        stop_logger(logger);
     }
+    telem_hub_destroy(hub);
+    lap_store_destroy(laps);
+
+    /* Let pending session work finish; the launcher is ours again after this */
+    worker_destroy(session_worker);
 
     /* Save configuration */
     cfg.telemetry_logging_enabled = enable_logging;
@@ -1547,6 +2250,8 @@ int main(int argc, char *argv[])
     }
 
     free(data);
+    irsdk_var_view_destroy(telemetry.view);
+    yaml_index_destroy(g_session_index);
     irsdk_shutdown();
     printf("Goodbye!\n");
 
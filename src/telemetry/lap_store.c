@@ -0,0 +1,504 @@
+/*
+ * ira - iRacing Application
+ * Lap Store Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lap_store.h"
+
+/* A lap is complete if it starts and ends within this of the line */
+#define LAP_STORE_EDGE      0.05f
+
+/* Largest quantized value */
+#define LAP_STORE_QUANT_MAX 65535.0f
+
+/* Stored channel */
+typedef struct {
+    char name[IRSDK_MAX_STRING];
+    int offset;
+    int type;
+    float min;
+    float max;
+} lap_channel;
+
+/* One lap in the ring */
+typedef struct {
+    int lap;
+    bool complete;
+    bool from_line;             /* Started at the start/finish line */
+    double start_time;          /* SessionTime the lap began */
+    float elapsed;              /* Seconds into the lap at the last sample */
+    float lap_time;
+    float last_pct;
+    int last_bin;               /* Highest bin filled, -1 = none */
+
+    int sector;
+    float sector_start;         /* Elapsed time the current sector began */
+    float sector_times[LAP_STORE_MAX_SECTORS];
+
+    float *bin_time;            /* Elapsed time reaching each bin, < 0 = not reached */
+    uint16_t *values;           /* [channel * LAP_STORE_BINS + bin] */
+
+    /* [channel][0] = whole lap, [channel][1 + s] = sector s */
+    lap_store_stats stats[LAP_STORE_MAX_CHANNELS][LAP_STORE_MAX_SECTORS + 1];
+} lap_record;
+
+struct lap_store {
+    lap_channel channels[LAP_STORE_MAX_CHANNELS];
+    int channel_count;
+    float sector_starts[LAP_STORE_MAX_SECTORS];
+    int sector_count;
+    bool active;
+
+    /* Lap position sources */
+    int lap_offset;
+    int pct_offset;
+    int time_offset;
+
+    /* Ring of laps; head is the lap in progress */
+    lap_record *laps;
+    int max_laps;
+    int head;
+    int lap_total;
+    float *time_pool;
+    uint16_t *value_pool;
+
+    /* Best complete lap: time reaching each bin, then the lap time */
+    float *best_time;
+    float best_lap_time;
+
+    /* Last sample */
+    bool have_sample;
+    double last_time;
+    float delta;
+    bool have_delta;
+};
+
+/*
+ * Helper: Read a numeric variable of any type as a float
+ */
+static float read_number(const char *data, int offset, int type)
+{
+    switch (type) {
+        case IRSDK_TYPE_FLOAT:    return irsdk_get_var_float(data, offset, 0);
+        case IRSDK_TYPE_DOUBLE:   return (float)irsdk_get_var_double(data, offset, 0);
+        case IRSDK_TYPE_INT:
+        case IRSDK_TYPE_BITFIELD: return (float)irsdk_get_var_int(data, offset, 0);
+        case IRSDK_TYPE_BOOL:     return irsdk_get_var_bool(data, offset, 0) ? 1.0f : 0.0f;
+        default:                  return 0.0f;
+    }
+}
+
+static uint16_t quantize(const lap_channel *ch, float value)
+{
+    float q = (value - ch->min) / (ch->max - ch->min) * LAP_STORE_QUANT_MAX;
+    if (!(q > 0.0f)) return 0;
+    if (q >= LAP_STORE_QUANT_MAX) return (uint16_t)LAP_STORE_QUANT_MAX;
+    return (uint16_t)(q + 0.5f);
+}
+
+static float dequantize(const lap_channel *ch, uint16_t q)
+{
+    return ch->min + (ch->max - ch->min) * ((float)q / LAP_STORE_QUANT_MAX);
+}
+
+static void stats_add(lap_store_stats *stats, float value)
+{
+    if (stats->count == 0) {
+        stats->min = value;
+        stats->max = value;
+    } else {
+        if (value < stats->min) stats->min = value;
+        if (value > stats->max) stats->max = value;
+    }
+    stats->sum += value;
+    stats->count++;
+}
+
+/*
+ * Lifecycle
+ */
+
+lap_store *lap_store_create(int max_laps)
+{
+    lap_store *store = calloc(1, sizeof(lap_store));
+    if (!store) return NULL;
+
+    store->max_laps = max_laps > 0 ? max_laps : LAP_STORE_DEFAULT_LAPS;
+    store->sector_count = 3;
+    for (int i = 0; i < store->sector_count; i++) {
+        store->sector_starts[i] = (float)i / (float)store->sector_count;
+    }
+    return store;
+}
+
+void lap_store_destroy(lap_store *store)
+{
+    if (!store) return;
+
+    free(store->laps);
+    free(store->time_pool);
+    free(store->value_pool);
+    free(store->best_time);
+    free(store);
+}
+
+/*
+ * Configuration
+ */
+
+int lap_store_add_channel(lap_store *store, const char *var_name, float min, float max)
+{
+    if (!store || !var_name || store->active || !(max > min) ||
+        store->channel_count >= LAP_STORE_MAX_CHANNELS ||
+        strlen(var_name) >= IRSDK_MAX_STRING) {
+        return -1;
+    }
+
+    int idx = irsdk_var_name_to_index(var_name);
+    const irsdk_VarHeader *header = idx >= 0 ? irsdk_get_var_header(idx) : NULL;
+    if (!header) return -1;
+
+    lap_channel *ch = &store->channels[store->channel_count];
+    strcpy(ch->name, var_name);
+    ch->offset = header->offset;
+    ch->type = header->type;
+    ch->min = min;
+    ch->max = max;
+    return store->channel_count++;
+}
+
+bool lap_store_add_defaults(lap_store *store)
+{
+    if (!store) return false;
+
+    int added = 0;
+    added += lap_store_add_channel(store, "Speed", 0.0f, 120.0f) >= 0;
+    added += lap_store_add_channel(store, "RPM", 0.0f, 20000.0f) >= 0;
+    added += lap_store_add_channel(store, "Gear", -1.0f, 10.0f) >= 0;
+    added += lap_store_add_channel(store, "Throttle", 0.0f, 1.0f) >= 0;
+    added += lap_store_add_channel(store, "Brake", 0.0f, 1.0f) >= 0;
+    added += lap_store_add_channel(store, "Clutch", 0.0f, 1.0f) >= 0;
+    added += lap_store_add_channel(store, "SteeringWheelAngle", -10.0f, 10.0f) >= 0;
+    added += lap_store_add_channel(store, "LatAccel", -50.0f, 50.0f) >= 0;
+    added += lap_store_add_channel(store, "LongAccel", -50.0f, 50.0f) >= 0;
+
+    return added > 0;
+}
+
+bool lap_store_set_sectors(lap_store *store, const float *starts, int count)
+{
+    if (!store || !starts || store->active || count < 1 || count > LAP_STORE_MAX_SECTORS ||
+        starts[0] != 0.0f) {
+        return false;
+    }
+
+    for (int i = 1; i < count; i++) {
+        if (!(starts[i] > starts[i - 1]) || starts[i] >= 1.0f) return false;
+    }
+
+    memcpy(store->sector_starts, starts, count * sizeof(float));
+    store->sector_count = count;
+    return true;
+}
+
+static void resolve_sources(lap_store *store)
+{
+    store->lap_offset = irsdk_var_name_to_offset("Lap");
+    store->pct_offset = irsdk_var_name_to_offset("LapDistPct");
+    store->time_offset = irsdk_var_name_to_offset("SessionTime");
+}
+
+bool lap_store_start(lap_store *store)
+{
+    if (!store || store->active) return false;
+
+    size_t bins = (size_t)store->max_laps * LAP_STORE_BINS;
+    size_t channels = store->channel_count > 0 ? (size_t)store->channel_count : 1;
+
+    store->laps = calloc(store->max_laps, sizeof(lap_record));
+    store->time_pool = malloc(bins * sizeof(float));
+    store->value_pool = calloc(bins * channels, sizeof(uint16_t));
+    store->best_time = malloc((LAP_STORE_BINS + 1) * sizeof(float));
+    if (!store->laps || !store->time_pool || !store->value_pool || !store->best_time) {
+        return false;
+    }
+
+    for (int i = 0; i < store->max_laps; i++) {
+        lap_record *rec = &store->laps[i];
+        rec->bin_time = store->time_pool + (size_t)i * LAP_STORE_BINS;
+        rec->values = store->value_pool + (size_t)i * LAP_STORE_BINS * channels;
+    }
+
+    resolve_sources(store);
+    store->head = -1;
+    store->active = true;
+    return true;
+}
+
+void lap_store_rebind(lap_store *store)
+{
+    if (!store) return;
+
+    resolve_sources(store);
+    for (int i = 0; i < store->channel_count; i++) {
+        lap_channel *ch = &store->channels[i];
+        int idx = irsdk_var_name_to_index(ch->name);
+        const irsdk_VarHeader *header = idx >= 0 ? irsdk_get_var_header(idx) : NULL;
+        ch->offset = header ? header->offset : -1;
+        ch->type = header ? header->type : IRSDK_TYPE_FLOAT;
+    }
+
+    /* Positions from before the reconnect say nothing about the next sample */
+    store->have_sample = false;
+    store->have_delta = false;
+}
+
+/*
+ * Sampling
+ */
+
+/*
+ * Helper: Close the lap in progress at crossing_time
+ */
+static void finish_lap(lap_store *store, lap_record *rec, float lap_time, bool complete)
+{
+    rec->lap_time = lap_time;
+    rec->complete = complete && rec->from_line;
+    if (rec->sector < LAP_STORE_MAX_SECTORS) {
+        rec->sector_times[rec->sector] = lap_time - rec->sector_start;
+    }
+
+    if (!rec->complete || (store->best_lap_time > 0.0f && lap_time >= store->best_lap_time)) {
+        return;
+    }
+
+    /* New best: keep its timing, filling any bins the samples skipped */
+    float prev_time = 0.0f;
+    for (int b = 0; b < LAP_STORE_BINS; b++) {
+        float t = b <= rec->last_bin ? rec->bin_time[b] : -1.0f;
+        if (t < 0.0f) {
+            float remaining = lap_time - prev_time;
+            t = prev_time + remaining / (float)(LAP_STORE_BINS - b + 1);
+        }
+        store->best_time[b] = t;
+        prev_time = t;
+    }
+    store->best_time[LAP_STORE_BINS] = lap_time;
+    store->best_lap_time = lap_time;
+}
+
+/*
+ * Helper: Begin a new lap in the next ring slot
+ */
+static lap_record *begin_lap(lap_store *store, int lap, double start_time, bool from_line)
+{
+    store->head = (store->head + 1) % store->max_laps;
+    if (store->lap_total < store->max_laps) store->lap_total++;
+
+    lap_record *rec = &store->laps[store->head];
+    float *bin_time = rec->bin_time;
+    uint16_t *values = rec->values;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->bin_time = bin_time;
+    rec->values = values;
+    rec->lap = lap;
+    rec->from_line = from_line;
+    rec->start_time = start_time;
+    rec->last_bin = -1;
+
+    for (int b = 0; b < LAP_STORE_BINS; b++) {
+        bin_time[b] = -1.0f;
+    }
+    return rec;
+}
+
+/*
+ * Helper: Time on the best lap at a track position
+ */
+static float best_time_at(const lap_store *store, float pct)
+{
+    float x = pct * LAP_STORE_BINS;
+    int b = (int)x;
+    if (b < 0) return 0.0f;
+    if (b >= LAP_STORE_BINS) return store->best_time[LAP_STORE_BINS];
+
+    float t0 = store->best_time[b];
+    float t1 = store->best_time[b + 1];
+    return t0 + (t1 - t0) * (x - (float)b);
+}
+
+void lap_store_sample(lap_store *store, const char *data)
+{
+    if (!store || !store->active || !data ||
+        store->lap_offset < 0 || store->pct_offset < 0 || store->time_offset < 0) {
+        return;
+    }
+
+    int lap = irsdk_get_var_int(data, store->lap_offset, 0);
+    float pct = irsdk_get_var_float(data, store->pct_offset, 0);
+    double now = irsdk_get_var_double(data, store->time_offset, 0);
+
+    /* Not in the world */
+    if (pct < 0.0f || pct > 1.0f) {
+        store->have_delta = false;
+        return;
+    }
+
+    lap_record *rec = store->head >= 0 && store->have_sample ? &store->laps[store->head] : NULL;
+
+    if (!rec || lap != rec->lap) {
+        /* Crossing the line: place it between the last two samples */
+        bool crossed = rec && lap == rec->lap + 1 &&
+                       rec->last_pct > 1.0f - LAP_STORE_EDGE && pct < LAP_STORE_EDGE;
+        double start = now;
+        if (crossed) {
+            float before = 1.0f - rec->last_pct;
+            start = store->last_time + (now - store->last_time) * (before / (before + pct));
+        }
+
+        if (rec) {
+            finish_lap(store, rec, (float)(start - rec->start_time), crossed);
+        }
+        rec = begin_lap(store, lap, start, crossed || (!store->have_sample && pct < LAP_STORE_EDGE));
+    }
+
+    float elapsed = (float)(now - rec->start_time);
+
+    /* Fill the bins reached since the last sample, interpolating their times */
+    int bin = (int)(pct * LAP_STORE_BINS);
+    if (bin >= LAP_STORE_BINS) bin = LAP_STORE_BINS - 1;
+
+    if (bin > rec->last_bin) {
+        float prev_pct = rec->last_bin >= 0 ? rec->last_pct : 0.0f;
+        float prev_elapsed = rec->last_bin >= 0 ? rec->elapsed : 0.0f;
+        float span = pct - prev_pct;
+
+        for (int b = rec->last_bin + 1; b <= bin; b++) {
+            float frac = span > 0.0f ? ((float)b / LAP_STORE_BINS - prev_pct) / span : 1.0f;
+            if (frac < 0.0f) frac = 0.0f;
+            rec->bin_time[b] = prev_elapsed + (elapsed - prev_elapsed) * frac;
+        }
+    }
+
+    /* Sector boundaries passed */
+    while (rec->sector + 1 < store->sector_count &&
+           pct >= store->sector_starts[rec->sector + 1]) {
+        rec->sector_times[rec->sector] = elapsed - rec->sector_start;
+        rec->sector_start = elapsed;
+        rec->sector++;
+    }
+
+    for (int i = 0; i < store->channel_count; i++) {
+        const lap_channel *ch = &store->channels[i];
+        if (ch->offset < 0) continue;
+
+        float value = read_number(data, ch->offset, ch->type);
+        stats_add(&rec->stats[i][0], value);
+        stats_add(&rec->stats[i][1 + rec->sector], value);
+
+        if (bin > rec->last_bin) {
+            uint16_t q = quantize(ch, value);
+            uint16_t *column = rec->values + (size_t)i * LAP_STORE_BINS;
+            for (int b = rec->last_bin + 1; b <= bin; b++) {
+                column[b] = q;
+            }
+        }
+    }
+
+    if (bin > rec->last_bin) rec->last_bin = bin;
+    rec->elapsed = elapsed;
+    rec->last_pct = pct;
+    store->last_time = now;
+    store->have_sample = true;
+
+    /* Only meaningful on a lap timed from the line */
+    store->have_delta = store->best_lap_time > 0.0f && rec->from_line;
+    if (store->have_delta) {
+        store->delta = elapsed - best_time_at(store, pct);
+    }
+}
+
+/*
+ * Queries
+ */
+
+bool lap_store_delta_to_best(const lap_store *store, float *delta)
+{
+    if (!store || !store->have_delta) return false;
+    if (delta) *delta = store->delta;
+    return true;
+}
+
+float lap_store_best_lap_time(const lap_store *store)
+{
+    return store ? store->best_lap_time : 0.0f;
+}
+
+int lap_store_lap_count(const lap_store *store)
+{
+    return store ? store->lap_total : 0;
+}
+
+/*
+ * Helper: The i-th held lap, 0 = oldest
+ */
+static const lap_record *held_lap(const lap_store *store, int index)
+{
+    if (!store || !store->active || index < 0 || index >= store->lap_total) return NULL;
+
+    int oldest = store->head - store->lap_total + 1;
+    return &store->laps[(oldest + index + store->max_laps) % store->max_laps];
+}
+
+bool lap_store_get_lap(const lap_store *store, int index, lap_store_lap_info *info)
+{
+    const lap_record *rec = held_lap(store, index);
+    if (!rec || !info) return false;
+
+    memset(info, 0, sizeof(*info));
+    info->lap = rec->lap;
+    info->complete = rec->complete;
+    info->in_progress = (rec == &store->laps[store->head]);
+    info->lap_time = info->in_progress ? rec->elapsed : rec->lap_time;
+    info->sector_count = store->sector_count;
+    memcpy(info->sector_times, rec->sector_times, sizeof(info->sector_times));
+    return true;
+}
+
+bool lap_store_get_stats(const lap_store *store, int index, int channel, int sector,
+                         lap_store_stats *stats)
+{
+    const lap_record *rec = held_lap(store, index);
+    if (!rec || !stats || channel < 0 || channel >= store->channel_count ||
+        sector < -1 || sector >= store->sector_count) {
+        return false;
+    }
+
+    *stats = rec->stats[channel][sector + 1];
+    return stats->count > 0;
+}
+
+bool lap_store_get_value(const lap_store *store, int index, int channel, float lap_pct,
+                         float *value)
+{
+    const lap_record *rec = held_lap(store, index);
+    if (!rec || !value || channel < 0 || channel >= store->channel_count ||
+        !(lap_pct >= 0.0f) || lap_pct > 1.0f) {
+        return false;
+    }
+
+    int bin = (int)(lap_pct * LAP_STORE_BINS);
+    if (bin >= LAP_STORE_BINS) bin = LAP_STORE_BINS - 1;
+    if (bin > rec->last_bin || rec->bin_time[bin] < 0.0f) return false;
+
+    *value = dequantize(&store->channels[channel],
+                        rec->values[(size_t)channel * LAP_STORE_BINS + bin]);
+    return true;
+}
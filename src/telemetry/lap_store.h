@@ -0,0 +1,121 @@
+/*
+ * ira - iRacing Application
+ * Lap Store - in-memory telemetry segmented by lap, with per-lap statistics
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_LAP_STORE_H
+#define IRA_LAP_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../irsdk/irsdk.h"
+
+/* Distance bins per lap; each stores one quantized sample per channel */
+#define LAP_STORE_BINS          1024
+
+/* Limits */
+#define LAP_STORE_MAX_CHANNELS  16
+#define LAP_STORE_MAX_SECTORS   8
+
+/* Laps kept when lap_store_create() is given 0 */
+#define LAP_STORE_DEFAULT_LAPS  64
+
+/* Running statistics of one channel over a lap or sector */
+typedef struct {
+    float min;
+    float max;
+    double sum;
+    int count;
+} lap_store_stats;
+
+/* Summary of a stored lap */
+typedef struct {
+    int lap;                    /* Sim lap number */
+    bool complete;              /* Ran from the line to the line */
+    bool in_progress;           /* The lap being driven now */
+    float lap_time;             /* Seconds; so far, if in progress */
+    float sector_times[LAP_STORE_MAX_SECTORS];
+    int sector_count;
+} lap_store_lap_info;
+
+/*
+ * Lap store (opaque type)
+ *
+ * Keeps the last max_laps laps as LAP_STORE_BINS samples spread evenly
+ * over LapDistPct, with min/max/mean per channel for the lap and for
+ * each sector. Everything is allocated by lap_store_start(), so memory
+ * stays constant however long the session runs. The best complete lap's
+ * timing is kept even after it leaves the ring.
+ *
+ * Not thread safe: sample and query from the telemetry thread.
+ */
+typedef struct lap_store lap_store;
+
+/* Create a store keeping max_laps laps (0 = LAP_STORE_DEFAULT_LAPS) */
+lap_store *lap_store_create(int max_laps);
+
+/* Free a store */
+void lap_store_destroy(lap_store *store);
+
+/*
+ * Add a channel stored as 16 bits over [min, max]; statistics use the
+ * exact values. Must be called before lap_store_start().
+ * Returns the channel index, or -1 if the variable is unknown.
+ */
+int lap_store_add_channel(lap_store *store, const char *var_name, float min, float max);
+
+/* Add speed, RPM, gear, pedals, steering and g-forces */
+bool lap_store_add_defaults(lap_store *store);
+
+/*
+ * Set the sector start points (LapDistPct, first must be 0). Defaults to
+ * three equal sectors. Must be called before lap_store_start().
+ */
+bool lap_store_set_sectors(lap_store *store, const float *starts, int count);
+
+/* Allocate the ring and resolve the variables */
+bool lap_store_start(lap_store *store);
+
+/* Resolve the variables again after the sim reconnects */
+void lap_store_rebind(lap_store *store);
+
+/*
+ * Add one telemetry sample. Never allocates.
+ *
+ * Parameters:
+ *   data - Telemetry data buffer from irsdk_wait_for_data()
+ */
+void lap_store_sample(lap_store *store, const char *data);
+
+/*
+ * Time gained (negative) or lost against the best complete lap at the
+ * current track position. Returns false if there is no best lap yet.
+ */
+bool lap_store_delta_to_best(const lap_store *store, float *delta);
+
+/* Best complete lap time in seconds, or 0 if none */
+float lap_store_best_lap_time(const lap_store *store);
+
+/* Number of laps held, including the one in progress */
+int lap_store_lap_count(const lap_store *store);
+
+/* Summary of the i-th held lap, 0 = oldest */
+bool lap_store_get_lap(const lap_store *store, int index, lap_store_lap_info *info);
+
+/*
+ * Statistics of a channel over the i-th held lap, or one of its sectors
+ * (sector = -1 for the whole lap).
+ */
+bool lap_store_get_stats(const lap_store *store, int index, int channel, int sector,
+                         lap_store_stats *stats);
+
+/*
+ * Channel value of the i-th held lap at a track position, as stored
+ * (quantized). Returns false if the lap has no sample there.
+ */
+bool lap_store_get_value(const lap_store *store, int index, int channel, float lap_pct,
+                         float *value);
+
+#endif /* IRA_LAP_STORE_H */
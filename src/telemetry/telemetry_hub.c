@@ -0,0 +1,652 @@
+/*
+ * ira - iRacing Application
+ * Telemetry Hub Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry_hub.h"
+
+#pragma comment(lib, "ws2_32")
+
+/* Attempts at a consistent copy before a reader gives up on a row */
+#define TELEM_HUB_READ_RETRIES 3
+
+/* Longest a client waits between looks at head, should a pulse be missed */
+#define TELEM_HUB_POLL_MS 4
+
+/* Published variable */
+typedef struct {
+    irsdk_VarHeader header;     /* As published; offset is the row offset */
+    int src_offset;             /* Offset in the sim's buffer, -1 if missing */
+    int width;                  /* Bytes per sample */
+} hub_var;
+
+struct telem_hub {
+    hub_var vars[TELEM_HUB_MAX_VARS];
+    int var_count;
+    int row_bytes;
+    bool active;
+
+    /* Shared memory ring */
+    HANDLE mem_map;
+    char *shared;
+    telem_hub_header *header;
+    HANDLE data_event;
+    char *row;                  /* Row being published */
+
+    /* UDP */
+    char udp_host[256];
+    int udp_port;
+    bool wsa_started;
+    SOCKET sock;
+    struct sockaddr_storage udp_addr;
+    int udp_addr_len;
+    char *keyframe;             /* Row of the last keyframe sent */
+    uint8_t *packet;            /* Send buffer */
+    uint32_t seq;
+    uint32_t key_seq;
+    int ticks_since_key;
+    int keyframes_sent;
+
+    telem_hub_stats stats;
+};
+
+struct telem_hub_client {
+    HANDLE mem_map;
+    const char *shared;
+    const telem_hub_header *header;
+    const irsdk_VarHeader *vars;
+    HANDLE data_event;
+    int last_head;
+};
+
+/*
+ * Helper: Round up to a multiple of align (a power of two)
+ */
+static int align_up(int value, int align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+/*
+ * Helper: Row slot n of the shared ring
+ */
+static telem_hub_slot *ring_slot(const telem_hub_header *header, int n)
+{
+    return (telem_hub_slot *)((char *)header + header->ring_offset +
+                              (size_t)(n % header->slot_count) * header->slot_bytes);
+}
+
+/*
+ * Lifecycle
+ */
+
+telem_hub *telem_hub_create(void)
+{
+    telem_hub *hub = calloc(1, sizeof(telem_hub));
+    if (!hub) return NULL;
+
+    hub->sock = INVALID_SOCKET;
+    return hub;
+}
+
+void telem_hub_destroy(telem_hub *hub)
+{
+    if (!hub) return;
+
+    if (hub->sock != INVALID_SOCKET) closesocket(hub->sock);
+    if (hub->wsa_started) WSACleanup();
+
+    if (hub->data_event) CloseHandle(hub->data_event);
+    if (hub->shared) UnmapViewOfFile(hub->shared);
+    if (hub->mem_map) CloseHandle(hub->mem_map);
+
+    free(hub->row);
+    free(hub->keyframe);
+    free(hub->packet);
+    free(hub);
+}
+
+/*
+ * Configuration
+ */
+
+bool telem_hub_add_var(telem_hub *hub, const char *var_name)
+{
+    if (!hub || !var_name || hub->active || hub->var_count >= TELEM_HUB_MAX_VARS) {
+        return false;
+    }
+
+    int idx = irsdk_var_name_to_index(var_name);
+    const irsdk_VarHeader *header = idx >= 0 ? irsdk_get_var_header(idx) : NULL;
+    if (!header || header->type < 0 || header->type >= IRSDK_TYPE_COUNT) {
+        return false;
+    }
+
+    /* Skip duplicates */
+    for (int i = 0; i < hub->var_count; i++) {
+        if (strcmp(hub->vars[i].header.name, header->name) == 0) return true;
+    }
+
+    /* Keep values aligned so consumers can read them in place */
+    int type_bytes = irsdk_var_type_bytes[header->type];
+    int width = type_bytes * header->count;
+    int offset = align_up(hub->row_bytes, type_bytes);
+    if (width <= 0 || offset + width > TELEM_HUB_MAX_ROW) {
+        return false;
+    }
+
+    hub_var *var = &hub->vars[hub->var_count++];
+    var->header = *header;
+    var->header.offset = offset;
+    var->src_offset = header->offset;
+    var->width = width;
+    hub->row_bytes = offset + width;
+    return true;
+}
+
+int telem_hub_add_list(telem_hub *hub, const char *var_names)
+{
+    if (!hub || !var_names) return 0;
+
+    int added = 0;
+    const char *p = var_names;
+
+    while (*p) {
+        while (*p == ',' || *p == ' ') p++;
+
+        const char *start = p;
+        while (*p && *p != ',' && *p != ' ') p++;
+
+        size_t len = (size_t)(p - start);
+        if (len > 0 && len < IRSDK_MAX_STRING) {
+            char name[IRSDK_MAX_STRING];
+            memcpy(name, start, len);
+            name[len] = '\0';
+            if (telem_hub_add_var(hub, name)) added++;
+        }
+    }
+
+    return added;
+}
+
+bool telem_hub_add_defaults(telem_hub *hub)
+{
+    if (!hub) return false;
+
+    static const char *defaults[] = {
+        "SessionTime", "SessionFlags", "Lap", "LapDistPct",
+        "LapCurrentLapTime", "LapLastLapTime", "LapBestLapTime",
+        "LapDeltaToBestLap", "Speed", "RPM", "Gear",
+        "Throttle", "Brake", "Clutch", "SteeringWheelAngle",
+        "FuelLevel", "FuelLevelPct", "OilTemp", "WaterTemp",
+        "PlayerCarPosition", "OnPitRoad",
+        "CarIdxLapDistPct", "CarIdxPosition",
+    };
+
+    int added = 0;
+    for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+        if (telem_hub_add_var(hub, defaults[i])) added++;
+    }
+
+    return added > 0;
+}
+
+bool telem_hub_set_udp_target(telem_hub *hub, const char *host, int port)
+{
+    if (!hub || !host || hub->active || port <= 0 || port > 65535) return false;
+    if (strlen(host) >= sizeof(hub->udp_host)) return false;
+
+    strcpy(hub->udp_host, host);
+    hub->udp_port = port;
+    return true;
+}
+
+/*
+ * Helper: Resolve the UDP target and open a non-blocking socket
+ */
+static bool open_udp(telem_hub *hub)
+{
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        return false;
+    }
+    hub->wsa_started = true;
+
+    char port[16];
+    snprintf(port, sizeof(port), "%d", hub->udp_port);
+
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+
+    if (getaddrinfo(hub->udp_host, port, &hints, &result) != 0 || !result) {
+        return false;
+    }
+
+    hub->sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (hub->sock != INVALID_SOCKET && result->ai_addrlen <= sizeof(hub->udp_addr)) {
+        memcpy(&hub->udp_addr, result->ai_addr, result->ai_addrlen);
+        hub->udp_addr_len = (int)result->ai_addrlen;
+    }
+    freeaddrinfo(result);
+
+    if (hub->sock == INVALID_SOCKET || hub->udp_addr_len == 0) {
+        return false;
+    }
+
+    /* A full socket buffer drops the packet instead of stalling the tick */
+    unsigned long non_blocking = 1;
+    ioctlsocket(hub->sock, FIONBIO, &non_blocking);
+    return true;
+}
+
+bool telem_hub_start(telem_hub *hub)
+{
+    if (!hub || hub->active || hub->var_count == 0) return false;
+
+    int var_header_offset = align_up((int)sizeof(telem_hub_header), 16);
+    int ring_offset = align_up(var_header_offset +
+                               hub->var_count * (int)sizeof(irsdk_VarHeader), 16);
+    int slot_bytes = align_up((int)sizeof(telem_hub_slot) + hub->row_bytes, 16);
+    DWORD size = (DWORD)ring_offset + (DWORD)TELEM_HUB_SLOTS * (DWORD)slot_bytes;
+
+    hub->mem_map = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                      0, size, TELEM_HUB_MEMMAPNAME);
+    if (!hub->mem_map) return false;
+
+    /* Another ira is already publishing */
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(hub->mem_map);
+        hub->mem_map = NULL;
+        return false;
+    }
+
+    hub->shared = MapViewOfFile(hub->mem_map, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    hub->data_event = CreateEventA(NULL, TRUE, FALSE, TELEM_HUB_DATAVALIDEVENT);
+    hub->row = calloc(1, hub->row_bytes);
+    if (!hub->shared || !hub->data_event || !hub->row) {
+        return false;
+    }
+
+    /* Header and variable table; the mapping starts zeroed */
+    telem_hub_header *header = (telem_hub_header *)hub->shared;
+    memcpy(header->magic, TELEM_HUB_MAGIC, sizeof(TELEM_HUB_MAGIC));
+    header->version = TELEM_HUB_VERSION;
+    header->var_count = hub->var_count;
+    header->var_header_offset = var_header_offset;
+    header->row_bytes = hub->row_bytes;
+    header->slot_count = TELEM_HUB_SLOTS;
+    header->slot_bytes = slot_bytes;
+    header->ring_offset = ring_offset;
+
+    const irsdk_Header *sdk = irsdk_get_header();
+    header->tick_rate = sdk ? sdk->tick_rate : 60;
+
+    irsdk_VarHeader *vars = (irsdk_VarHeader *)(hub->shared + var_header_offset);
+    for (int i = 0; i < hub->var_count; i++) {
+        vars[i] = hub->vars[i].header;
+    }
+    hub->header = header;
+
+    /* UDP is optional; without it the hub still serves local consumers */
+    if (hub->udp_host[0]) {
+        /* Deltas are capped at a keyframe's size, see publish_udp() */
+        int schema_bytes = hub->var_count * (int)sizeof(telem_hub_schema_var);
+        int payload = schema_bytes > hub->row_bytes ? schema_bytes : hub->row_bytes;
+
+        hub->keyframe = calloc(1, hub->row_bytes);
+        hub->packet = malloc(sizeof(telem_hub_packet) + payload);
+        if (!hub->keyframe || !hub->packet || !open_udp(hub)) {
+            printf("Warning: Telemetry hub could not open UDP target %s:%d\n",
+                   hub->udp_host, hub->udp_port);
+            if (hub->sock != INVALID_SOCKET) closesocket(hub->sock);
+            hub->sock = INVALID_SOCKET;
+        }
+    }
+
+    hub->stats.var_count = hub->var_count;
+    hub->stats.row_bytes = hub->row_bytes;
+    hub->stats.udp_active = hub->sock != INVALID_SOCKET;
+    hub->ticks_since_key = 0;
+    hub->active = true;
+    return true;
+}
+
+void telem_hub_rebind(telem_hub *hub)
+{
+    if (!hub) return;
+
+    for (int i = 0; i < hub->var_count; i++) {
+        hub_var *var = &hub->vars[i];
+        int idx = irsdk_var_name_to_index(var->header.name);
+        const irsdk_VarHeader *header = idx >= 0 ? irsdk_get_var_header(idx) : NULL;
+
+        /* The published layout is fixed, so a resized variable can't follow */
+        if (header && header->type == var->header.type && header->count == var->header.count) {
+            var->src_offset = header->offset;
+        } else {
+            var->src_offset = -1;
+        }
+    }
+
+    /* Start remote consumers from a fresh keyframe */
+    hub->ticks_since_key = 0;
+}
+
+/*
+ * Publishing
+ */
+
+/*
+ * Helper: Send one UDP packet from hub->packet, payload already in place
+ */
+static void send_packet(telem_hub *hub, telem_hub_packet_type type, int payload_size,
+                        int tick_count)
+{
+    telem_hub_packet *pkt = (telem_hub_packet *)hub->packet;
+    memcpy(pkt->magic, "IRAH", 4);
+    pkt->version = TELEM_HUB_VERSION;
+    pkt->type = (uint8_t)type;
+    pkt->var_count = (uint16_t)hub->var_count;
+    pkt->seq = hub->seq++;
+    pkt->key_seq = hub->key_seq;
+    pkt->tick_count = tick_count;
+    pkt->payload_size = (uint32_t)payload_size;
+
+    int size = (int)sizeof(telem_hub_packet) + payload_size;
+    int sent = sendto(hub->sock, (const char *)hub->packet, size, 0,
+                      (const struct sockaddr *)&hub->udp_addr, hub->udp_addr_len);
+    if (sent == size) {
+        hub->stats.packets_sent++;
+        hub->stats.bytes_sent += size;
+    } else {
+        hub->stats.packets_dropped++;
+    }
+}
+
+/*
+ * Helper: XOR row against the keyframe and compress the zero runs.
+ * Returns the encoded size, or -1 if it would exceed capacity bytes.
+ * Alternating zero and changed bytes can reach 1.5x the row size.
+ */
+static int encode_delta(const uint8_t *row, const uint8_t *key, int size,
+                        uint8_t *out, int capacity)
+{
+    int in = 0;
+    int pos = 0;
+
+    while (in < size) {
+        int run = 0;
+        if (pos >= capacity) return -1;
+        if ((row[in] ^ key[in]) == 0) {
+            while (in < size && run < 128 && (row[in] ^ key[in]) == 0) {
+                run++;
+                in++;
+            }
+            out[pos++] = (uint8_t)(0x80 | (run - 1));
+        } else {
+            int control = pos++;
+            while (in < size && run < 128 && (row[in] ^ key[in]) != 0) {
+                if (pos >= capacity) return -1;
+                out[pos++] = row[in] ^ key[in];
+                run++;
+                in++;
+            }
+            out[control] = (uint8_t)(run - 1);
+        }
+    }
+
+    return pos;
+}
+
+/*
+ * Helper: Send the row as a keyframe (preceded now and then by the
+ * schema) or as a delta against the last keyframe
+ */
+static void publish_udp(telem_hub *hub, int tick_count)
+{
+    uint8_t *payload = hub->packet + sizeof(telem_hub_packet);
+
+    /* A delta no smaller than the row goes out as a keyframe instead */
+    if (hub->ticks_since_key != 0) {
+        int size = encode_delta((const uint8_t *)hub->row, (const uint8_t *)hub->keyframe,
+                                hub->row_bytes, payload, hub->row_bytes);
+        if (size >= 0) {
+            send_packet(hub, TELEM_HUB_PKT_DELTA, size, tick_count);
+        } else {
+            hub->ticks_since_key = 0;
+        }
+    }
+
+    if (hub->ticks_since_key == 0) {
+        if (hub->keyframes_sent % TELEM_HUB_SCHEMA_KEYFRAMES == 0) {
+            telem_hub_schema_var *schema = (telem_hub_schema_var *)payload;
+            memset(schema, 0, hub->var_count * sizeof(telem_hub_schema_var));
+            for (int i = 0; i < hub->var_count; i++) {
+                memcpy(schema[i].name, hub->vars[i].header.name, IRSDK_MAX_STRING);
+                schema[i].type = hub->vars[i].header.type;
+                schema[i].count = hub->vars[i].header.count;
+                schema[i].offset = hub->vars[i].header.offset;
+            }
+            send_packet(hub, TELEM_HUB_PKT_SCHEMA,
+                        hub->var_count * (int)sizeof(telem_hub_schema_var), tick_count);
+        }
+
+        hub->key_seq = hub->seq;
+        memcpy(hub->keyframe, hub->row, hub->row_bytes);
+        memcpy(payload, hub->row, hub->row_bytes);
+        send_packet(hub, TELEM_HUB_PKT_KEYFRAME, hub->row_bytes, tick_count);
+        hub->keyframes_sent++;
+    }
+
+    hub->ticks_since_key = (hub->ticks_since_key + 1) % TELEM_HUB_KEYFRAME_TICKS;
+}
+
+bool telem_hub_publish(telem_hub *hub, const char *data, int tick_count)
+{
+    if (!hub || !hub->active || !data) return false;
+
+    /* Gather the published subset into one packed row */
+    for (int i = 0; i < hub->var_count; i++) {
+        const hub_var *var = &hub->vars[i];
+        char *dst = hub->row + var->header.offset;
+        if (var->src_offset >= 0) {
+            memcpy(dst, data + var->src_offset, var->width);
+        } else {
+            memset(dst, 0, var->width);
+        }
+    }
+
+    /* Write the next slot under its sequence number, then publish it */
+    telem_hub_header *header = hub->header;
+    int n = header->head;
+    telem_hub_slot *slot = ring_slot(header, n);
+
+    slot->seq = 2 * n + 1;
+    MemoryBarrier();
+    slot->tick_count = tick_count;
+    memcpy(slot + 1, hub->row, hub->row_bytes);
+    MemoryBarrier();
+    slot->seq = 2 * n + 2;
+    MemoryBarrier();
+    header->head = n + 1;
+
+    PulseEvent(hub->data_event);
+    hub->stats.rows_published++;
+
+    if (hub->sock != INVALID_SOCKET) {
+        publish_udp(hub, tick_count);
+    }
+
+    return true;
+}
+
+void telem_hub_get_stats(const telem_hub *hub, telem_hub_stats *stats)
+{
+    if (!stats) return;
+
+    if (!hub) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = hub->stats;
+}
+
+/*
+ * Local consumer
+ */
+
+telem_hub_client *telem_hub_client_open(void)
+{
+    telem_hub_client *client = calloc(1, sizeof(telem_hub_client));
+    if (!client) return NULL;
+
+    client->mem_map = OpenFileMappingA(FILE_MAP_READ, FALSE, TELEM_HUB_MEMMAPNAME);
+    if (client->mem_map) {
+        client->shared = MapViewOfFile(client->mem_map, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (client->shared) {
+        client->data_event = OpenEventA(SYNCHRONIZE, FALSE, TELEM_HUB_DATAVALIDEVENT);
+    }
+
+    const telem_hub_header *header = (const telem_hub_header *)client->shared;
+    if (!client->data_event || memcmp(header->magic, TELEM_HUB_MAGIC, sizeof(TELEM_HUB_MAGIC)) != 0 ||
+        header->version != TELEM_HUB_VERSION) {
+        telem_hub_client_close(client);
+        return NULL;
+    }
+
+    client->header = header;
+    client->vars = (const irsdk_VarHeader *)(client->shared + header->var_header_offset);
+    client->last_head = header->head;
+    return client;
+}
+
+void telem_hub_client_close(telem_hub_client *client)
+{
+    if (!client) return;
+
+    if (client->data_event) CloseHandle(client->data_event);
+    if (client->shared) UnmapViewOfFile(client->shared);
+    if (client->mem_map) CloseHandle(client->mem_map);
+    free(client);
+}
+
+const irsdk_VarHeader *telem_hub_client_find_var(const telem_hub_client *client,
+                                                 const char *name)
+{
+    if (!client || !name) return NULL;
+
+    for (int i = 0; i < client->header->var_count; i++) {
+        if (strncmp(client->vars[i].name, name, IRSDK_MAX_STRING) == 0) {
+            return &client->vars[i];
+        }
+    }
+    return NULL;
+}
+
+int telem_hub_client_row_bytes(const telem_hub_client *client)
+{
+    return client ? client->header->row_bytes : 0;
+}
+
+/*
+ * Helper: Copy the newest row if it is one we have not returned yet
+ */
+static bool read_latest(telem_hub_client *client, char *row, int *tick_count)
+{
+    const telem_hub_header *header = client->header;
+
+    for (int attempt = 0; attempt < TELEM_HUB_READ_RETRIES; attempt++) {
+        MemoryBarrier();
+        int head = header->head;
+        if (head == client->last_head) return false;
+
+        int n = head - 1;
+        const telem_hub_slot *slot = ring_slot(header, n);
+        int seq = slot->seq;
+        MemoryBarrier();
+
+        if (seq != 2 * n + 2) continue;
+
+        int tick = slot->tick_count;
+        memcpy(row, slot + 1, header->row_bytes);
+        MemoryBarrier();
+
+        /* The hub lapped us mid-copy; try the newest row again */
+        if (slot->seq != seq) continue;
+
+        client->last_head = head;
+        if (tick_count) *tick_count = tick;
+        return true;
+    }
+
+    return false;
+}
+
+bool telem_hub_client_wait(telem_hub_client *client, int timeout_ms,
+                           char *row, int *tick_count)
+{
+    if (!client || !row) return false;
+
+    /*
+     * The pulse only wakes us early. One landing between read_latest()
+     * and the wait is lost, so wait in slices and poll head between them.
+     */
+    DWORD start = GetTickCount();
+    for (;;) {
+        if (read_latest(client, row, tick_count)) return true;
+
+        DWORD elapsed = GetTickCount() - start;
+        if (timeout_ms <= 0 || elapsed >= (DWORD)timeout_ms) return false;
+
+        DWORD remaining = (DWORD)timeout_ms - elapsed;
+        WaitForSingleObject(client->data_event,
+                            remaining < TELEM_HUB_POLL_MS ? remaining : TELEM_HUB_POLL_MS);
+    }
+}
+
+/*
+ * UDP consumer
+ */
+
+bool telem_hub_decode_delta(const uint8_t *payload, int payload_size,
+                            const char *keyframe, char *row, int row_bytes)
+{
+    if (!payload || !keyframe || !row) return false;
+
+    int in = 0;
+    int out = 0;
+
+    while (in < payload_size) {
+        uint8_t control = payload[in++];
+        int run = (control & 0x7F) + 1;
+        if (out + run > row_bytes) return false;
+
+        if (control & 0x80) {
+            memcpy(row + out, keyframe + out, run);
+        } else {
+            if (in + run > payload_size) return false;
+            for (int i = 0; i < run; i++) {
+                row[out + i] = (char)(keyframe[out + i] ^ payload[in + i]);
+            }
+            in += run;
+        }
+        out += run;
+    }
+
+    return out == row_bytes;
+}
@@ -0,0 +1,208 @@
+/*
+ * ira - iRacing Application
+ * Telemetry Hub - republish telemetry to overlays and remote dashboards
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_TELEMETRY_HUB_H
+#define IRA_TELEMETRY_HUB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../irsdk/irsdk.h"
+
+/*
+ * Shared memory and event local consumers open. The event is pulsed per
+ * row as a wake-up hint only; pulses can be missed, so poll head as well.
+ */
+#define TELEM_HUB_MEMMAPNAME        "Local\\IRAHubMemMap"
+#define TELEM_HUB_DATAVALIDEVENT    "Local\\IRAHubDataValidEvent"
+
+#define TELEM_HUB_MAGIC             "IRAHUB"
+#define TELEM_HUB_VERSION           1
+
+/* Rows kept in shared memory (power of two) */
+#define TELEM_HUB_SLOTS             16
+
+/* Published variable and row limits; a keyframe must fit one datagram */
+#define TELEM_HUB_MAX_VARS          256
+#define TELEM_HUB_MAX_ROW           32768
+
+/* Default UDP port for remote dashboards */
+#define TELEM_HUB_DEFAULT_PORT      27245
+
+/* Ticks per UDP keyframe (1 second at 60Hz) and keyframes per schema */
+#define TELEM_HUB_KEYFRAME_TICKS    60
+#define TELEM_HUB_SCHEMA_KEYFRAMES  5
+
+/*
+ * Shared memory layout
+ *
+ *   telem_hub_header
+ *   irsdk_VarHeader[var_count]     offset = byte offset within a row
+ *   slot_count slots of slot_bytes: telem_hub_slot, then the row
+ *
+ * Row n goes to slot n % slot_count, and head counts the rows published.
+ * A slot's seq is odd while the hub writes it; a reader copies the row and
+ * keeps it only if seq was even and unchanged across the copy.
+ */
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t var_count;
+    int32_t var_header_offset;
+    int32_t row_bytes;
+    int32_t slot_count;
+    int32_t slot_bytes;
+    int32_t ring_offset;
+    int32_t tick_rate;
+    volatile int32_t head;
+    int32_t reserved[7];
+} telem_hub_header;
+
+typedef struct {
+    volatile int32_t seq;
+    int32_t tick_count;
+    int32_t reserved[2];
+} telem_hub_slot;
+
+/*
+ * UDP packets: telem_hub_packet, then payload_size bytes of
+ *
+ *   TELEM_HUB_PKT_SCHEMA    telem_hub_schema_var[var_count]
+ *   TELEM_HUB_PKT_KEYFRAME  one full row
+ *   TELEM_HUB_PKT_DELTA     the row XORed with keyframe key_seq, stored as
+ *                           runs: a control byte with the high bit set
+ *                           means (c & 0x7F) + 1 zero bytes, otherwise
+ *                           c + 1 literal bytes follow
+ *
+ * Deltas refer to the last keyframe rather than the previous packet, so
+ * a lost datagram costs one row, and a lost keyframe at most a second.
+ */
+typedef enum {
+    TELEM_HUB_PKT_SCHEMA = 0,
+    TELEM_HUB_PKT_KEYFRAME,
+    TELEM_HUB_PKT_DELTA
+} telem_hub_packet_type;
+
+typedef struct {
+    char magic[4];              /* "IRAH" */
+    uint8_t version;
+    uint8_t type;               /* telem_hub_packet_type */
+    uint16_t var_count;
+    uint32_t seq;               /* Packet sequence number */
+    uint32_t key_seq;           /* Keyframe a delta applies to */
+    int32_t tick_count;
+    uint32_t payload_size;
+} telem_hub_packet;
+
+typedef struct {
+    char name[IRSDK_MAX_STRING];
+    int32_t type;               /* irsdk_VarType */
+    int32_t count;
+    int32_t offset;             /* Byte offset within a row */
+} telem_hub_schema_var;
+
+/* Publisher statistics */
+typedef struct {
+    int var_count;
+    int row_bytes;
+    bool udp_active;            /* UDP target set and its socket opened */
+    int rows_published;
+    int packets_sent;
+    int packets_dropped;        /* Send failures, e.g. a full socket buffer */
+    long long bytes_sent;
+} telem_hub_stats;
+
+/*
+ * Publisher
+ */
+
+typedef struct telem_hub telem_hub;
+
+/* Create a hub. Returns NULL on error. */
+telem_hub *telem_hub_create(void);
+
+/* Stop publishing and free the hub */
+void telem_hub_destroy(telem_hub *hub);
+
+/*
+ * Add a variable to publish, resolved against the connected sim.
+ * Must be called before telem_hub_start().
+ */
+bool telem_hub_add_var(telem_hub *hub, const char *var_name);
+
+/* Add a comma separated list of variables. Returns the number added. */
+int telem_hub_add_list(telem_hub *hub, const char *var_names);
+
+/* Add the usual dashboard set: speed, RPM, gear, pedals, lap, fuel, ... */
+bool telem_hub_add_defaults(telem_hub *hub);
+
+/*
+ * Also send rows to host:port over UDP.
+ * Must be called before telem_hub_start().
+ */
+bool telem_hub_set_udp_target(telem_hub *hub, const char *host, int port);
+
+/* Create the shared memory and open the UDP socket */
+bool telem_hub_start(telem_hub *hub);
+
+/*
+ * Resolve the variables again after the sim reconnects. Variables that
+ * are gone, or changed size, are published as zeros.
+ */
+void telem_hub_rebind(telem_hub *hub);
+
+/*
+ * Publish one sample. Call with each telemetry update; never blocks.
+ *
+ * Parameters:
+ *   data - Telemetry data buffer from irsdk_wait_for_data()
+ *   tick_count - The sample's tick, see irsdk_get_tick_count()
+ */
+bool telem_hub_publish(telem_hub *hub, const char *data, int tick_count);
+
+/* Get publisher statistics */
+void telem_hub_get_stats(const telem_hub *hub, telem_hub_stats *stats);
+
+/*
+ * Consumer (local)
+ *
+ * Overlays read ira's ring instead of mapping the sim themselves.
+ */
+
+typedef struct telem_hub_client telem_hub_client;
+
+/* Open the hub's shared memory. Returns NULL if ira is not publishing. */
+telem_hub_client *telem_hub_client_open(void);
+
+/* Close a client */
+void telem_hub_client_close(telem_hub_client *client);
+
+/* Find a published variable by name. Returns NULL if not published. */
+const irsdk_VarHeader *telem_hub_client_find_var(const telem_hub_client *client,
+                                                 const char *name);
+
+/* Bytes per row; the buffer passed to telem_hub_client_wait() */
+int telem_hub_client_row_bytes(const telem_hub_client *client);
+
+/*
+ * Wait up to timeout_ms for a row newer than the last one returned and
+ * copy it to row. Returns true with the row's tick in *tick_count.
+ */
+bool telem_hub_client_wait(telem_hub_client *client, int timeout_ms,
+                           char *row, int *tick_count);
+
+/*
+ * Consumer (UDP)
+ */
+
+/*
+ * Rebuild a row from a DELTA payload and the keyframe it refers to.
+ * Returns false if the payload is malformed.
+ */
+bool telem_hub_decode_delta(const uint8_t *payload, int payload_size,
+                            const char *keyframe, char *row, int row_bytes);
+
+#endif /* IRA_TELEMETRY_HUB_H */
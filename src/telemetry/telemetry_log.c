@@ -1,6 +1,6 @@
 /*
  * ira - iRacing Application
- * Telemetry CSV Logger
+ * Telemetry Logger (CSV and binary columnar)
  *
  * Copyright (c) 2026 Christopher Griffiths
  */
@@ -10,10 +10,89 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h>
 #include <direct.h>
 
 #include "telemetry_log.h"
+#include "../util/stats.h"
+
+/* Binary log magic and version */
+#define TELEM_BIN_MAGIC     "IRATLOG"
+#define TELEM_BIN_VERSION   2
+#define TELEM_BLOCK_MAGIC   0x4B4C4254  /* "TBLK" */
+
+/* Column encodings */
+#define TELEM_ENC_RAW       0
+#define TELEM_ENC_XOR_RLE   1
+
+/* Initial variable table size */
+#define INITIAL_VAR_CAPACITY 32
+
+/* Sanity limits on the schema and block size when converting */
+#define TELEM_CONVERT_MAX_VARS 65536
+#define TELEM_CONVERT_MAX_ROW_BYTES (1024 * 1024)
+#define TELEM_CONVERT_MAX_BLOCK_BYTES (256 * 1024 * 1024)
+
+/*
+ * Stdio buffer size for log files. The writer leaves flushing to stdio,
+ * so rows reach the file in writes of this size; a crash loses at most
+ * one buffer.
+ */
+#define TELEM_FILE_BUFFER   (256 * 1024)
+
+/* Sample ring sizing: about TELEM_RING_BYTES, power of two slots */
+#define TELEM_RING_BYTES    (16 * 1024 * 1024)
+#define TELEM_RING_MIN      64
+#define TELEM_RING_MAX      8192
+
+/* Writer thread wakes when this many rows are queued, or on the idle timeout */
+#define TELEM_WRITER_BATCH  32
+#define TELEM_WRITER_IDLE_MS 100
+
+/*
+ * Binary log layout
+ *
+ *   telem_bin_header
+ *   irsdk_VarHeader[var_count]   offset = byte offset within a packed row
+ *   int32_t divider[var_count]   (version 2+) var is present in row r
+ *                                when r % divider == 0
+ *   blocks until end of file:
+ *     telem_bin_block
+ *     per variable, in schema order:
+ *       telem_bin_column
+ *       size bytes of column data
+ *
+ * Column data holds rows * width bytes of raw values (width is the var's
+ * type size times its count); rows counts only the block rows the var was
+ * sampled in. With TELEM_ENC_XOR_RLE each value is first
+ * XORed with the previous row's value, and the result is stored as runs:
+ * a control byte with the high bit set means (c & 0x7F) + 1 zero bytes,
+ * otherwise c + 1 literal bytes follow.
+ */
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t var_count;
+    int32_t tick_rate;
+    int32_t block_rows;
+    int64_t start_time;
+    char session_name[128];
+} telem_bin_header;
+
+typedef struct {
+    uint32_t magic;
+    int32_t rows;
+    int32_t flags;
+    int32_t reserved;
+} telem_bin_block;
+
+typedef struct {
+    int32_t encoding;
+    int32_t rows;
+    int32_t size;
+    int32_t reserved;
+} telem_bin_column;
 
 /* Variable info for logging */
 typedef struct {
@@ -21,6 +100,11 @@ typedef struct {
     int offset;
     int type;
     int count;
+    int width;          /* Bytes per sample */
+    int copy_bytes;     /* Bytes read from the sim; the rest of width is zeroed */
+    int packed_offset;  /* Offset within a packed row */
+    int divider;        /* Sample every Nth row (1 = every row) */
+    int block_count;    /* Samples in the current binary block */
 } telem_var_info;
 
 /* Logger state */
@@ -31,11 +115,39 @@ struct telem_logger {
 
     FILE *file;
     bool active;
+    telem_log_format format;
+    bool compress;
 
-    telem_var_info vars[TELEM_LOG_MAX_VARS];
+    telem_var_info *vars;
     int var_count;
+    int var_capacity;
+    int row_bytes;
 
-    int sample_count;
+    /* Binary block being filled, one column after another */
+    char *block;
+    int block_rows;
+    char *encode_buf;
+    int encode_cap;
+
+    /*
+     * Sample ring: telem_log_sample() is the only producer and the writer
+     * thread the only consumer. Both positions only ever grow; the slot is
+     * position & (ring_slots - 1).
+     */
+    char *ring;
+    int ring_slots;
+    volatile LONG ring_head;        /* Rows published by the producer */
+    volatile LONG ring_tail;        /* Rows consumed by the writer */
+    volatile LONG stop_requested;
+    HANDLE writer_thread;
+    HANDLE writer_event;
+
+    /* Counters */
+    volatile LONG sample_count;     /* Rows written to the file */
+    volatile LONG batch_count;
+    volatile LONG write_failed;
+    int dropped_count;
+    int ring_high_water;
     double start_time;
 };
 
@@ -63,6 +175,8 @@ telem_logger *telem_log_create(const char *output_dir, const char *session_name)
 
     logger->file = NULL;
     logger->active = false;
+    logger->format = TELEM_LOG_FORMAT_CSV;
+    logger->compress = true;
     logger->var_count = 0;
     logger->sample_count = 0;
 
@@ -77,43 +191,234 @@ void telem_log_destroy(telem_logger *logger)
     if (!logger) return;
 
     telem_log_stop(logger);
+    free(logger->vars);
     free(logger);
 }
 
 /*
- * Add a variable to be logged
+ * Select the output format
  */
-bool telem_log_add_var(telem_logger *logger, const char *var_name)
+bool telem_log_set_format(telem_logger *logger, telem_log_format format)
 {
-    if (!logger || !var_name || logger->active) {
+    if (!logger || logger->active) {
         return false;
     }
 
-    if (logger->var_count >= TELEM_LOG_MAX_VARS) {
+    if (format != TELEM_LOG_FORMAT_CSV && format != TELEM_LOG_FORMAT_BINARY) {
         return false;
     }
 
-    /* Find the variable in iRacing */
-    int idx = irsdk_var_name_to_index(var_name);
-    if (idx < 0) {
-        return false;
+    logger->format = format;
+    return true;
+}
+
+/*
+ * Enable or disable per-block compression
+ */
+void telem_log_set_compression(telem_logger *logger, bool enabled)
+{
+    if (logger && !logger->active) {
+        logger->compress = enabled;
     }
+}
 
-    const irsdk_VarHeader *header = irsdk_get_var_header(idx);
-    if (!header) {
+/* Find an added variable by name. Returns -1 if not added. */
+static int find_var(const telem_logger *logger, const char *name)
+{
+    for (int i = 0; i < logger->var_count; i++) {
+        if (strncmp(logger->vars[i].name, name, IRSDK_MAX_STRING) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Append a variable from its SDK header */
+static bool append_var(telem_logger *logger, const irsdk_VarHeader *header)
+{
+    if (header->type < 0 || header->type >= IRSDK_TYPE_COUNT || header->count <= 0) {
         return false;
     }
 
+    if (find_var(logger, header->name) >= 0) {
+        return true;
+    }
+
+    if (logger->var_count >= logger->var_capacity) {
+        int new_capacity = logger->var_capacity ? logger->var_capacity * 2 : INITIAL_VAR_CAPACITY;
+        telem_var_info *new_vars = (telem_var_info *)realloc(logger->vars,
+                                                             new_capacity * sizeof(telem_var_info));
+        if (!new_vars) {
+            return false;
+        }
+        logger->vars = new_vars;
+        logger->var_capacity = new_capacity;
+    }
+
     telem_var_info *var = &logger->vars[logger->var_count];
-    strncpy(var->name, var_name, IRSDK_MAX_STRING - 1);
+    memset(var, 0, sizeof(*var));
+    strncpy(var->name, header->name, IRSDK_MAX_STRING - 1);
     var->offset = header->offset;
     var->type = header->type;
     var->count = header->count;
+    var->width = irsdk_var_type_bytes[header->type] * header->count;
+    var->copy_bytes = var->width;
+    var->packed_offset = logger->row_bytes;
+    var->divider = 1;
 
+    logger->row_bytes += var->width;
     logger->var_count++;
     return true;
 }
 
+/*
+ * Add a variable to be logged
+ */
+bool telem_log_add_var(telem_logger *logger, const char *var_name)
+{
+    if (!logger || !var_name || logger->active) {
+        return false;
+    }
+
+    /* Find the variable in iRacing */
+    int idx = irsdk_var_name_to_index(var_name);
+    if (idx < 0) {
+        return false;
+    }
+
+    const irsdk_VarHeader *header = irsdk_get_var_header(idx);
+    if (!header) {
+        return false;
+    }
+
+    return append_var(logger, header);
+}
+
+/*
+ * Resolve the variables again after a layout change
+ */
+void telem_log_rebind(telem_logger *logger)
+{
+    if (!logger) {
+        return;
+    }
+
+    /* Only the producer side reads offset and copy_bytes, so no locking */
+    for (int i = 0; i < logger->var_count; i++) {
+        telem_var_info *var = &logger->vars[i];
+        const irsdk_VarHeader *header = irsdk_get_var_header(irsdk_var_name_to_index(var->name));
+
+        var->offset = 0;
+        var->copy_bytes = 0;
+        if (header && header->type == var->type) {
+            int count = header->count < var->count ? header->count : var->count;
+            var->offset = header->offset;
+            var->copy_bytes = irsdk_var_type_bytes[var->type] * count;
+        }
+    }
+}
+
+/*
+ * Add every variable the sim publishes
+ */
+int telem_log_add_all(telem_logger *logger)
+{
+    const irsdk_Header *sdk = irsdk_get_header();
+    if (!logger || logger->active || !sdk) {
+        return 0;
+    }
+
+    int added = 0;
+    for (int i = 0; i < sdk->num_vars; i++) {
+        const irsdk_VarHeader *header = irsdk_get_var_header(i);
+        if (header && append_var(logger, header)) {
+            added++;
+        }
+    }
+
+    return added;
+}
+
+/* Match a name against a pattern with '*' and '?' wildcards */
+static bool name_matches(const char *pattern, const char *name)
+{
+    while (*pattern) {
+        if (*pattern == '*') {
+            pattern++;
+            if (!*pattern) {
+                return true;
+            }
+            for (; *name; name++) {
+                if (name_matches(pattern, name)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        if (!*name || (*pattern != '?' && *pattern != *name)) {
+            return false;
+        }
+        pattern++;
+        name++;
+    }
+
+    return *name == '\0';
+}
+
+/*
+ * Set the sample rate of matching variables
+ */
+int telem_log_set_var_rate(telem_logger *logger, const char *pattern, int rate_hz)
+{
+    if (!logger || !pattern || logger->active || rate_hz <= 0) {
+        return 0;
+    }
+
+    const irsdk_Header *sdk = irsdk_get_header();
+    int tick_rate = (sdk && sdk->tick_rate > 0) ? sdk->tick_rate : 60;
+
+    /* Round to the nearest whole divider of the tick rate */
+    int divider = (tick_rate + rate_hz / 2) / rate_hz;
+    if (divider < 1) divider = 1;
+
+    int matched = 0;
+    for (int i = 0; i < logger->var_count; i++) {
+        if (name_matches(pattern, logger->vars[i].name)) {
+            logger->vars[i].divider = divider;
+            matched++;
+        }
+    }
+
+    return matched;
+}
+
+/*
+ * Apply default rates for slow-changing channels
+ */
+void telem_log_apply_default_rates(telem_logger *logger)
+{
+    /* Everything else stays at the full tick rate */
+    static const struct {
+        const char *pattern;
+        int rate_hz;
+    } default_rates[] = {
+        { "??temp*",        1 },    /* Tyre surface and carcass temps */
+        { "??wear*",        1 },    /* Tyre wear */
+        { "??coldPressure", 1 },
+        { "*Temp",          1 },    /* Oil, water, air and track temps */
+        { "*Press",         10 },   /* Oil, fuel and manifold pressure */
+        { "FuelLevel*",     10 },
+        { "CarIdx*",        10 },   /* Other cars */
+        { "Dc*",            4 },    /* In-car adjustments */
+        { "dc*",            4 },
+    };
+
+    for (size_t i = 0; i < sizeof(default_rates) / sizeof(default_rates[0]); i++) {
+        telem_log_set_var_rate(logger, default_rates[i].pattern, default_rates[i].rate_hz);
+    }
+}
+
 /*
  * Add default variables for logging
  */
@@ -163,37 +468,454 @@ static void generate_filename(telem_logger *logger)
     char timestamp[32];
     strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", t);
 
-    snprintf(logger->filepath, MAX_PATH, "%s\\%s_%s.csv",
-             logger->output_dir, logger->session_name, timestamp);
+    const char *ext = (logger->format == TELEM_LOG_FORMAT_BINARY) ?
+                      TELEM_LOG_BINARY_EXT : ".csv";
+
+    snprintf(logger->filepath, MAX_PATH, "%s\\%s_%s%s",
+             logger->output_dir, logger->session_name, timestamp, ext);
 }
 
 /*
- * Write CSV header
+ * CSV output
  */
-static bool write_header(telem_logger *logger)
-{
-    if (!logger || !logger->file) return false;
 
-    /* Write variable names */
-    for (int i = 0; i < logger->var_count; i++) {
-        telem_var_info *var = &logger->vars[i];
+/* Write CSV column names */
+static void write_csv_header(FILE *file, const telem_var_info *vars, int var_count)
+{
+    for (int i = 0; i < var_count; i++) {
+        const telem_var_info *var = &vars[i];
 
         if (var->count > 1 && var->type != IRSDK_TYPE_CHAR) {
             /* Array variable - write multiple columns */
             for (int j = 0; j < var->count; j++) {
-                if (i > 0 || j > 0) fprintf(logger->file, ",");
-                fprintf(logger->file, "%s_%d", var->name, j);
+                if (i > 0 || j > 0) fprintf(file, ",");
+                fprintf(file, "%s_%d", var->name, j);
+            }
+        } else {
+            if (i > 0) fprintf(file, ",");
+            fprintf(file, "%s", var->name);
+        }
+    }
+    fprintf(file, "\n");
+}
+
+/* Write empty cells for a variable not sampled in this row */
+static void write_var_gap(FILE *file, const telem_var_info *var, bool *first)
+{
+    int cells = (var->count > 1 && var->type != IRSDK_TYPE_CHAR) ? var->count : 1;
+    for (int j = 0; j < cells; j++) {
+        if (!*first) fputc(',', file);
+        *first = false;
+    }
+}
+
+/*
+ * Write every column of one variable; ptr points at its first entry.
+ * The type is switched on once per variable, not once per entry.
+ */
+static void write_var_values(FILE *file, const char *ptr, const telem_var_info *var, bool *first)
+{
+    if (!*first) fputc(',', file);
+    *first = false;
+
+    /* Strings are one quoted column */
+    if (var->type == IRSDK_TYPE_CHAR) {
+        fprintf(file, "\"%.*s\"", var->count, ptr);
+        return;
+    }
+
+    int count = var->count > 1 ? var->count : 1;
+
+    switch (var->type) {
+    case IRSDK_TYPE_BOOL: {
+        const bool *v = (const bool *)ptr;
+        for (int j = 0; j < count; j++) {
+            if (j) fputc(',', file);
+            fputc(v[j] ? '1' : '0', file);
+        }
+        break;
+    }
+
+    case IRSDK_TYPE_INT:
+    case IRSDK_TYPE_BITFIELD: {
+        const int *v = (const int *)ptr;
+        for (int j = 0; j < count; j++) {
+            fprintf(file, j ? ",%d" : "%d", v[j]);
+        }
+        break;
+    }
+
+    case IRSDK_TYPE_FLOAT: {
+        const float *v = (const float *)ptr;
+        for (int j = 0; j < count; j++) {
+            fprintf(file, j ? ",%.6f" : "%.6f", v[j]);
+        }
+        break;
+    }
+
+    case IRSDK_TYPE_DOUBLE: {
+        const double *v = (const double *)ptr;
+        for (int j = 0; j < count; j++) {
+            fprintf(file, j ? ",%.9f" : "%.9f", v[j]);
+        }
+        break;
+    }
+
+    default:
+        for (int j = 0; j < count; j++) {
+            fputs(j ? ",0" : "0", file);
+        }
+        break;
+    }
+}
+
+/*
+ * Binary output
+ */
+
+/* Make sure the encode buffer can hold the worst case for n bytes */
+static bool ensure_encode_capacity(char **buf, int *cap, int n)
+{
+    int needed = n + n / 128 + 16;
+    if (*cap >= needed) {
+        return true;
+    }
+
+    char *new_buf = (char *)realloc(*buf, needed);
+    if (!new_buf) {
+        return false;
+    }
+
+    *buf = new_buf;
+    *cap = needed;
+    return true;
+}
+
+/*
+ * XOR each value with the one before it, then run-length encode the zeros.
+ * Returns encoded size.
+ */
+static int encode_column(const char *src, int rows, int width, char *dst)
+{
+    int total = rows * width;
+    int out = 0;
+    int i = 0;
+
+    while (i < total) {
+        unsigned char b = (unsigned char)src[i];
+        if (i >= width) {
+            b ^= (unsigned char)src[i - width];
+        }
+
+        if (b == 0) {
+            /* Zero run */
+            int run = 1;
+            while (i + run < total && run < 128) {
+                unsigned char n = (unsigned char)src[i + run];
+                if (i + run >= width) {
+                    n ^= (unsigned char)src[i + run - width];
+                }
+                if (n != 0) break;
+                run++;
+            }
+            dst[out++] = (char)(0x80 | (run - 1));
+            i += run;
+        } else {
+            /* Literal run, stopping at the next pair of zeros */
+            int ctrl = out++;
+            int run = 0;
+            while (i < total && run < 128) {
+                unsigned char n = (unsigned char)src[i];
+                if (i >= width) {
+                    n ^= (unsigned char)src[i - width];
+                }
+                if (n == 0 && i + 1 < total) {
+                    unsigned char next = (unsigned char)src[i + 1];
+                    if (i + 1 >= width) {
+                        next ^= (unsigned char)src[i + 1 - width];
+                    }
+                    if (next == 0) break;
+                }
+                dst[out++] = (char)n;
+                run++;
+                i++;
+            }
+            dst[ctrl] = (char)(run - 1);
+        }
+    }
+
+    return out;
+}
+
+/*
+ * Reverse encode_column. Returns false if the data is malformed.
+ */
+static bool decode_column(const char *src, int size, int rows, int width, char *dst)
+{
+    int total = rows * width;
+    int out = 0;
+    int i = 0;
+
+    while (i < size && out < total) {
+        unsigned char ctrl = (unsigned char)src[i++];
+        int run = (ctrl & 0x7F) + 1;
+
+        if (out + run > total) {
+            return false;
+        }
+
+        if (ctrl & 0x80) {
+            memset(dst + out, 0, run);
+        } else {
+            if (i + run > size) {
+                return false;
             }
+            memcpy(dst + out, src + i, run);
+            i += run;
+        }
+        out += run;
+    }
+
+    if (out != total) {
+        return false;
+    }
+
+    /* Undo the XOR against the previous row */
+    for (int j = width; j < total; j++) {
+        dst[j] ^= dst[j - width];
+    }
+
+    return true;
+}
+
+/* Write the file header and variable schema */
+static bool write_binary_header(telem_logger *logger)
+{
+    telem_bin_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEM_BIN_MAGIC, sizeof(TELEM_BIN_MAGIC));
+    header.version = TELEM_BIN_VERSION;
+    header.var_count = logger->var_count;
+    header.block_rows = TELEM_LOG_BLOCK_ROWS;
+    header.start_time = (int64_t)time(NULL);
+    strncpy(header.session_name, logger->session_name, sizeof(header.session_name) - 1);
+
+    const irsdk_Header *sdk = irsdk_get_header();
+    header.tick_rate = sdk ? sdk->tick_rate : 60;
+
+    if (fwrite(&header, sizeof(header), 1, logger->file) != 1) {
+        return false;
+    }
+
+    for (int i = 0; i < logger->var_count; i++) {
+        const telem_var_info *var = &logger->vars[i];
+        irsdk_VarHeader schema;
+        memset(&schema, 0, sizeof(schema));
+
+        int idx = irsdk_var_name_to_index(var->name);
+        const irsdk_VarHeader *src = irsdk_get_var_header(idx);
+        if (src) {
+            schema = *src;
         } else {
-            if (i > 0) fprintf(logger->file, ",");
-            fprintf(logger->file, "%s", var->name);
+            strncpy(schema.name, var->name, IRSDK_MAX_STRING - 1);
+            schema.type = var->type;
+            schema.count = var->count;
+        }
+        schema.offset = var->packed_offset;
+
+        if (fwrite(&schema, sizeof(schema), 1, logger->file) != 1) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < logger->var_count; i++) {
+        int32_t divider = logger->vars[i].divider;
+        if (fwrite(&divider, sizeof(divider), 1, logger->file) != 1) {
+            return false;
         }
     }
-    fprintf(logger->file, "\n");
 
     return true;
 }
 
+/* Encode and write the buffered block */
+static bool flush_block(telem_logger *logger)
+{
+    if (logger->block_rows == 0) {
+        return true;
+    }
+
+    telem_bin_block block;
+    memset(&block, 0, sizeof(block));
+    block.magic = TELEM_BLOCK_MAGIC;
+    block.rows = logger->block_rows;
+
+    if (fwrite(&block, sizeof(block), 1, logger->file) != 1) {
+        return false;
+    }
+
+    for (int i = 0; i < logger->var_count; i++) {
+        telem_var_info *var = &logger->vars[i];
+        const char *col = logger->block + (size_t)var->packed_offset * TELEM_LOG_BLOCK_ROWS;
+        int raw_size = var->block_count * var->width;
+
+        telem_bin_column column;
+        memset(&column, 0, sizeof(column));
+        column.encoding = TELEM_ENC_RAW;
+        column.rows = var->block_count;
+        column.size = raw_size;
+        var->block_count = 0;
+
+        const char *payload = col;
+        if (logger->compress && raw_size > 0 &&
+            ensure_encode_capacity(&logger->encode_buf, &logger->encode_cap, raw_size)) {
+            int enc_size = encode_column(col, column.rows, var->width, logger->encode_buf);
+            if (enc_size < raw_size) {
+                column.encoding = TELEM_ENC_XOR_RLE;
+                column.size = enc_size;
+                payload = logger->encode_buf;
+            }
+        }
+
+        if (fwrite(&column, sizeof(column), 1, logger->file) != 1) {
+            return false;
+        }
+        if (column.size > 0 && fwrite(payload, column.size, 1, logger->file) != 1) {
+            return false;
+        }
+    }
+
+    logger->block_rows = 0;
+    return true;
+}
+
+/*
+ * Writer thread
+ */
+
+/* Read a ring position written by the other thread */
+static LONG load_position(volatile LONG *pos)
+{
+    return InterlockedCompareExchange(pos, 0, 0);
+}
+
+/* Write one packed row to the file; seq decides which vars it holds */
+static bool write_row(telem_logger *logger, const char *row, unsigned long seq)
+{
+    if (logger->format == TELEM_LOG_FORMAT_BINARY) {
+        /* Scatter each sampled variable into its column */
+        for (int i = 0; i < logger->var_count; i++) {
+            telem_var_info *var = &logger->vars[i];
+            if (seq % var->divider != 0) continue;
+
+            char *col = logger->block + (size_t)var->packed_offset * TELEM_LOG_BLOCK_ROWS;
+            memcpy(col + (size_t)var->block_count * var->width,
+                   row + var->packed_offset, var->width);
+            var->block_count++;
+        }
+
+        logger->block_rows++;
+        if (logger->block_rows == TELEM_LOG_BLOCK_ROWS) {
+            return flush_block(logger);
+        }
+        return true;
+    }
+
+    bool first = true;
+    for (int i = 0; i < logger->var_count; i++) {
+        const telem_var_info *var = &logger->vars[i];
+        if (seq % var->divider == 0) {
+            write_var_values(logger->file, row + var->packed_offset, var, &first);
+        } else {
+            write_var_gap(logger->file, var, &first);
+        }
+    }
+    return fputc('\n', logger->file) != EOF;
+}
+
+/* Drain everything queued so far. Returns number of rows written. */
+static int drain_ring(telem_logger *logger)
+{
+    LONG tail = logger->ring_tail;
+    LONG head = load_position(&logger->ring_head);
+    int written = 0;
+    long long start = stats_now();
+
+    while (tail != head) {
+        const char *row = logger->ring +
+            (size_t)((unsigned long)tail & (logger->ring_slots - 1)) * logger->row_bytes;
+
+        if (!logger->write_failed && !write_row(logger, row, (unsigned long)tail)) {
+            InterlockedExchange(&logger->write_failed, 1);
+        }
+
+        tail++;
+        written++;
+
+        /* Hand slots back in batches so the producer sees space early */
+        if ((written % TELEM_WRITER_BATCH) == 0) {
+            InterlockedExchange(&logger->ring_tail, tail);
+            head = load_position(&logger->ring_head);
+        }
+    }
+
+    InterlockedExchange(&logger->ring_tail, tail);
+
+    if (written > 0) {
+        InterlockedExchangeAdd(&logger->sample_count, written);
+        InterlockedIncrement(&logger->batch_count);
+        stats_span_end(STAT_SPAN_LOG_WRITE, start);
+    }
+
+    return written;
+}
+
+static DWORD WINAPI writer_thread_proc(LPVOID param)
+{
+    telem_logger *logger = (telem_logger *)param;
+
+    while (!load_position(&logger->stop_requested)) {
+        WaitForSingleObject(logger->writer_event, TELEM_WRITER_IDLE_MS);
+        drain_ring(logger);
+    }
+
+    /* Producer has stopped; write whatever is left */
+    drain_ring(logger);
+    if (logger->format == TELEM_LOG_FORMAT_BINARY && !flush_block(logger)) {
+        InterlockedExchange(&logger->write_failed, 1);
+    }
+    fflush(logger->file);
+
+    return 0;
+}
+
+/* Pick a power of two ring size for the current row width */
+static int choose_ring_slots(int row_bytes)
+{
+    int slots = TELEM_RING_MIN;
+    while (slots < TELEM_RING_MAX && (size_t)slots * 2 * row_bytes <= TELEM_RING_BYTES) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+/* Release everything telem_log_start() allocated */
+static void release_buffers(telem_logger *logger)
+{
+    free(logger->block);
+    logger->block = NULL;
+    free(logger->encode_buf);
+    logger->encode_buf = NULL;
+    logger->encode_cap = 0;
+    free(logger->ring);
+    logger->ring = NULL;
+
+    if (logger->writer_event) {
+        CloseHandle(logger->writer_event);
+        logger->writer_event = NULL;
+    }
+}
+
 /*
  * Start logging
  */
@@ -210,20 +932,52 @@ bool telem_log_start(telem_logger *logger)
     generate_filename(logger);
 
     /* Open file */
-    logger->file = fopen(logger->filepath, "w");
+    bool binary = (logger->format == TELEM_LOG_FORMAT_BINARY);
+    logger->file = fopen(logger->filepath, binary ? "wb" : "w");
     if (!logger->file) {
         return false;
     }
+    setvbuf(logger->file, NULL, _IOFBF, TELEM_FILE_BUFFER);
+
+    /* Sample ring and writer wake-up event */
+    logger->ring_slots = choose_ring_slots(logger->row_bytes);
+    logger->ring = (char *)malloc((size_t)logger->ring_slots * logger->row_bytes);
+    logger->writer_event = CreateEventA(NULL, FALSE, FALSE, NULL);
+    logger->ring_head = 0;
+    logger->ring_tail = 0;
+    logger->stop_requested = 0;
+    logger->write_failed = 0;
+    logger->sample_count = 0;
+    logger->batch_count = 0;
+    logger->dropped_count = 0;
+    logger->ring_high_water = 0;
 
     /* Write header */
-    if (!write_header(logger)) {
+    bool ok = logger->ring && logger->writer_event;
+    if (ok && binary) {
+        logger->block = (char *)malloc((size_t)logger->row_bytes * TELEM_LOG_BLOCK_ROWS);
+        logger->block_rows = 0;
+        for (int i = 0; i < logger->var_count; i++) {
+            logger->vars[i].block_count = 0;
+        }
+        ok = logger->block && write_binary_header(logger);
+    } else if (ok) {
+        write_csv_header(logger->file, logger->vars, logger->var_count);
+    }
+
+    if (ok) {
+        logger->writer_thread = CreateThread(NULL, 0, writer_thread_proc, logger, 0, NULL);
+        ok = (logger->writer_thread != NULL);
+    }
+
+    if (!ok) {
         fclose(logger->file);
         logger->file = NULL;
+        release_buffers(logger);
         return false;
     }
 
     logger->active = true;
-    logger->sample_count = 0;
     logger->start_time = 0.0;
 
     return true;
@@ -236,12 +990,23 @@ void telem_log_stop(telem_logger *logger)
 {
     if (!logger) return;
 
+    /* Let the writer drain the ring, then join it */
+    if (logger->writer_thread) {
+        InterlockedExchange(&logger->stop_requested, 1);
+        SetEvent(logger->writer_event);
+        WaitForSingleObject(logger->writer_thread, INFINITE);
+        CloseHandle(logger->writer_thread);
+        logger->writer_thread = NULL;
+    }
+
     if (logger->file) {
         fflush(logger->file);
         fclose(logger->file);
         logger->file = NULL;
     }
 
+    release_buffers(logger);
+
     logger->active = false;
 }
 
@@ -253,76 +1018,48 @@ bool telem_log_is_active(telem_logger *logger)
     return logger && logger->active;
 }
 
-/*
- * Write a value to the CSV
- */
-static void write_value(FILE *file, const char *data, telem_var_info *var, int entry)
-{
-    const char *ptr = data + var->offset;
-
-    switch (var->type) {
-    case IRSDK_TYPE_CHAR:
-        /* String - write as quoted string */
-        fprintf(file, "\"%s\"", ptr);
-        break;
-
-    case IRSDK_TYPE_BOOL:
-        fprintf(file, "%d", ((const bool *)ptr)[entry] ? 1 : 0);
-        break;
-
-    case IRSDK_TYPE_INT:
-    case IRSDK_TYPE_BITFIELD:
-        fprintf(file, "%d", ((const int *)ptr)[entry]);
-        break;
-
-    case IRSDK_TYPE_FLOAT:
-        fprintf(file, "%.6f", ((const float *)ptr)[entry]);
-        break;
-
-    case IRSDK_TYPE_DOUBLE:
-        fprintf(file, "%.9f", ((const double *)ptr)[entry]);
-        break;
-
-    default:
-        fprintf(file, "0");
-        break;
-    }
-}
-
 /*
  * Log a single data sample
  */
 bool telem_log_sample(telem_logger *logger, const char *data)
 {
-    if (!logger || !logger->active || !logger->file || !data) {
+    if (!logger || !logger->active || !data) {
         return false;
     }
 
-    /* Write values */
-    bool first = true;
-    for (int i = 0; i < logger->var_count; i++) {
-        telem_var_info *var = &logger->vars[i];
+    LONG head = logger->ring_head;
+    int used = (int)((unsigned long)head - (unsigned long)load_position(&logger->ring_tail));
 
-        if (var->count > 1 && var->type != IRSDK_TYPE_CHAR) {
-            /* Array variable */
-            for (int j = 0; j < var->count; j++) {
-                if (!first) fprintf(logger->file, ",");
-                first = false;
-                write_value(logger->file, data, var, j);
+    /* Never wait for the writer; drop the sample if the ring is full */
+    if (used >= logger->ring_slots) {
+        logger->dropped_count++;
+        SetEvent(logger->writer_event);
+        return false;
+    }
+
+    /* Pack the variables due this row into the next free slot */
+    char *row = logger->ring +
+        (size_t)((unsigned long)head & (logger->ring_slots - 1)) * logger->row_bytes;
+    for (int i = 0; i < logger->var_count; i++) {
+        const telem_var_info *var = &logger->vars[i];
+        if ((unsigned long)head % var->divider == 0) {
+            char *dst = row + var->packed_offset;
+            memcpy(dst, data + var->offset, var->copy_bytes);
+            if (var->copy_bytes < var->width) {
+                memset(dst + var->copy_bytes, 0, var->width - var->copy_bytes);
             }
-        } else {
-            if (!first) fprintf(logger->file, ",");
-            first = false;
-            write_value(logger->file, data, var, 0);
         }
     }
-    fprintf(logger->file, "\n");
 
-    logger->sample_count++;
+    /* Publish; the interlocked write orders the copy before the new head */
+    InterlockedExchange(&logger->ring_head, head + 1);
 
-    /* Flush periodically */
-    if (logger->sample_count % 100 == 0) {
-        fflush(logger->file);
+    used++;
+    if (used > logger->ring_high_water) {
+        logger->ring_high_water = used;
+    }
+    if (used == TELEM_WRITER_BATCH) {
+        SetEvent(logger->writer_event);
     }
 
     return true;
@@ -341,5 +1078,197 @@ const char *telem_log_get_filepath(const telem_logger *logger)
  */
 int telem_log_get_sample_count(const telem_logger *logger)
 {
-    return logger ? logger->sample_count : 0;
+    return logger ? (int)logger->sample_count : 0;
+}
+
+/*
+ * Get writer and ring statistics
+ */
+void telem_log_get_stats(const telem_logger *logger, telem_log_stats *stats)
+{
+    if (!stats) return;
+
+    memset(stats, 0, sizeof(*stats));
+    if (!logger) return;
+
+    stats->samples_written = (int)logger->sample_count;
+    stats->samples_dropped = logger->dropped_count;
+    stats->samples_queued = (int)((unsigned long)logger->ring_head - (unsigned long)logger->ring_tail);
+    stats->batches_written = (int)logger->batch_count;
+    stats->ring_capacity = logger->ring_slots;
+    stats->ring_high_water = logger->ring_high_water;
+    stats->write_failed = logger->write_failed != 0;
+}
+
+/*
+ * Convert a binary log to CSV
+ */
+bool telem_log_convert_to_csv(const char *binary_path, const char *csv_path)
+{
+    if (!binary_path || !csv_path) {
+        return false;
+    }
+
+    FILE *in = fopen(binary_path, "rb");
+    if (!in) {
+        return false;
+    }
+
+    telem_bin_header header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TELEM_BIN_MAGIC, sizeof(TELEM_BIN_MAGIC)) != 0 ||
+        header.version < 1 || header.version > TELEM_BIN_VERSION ||
+        header.var_count <= 0 || header.var_count > TELEM_CONVERT_MAX_VARS ||
+        header.block_rows <= 0) {
+        fclose(in);
+        return false;
+    }
+
+    /* Rebuild the variable table from the schema */
+    int var_count = header.var_count;
+    int row_bytes = 0;
+    telem_var_info *vars = (telem_var_info *)calloc(var_count, sizeof(telem_var_info));
+    if (!vars) {
+        fclose(in);
+        return false;
+    }
+
+    for (int i = 0; i < var_count; i++) {
+        irsdk_VarHeader schema;
+        if (fread(&schema, sizeof(schema), 1, in) != 1 ||
+            schema.type < 0 || schema.type >= IRSDK_TYPE_COUNT || schema.count <= 0 ||
+            schema.count > (TELEM_CONVERT_MAX_ROW_BYTES - row_bytes) / irsdk_var_type_bytes[schema.type]) {
+            free(vars);
+            fclose(in);
+            return false;
+        }
+
+        telem_var_info *var = &vars[i];
+        memset(var, 0, sizeof(*var));
+        strncpy(var->name, schema.name, IRSDK_MAX_STRING - 1);
+        var->type = schema.type;
+        var->count = schema.count;
+        var->width = irsdk_var_type_bytes[schema.type] * schema.count;
+        var->packed_offset = row_bytes;
+        var->divider = 1;
+        row_bytes += var->width;
+    }
+
+    /* Version 1 logs have no dividers; every var is in every row */
+    if (header.version >= 2) {
+        for (int i = 0; i < var_count; i++) {
+            int32_t divider;
+            if (fread(&divider, sizeof(divider), 1, in) != 1 || divider < 1) {
+                free(vars);
+                fclose(in);
+                return false;
+            }
+            vars[i].divider = divider;
+        }
+    }
+
+    /* Keeps the block buffer, and every column size within it, in int range */
+    if ((long long)row_bytes * header.block_rows > TELEM_CONVERT_MAX_BLOCK_BYTES) {
+        free(vars);
+        fclose(in);
+        return false;
+    }
+
+    char *columns = (char *)malloc((size_t)row_bytes * header.block_rows);
+    char *payload = NULL;
+    int payload_cap = 0;
+
+    FILE *out = columns ? fopen(csv_path, "w") : NULL;
+    if (!out) {
+        free(columns);
+        free(vars);
+        fclose(in);
+        return false;
+    }
+    setvbuf(out, NULL, _IOFBF, TELEM_FILE_BUFFER);
+
+    write_csv_header(out, vars, var_count);
+
+    bool ok = true;
+    telem_bin_block block;
+    unsigned long long base_row = 0;
+
+    while (ok && fread(&block, sizeof(block), 1, in) == 1) {
+        if (block.magic != TELEM_BLOCK_MAGIC || block.rows <= 0 || block.rows > header.block_rows) {
+            ok = false;
+            break;
+        }
+
+        /* Decode every column of the block */
+        for (int i = 0; i < var_count && ok; i++) {
+            telem_var_info *var = &vars[i];
+            char *col = columns + (size_t)var->packed_offset * header.block_rows;
+
+            /* Rows in [base_row, base_row + rows) that are multiples of divider */
+            unsigned long long d = (unsigned long long)var->divider;
+            int expected = (int)((base_row + block.rows + d - 1) / d - (base_row + d - 1) / d);
+            int raw_size = expected * var->width;
+
+            telem_bin_column column;
+            if (fread(&column, sizeof(column), 1, in) != 1 ||
+                column.rows != expected || column.size < 0) {
+                ok = false;
+                break;
+            }
+
+            if (column.encoding == TELEM_ENC_RAW) {
+                ok = (column.size == raw_size) &&
+                     (raw_size == 0 || fread(col, raw_size, 1, in) == 1);
+            } else if (column.encoding == TELEM_ENC_XOR_RLE) {
+                if (column.size > payload_cap) {
+                    char *new_payload = (char *)realloc(payload, column.size);
+                    if (!new_payload) {
+                        ok = false;
+                        break;
+                    }
+                    payload = new_payload;
+                    payload_cap = column.size;
+                }
+                ok = fread(payload, column.size, 1, in) == 1 &&
+                     decode_column(payload, column.size, expected, var->width, col);
+            } else {
+                ok = false;
+            }
+        }
+
+        /* Emit rows, walking each column as its var comes due */
+        for (int i = 0; i < var_count; i++) {
+            vars[i].block_count = 0;
+        }
+
+        for (int row = 0; row < block.rows && ok; row++) {
+            unsigned long long seq = base_row + row;
+            bool first = true;
+            for (int i = 0; i < var_count; i++) {
+                telem_var_info *var = &vars[i];
+                if (seq % (unsigned long long)var->divider != 0) {
+                    write_var_gap(out, var, &first);
+                    continue;
+                }
+
+                const char *col = columns + (size_t)var->packed_offset * header.block_rows;
+                write_var_values(out, col + (size_t)var->block_count * var->width, var, &first);
+                var->block_count++;
+            }
+            fputc('\n', out);
+        }
+
+        base_row += block.rows;
+    }
+
+    free(payload);
+    free(columns);
+    free(vars);
+    fclose(in);
+
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+
+    return ok;
 }
@@ -1,6 +1,6 @@
 /*
  * ira - iRacing Application
- * Telemetry CSV Logger
+ * Telemetry Logger (CSV and binary columnar)
  *
  * Copyright (c) 2026 Christopher Griffiths
  */
@@ -11,8 +11,28 @@
 #include <stdbool.h>
 #include "../irsdk/irsdk.h"
 
-/* Maximum number of variables to log */
-#define TELEM_LOG_MAX_VARS 64
+/* Rows buffered per block in binary logs (10 seconds at 60Hz) */
+#define TELEM_LOG_BLOCK_ROWS 600
+
+/* File extension used for binary logs */
+#define TELEM_LOG_BINARY_EXT ".itl"
+
+/* Output format */
+typedef enum {
+    TELEM_LOG_FORMAT_CSV,       /* One text row per sample */
+    TELEM_LOG_FORMAT_BINARY     /* Schema once, then raw column blocks */
+} telem_log_format;
+
+/* Writer and ring statistics */
+typedef struct {
+    int samples_written;    /* Rows written to the file */
+    int samples_dropped;    /* Rows dropped because the ring was full */
+    int samples_queued;     /* Rows waiting for the writer */
+    int batches_written;    /* Writer wake-ups that wrote something */
+    int ring_capacity;      /* Ring size in rows */
+    int ring_high_water;    /* Most rows ever queued at once */
+    bool write_failed;      /* A file write failed; later rows are discarded */
+} telem_log_stats;
 
 /* Telemetry logger state */
 typedef struct telem_logger telem_logger;
@@ -33,6 +53,22 @@ telem_logger *telem_log_create(const char *output_dir, const char *session_name)
  */
 void telem_log_destroy(telem_logger *logger);
 
+/*
+ * Select the output format. Defaults to CSV.
+ * Must be called before telem_log_start().
+ *
+ * Binary logs store the irsdk_VarHeader of each variable once, then
+ * blocks of TELEM_LOG_BLOCK_ROWS samples laid out column by column, so a
+ * single channel can be read without touching the others.
+ */
+bool telem_log_set_format(telem_logger *logger, telem_log_format format);
+
+/*
+ * Enable or disable per-block compression for binary logs (default on).
+ * Columns that do not shrink are stored raw.
+ */
+void telem_log_set_compression(telem_logger *logger, bool enabled);
+
 /*
  * Add a variable to be logged.
  * Must be called before telem_log_start().
@@ -50,6 +86,44 @@ bool telem_log_add_var(telem_logger *logger, const char *var_name);
  */
 bool telem_log_add_defaults(telem_logger *logger);
 
+/*
+ * Add every variable the sim currently publishes, arrays included.
+ * Must be called before telem_log_start().
+ *
+ * Returns: number of variables added.
+ */
+int telem_log_add_all(telem_logger *logger);
+
+/*
+ * Log matching variables at a lower rate than the tick rate.
+ * Must be called after the variables are added and before telem_log_start().
+ *
+ * Parameters:
+ *   pattern - Variable name, may contain '*' and '?' wildcards
+ *   rate_hz - Samples per second; rounded to a whole divider of the
+ *             tick rate (60Hz sim: 1, 2, 4, 10, 20, 30, 60 are exact)
+ *
+ * Rows where a variable is not sampled have empty CSV cells, and binary
+ * logs store only the samples actually taken.
+ *
+ * Returns: number of variables matched.
+ */
+int telem_log_set_var_rate(telem_logger *logger, const char *pattern, int rate_hz);
+
+/*
+ * Apply the built-in rate table for slow channels: tyre temps and wear
+ * at 1Hz, engine temps and pressures at 1-10Hz, other cars at 10Hz.
+ * Pedals, steering and other driver inputs stay at the full rate.
+ */
+void telem_log_apply_default_rates(telem_logger *logger);
+
+/*
+ * Resolve the variables again after the sim's layout changed. The log
+ * keeps its columns: variables that are gone, or changed type, log as
+ * zeros, and arrays that shrank are padded with zeros.
+ */
+void telem_log_rebind(telem_logger *logger);
+
 /*
  * Start logging. Opens the output file and writes headers.
  *
@@ -71,10 +145,14 @@ bool telem_log_is_active(telem_logger *logger);
  * Log a single data sample.
  * Call this with each telemetry update.
  *
+ * The sample is copied into a ring buffer and written by a background
+ * thread, so this never waits on the disk. If the writer falls so far
+ * behind that the ring is full, the sample is dropped and counted.
+ *
  * Parameters:
  *   data - Telemetry data buffer from irsdk_wait_for_data()
  *
- * Returns: true if logged successfully.
+ * Returns: true if the sample was queued, false if dropped.
  */
 bool telem_log_sample(telem_logger *logger, const char *data);
 
@@ -84,8 +162,24 @@ bool telem_log_sample(telem_logger *logger, const char *data);
 const char *telem_log_get_filepath(const telem_logger *logger);
 
 /*
- * Get the number of samples logged.
+ * Get the number of samples written to the file.
  */
 int telem_log_get_sample_count(const telem_logger *logger);
 
+/*
+ * Get writer and ring statistics.
+ */
+void telem_log_get_stats(const telem_logger *logger, telem_log_stats *stats);
+
+/*
+ * Convert a binary log to the CSV layout telem_log_start() writes.
+ *
+ * Parameters:
+ *   binary_path - Binary log written with TELEM_LOG_FORMAT_BINARY
+ *   csv_path - CSV file to create
+ *
+ * Returns: true if the whole file was converted.
+ */
+bool telem_log_convert_to_csv(const char *binary_path, const char *csv_path);
+
 #endif /* IRA_TELEMETRY_LOG_H */
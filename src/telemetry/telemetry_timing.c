@@ -0,0 +1,206 @@
+/*
+ * ira - iRacing Application
+ * Telemetry Timing Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry_timing.h"
+
+#pragma comment(lib, "winmm")
+
+/* Bucket upper limits in microseconds, the last one open ended */
+static const int bucket_limits[TELEM_TIMING_BUCKETS] = {
+    50, 100, 250, 500, 1000, 2000, 4000, 8000, TELEM_TIMING_FRAME_US, 33333, -1
+};
+
+struct telem_timing {
+    telem_timing_config cfg;
+    bool period_set;
+    int old_priority;
+    DWORD_PTR old_affinity;     /* 0 = not changed */
+
+    double us_per_count;
+    LARGE_INTEGER tick_start;
+    bool in_tick;
+    int last_tick;              /* SDK tick of the last pickup, -1 = none */
+
+    int ticks;
+    int missed;
+    int late;
+    double total_us;
+    double max_us;
+    int buckets[TELEM_TIMING_BUCKETS];
+};
+
+/*
+ * Lifecycle
+ */
+
+telem_timing *telem_timing_create(const telem_timing_config *cfg)
+{
+    telem_timing *timing = (telem_timing *)calloc(1, sizeof(telem_timing));
+    if (!timing) {
+        return NULL;
+    }
+
+    if (cfg) {
+        timing->cfg = *cfg;
+    } else {
+        timing->cfg.cpu = -1;
+    }
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    timing->us_per_count = 1000000.0 / (double)freq.QuadPart;
+    timing->last_tick = -1;
+
+    /* Wait timeouts and Sleep() round to the timer period, 15.6ms by default */
+    if (timing->cfg.low_latency) {
+        timing->period_set = (timeBeginPeriod(1) == TIMERR_NOERROR);
+        if (!timing->period_set) {
+            printf("Warning: Could not raise the timer resolution\n");
+        }
+    }
+
+    HANDLE thread = GetCurrentThread();
+    timing->old_priority = GetThreadPriority(thread);
+    if (timing->cfg.high_priority && !SetThreadPriority(thread, THREAD_PRIORITY_HIGHEST)) {
+        printf("Warning: Could not raise the telemetry thread priority\n");
+    }
+
+    if (timing->cfg.cpu >= 0) {
+        DWORD_PTR mask = (DWORD_PTR)1 << timing->cfg.cpu;
+        if (timing->cfg.cpu >= (int)(sizeof(DWORD_PTR) * 8) ||
+            !(timing->old_affinity = SetThreadAffinityMask(thread, mask))) {
+            printf("Warning: Could not pin the telemetry thread to CPU %d\n", timing->cfg.cpu);
+            timing->old_affinity = 0;
+        }
+    }
+
+    return timing;
+}
+
+void telem_timing_destroy(telem_timing *timing)
+{
+    if (!timing) {
+        return;
+    }
+
+    HANDLE thread = GetCurrentThread();
+    if (timing->old_affinity) {
+        SetThreadAffinityMask(thread, timing->old_affinity);
+    }
+    if (timing->cfg.high_priority) {
+        SetThreadPriority(thread, timing->old_priority);
+    }
+    if (timing->period_set) {
+        timeEndPeriod(1);
+    }
+
+    free(timing);
+}
+
+/*
+ * Measurement
+ */
+
+void telem_timing_tick_begin(telem_timing *timing, int tick_count)
+{
+    if (!timing) {
+        return;
+    }
+
+    QueryPerformanceCounter(&timing->tick_start);
+    timing->in_tick = true;
+
+    /* Ticks skipped since the last pickup; a lower tick is a new session */
+    if (timing->last_tick >= 0 && tick_count > timing->last_tick + 1) {
+        timing->missed += tick_count - timing->last_tick - 1;
+    }
+    timing->last_tick = tick_count;
+}
+
+void telem_timing_tick_end(telem_timing *timing)
+{
+    if (!timing || !timing->in_tick) {
+        return;
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    timing->in_tick = false;
+
+    double us = (double)(now.QuadPart - timing->tick_start.QuadPart) * timing->us_per_count;
+
+    int bucket = 0;
+    while (bucket < TELEM_TIMING_BUCKETS - 1 && us > bucket_limits[bucket]) {
+        bucket++;
+    }
+    timing->buckets[bucket]++;
+
+    timing->ticks++;
+    timing->total_us += us;
+    if (us > timing->max_us) {
+        timing->max_us = us;
+    }
+    if (us > TELEM_TIMING_FRAME_US) {
+        timing->late++;
+    }
+}
+
+/*
+ * Helper: Upper limit of the bucket holding the given fraction of ticks
+ */
+static int percentile_limit(const telem_timing *timing, double fraction)
+{
+    int target = (int)(timing->ticks * fraction);
+    int seen = 0;
+
+    for (int i = 0; i < TELEM_TIMING_BUCKETS; i++) {
+        seen += timing->buckets[i];
+        if (seen > target) {
+            return bucket_limits[i];
+        }
+    }
+    return -1;
+}
+
+void telem_timing_get_stats(const telem_timing *timing, telem_timing_stats *stats)
+{
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (!timing) {
+        return;
+    }
+
+    stats->ticks = timing->ticks;
+    stats->missed_ticks = timing->missed;
+    stats->late_ticks = timing->late;
+    stats->max_us = timing->max_us;
+    memcpy(stats->buckets, timing->buckets, sizeof(stats->buckets));
+
+    if (timing->ticks > 0) {
+        stats->mean_us = timing->total_us / timing->ticks;
+        stats->p50_us = percentile_limit(timing, 0.50);
+        stats->p99_us = percentile_limit(timing, 0.99);
+    }
+}
+
+int telem_timing_bucket_limit_us(int bucket)
+{
+    if (bucket < 0 || bucket >= TELEM_TIMING_BUCKETS) {
+        return -1;
+    }
+    return bucket_limits[bucket];
+}
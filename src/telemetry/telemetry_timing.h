@@ -0,0 +1,65 @@
+/*
+ * ira - iRacing Application
+ * Telemetry Timing - timer resolution, thread placement and tick latency
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_TELEMETRY_TIMING_H
+#define IRA_TELEMETRY_TIMING_H
+
+#include <stdbool.h>
+
+/* Latency histogram buckets, see telem_timing_bucket_limit_us() */
+#define TELEM_TIMING_BUCKETS    11
+
+/* One sim frame at 60Hz in microseconds */
+#define TELEM_TIMING_FRAME_US   16667
+
+/* Timing settings, applied to the calling thread */
+typedef struct {
+    bool low_latency;           /* 1ms system timer resolution while active */
+    bool high_priority;         /* THREAD_PRIORITY_HIGHEST */
+    int cpu;                    /* Pin to this CPU, -1 = any */
+} telem_timing_config;
+
+/*
+ * Per-tick latency: from picking up an SDK tick to the end of our
+ * processing of it, in microseconds.
+ */
+typedef struct {
+    int ticks;                  /* Ticks measured */
+    int missed_ticks;           /* SDK ticks never picked up */
+    int late_ticks;             /* Ticks that took longer than a frame */
+    double mean_us;
+    double max_us;
+    int p50_us;                 /* Upper limit of the bucket holding the median */
+    int p99_us;
+    int buckets[TELEM_TIMING_BUCKETS];
+} telem_timing_stats;
+
+typedef struct telem_timing telem_timing;
+
+/*
+ * Apply the settings to the calling thread and start measuring.
+ * Settings the system refuses are skipped with a warning.
+ * Returns NULL on allocation failure.
+ */
+telem_timing *telem_timing_create(const telem_timing_config *cfg);
+
+/* Restore the timer resolution and thread settings, then free */
+void telem_timing_destroy(telem_timing *timing);
+
+/* Mark an SDK tick as picked up; call as soon as the data arrives */
+void telem_timing_tick_begin(telem_timing *timing, int tick_count);
+
+/* Mark the picked up tick as fully processed */
+void telem_timing_tick_end(telem_timing *timing);
+
+/* Get the latency statistics so far */
+void telem_timing_get_stats(const telem_timing *timing, telem_timing_stats *stats);
+
+/* Upper limit of a histogram bucket in microseconds; the last is unbounded (-1) */
+int telem_timing_bucket_limit_us(int bucket);
+
+#endif /* IRA_TELEMETRY_TIMING_H */
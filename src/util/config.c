@@ -67,6 +67,12 @@ void config_init_defaults(ira_config *cfg)
     cfg->telemetry_logging_enabled = false;
     cfg->telemetry_log_interval_ms = 100; /* 10 Hz */
     strncpy(cfg->telemetry_log_path, g_data_path, sizeof(cfg->telemetry_log_path) - 1);
+    cfg->telemetry_log_binary = false;
+    cfg->telemetry_log_all_vars = false;
+    cfg->telemetry_hub_enabled = false;
+    cfg->telemetry_low_latency = false;
+    cfg->telemetry_high_priority = false;
+    cfg->telemetry_cpu = -1;
 
     cfg->use_metric_units = true;
     cfg->refresh_rate_hz = 60;
@@ -176,6 +182,48 @@ bool config_load(ira_config *cfg, const char *filename)
             strncpy(cfg->telemetry_log_path, json_get_string(val),
                     sizeof(cfg->telemetry_log_path) - 1);
         }
+
+        val = json_object_get(telemetry, "log_format");
+        if (val && json_get_type(val) == JSON_STRING) {
+            cfg->telemetry_log_binary = (strcmp(json_get_string(val), "binary") == 0);
+        }
+
+        val = json_object_get(telemetry, "log_all_vars");
+        if (val && json_get_type(val) == JSON_BOOL) {
+            cfg->telemetry_log_all_vars = json_get_bool(val);
+        }
+
+        val = json_object_get(telemetry, "hub_enabled");
+        if (val && json_get_type(val) == JSON_BOOL) {
+            cfg->telemetry_hub_enabled = json_get_bool(val);
+        }
+
+        val = json_object_get(telemetry, "hub_udp");
+        if (val && json_get_type(val) == JSON_STRING) {
+            strncpy(cfg->telemetry_hub_udp, json_get_string(val),
+                    sizeof(cfg->telemetry_hub_udp) - 1);
+        }
+
+        val = json_object_get(telemetry, "hub_vars");
+        if (val && json_get_type(val) == JSON_STRING) {
+            strncpy(cfg->telemetry_hub_vars, json_get_string(val),
+                    sizeof(cfg->telemetry_hub_vars) - 1);
+        }
+
+        val = json_object_get(telemetry, "low_latency");
+        if (val && json_get_type(val) == JSON_BOOL) {
+            cfg->telemetry_low_latency = json_get_bool(val);
+        }
+
+        val = json_object_get(telemetry, "high_priority");
+        if (val && json_get_type(val) == JSON_BOOL) {
+            cfg->telemetry_high_priority = json_get_bool(val);
+        }
+
+        val = json_object_get(telemetry, "cpu");
+        if (val && json_get_type(val) == JSON_NUMBER) {
+            cfg->telemetry_cpu = json_get_int(val);
+        }
     }
 
     /* Read display settings */
@@ -217,6 +265,24 @@ bool config_load(ira_config *cfg, const char *filename)
         }
     }
 
+    /* Read API settings */
+    json_value *api = json_object_get(root, "api");
+    if (api && json_get_type(api) == JSON_OBJECT) {
+        json_value *val;
+
+        val = json_object_get(api, "client_id");
+        if (val && json_get_type(val) == JSON_STRING) {
+            strncpy(cfg->api_client_id, json_get_string(val),
+                    sizeof(cfg->api_client_id) - 1);
+        }
+
+        val = json_object_get(api, "client_secret");
+        if (val && json_get_type(val) == JSON_STRING) {
+            strncpy(cfg->api_client_secret, json_get_string(val),
+                    sizeof(cfg->api_client_secret) - 1);
+        }
+    }
+
     json_free(root);
     return true;
 }
@@ -254,6 +320,22 @@ bool config_save(const ira_config *cfg, const char *filename)
                        json_new_number(cfg->telemetry_log_interval_ms));
         json_object_set(telemetry, "log_path",
                        json_new_string(cfg->telemetry_log_path));
+        json_object_set(telemetry, "log_format",
+                       json_new_string(cfg->telemetry_log_binary ? "binary" : "csv"));
+        json_object_set(telemetry, "log_all_vars",
+                       json_new_bool(cfg->telemetry_log_all_vars));
+        json_object_set(telemetry, "hub_enabled",
+                       json_new_bool(cfg->telemetry_hub_enabled));
+        json_object_set(telemetry, "hub_udp",
+                       json_new_string(cfg->telemetry_hub_udp));
+        json_object_set(telemetry, "hub_vars",
+                       json_new_string(cfg->telemetry_hub_vars));
+        json_object_set(telemetry, "low_latency",
+                       json_new_bool(cfg->telemetry_low_latency));
+        json_object_set(telemetry, "high_priority",
+                       json_new_bool(cfg->telemetry_high_priority));
+        json_object_set(telemetry, "cpu",
+                       json_new_number(cfg->telemetry_cpu));
         json_object_set(root, "telemetry", telemetry);
     }
 
@@ -283,6 +365,18 @@ bool config_save(const ira_config *cfg, const char *filename)
         json_object_set(root, "launcher", launcher);
     }
 
+    /* API settings */
+    json_value *api = json_new_object();
+    if (api) {
+        json_object_set(api, "client_id",
+                       json_new_string(cfg->api_client_id));
+        if (cfg->api_client_secret[0]) {
+            json_object_set(api, "client_secret",
+                           json_new_string(cfg->api_client_secret));
+        }
+        json_object_set(root, "api", api);
+    }
+
     /* Write to file */
     bool result = json_write_file(root, filename, true);
     json_free(root);
@@ -23,6 +23,18 @@ typedef struct {
     bool telemetry_logging_enabled;
     int telemetry_log_interval_ms;
     char telemetry_log_path[260];
+    bool telemetry_log_binary;      /* Binary columnar logs instead of CSV */
+    bool telemetry_log_all_vars;    /* Log every var, slow channels decimated */
+
+    /* Telemetry hub settings */
+    bool telemetry_hub_enabled;     /* Republish to overlays and dashboards */
+    char telemetry_hub_udp[128];    /* "host[:port]" of a remote dashboard, empty = none */
+    char telemetry_hub_vars[512];   /* Comma separated, empty = default set */
+
+    /* Telemetry loop timing */
+    bool telemetry_low_latency;     /* 1ms timer resolution for the telemetry loop */
+    bool telemetry_high_priority;   /* Raise the telemetry thread's priority */
+    int telemetry_cpu;              /* Pin the telemetry thread to this CPU, -1 = any */
 
     /* Display settings */
     bool use_metric_units;
@@ -33,6 +45,10 @@ typedef struct {
 
     /* Launcher settings */
     car_switch_mode car_switch_behavior;
+
+    /* iRacing API settings */
+    char api_client_id[128];        /* OAuth client id, empty = sync disabled */
+    char api_client_secret[128];    /* Only for confidential clients */
 } ira_config;
 
 /*
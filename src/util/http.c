@@ -14,11 +14,25 @@
 #include <winhttp.h>
 
 #include "http.h"
+#include "stats.h"
 
 #define DEFAULT_TIMEOUT_MS 30000
 #define DEFAULT_USER_AGENT L"Mozilla/5.0 (Windows NT 10.0; Win64; x64) ira/0.1"
 #define INITIAL_BUFFER_SIZE 4096
+#define STREAM_CHUNK_SIZE (64 * 1024)
 #define MAX_ERROR_MSG 256
+#define MAX_CACHED_CONNECTIONS 8
+#define MAX_BATCH_THREADS 8
+
+/*
+ * Cached connection to one host. WinHTTP keeps the underlying sockets
+ * alive per connect handle, so reusing it skips the TCP and TLS handshake.
+ */
+typedef struct {
+    wchar_t *host;
+    INTERNET_PORT port;
+    HINTERNET connect;
+} http_connection;
 
 /*
  * HTTP Session structure
@@ -28,8 +42,25 @@ struct http_session {
     int timeout_ms;
     wchar_t *user_agent;
     char last_error[MAX_ERROR_MSG];
+
+    /* Per-host connection cache, shared by batch worker threads */
+    CRITICAL_SECTION lock;
+    http_connection connections[MAX_CACHED_CONNECTIONS];
+    int connection_count;
 };
 
+/* Options for a single request */
+typedef struct {
+    const char *method;
+    const char *body;
+    const wchar_t *content_type;
+    const char *bearer_token;   /* Adds an Authorization header */
+    const char *etag;           /* Adds If-None-Match */
+    const char *last_modified;  /* Adds If-Modified-Since */
+    http_chunk_fn sink;         /* Streams a 2xx body instead of buffering it */
+    void *user;
+} request_options;
+
 /*
  * Helper: Convert UTF-8 to wide string
  */
@@ -47,27 +78,44 @@ static wchar_t *utf8_to_wide(const char *str)
     return wide;
 }
 
+/*
+ * Helper: Convert wide string to UTF-8
+ */
+static char *wide_to_utf8(const wchar_t *str)
+{
+    if (!str) return NULL;
+
+    int len = WideCharToMultiByte(CP_UTF8, 0, str, -1, NULL, 0, NULL, NULL);
+    if (len <= 0) return NULL;
+
+    char *utf8 = malloc(len);
+    if (!utf8) return NULL;
+
+    WideCharToMultiByte(CP_UTF8, 0, str, -1, utf8, len, NULL, NULL);
+    return utf8;
+}
+
 /*
  * Helper: Set error message
  */
-static void set_error(http_session *session, const char *msg)
+static void set_error(char *error, const char *msg)
 {
-    if (session && msg) {
-        strncpy(session->last_error, msg, MAX_ERROR_MSG - 1);
-        session->last_error[MAX_ERROR_MSG - 1] = '\0';
+    if (error && msg) {
+        strncpy(error, msg, MAX_ERROR_MSG - 1);
+        error[MAX_ERROR_MSG - 1] = '\0';
     }
 }
 
 /*
  * Helper: Set Windows error message
  */
-static void set_win_error(http_session *session, const char *prefix, DWORD err)
+static void set_win_error(char *error, const char *prefix, DWORD err)
 {
-    if (!session) return;
+    if (!error) return;
 
     char msg[MAX_ERROR_MSG];
     snprintf(msg, sizeof(msg), "%s: error %lu", prefix, (unsigned long)err);
-    set_error(session, msg);
+    set_error(error, msg);
 }
 
 /*
@@ -147,12 +195,45 @@ static void parse_rate_limit_headers(HINTERNET request, http_response *resp)
     }
 }
 
+/*
+ * Helper: Read a response header as UTF-8. Returns NULL if absent.
+ */
+static char *query_header(HINTERNET request, DWORD info_level)
+{
+    wchar_t buffer[256];
+    DWORD size = sizeof(buffer);
+
+    if (!WinHttpQueryHeaders(request, info_level, WINHTTP_HEADER_NAME_BY_INDEX,
+                             buffer, &size, WINHTTP_NO_HEADER_INDEX)) {
+        return NULL;
+    }
+    return wide_to_utf8(buffer);
+}
+
+/*
+ * Helper: Add a "Name: value" request header with a UTF-8 value
+ */
+static void add_header(HINTERNET request, const wchar_t *name, const char *value)
+{
+    size_t header_len = wcslen(name) + strlen(value) + 3;  /* ": " + null */
+    wchar_t *header = malloc(header_len * sizeof(wchar_t));
+    if (header) {
+        swprintf(header, header_len, L"%s: %hs", name, value);
+        WinHttpAddRequestHeaders(request, header, (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
+        free(header);
+    }
+}
+
 /*
  * Helper: Read response body
+ *
+ * With a sink, the body is handed over in chunks as it arrives and is never
+ * buffered whole; resp->body stays NULL.
  */
-static bool read_response_body(HINTERNET request, http_response *resp)
+static bool read_response_body(HINTERNET request, http_response *resp,
+                               http_chunk_fn sink, void *user)
 {
-    size_t capacity = INITIAL_BUFFER_SIZE;
+    size_t capacity = sink ? STREAM_CHUNK_SIZE : INITIAL_BUFFER_SIZE;
     size_t len = 0;
     char *buffer = malloc(capacity);
 
@@ -162,6 +243,19 @@ static bool read_response_body(HINTERNET request, http_response *resp)
     DWORD bytes_read;
 
     while (WinHttpQueryDataAvailable(request, &bytes_available) && bytes_available > 0) {
+        if (sink) {
+            if (bytes_available > capacity) bytes_available = (DWORD)capacity;
+
+            if (!WinHttpReadData(request, buffer, bytes_available, &bytes_read) ||
+                !sink(user, buffer, bytes_read)) {
+                free(buffer);
+                return false;
+            }
+
+            resp->body_len += bytes_read;
+            continue;
+        }
+
         /* Expand buffer if needed */
         if (len + bytes_available + 1 > capacity) {
             capacity = (len + bytes_available + 1) * 2;
@@ -181,6 +275,11 @@ static bool read_response_body(HINTERNET request, http_response *resp)
         len += bytes_read;
     }
 
+    if (sink) {
+        free(buffer);
+        return true;
+    }
+
     /* Null-terminate for convenience */
     buffer[len] = '\0';
 
@@ -216,7 +315,7 @@ http_session *http_session_create(void)
     );
 
     if (!session->session) {
-        set_win_error(session, "WinHttpOpen failed", GetLastError());
+        set_win_error(session->last_error, "WinHttpOpen failed", GetLastError());
         free(session->user_agent);
         free(session);
         return NULL;
@@ -227,6 +326,14 @@ http_session *http_session_create(void)
     WinHttpSetOption(session->session, WINHTTP_OPTION_REDIRECT_POLICY,
                      &option, sizeof(option));
 
+    /* Ask for gzip/deflate bodies; WinHTTP decodes them transparently.
+     * Unsupported before Windows 8.1, where bodies simply stay identity. */
+    DWORD decompression = WINHTTP_DECOMPRESSION_FLAG_ALL;
+    WinHttpSetOption(session->session, WINHTTP_OPTION_DECOMPRESSION,
+                     &decompression, sizeof(decompression));
+
+    InitializeCriticalSection(&session->lock);
+
     return session;
 }
 
@@ -234,6 +341,12 @@ void http_session_destroy(http_session *session)
 {
     if (!session) return;
 
+    for (int i = 0; i < session->connection_count; i++) {
+        WinHttpCloseHandle(session->connections[i].connect);
+        free(session->connections[i].host);
+    }
+    DeleteCriticalSection(&session->lock);
+
     if (session->session) {
         WinHttpCloseHandle(session->session);
     }
@@ -263,21 +376,64 @@ void http_session_set_user_agent(http_session *session, const char *user_agent)
     }
 }
 
+/*
+ * Helper: Get a connect handle for a host, reusing a cached one.
+ * Sets *cached to false when the cache is full and the caller must close
+ * the handle itself.
+ */
+static HINTERNET get_connection(http_session *session, const url_parts *parts, bool *cached)
+{
+    HINTERNET connect = NULL;
+    *cached = true;
+
+    EnterCriticalSection(&session->lock);
+
+    for (int i = 0; i < session->connection_count; i++) {
+        http_connection *conn = &session->connections[i];
+        if (conn->port == parts->port && _wcsicmp(conn->host, parts->host) == 0) {
+            connect = conn->connect;
+            break;
+        }
+    }
+
+    if (!connect) {
+        connect = WinHttpConnect(session->session, parts->host, parts->port, 0);
+        if (connect) {
+            wchar_t *host = session->connection_count < MAX_CACHED_CONNECTIONS ?
+                            _wcsdup(parts->host) : NULL;
+            if (host) {
+                http_connection *conn = &session->connections[session->connection_count++];
+                conn->host = host;
+                conn->port = parts->port;
+                conn->connect = connect;
+            } else {
+                *cached = false;
+            }
+        }
+    }
+
+    LeaveCriticalSection(&session->lock);
+    return connect;
+}
+
 /*
  * Helper: Send request and get response
+ *
+ * Errors are written to error (MAX_ERROR_MSG bytes), which lets batch
+ * workers report per request without touching the session.
  */
 static http_response *send_request(http_session *session, const char *url,
-                                   const char *method, const char *body,
-                                   const wchar_t *content_type)
+                                   const request_options *opts, char *error)
 {
     if (!session || !url) return NULL;
 
-    session->last_error[0] = '\0';
+    error[0] = '\0';
+    long long start = stats_now();
 
     /* Parse URL */
     url_parts parts;
     if (!parse_url(url, &parts)) {
-        set_error(session, "Failed to parse URL");
+        set_error(error, "Failed to parse URL");
         return NULL;
     }
 
@@ -285,16 +441,17 @@ static http_response *send_request(http_session *session, const char *url,
     http_response *resp = NULL;
     HINTERNET connect = NULL;
     HINTERNET request = NULL;
+    bool connect_cached = true;
 
     /* Connect to host */
-    connect = WinHttpConnect(session->session, parts.host, parts.port, 0);
+    connect = get_connection(session, &parts, &connect_cached);
     if (!connect) {
-        set_win_error(session, "WinHttpConnect failed", GetLastError());
+        set_win_error(error, "WinHttpConnect failed", GetLastError());
         goto cleanup;
     }
 
     /* Create request */
-    wchar_t *wide_method = utf8_to_wide(method);
+    wchar_t *wide_method = utf8_to_wide(opts->method);
     DWORD flags = parts.secure ? WINHTTP_FLAG_SECURE : 0;
 
     request = WinHttpOpenRequest(
@@ -309,7 +466,7 @@ static http_response *send_request(http_session *session, const char *url,
     free(wide_method);
 
     if (!request) {
-        set_win_error(session, "WinHttpOpenRequest failed", GetLastError());
+        set_win_error(error, "WinHttpOpenRequest failed", GetLastError());
         goto cleanup;
     }
 
@@ -319,39 +476,55 @@ static http_response *send_request(http_session *session, const char *url,
     WinHttpSetOption(request, WINHTTP_OPTION_SEND_TIMEOUT, &timeout, sizeof(timeout));
     WinHttpSetOption(request, WINHTTP_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
 
+    /* Add Authorization header */
+    if (opts->bearer_token) {
+        size_t token_len = strlen(opts->bearer_token);
+        size_t header_len = token_len + 30;  /* "Authorization: Bearer " + token + null */
+        wchar_t *auth_header = malloc(header_len * sizeof(wchar_t));
+        if (auth_header) {
+            swprintf(auth_header, header_len, L"Authorization: Bearer %hs", opts->bearer_token);
+            WinHttpAddRequestHeaders(request, auth_header, (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
+            free(auth_header);
+        }
+    }
+
     /* Add required headers */
     WinHttpAddRequestHeaders(request, L"Accept: application/json", (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
 
+    /* Add conditional headers */
+    if (opts->etag) add_header(request, L"If-None-Match", opts->etag);
+    if (opts->last_modified) add_header(request, L"If-Modified-Since", opts->last_modified);
+
     /* Add Content-Type header if specified */
-    if (content_type) {
-        size_t ct_len = wcslen(content_type);
+    if (opts->content_type) {
+        size_t ct_len = wcslen(opts->content_type);
         size_t header_len = ct_len + 20;  /* "Content-Type: " + content_type + null */
         wchar_t *header = malloc(header_len * sizeof(wchar_t));
         if (header) {
-            swprintf(header, header_len, L"Content-Type: %s", content_type);
+            swprintf(header, header_len, L"Content-Type: %s", opts->content_type);
             WinHttpAddRequestHeaders(request, header, (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
             free(header);
         }
     }
 
     /* Send request */
-    DWORD body_len = body ? (DWORD)strlen(body) : 0;
+    DWORD body_len = opts->body ? (DWORD)strlen(opts->body) : 0;
     if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                            (LPVOID)body, body_len, body_len, 0)) {
-        set_win_error(session, "WinHttpSendRequest failed", GetLastError());
+                            (LPVOID)opts->body, body_len, body_len, 0)) {
+        set_win_error(error, "WinHttpSendRequest failed", GetLastError());
         goto cleanup;
     }
 
     /* Receive response */
     if (!WinHttpReceiveResponse(request, NULL)) {
-        set_win_error(session, "WinHttpReceiveResponse failed", GetLastError());
+        set_win_error(error, "WinHttpReceiveResponse failed", GetLastError());
         goto cleanup;
     }
 
     /* Allocate response */
     resp = calloc(1, sizeof(http_response));
     if (!resp) {
-        set_error(session, "Memory allocation failed");
+        set_error(error, "Memory allocation failed");
         goto cleanup;
     }
 
@@ -366,10 +539,14 @@ static http_response *send_request(http_session *session, const char *url,
     /* Parse rate limit headers */
     parse_rate_limit_headers(request, resp);
 
+    /* Keep validators for conditional requests */
+    resp->etag = query_header(request, WINHTTP_QUERY_ETAG);
+    resp->last_modified = query_header(request, WINHTTP_QUERY_LAST_MODIFIED);
 
-    /* Read body */
-    if (!read_response_body(request, resp)) {
-        set_error(session, "Failed to read response body");
+    /* Read body; error responses are always buffered for the caller */
+    http_chunk_fn sink = http_response_ok(resp) ? opts->sink : NULL;
+    if (!read_response_body(request, resp, sink, opts->user)) {
+        set_error(error, "Failed to read response body");
         http_response_free(resp);
         resp = NULL;
         goto cleanup;
@@ -377,9 +554,11 @@ static http_response *send_request(http_session *session, const char *url,
 
 cleanup:
     if (request) WinHttpCloseHandle(request);
-    if (connect) WinHttpCloseHandle(connect);
+    if (connect && !connect_cached) WinHttpCloseHandle(connect);
     free_url_parts(&parts);
 
+    stats_http(url, start, resp ? (long long)resp->body_len : 0, resp != NULL);
+
     return resp;
 }
 
@@ -389,129 +568,115 @@ cleanup:
 
 http_response *http_post_json(http_session *session, const char *url, const char *json_body)
 {
-    return send_request(session, url, "POST", json_body, L"application/json");
+    if (!session) return NULL;
+    request_options opts = { "POST", json_body, L"application/json", NULL, NULL, NULL, NULL, NULL };
+    return send_request(session, url, &opts, session->last_error);
 }
 
 http_response *http_post_form(http_session *session, const char *url, const char *form_body)
 {
-    return send_request(session, url, "POST", form_body, L"application/x-www-form-urlencoded");
+    if (!session) return NULL;
+    request_options opts = { "POST", form_body, L"application/x-www-form-urlencoded", NULL, NULL, NULL, NULL, NULL };
+    return send_request(session, url, &opts, session->last_error);
 }
 
 http_response *http_get(http_session *session, const char *url)
 {
-    return send_request(session, url, "GET", NULL, NULL);
+    return http_get_with_token(session, url, NULL);
 }
 
 http_response *http_get_with_token(http_session *session, const char *url, const char *bearer_token)
 {
-    if (!session || !url) return NULL;
+    if (!session) return NULL;
+    request_options opts = { "GET", NULL, NULL, bearer_token, NULL, NULL, NULL, NULL };
+    return send_request(session, url, &opts, session->last_error);
+}
 
-    session->last_error[0] = '\0';
-
-    /* Parse URL */
-    url_parts parts;
-    if (!parse_url(url, &parts)) {
-        set_error(session, "Failed to parse URL");
-        return NULL;
-    }
 
+http_response *http_get_conditional(http_session *session, const char *url,
+                                    const char *bearer_token,
+                                    const char *etag, const char *last_modified)
+{
+    if (!session) return NULL;
+    request_options opts = { "GET", NULL, NULL, bearer_token, etag, last_modified, NULL, NULL };
+    return send_request(session, url, &opts, session->last_error);
+}
 
-    http_response *resp = NULL;
-    HINTERNET connect = NULL;
-    HINTERNET request = NULL;
+http_response *http_get_stream(http_session *session, const char *url, const char *bearer_token,
+                               const char *etag, const char *last_modified,
+                               http_chunk_fn sink, void *user)
+{
+    if (!session || !sink) return NULL;
+    request_options opts = { "GET", NULL, NULL, bearer_token, etag, last_modified, sink, user };
+    return send_request(session, url, &opts, session->last_error);
+}
 
-    /* Connect to host */
-    connect = WinHttpConnect(session->session, parts.host, parts.port, 0);
-    if (!connect) {
-        set_win_error(session, "WinHttpConnect failed", GetLastError());
-        goto cleanup;
-    }
+/*
+ * Batch Requests
+ */
 
-    /* Create request */
-    DWORD flags = parts.secure ? WINHTTP_FLAG_SECURE : 0;
+typedef struct {
+    http_session *session;
+    http_batch_item *items;
+    int count;
+    volatile LONG next;         /* Next unclaimed item */
+} batch_context;
 
-    request = WinHttpOpenRequest(
-        connect,
-        L"GET",
-        parts.path,
-        NULL,
-        WINHTTP_NO_REFERER,
-        WINHTTP_DEFAULT_ACCEPT_TYPES,
-        flags
-    );
+static DWORD WINAPI batch_worker(LPVOID param)
+{
+    batch_context *ctx = (batch_context *)param;
 
-    if (!request) {
-        set_win_error(session, "WinHttpOpenRequest failed", GetLastError());
-        goto cleanup;
-    }
+    for (;;) {
+        LONG index = InterlockedIncrement(&ctx->next) - 1;
+        if (index >= ctx->count) break;
 
-    /* Set timeouts */
-    int timeout = session->timeout_ms;
-    WinHttpSetOption(request, WINHTTP_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
-    WinHttpSetOption(request, WINHTTP_OPTION_SEND_TIMEOUT, &timeout, sizeof(timeout));
-    WinHttpSetOption(request, WINHTTP_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
+        http_batch_item *item = &ctx->items[index];
+        if (!item->url) continue;
 
-    /* Add Authorization header */
-    if (bearer_token) {
-        size_t token_len = strlen(bearer_token);
-        size_t header_len = token_len + 30;  /* "Authorization: Bearer " + token + null */
-        wchar_t *auth_header = malloc(header_len * sizeof(wchar_t));
-        if (auth_header) {
-            swprintf(auth_header, header_len, L"Authorization: Bearer %hs", bearer_token);
-            WinHttpAddRequestHeaders(request, auth_header, (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
-            free(auth_header);
-        }
+        request_options opts = { "GET", NULL, NULL, item->bearer_token, item->etag, item->last_modified,
+                                 item->sink, item->user };
+        item->response = send_request(ctx->session, item->url, &opts, item->error);
     }
+    return 0;
+}
 
-    /* Add Accept header */
-    WinHttpAddRequestHeaders(request, L"Accept: application/json", (DWORD)-1, WINHTTP_ADDREQ_FLAG_ADD);
+int http_batch_get(http_session *session, http_batch_item *items, int count, int max_parallel)
+{
+    if (!session || !items || count <= 0) return 0;
 
-    /* Send request */
-    if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                            WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
-        set_win_error(session, "WinHttpSendRequest failed", GetLastError());
-        goto cleanup;
+    for (int i = 0; i < count; i++) {
+        items[i].response = NULL;
+        items[i].error[0] = '\0';
     }
 
-    /* Receive response */
-    if (!WinHttpReceiveResponse(request, NULL)) {
-        set_win_error(session, "WinHttpReceiveResponse failed", GetLastError());
-        goto cleanup;
-    }
+    int threads = max_parallel;
+    if (threads <= 0 || threads > MAX_BATCH_THREADS) threads = MAX_BATCH_THREADS;
+    if (threads > count) threads = count;
 
-    /* Allocate response */
-    resp = calloc(1, sizeof(http_response));
-    if (!resp) {
-        set_error(session, "Memory allocation failed");
-        goto cleanup;
-    }
-
-    /* Get status code */
-    DWORD status_code = 0;
-    DWORD size = sizeof(status_code);
-    WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
-                        WINHTTP_HEADER_NAME_BY_INDEX, &status_code, &size,
-                        WINHTTP_NO_HEADER_INDEX);
-    resp->status_code = (int)status_code;
+    batch_context ctx = { session, items, count, 0 };
+    HANDLE handles[MAX_BATCH_THREADS];
+    int started = 0;
 
+    /* The calling thread works too, so one fewer thread is needed */
+    for (int i = 0; i < threads - 1; i++) {
+        handles[started] = CreateThread(NULL, 0, batch_worker, &ctx, 0, NULL);
+        if (handles[started]) started++;
+    }
 
-    /* Parse rate limit headers */
-    parse_rate_limit_headers(request, resp);
+    batch_worker(&ctx);
 
-    /* Read body */
-    if (!read_response_body(request, resp)) {
-        set_error(session, "Failed to read response body");
-        http_response_free(resp);
-        resp = NULL;
-        goto cleanup;
+    if (started > 0) {
+        WaitForMultipleObjects((DWORD)started, handles, TRUE, INFINITE);
+        for (int i = 0; i < started; i++) {
+            CloseHandle(handles[i]);
+        }
     }
 
-cleanup:
-    if (request) WinHttpCloseHandle(request);
-    if (connect) WinHttpCloseHandle(connect);
-    free_url_parts(&parts);
-
-    return resp;
+    int succeeded = 0;
+    for (int i = 0; i < count; i++) {
+        if (items[i].response) succeeded++;
+    }
+    return succeeded;
 }
 
 /*
@@ -524,6 +689,8 @@ void http_response_free(http_response *resp)
 
     free(resp->body);
     free(resp->content_type);
+    free(resp->etag);
+    free(resp->last_modified);
     free(resp);
 }
 
@@ -532,6 +699,11 @@ bool http_response_ok(http_response *resp)
     return resp && resp->status_code >= 200 && resp->status_code < 300;
 }
 
+bool http_response_not_modified(http_response *resp)
+{
+    return resp && resp->status_code == 304;
+}
+
 const char *http_response_body(http_response *resp)
 {
     return resp ? resp->body : NULL;
@@ -19,14 +19,25 @@ typedef struct http_response {
     char *body;
     size_t body_len;
     char *content_type;
+    /* Cache validators, NULL when the server sent none */
+    char *etag;
+    char *last_modified;
     /* Rate limiting info from iRacing */
     int rate_limit_remaining;
     int rate_limit_reset;
 } http_response;
 
+/*
+ * Body chunk callback for streamed requests.
+ * Return false to abort the transfer.
+ */
+typedef bool (*http_chunk_fn)(void *user, const char *data, size_t len);
+
 /*
  * HTTP Session (opaque type)
- * Maintains cookies and connection state across requests.
+ * Maintains cookies and connection state across requests. Connections are
+ * cached per host and reused; a session may be used from batch requests
+ * on several threads at once.
  */
 typedef struct http_session http_session;
 
@@ -88,6 +99,62 @@ http_response *http_get_with_token(http_session *session, const char *url, const
  */
 http_response *http_get(http_session *session, const char *url);
 
+
+/*
+ * Send a conditional GET request.
+ *
+ * etag and last_modified come from an earlier response's validators and
+ * are sent as If-None-Match and If-Modified-Since; either may be NULL.
+ * An unchanged resource answers 304 with an empty body, see
+ * http_response_not_modified().
+ */
+http_response *http_get_conditional(http_session *session, const char *url,
+                                    const char *bearer_token,
+                                    const char *etag, const char *last_modified);
+
+/*
+ * Send a GET request and stream the body to a callback.
+ *
+ * bearer_token, etag and last_modified may be NULL; the validators are used
+ * as for http_get_conditional(). For 2xx responses the body is passed to
+ * sink in chunks as it is received and resp->body is NULL; other responses
+ * are buffered as usual. Returns NULL on error or if sink aborts.
+ * Caller must free response with http_response_free().
+ */
+http_response *http_get_stream(http_session *session, const char *url, const char *bearer_token,
+                               const char *etag, const char *last_modified,
+                               http_chunk_fn sink, void *user);
+
+/*
+ * Batch Requests
+ */
+
+/* One GET in a batch. url and the optional fields are inputs; items with
+ * a NULL url are skipped. */
+typedef struct {
+    const char *url;
+    const char *bearer_token;   /* May be NULL */
+    const char *etag;           /* May be NULL; as for http_get_conditional() */
+    const char *last_modified;  /* May be NULL */
+    http_chunk_fn sink;         /* May be NULL; as for http_get_stream() */
+    void *user;
+    http_response *response;    /* Result, NULL on failure */
+    char error[256];            /* Failure reason when response is NULL */
+} http_batch_item;
+
+/*
+ * Run several GET requests concurrently.
+ *
+ * Up to max_parallel requests (0 for the default of 8) are in flight at
+ * once, sharing the session's connection cache. Each item receives its own
+ * response or error; a sink is only ever called from one thread at a time.
+ * Blocks until every request has finished.
+ *
+ * Returns the number of items that got a response.
+ * Caller must free each response with http_response_free().
+ */
+int http_batch_get(http_session *session, http_batch_item *items, int count, int max_parallel);
+
 /*
  * Response Handling
  */
@@ -98,6 +165,9 @@ void http_response_free(http_response *resp);
 /* Check if response indicates success (2xx status). */
 bool http_response_ok(http_response *resp);
 
+/* Check if response is 304 Not Modified. */
+bool http_response_not_modified(http_response *resp);
+
 /* Get response body as string (null-terminated). */
 const char *http_response_body(http_response *resp);
 
@@ -9,13 +9,53 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#endif
+
 #include "json.h"
 
+/* Capacity marker for containers owned by a json_document */
+#define JSON_CAPACITY_FIXED -1
+
+/* Objects with at least this many keys get a hash index in documents */
+#define JSON_INDEX_MIN_KEYS 16
+
+/* Arena block sizing */
+#define ARENA_MIN_BLOCK (16 * 1024)
+#define ARENA_MAX_BLOCK (16 * 1024 * 1024)
+
+/* Arena block, allocations are carved from data[] */
+typedef struct json_arena_block {
+    struct json_arena_block *next;
+    size_t used;
+    size_t size;
+    char data[];
+} json_arena_block;
+
+struct json_document {
+    json_arena_block *blocks;
+    size_t next_block_size;
+    json_value *root;
+};
+
 /* Parser context */
 typedef struct {
     const char *str;
     const char *ptr;
     int depth;
+    json_document *doc;     /* NULL: every node is heap-allocated */
+
+    /* Scratch stacks; children collect here until their container closes */
+    json_value **items;
+    int item_count;
+    int item_capacity;
+    json_pair *pairs;
+    int pair_count;
+    int pair_capacity;
 } json_parser;
 
 /* Forward declarations */
@@ -37,15 +77,50 @@ static char *str_dup(const char *s)
     return dup;
 }
 
-static char *str_ndup(const char *s, size_t n)
+static void *arena_alloc(json_document *doc, size_t size)
 {
-    if (!s) return NULL;
-    char *dup = (char *)malloc(n + 1);
-    if (dup) {
-        memcpy(dup, s, n);
-        dup[n] = '\0';
+    size = (size + 7) & ~(size_t)7;
+
+    json_arena_block *block = doc->blocks;
+    if (!block || block->size - block->used < size) {
+        size_t block_size = doc->next_block_size;
+        if (block_size < size) {
+            block_size = size;
+        }
+
+        block = (json_arena_block *)malloc(sizeof(json_arena_block) + block_size);
+        if (!block) {
+            return NULL;
+        }
+        block->next = doc->blocks;
+        block->used = 0;
+        block->size = block_size;
+        doc->blocks = block;
+
+        if (doc->next_block_size < ARENA_MAX_BLOCK) {
+            doc->next_block_size *= 2;
+        }
     }
-    return dup;
+
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+/* Allocate from the document arena, or the heap for plain json_parse() */
+static void *parser_alloc(json_parser *p, size_t size)
+{
+    return p->doc ? arena_alloc(p->doc, size) : malloc(size);
+}
+
+static json_value *parser_new_value(json_parser *p, json_type type)
+{
+    json_value *val = (json_value *)parser_alloc(p, sizeof(json_value));
+    if (val) {
+        memset(val, 0, sizeof(*val));
+        val->type = type;
+    }
+    return val;
 }
 
 /*
@@ -96,7 +171,6 @@ json_value *json_new_array(void)
     json_value *val = (json_value *)calloc(1, sizeof(json_value));
     if (val) {
         val->type = JSON_ARRAY;
-        val->data.array_val = NULL;
     }
     return val;
 }
@@ -106,7 +180,6 @@ json_value *json_new_object(void)
     json_value *val = (json_value *)calloc(1, sizeof(json_value));
     if (val) {
         val->type = JSON_OBJECT;
-        val->data.object_val = NULL;
     }
     return val;
 }
@@ -154,25 +227,51 @@ int json_array_length(const json_value *val)
     if (!val || val->type != JSON_ARRAY) {
         return 0;
     }
-    int count = 0;
-    json_element *elem = val->data.array_val;
-    while (elem) {
-        count++;
-        elem = elem->next;
-    }
-    return count;
+    return val->data.array_val.count;
 }
 
 json_value *json_array_get(const json_value *val, int index)
 {
-    if (!val || val->type != JSON_ARRAY || index < 0) {
+    if (!val || val->type != JSON_ARRAY || index < 0 ||
+        index >= val->data.array_val.count) {
         return NULL;
     }
-    json_element *elem = val->data.array_val;
-    for (int i = 0; elem && i < index; i++) {
-        elem = elem->next;
+    return val->data.array_val.items[index];
+}
+
+/* FNV-1a, used for the document key index */
+static unsigned int hash_key(const char *key)
+{
+    unsigned int h = 2166136261u;
+    while (*key) {
+        h ^= (unsigned char)*key++;
+        h *= 16777619u;
     }
-    return elem ? elem->value : NULL;
+    return h;
+}
+
+/* Position of key in an object, or -1. Later duplicates win. */
+static int object_find(const json_value *obj, const char *key)
+{
+    const json_pair *pairs = obj->data.object_val.pairs;
+
+    if (obj->data.object_val.index) {
+        const int *index = obj->data.object_val.index;
+        unsigned int mask = (unsigned int)obj->data.object_val.index_size - 1;
+        for (unsigned int slot = hash_key(key) & mask;; slot = (slot + 1) & mask) {
+            int i = index[slot];
+            if (i < 0 || strcmp(pairs[i].key, key) == 0) {
+                return i;
+            }
+        }
+    }
+
+    for (int i = obj->data.object_val.count - 1; i >= 0; i--) {
+        if (pairs[i].key && strcmp(pairs[i].key, key) == 0) {
+            return i;
+        }
+    }
+    return -1;
 }
 
 json_value *json_object_get(const json_value *val, const char *key)
@@ -180,14 +279,8 @@ json_value *json_object_get(const json_value *val, const char *key)
     if (!val || val->type != JSON_OBJECT || !key) {
         return NULL;
     }
-    json_pair *pair = val->data.object_val;
-    while (pair) {
-        if (pair->key && strcmp(pair->key, key) == 0) {
-            return pair->value;
-        }
-        pair = pair->next;
-    }
-    return NULL;
+    int i = object_find(val, key);
+    return i >= 0 ? val->data.object_val.pairs[i].value : NULL;
 }
 
 bool json_object_has(const json_value *val, const char *key)
@@ -201,55 +294,62 @@ bool json_object_has(const json_value *val, const char *key)
 
 bool json_array_push(json_value *arr, json_value *val)
 {
-    if (!arr || arr->type != JSON_ARRAY || !val) {
-        return false;
-    }
-
-    json_element *elem = (json_element *)calloc(1, sizeof(json_element));
-    if (!elem) {
+    if (!arr || arr->type != JSON_ARRAY || !val ||
+        arr->data.array_val.capacity == JSON_CAPACITY_FIXED) {
         return false;
     }
-    elem->value = val;
-    elem->next = NULL;
 
-    if (!arr->data.array_val) {
-        arr->data.array_val = elem;
-    } else {
-        json_element *last = arr->data.array_val;
-        while (last->next) {
-            last = last->next;
+    if (arr->data.array_val.count >= arr->data.array_val.capacity) {
+        int new_capacity = arr->data.array_val.capacity ?
+                           arr->data.array_val.capacity * 2 : 8;
+        json_value **new_items = (json_value **)realloc(arr->data.array_val.items,
+                                                        new_capacity * sizeof(json_value *));
+        if (!new_items) {
+            return false;
         }
-        last->next = elem;
+        arr->data.array_val.items = new_items;
+        arr->data.array_val.capacity = new_capacity;
     }
+
+    arr->data.array_val.items[arr->data.array_val.count++] = val;
     return true;
 }
 
 bool json_object_set(json_value *obj, const char *key, json_value *val)
 {
-    if (!obj || obj->type != JSON_OBJECT || !key || !val) {
+    if (!obj || obj->type != JSON_OBJECT || !key || !val ||
+        obj->data.object_val.capacity == JSON_CAPACITY_FIXED) {
         return false;
     }
 
     /* Check if key already exists */
-    json_pair *pair = obj->data.object_val;
-    while (pair) {
-        if (pair->key && strcmp(pair->key, key) == 0) {
-            json_free(pair->value);
-            pair->value = val;
-            return true;
+    int i = object_find(obj, key);
+    if (i >= 0) {
+        json_free(obj->data.object_val.pairs[i].value);
+        obj->data.object_val.pairs[i].value = val;
+        return true;
+    }
+
+    if (obj->data.object_val.count >= obj->data.object_val.capacity) {
+        int new_capacity = obj->data.object_val.capacity ?
+                           obj->data.object_val.capacity * 2 : 8;
+        json_pair *new_pairs = (json_pair *)realloc(obj->data.object_val.pairs,
+                                                    new_capacity * sizeof(json_pair));
+        if (!new_pairs) {
+            return false;
         }
-        pair = pair->next;
+        obj->data.object_val.pairs = new_pairs;
+        obj->data.object_val.capacity = new_capacity;
     }
 
-    /* Create new pair */
-    pair = (json_pair *)calloc(1, sizeof(json_pair));
-    if (!pair) {
+    char *key_copy = str_dup(key);
+    if (!key_copy) {
         return false;
     }
-    pair->key = str_dup(key);
+
+    json_pair *pair = &obj->data.object_val.pairs[obj->data.object_val.count++];
+    pair->key = key_copy;
     pair->value = val;
-    pair->next = obj->data.object_val;
-    obj->data.object_val = pair;
     return true;
 }
 
@@ -266,27 +366,18 @@ void json_free(json_value *val)
         free(val->data.string_val);
         break;
     case JSON_ARRAY:
-        {
-            json_element *elem = val->data.array_val;
-            while (elem) {
-                json_element *next = elem->next;
-                json_free(elem->value);
-                free(elem);
-                elem = next;
-            }
+        for (int i = 0; i < val->data.array_val.count; i++) {
+            json_free(val->data.array_val.items[i]);
         }
+        free(val->data.array_val.items);
         break;
     case JSON_OBJECT:
-        {
-            json_pair *pair = val->data.object_val;
-            while (pair) {
-                json_pair *next = pair->next;
-                free(pair->key);
-                json_free(pair->value);
-                free(pair);
-                pair = next;
-            }
+        for (int i = 0; i < val->data.object_val.count; i++) {
+            free(val->data.object_val.pairs[i].key);
+            json_free(val->data.object_val.pairs[i].value);
         }
+        free(val->data.object_val.pairs);
+        free(val->data.object_val.index);
         break;
     default:
         break;
@@ -294,6 +385,24 @@ void json_free(json_value *val)
     free(val);
 }
 
+void json_document_free(json_document *doc)
+{
+    if (!doc) return;
+
+    json_arena_block *block = doc->blocks;
+    while (block) {
+        json_arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(doc);
+}
+
+json_value *json_document_root(const json_document *doc)
+{
+    return doc ? doc->root : NULL;
+}
+
 /*
  * Parsing
  */
@@ -305,7 +414,89 @@ static void skip_whitespace(json_parser *p)
     }
 }
 
-static json_value *parse_string(json_parser *p)
+static bool push_item(json_parser *p, json_value *val)
+{
+    if (p->item_count >= p->item_capacity) {
+        int new_capacity = p->item_capacity ? p->item_capacity * 2 : 64;
+        json_value **new_items = (json_value **)realloc(p->items,
+                                                        new_capacity * sizeof(json_value *));
+        if (!new_items) return false;
+        p->items = new_items;
+        p->item_capacity = new_capacity;
+    }
+    p->items[p->item_count++] = val;
+    return true;
+}
+
+static bool push_pair(json_parser *p, char *key, json_value *val)
+{
+    if (p->pair_count >= p->pair_capacity) {
+        int new_capacity = p->pair_capacity ? p->pair_capacity * 2 : 64;
+        json_pair *new_pairs = (json_pair *)realloc(p->pairs,
+                                                    new_capacity * sizeof(json_pair));
+        if (!new_pairs) return false;
+        p->pairs = new_pairs;
+        p->pair_capacity = new_capacity;
+    }
+    p->pairs[p->pair_count].key = key;
+    p->pairs[p->pair_count].value = val;
+    p->pair_count++;
+    return true;
+}
+
+/* Drop scratch entries above base after an error. Arena memory goes with the document. */
+static void discard_items(json_parser *p, int base)
+{
+    if (!p->doc) {
+        for (int i = base; i < p->item_count; i++) {
+            json_free(p->items[i]);
+        }
+    }
+    p->item_count = base;
+}
+
+static void discard_pairs(json_parser *p, int base)
+{
+    if (!p->doc) {
+        for (int i = base; i < p->pair_count; i++) {
+            free(p->pairs[i].key);
+            json_free(p->pairs[i].value);
+        }
+    }
+    p->pair_count = base;
+}
+
+static void build_key_index(json_parser *p, json_value *obj)
+{
+    int count = obj->data.object_val.count;
+    int size = 1;
+    while (size < count * 2) {
+        size <<= 1;
+    }
+
+    int *index = (int *)arena_alloc(p->doc, size * sizeof(int));
+    if (!index) return;     /* Lookups fall back to a linear scan */
+
+    for (int i = 0; i < size; i++) {
+        index[i] = -1;
+    }
+
+    const json_pair *pairs = obj->data.object_val.pairs;
+    unsigned int mask = (unsigned int)size - 1;
+    for (int i = 0; i < count; i++) {
+        unsigned int slot = hash_key(pairs[i].key) & mask;
+        while (index[slot] >= 0 && strcmp(pairs[index[slot]].key, pairs[i].key) != 0) {
+            slot = (slot + 1) & mask;
+        }
+        index[slot] = i;
+    }
+
+    obj->data.object_val.index = index;
+    obj->data.object_val.index_size = size;
+}
+
+/* Parse a string literal into parser-owned storage */
+static char *parse_string_raw(json_parser *p)
 {
     if (*p->ptr != '"') return NULL;
     p->ptr++; /* Skip opening quote */
@@ -327,7 +518,7 @@ static json_value *parse_string(json_parser *p)
     if (*p->ptr != '"') return NULL;
 
     /* Build the string, handling escapes */
-    char *str = (char *)malloc(len + 1);
+    char *str = (char *)parser_alloc(p, len + 1);
     if (!str) return NULL;
 
     const char *src = start;
@@ -354,9 +545,20 @@ static json_value *parse_string(json_parser *p)
     *dst = '\0';
 
     p->ptr++; /* Skip closing quote */
+    return str;
+}
 
-    json_value *val = json_new_string(str);
-    free(str);
+static json_value *parse_string(json_parser *p)
+{
+    char *str = parse_string_raw(p);
+    if (!str) return NULL;
+
+    json_value *val = parser_new_value(p, JSON_STRING);
+    if (!val) {
+        if (!p->doc) free(str);
+        return NULL;
+    }
+    val->data.string_val = str;
     return val;
 }
 
@@ -379,13 +581,28 @@ static json_value *parse_number(json_parser *p)
         while (isdigit((unsigned char)*p->ptr)) p->ptr++;
     }
 
-    char *temp = str_ndup(start, p->ptr - start);
-    if (!temp) return NULL;
-
-    double num = atof(temp);
-    free(temp);
+    /* Copy out the token so strtod cannot read past it */
+    char buf[64];
+    size_t len = (size_t)(p->ptr - start);
+    double num;
+    if (len < sizeof(buf)) {
+        memcpy(buf, start, len);
+        buf[len] = '\0';
+        num = strtod(buf, NULL);
+    } else {
+        char *temp = (char *)malloc(len + 1);
+        if (!temp) return NULL;
+        memcpy(temp, start, len);
+        temp[len] = '\0';
+        num = strtod(temp, NULL);
+        free(temp);
+    }
 
-    return json_new_number(num);
+    json_value *val = parser_new_value(p, JSON_NUMBER);
+    if (val) {
+        val->data.number_val = num;
+    }
+    return val;
 }
 
 static json_value *parse_array(json_parser *p)
@@ -398,43 +615,62 @@ static json_value *parse_array(json_parser *p)
         return NULL;
     }
 
-    json_value *arr = json_new_array();
-    if (!arr) {
-        p->depth--;
-        return NULL;
-    }
+    int base = p->item_count;
 
     skip_whitespace(p);
 
-    if (*p->ptr == ']') {
-        p->ptr++;
-        p->depth--;
-        return arr;
-    }
-
-    while (1) {
-        skip_whitespace(p);
-        json_value *elem = parse_value(p);
-        if (!elem) {
-            json_free(arr);
-            p->depth--;
-            return NULL;
-        }
-        json_array_push(arr, elem);
+    if (*p->ptr != ']') {
+        while (1) {
+            skip_whitespace(p);
+            json_value *elem = parse_value(p);
+            if (!elem) {
+                discard_items(p, base);
+                p->depth--;
+                return NULL;
+            }
+            if (!push_item(p, elem)) {
+                if (!p->doc) json_free(elem);
+                discard_items(p, base);
+                p->depth--;
+                return NULL;
+            }
 
-        skip_whitespace(p);
-        if (*p->ptr == ']') {
+            skip_whitespace(p);
+            if (*p->ptr == ']') {
+                break;
+            }
+            if (*p->ptr != ',') {
+                discard_items(p, base);
+                p->depth--;
+                return NULL;
+            }
             p->ptr++;
-            break;
-        }
-        if (*p->ptr != ',') {
-            json_free(arr);
-            p->depth--;
-            return NULL;
         }
-        p->ptr++;
+    }
+    p->ptr++; /* Skip ']' */
+
+    /* Move the collected items into one contiguous block */
+    json_value *arr = parser_new_value(p, JSON_ARRAY);
+    int count = p->item_count - base;
+    json_value **items = NULL;
+    if (arr && count > 0) {
+        items = (json_value **)parser_alloc(p, count * sizeof(json_value *));
+    }
+    if (!arr || (count > 0 && !items)) {
+        if (!p->doc) free(arr);
+        discard_items(p, base);
+        p->depth--;
+        return NULL;
     }
 
+    if (count > 0) {
+        memcpy(items, p->items + base, count * sizeof(json_value *));
+    }
+    arr->data.array_val.items = items;
+    arr->data.array_val.count = count;
+    arr->data.array_val.capacity = p->doc ? JSON_CAPACITY_FIXED : count;
+    p->item_count = base;
+
     p->depth--;
     return arr;
 }
@@ -449,70 +685,103 @@ static json_value *parse_object(json_parser *p)
         return NULL;
     }
 
-    json_value *obj = json_new_object();
-    if (!obj) {
-        p->depth--;
-        return NULL;
-    }
+    int base = p->pair_count;
 
     skip_whitespace(p);
 
-    if (*p->ptr == '}') {
-        p->ptr++;
-        p->depth--;
-        return obj;
-    }
-
-    while (1) {
-        skip_whitespace(p);
+    if (*p->ptr != '}') {
+        while (1) {
+            skip_whitespace(p);
 
-        /* Parse key */
-        json_value *key_val = parse_string(p);
-        if (!key_val) {
-            json_free(obj);
-            p->depth--;
-            return NULL;
-        }
-        const char *key = json_get_string(key_val);
+            /* Parse key */
+            char *key = parse_string_raw(p);
+            if (!key) {
+                discard_pairs(p, base);
+                p->depth--;
+                return NULL;
+            }
 
-        skip_whitespace(p);
-        if (*p->ptr != ':') {
-            json_free(key_val);
-            json_free(obj);
-            p->depth--;
-            return NULL;
-        }
-        p->ptr++;
+            skip_whitespace(p);
+            if (*p->ptr != ':') {
+                if (!p->doc) free(key);
+                discard_pairs(p, base);
+                p->depth--;
+                return NULL;
+            }
+            p->ptr++;
 
-        skip_whitespace(p);
-        json_value *val = parse_value(p);
-        if (!val) {
-            json_free(key_val);
-            json_free(obj);
-            p->depth--;
-            return NULL;
-        }
+            skip_whitespace(p);
+            json_value *val = parse_value(p);
+            if (!val) {
+                if (!p->doc) free(key);
+                discard_pairs(p, base);
+                p->depth--;
+                return NULL;
+            }
 
-        json_object_set(obj, key, val);
-        json_free(key_val);
+            if (!push_pair(p, key, val)) {
+                if (!p->doc) {
+                    free(key);
+                    json_free(val);
+                }
+                discard_pairs(p, base);
+                p->depth--;
+                return NULL;
+            }
 
-        skip_whitespace(p);
-        if (*p->ptr == '}') {
+            skip_whitespace(p);
+            if (*p->ptr == '}') {
+                break;
+            }
+            if (*p->ptr != ',') {
+                discard_pairs(p, base);
+                p->depth--;
+                return NULL;
+            }
             p->ptr++;
-            break;
         }
-        if (*p->ptr != ',') {
-            json_free(obj);
-            p->depth--;
-            return NULL;
-        }
-        p->ptr++;
+    }
+    p->ptr++; /* Skip '}' */
+
+    /* Move the collected pairs into one contiguous block */
+    json_value *obj = parser_new_value(p, JSON_OBJECT);
+    int count = p->pair_count - base;
+    json_pair *pairs = NULL;
+    if (obj && count > 0) {
+        pairs = (json_pair *)parser_alloc(p, count * sizeof(json_pair));
+    }
+    if (!obj || (count > 0 && !pairs)) {
+        if (!p->doc) free(obj);
+        discard_pairs(p, base);
+        p->depth--;
+        return NULL;
+    }
+
+    if (count > 0) {
+        memcpy(pairs, p->pairs + base, count * sizeof(json_pair));
+    }
+    obj->data.object_val.pairs = pairs;
+    obj->data.object_val.count = count;
+    obj->data.object_val.capacity = p->doc ? JSON_CAPACITY_FIXED : count;
+    p->pair_count = base;
+
+    if (p->doc && count >= JSON_INDEX_MIN_KEYS) {
+        build_key_index(p, obj);
     }
 
     p->depth--;
     return obj;
 }
 
+static json_value *parse_literal(json_parser *p, json_type type, bool b)
+{
+    json_value *val = parser_new_value(p, type);
+    if (val && type == JSON_BOOL) {
+        val->data.bool_val = b;
+    }
+    return val;
+}
+
 static json_value *parse_value(json_parser *p)
 {
     skip_whitespace(p);
@@ -531,29 +800,63 @@ static json_value *parse_value(json_parser *p)
     }
     if (strncmp(p->ptr, "true", 4) == 0) {
         p->ptr += 4;
-        return json_new_bool(true);
+        return parse_literal(p, JSON_BOOL, true);
     }
     if (strncmp(p->ptr, "false", 5) == 0) {
         p->ptr += 5;
-        return json_new_bool(false);
+        return parse_literal(p, JSON_BOOL, false);
     }
     if (strncmp(p->ptr, "null", 4) == 0) {
         p->ptr += 4;
-        return json_new_null();
+        return parse_literal(p, JSON_NULL, false);
     }
 
     return NULL;
 }
 
+static json_value *run_parser(const char *str, json_document *doc)
+{
+    json_parser p;
+    memset(&p, 0, sizeof(p));
+    p.str = str;
+    p.ptr = str;
+    p.doc = doc;
+
+    json_value *val = parse_value(&p);
+
+    free(p.items);
+    free(p.pairs);
+    return val;
+}
+
 json_value *json_parse(const char *str)
 {
     if (!str) return NULL;
+    return run_parser(str, NULL);
+}
+
+json_document *json_document_parse(const char *str)
+{
+    if (!str) return NULL;
+
+    json_document *doc = (json_document *)calloc(1, sizeof(json_document));
+    if (!doc) return NULL;
+
+    /* Node overhead is a few times the text size, so start near it */
+    size_t len = strlen(str);
+    doc->next_block_size = len < ARENA_MIN_BLOCK ? ARENA_MIN_BLOCK :
+                           len > ARENA_MAX_BLOCK ? ARENA_MAX_BLOCK : len;
 
-    json_parser p = { str, str, 0 };
-    return parse_value(&p);
+    doc->root = run_parser(str, doc);
+    if (!doc->root) {
+        json_document_free(doc);
+        return NULL;
+    }
+    return doc;
 }
 
-json_value *json_parse_file(const char *filename)
+/* Read a whole file into a NUL-terminated buffer. Caller must free. */
+static char *read_file(const char *filename)
 {
     if (!filename) return NULL;
 
@@ -564,6 +867,11 @@ json_value *json_parse_file(const char *filename)
     long size = ftell(f);
     fseek(f, 0, SEEK_SET);
 
+    if (size < 0) {
+        fclose(f);
+        return NULL;
+    }
+
     char *str = (char *)malloc(size + 1);
     if (!str) {
         fclose(f);
@@ -573,28 +881,62 @@ json_value *json_parse_file(const char *filename)
     size_t read = fread(str, 1, size, f);
     str[read] = '\0';
     fclose(f);
+    return str;
+}
+
+json_value *json_parse_file(const char *filename)
+{
+    char *str = read_file(filename);
+    if (!str) return NULL;
 
     json_value *val = json_parse(str);
     free(str);
     return val;
 }
 
+json_document *json_document_parse_file(const char *filename)
+{
+    char *str = read_file(filename);
+    if (!str) return NULL;
+
+    json_document *doc = json_document_parse(str);
+    free(str);
+    return doc;
+}
+
 /*
  * Serialization
  */
 
+/* Buffer size for writers that stream to a file */
+#define JSON_FILE_BUFFER (64 * 1024)
+
 typedef struct {
     char *buf;
     size_t len;
     size_t cap;
     int indent;
     bool pretty;
+    FILE *file;             /* Set: flush here when full rather than growing */
 } json_writer;
 
+static bool writer_flush(json_writer *w)
+{
+    if (!w->file || w->len == 0) return true;
+    bool ok = fwrite(w->buf, 1, w->len, w->file) == w->len;
+    w->len = 0;
+    return ok;
+}
+
 static bool writer_grow(json_writer *w, size_t need)
 {
     if (w->len + need < w->cap) return true;
 
+    if (w->file) {
+        if (!writer_flush(w)) return false;
+        if (need < w->cap) return true;
+    }
+
     size_t new_cap = w->cap * 2;
     if (new_cap < w->len + need) new_cap = w->len + need + 256;
 
@@ -669,6 +1011,17 @@ static bool write_string(json_writer *w, const char *s)
     return writer_append_char(w, '"');
 }
 
+static bool write_number(json_writer *w, double n)
+{
+    char buf[64];
+    if (n == (int)n) {
+        snprintf(buf, sizeof(buf), "%d", (int)n);
+    } else {
+        snprintf(buf, sizeof(buf), "%g", n);
+    }
+    return writer_append(w, buf);
+}
+
 static bool write_value(json_writer *w, const json_value *val)
 {
     if (!val) {
@@ -683,16 +1036,7 @@ static bool write_value(json_writer *w, const json_value *val)
         return writer_append(w, val->data.bool_val ? "true" : "false");
 
     case JSON_NUMBER:
-        {
-            char buf[64];
-            double n = val->data.number_val;
-            if (n == (int)n) {
-                snprintf(buf, sizeof(buf), "%d", (int)n);
-            } else {
-                snprintf(buf, sizeof(buf), "%g", n);
-            }
-            return writer_append(w, buf);
-        }
+        return write_number(w, val->data.number_val);
 
     case JSON_STRING:
         return write_string(w, val->data.string_val ? val->data.string_val : "");
@@ -701,28 +1045,24 @@ static bool write_value(json_writer *w, const json_value *val)
         {
             if (!writer_append_char(w, '[')) return false;
 
-            json_element *elem = val->data.array_val;
-            bool first = true;
+            int count = val->data.array_val.count;
 
-            if (elem && w->pretty) {
+            if (count > 0 && w->pretty) {
                 w->indent++;
                 if (!writer_newline(w)) return false;
             }
 
-            while (elem) {
-                if (!first) {
+            for (int i = 0; i < count; i++) {
+                if (i > 0) {
                     if (!writer_append_char(w, ',')) return false;
                     if (!writer_newline(w)) return false;
                 }
-                first = false;
 
                 if (!writer_indent(w)) return false;
-                if (!write_value(w, elem->value)) return false;
-
-                elem = elem->next;
+                if (!write_value(w, val->data.array_val.items[i])) return false;
             }
 
-            if (val->data.array_val && w->pretty) {
+            if (count > 0 && w->pretty) {
                 w->indent--;
                 if (!writer_newline(w)) return false;
                 if (!writer_indent(w)) return false;
@@ -735,31 +1075,28 @@ static bool write_value(json_writer *w, const json_value *val)
         {
             if (!writer_append_char(w, '{')) return false;
 
-            json_pair *pair = val->data.object_val;
-            bool first = true;
+            int count = val->data.object_val.count;
 
-            if (pair && w->pretty) {
+            if (count > 0 && w->pretty) {
                 w->indent++;
                 if (!writer_newline(w)) return false;
             }
 
-            while (pair) {
-                if (!first) {
+            for (int i = 0; i < count; i++) {
+                const json_pair *pair = &val->data.object_val.pairs[i];
+                if (i > 0) {
                     if (!writer_append_char(w, ',')) return false;
                     if (!writer_newline(w)) return false;
                 }
-                first = false;
 
                 if (!writer_indent(w)) return false;
                 if (!write_string(w, pair->key ? pair->key : "")) return false;
                 if (!writer_append_char(w, ':')) return false;
                 if (w->pretty && !writer_append_char(w, ' ')) return false;
                 if (!write_value(w, pair->value)) return false;
-
-                pair = pair->next;
             }
 
-            if (val->data.object_val && w->pretty) {
+            if (count > 0 && w->pretty) {
                 w->indent--;
                 if (!writer_newline(w)) return false;
                 if (!writer_indent(w)) return false;
@@ -774,7 +1111,7 @@ static bool write_value(json_writer *w, const json_value *val)
 
 char *json_stringify(const json_value *val)
 {
-    json_writer w = { NULL, 0, 0, 0, false };
+    json_writer w = { NULL, 0, 0, 0, false, NULL };
     w.buf = (char *)malloc(256);
     if (!w.buf) return NULL;
     w.cap = 256;
@@ -790,7 +1127,7 @@ char *json_stringify(const json_value *val)
 
 char *json_stringify_pretty(const json_value *val)
 {
-    json_writer w = { NULL, 0, 0, 0, true };
+    json_writer w = { NULL, 0, 0, 0, true, NULL };
     w.buf = (char *)malloc(256);
     if (!w.buf) return NULL;
     w.cap = 256;
@@ -806,19 +1143,540 @@ char *json_stringify_pretty(const json_value *val)
 
 bool json_write_file(const json_value *val, const char *filename, bool pretty)
 {
-    char *str = pretty ? json_stringify_pretty(val) : json_stringify(val);
-    if (!str) return false;
+    json_out *out = json_out_open(filename, pretty);
+    if (!out) return false;
+
+    json_out_value(out, val);
+    return json_out_close(out);
+}
+
+/*
+ * Streaming writer
+ */
+
+struct json_out {
+    json_writer w;              /* w.indent is the number of open containers */
+    bool failed;
+    bool after_key;             /* Next value follows a key on the same line */
+    bool has_items[JSON_MAX_DEPTH];
+    char *path;
+    char *tmp_path;
+};
+
+json_out *json_out_open(const char *filename, bool pretty)
+{
+    if (!filename) return NULL;
+
+    json_out *out = (json_out *)calloc(1, sizeof(json_out));
+    if (!out) return NULL;
+
+    size_t len = strlen(filename);
+    out->path = str_dup(filename);
+    out->tmp_path = (char *)malloc(len + 5);
+    out->w.buf = (char *)malloc(JSON_FILE_BUFFER);
+    if (!out->path || !out->tmp_path || !out->w.buf) {
+        free(out->path);
+        free(out->tmp_path);
+        free(out->w.buf);
+        free(out);
+        return NULL;
+    }
+    memcpy(out->tmp_path, filename, len);
+    memcpy(out->tmp_path + len, ".tmp", 5);
+
+    out->w.cap = JSON_FILE_BUFFER;
+    out->w.pretty = pretty;
+    out->w.file = fopen(out->tmp_path, "wb");
+    if (!out->w.file) {
+        free(out->path);
+        free(out->tmp_path);
+        free(out->w.buf);
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/* Helper: Replace to with from, as one step */
+static bool replace_file(const char *from, const char *to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+bool json_out_close(json_out *out)
+{
+    if (!out) return false;
+
+    bool ok = !out->failed && out->w.indent == 0 && writer_flush(&out->w);
+    ok = fflush(out->w.file) == 0 && ok;
+#ifdef _WIN32
+    /* On disk before the rename, so a power cut can't leave an empty file */
+    ok = ok && FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(out->w.file)));
+#endif
+    ok = fclose(out->w.file) == 0 && ok;
+    ok = ok && replace_file(out->tmp_path, out->path);
+    if (!ok) {
+        remove(out->tmp_path);
+    }
+
+    free(out->path);
+    free(out->tmp_path);
+    free(out->w.buf);
+    free(out);
+    return ok;
+}
+
+/* Helper: Separator and indent before a value or key */
+static bool out_begin_item(json_out *out)
+{
+    if (out->failed) return false;
+
+    if (out->after_key) {
+        out->after_key = false;
+        return true;
+    }
+
+    int depth = out->w.indent;
+    if (depth > 0) {
+        bool ok = out->has_items[depth - 1] ? writer_append_char(&out->w, ',') : true;
+        out->has_items[depth - 1] = true;
+        if (!ok || !writer_newline(&out->w) || !writer_indent(&out->w)) {
+            out->failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void out_check(json_out *out, bool ok)
+{
+    if (!ok) out->failed = true;
+}
+
+static void out_open(json_out *out, char bracket)
+{
+    if (!out || !out_begin_item(out)) return;
+
+    if (out->w.indent >= JSON_MAX_DEPTH) {
+        out->failed = true;
+        return;
+    }
+    out_check(out, writer_append_char(&out->w, bracket));
+    out->has_items[out->w.indent++] = false;
+}
+
+static void out_close(json_out *out, char bracket)
+{
+    if (!out || out->failed) return;
+
+    if (out->w.indent == 0 || out->after_key) {
+        out->failed = true;
+        return;
+    }
+
+    bool had_items = out->has_items[--out->w.indent];
+    if (had_items) {
+        out_check(out, writer_newline(&out->w) && writer_indent(&out->w));
+    }
+    out_check(out, writer_append_char(&out->w, bracket));
+}
+
+void json_out_begin_object(json_out *out) { out_open(out, '{'); }
+void json_out_end_object(json_out *out)   { out_close(out, '}'); }
+void json_out_begin_array(json_out *out)  { out_open(out, '['); }
+void json_out_end_array(json_out *out)    { out_close(out, ']'); }
+
+void json_out_key(json_out *out, const char *key)
+{
+    if (!out || out->after_key || !out_begin_item(out)) return;
+
+    out_check(out, write_string(&out->w, key ? key : "") &&
+                   writer_append_char(&out->w, ':') &&
+                   (!out->w.pretty || writer_append_char(&out->w, ' ')));
+    out->after_key = true;
+}
+
+void json_out_string(json_out *out, const char *val)
+{
+    if (!out || !out_begin_item(out)) return;
+    out_check(out, write_string(&out->w, val ? val : ""));
+}
+
+void json_out_number(json_out *out, double val)
+{
+    if (!out || !out_begin_item(out)) return;
+    out_check(out, write_number(&out->w, val));
+}
+
+void json_out_bool(json_out *out, bool val)
+{
+    if (!out || !out_begin_item(out)) return;
+    out_check(out, writer_append(&out->w, val ? "true" : "false"));
+}
+
+void json_out_null(json_out *out)
+{
+    if (!out || !out_begin_item(out)) return;
+    out_check(out, writer_append(&out->w, "null"));
+}
+
+void json_out_value(json_out *out, const json_value *val)
+{
+    if (!out || !out_begin_item(out)) return;
+    out_check(out, write_value(&out->w, val));
+}
+
+void json_out_field_string(json_out *out, const char *key, const char *val)
+{
+    json_out_key(out, key);
+    json_out_string(out, val);
+}
+
+void json_out_field_number(json_out *out, const char *key, double val)
+{
+    json_out_key(out, key);
+    json_out_number(out, val);
+}
+
+void json_out_field_bool(json_out *out, const char *key, bool val)
+{
+    json_out_key(out, key);
+    json_out_bool(out, val);
+}
+
+/*
+ * Streaming parser
+ */
+
+typedef enum {
+    STREAM_VALUE,           /* Expecting a value */
+    STREAM_VALUE_OR_END,    /* After '[' */
+    STREAM_KEY_OR_END,      /* After '{' */
+    STREAM_KEY,             /* After ',' in an object */
+    STREAM_COLON,
+    STREAM_AFTER_VALUE,     /* Expecting ',' or a closing bracket */
+    STREAM_STRING,
+    STREAM_NUMBER,
+    STREAM_LITERAL,
+    STREAM_DONE,
+    STREAM_ERROR
+} stream_state;
+
+struct json_stream {
+    json_event_fn callback;
+    void *user;
+    stream_state state;
+
+    char stack[JSON_MAX_DEPTH];     /* '{' or '[' per open container */
+    int depth;
+
+    /* Partial token carried across chunks */
+    char *buf;
+    size_t buf_len;
+    size_t buf_cap;
+    bool string_is_key;
+    bool escape_pending;
+    const char *literal;
+    int literal_pos;
+};
+
+json_stream *json_stream_create(json_event_fn callback, void *user)
+{
+    if (!callback) return NULL;
+
+    json_stream *stream = (json_stream *)calloc(1, sizeof(json_stream));
+    if (!stream) return NULL;
+
+    stream->callback = callback;
+    stream->user = user;
+    stream->state = STREAM_VALUE;
+    return stream;
+}
+
+void json_stream_destroy(json_stream *stream)
+{
+    if (!stream) return;
+    free(stream->buf);
+    free(stream);
+}
+
+static bool stream_buf_append(json_stream *s, const char *data, size_t len)
+{
+    if (s->buf_len + len + 1 > s->buf_cap) {
+        size_t new_cap = s->buf_cap ? s->buf_cap * 2 : 256;
+        while (new_cap < s->buf_len + len + 1) new_cap *= 2;
+        char *new_buf = (char *)realloc(s->buf, new_cap);
+        if (!new_buf) return false;
+        s->buf = new_buf;
+        s->buf_cap = new_cap;
+    }
+    memcpy(s->buf + s->buf_len, data, len);
+    s->buf_len += len;
+    s->buf[s->buf_len] = '\0';
+    return true;
+}
+
+static bool stream_emit(json_stream *s, json_event_type type, const char *str, size_t len)
+{
+    json_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.depth = s->depth;
+    ev.str = str;
+    ev.len = len;
+
+    if (type == JSON_EVENT_NUMBER) {
+        ev.number = strtod(str, NULL);
+    } else if (type == JSON_EVENT_BOOL) {
+        ev.bool_val = (str[0] == 't');
+    }
 
-    FILE *f = fopen(filename, "wb");
-    if (!f) {
-        free(str);
+    if (!s->callback(s->user, &ev)) {
+        s->state = STREAM_ERROR;
         return false;
     }
+    return true;
+}
 
-    size_t len = strlen(str);
-    size_t written = fwrite(str, 1, len, f);
-    fclose(f);
-    free(str);
+/* A value just completed at the current depth */
+static void stream_end_value(json_stream *s)
+{
+    s->state = s->depth == 0 ? STREAM_DONE : STREAM_AFTER_VALUE;
+}
+
+static bool stream_open(json_stream *s, char bracket)
+{
+    if (s->depth >= JSON_MAX_DEPTH) {
+        s->state = STREAM_ERROR;
+        return false;
+    }
+    if (!stream_emit(s, bracket == '{' ? JSON_EVENT_OBJECT_START : JSON_EVENT_ARRAY_START, NULL, 0)) {
+        return false;
+    }
+    s->stack[s->depth++] = bracket;
+    s->state = bracket == '{' ? STREAM_KEY_OR_END : STREAM_VALUE_OR_END;
+    return true;
+}
+
+static bool stream_close(json_stream *s, char bracket)
+{
+    if (s->depth == 0 || s->stack[s->depth - 1] != (bracket == '}' ? '{' : '[')) {
+        s->state = STREAM_ERROR;
+        return false;
+    }
+    s->depth--;
+    if (!stream_emit(s, bracket == '}' ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END, NULL, 0)) {
+        return false;
+    }
+    stream_end_value(s);
+    return true;
+}
+
+/* Append escaped string content [start, end) to the token buffer */
+static bool stream_unescape(json_stream *s, const char *start, const char *end)
+{
+    while (start < end) {
+        if (s->escape_pending) {
+            char c;
+            switch (*start) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            default: c = *start; break;
+            }
+            if (!stream_buf_append(s, &c, 1)) return false;
+            s->escape_pending = false;
+            start++;
+            continue;
+        }
+
+        const char *run = start;
+        while (start < end && *start != '\\') start++;
+        if (start > run && !stream_buf_append(s, run, start - run)) return false;
+        if (start < end) {
+            s->escape_pending = true;
+            start++;
+        }
+    }
+    return true;
+}
+
+static bool stream_finish_string(json_stream *s)
+{
+    const char *str = "";
+    size_t len = s->buf_len;
+    if (s->buf) {
+        s->buf[len] = '\0';
+        str = s->buf;
+    }
+
+    if (s->string_is_key) {
+        if (!stream_emit(s, JSON_EVENT_KEY, str, len)) return false;
+        s->state = STREAM_COLON;
+    } else {
+        if (!stream_emit(s, JSON_EVENT_STRING, str, len)) return false;
+        stream_end_value(s);
+    }
+    s->buf_len = 0;
+    return true;
+}
+
+static bool stream_begin_value(json_stream *s, char c)
+{
+    if (c == '{' || c == '[') {
+        return stream_open(s, c);
+    }
+    if (c == '"') {
+        s->state = STREAM_STRING;
+        s->string_is_key = false;
+        s->buf_len = 0;
+        return true;
+    }
+    if (c == '-' || isdigit((unsigned char)c)) {
+        s->state = STREAM_NUMBER;
+        s->buf_len = 0;
+        return stream_buf_append(s, &c, 1);
+    }
+    if (c == 't' || c == 'f' || c == 'n') {
+        s->state = STREAM_LITERAL;
+        s->literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        s->literal_pos = 1;
+        return true;
+    }
+    s->state = STREAM_ERROR;
+    return false;
+}
+
+static bool stream_finish_number(json_stream *s)
+{
+    if (!stream_emit(s, JSON_EVENT_NUMBER, s->buf, s->buf_len)) return false;
+    s->buf_len = 0;
+    stream_end_value(s);
+    return true;
+}
 
-    return written == len;
+bool json_stream_feed(json_stream *s, const char *data, size_t len)
+{
+    if (!s || (!data && len > 0)) return false;
+
+    const char *p = data;
+    const char *end = data + len;
+
+    while (p < end) {
+        if (s->state == STREAM_ERROR) return false;
+
+        if (s->state == STREAM_STRING) {
+            /* Find the closing quote, honouring escapes */
+            const char *start = p;
+            bool escaped = s->escape_pending;
+            while (p < end) {
+                if (escaped) {
+                    escaped = false;
+                } else if (*p == '\\') {
+                    escaped = true;
+                } else if (*p == '"') {
+                    break;
+                }
+                p++;
+            }
+
+            /* Unescape into the token buffer; the string may continue in the next chunk */
+            if (!stream_unescape(s, start, p)) return false;
+            if (p == end) continue;
+            p++; /* Skip closing quote */
+
+            if (!stream_finish_string(s)) return false;
+            continue;
+        }
+
+        char c = *p;
+
+        if (s->state == STREAM_NUMBER) {
+            if (isdigit((unsigned char)c) || c == '.' || c == 'e' || c == 'E' ||
+                c == '+' || c == '-') {
+                if (!stream_buf_append(s, &c, 1)) return false;
+                p++;
+                continue;
+            }
+            if (!stream_finish_number(s)) return false;
+            continue;   /* Reprocess c in the new state */
+        }
+
+        if (s->state == STREAM_LITERAL) {
+            if (c != s->literal[s->literal_pos]) {
+                s->state = STREAM_ERROR;
+                return false;
+            }
+            p++;
+            if (s->literal[++s->literal_pos] == '\0') {
+                json_event_type type = s->literal[0] == 'n' ? JSON_EVENT_NULL : JSON_EVENT_BOOL;
+                if (!stream_emit(s, type, s->literal, s->literal_pos)) return false;
+                stream_end_value(s);
+            }
+            continue;
+        }
+
+        p++;
+        if (isspace((unsigned char)c)) continue;
+
+        bool ok;
+        switch (s->state) {
+        case STREAM_VALUE:
+            ok = stream_begin_value(s, c);
+            break;
+        case STREAM_VALUE_OR_END:
+            ok = c == ']' ? stream_close(s, c) : stream_begin_value(s, c);
+            break;
+        case STREAM_KEY_OR_END:
+        case STREAM_KEY:
+            if (c == '"') {
+                s->state = STREAM_STRING;
+                s->string_is_key = true;
+                s->buf_len = 0;
+                ok = true;
+            } else {
+                ok = c == '}' && s->state == STREAM_KEY_OR_END && stream_close(s, c);
+            }
+            break;
+        case STREAM_COLON:
+            ok = c == ':';
+            s->state = STREAM_VALUE;
+            break;
+        case STREAM_AFTER_VALUE:
+            if (c == ',') {
+                s->state = s->stack[s->depth - 1] == '{' ? STREAM_KEY : STREAM_VALUE;
+                ok = true;
+            } else {
+                ok = (c == '}' || c == ']') && stream_close(s, c);
+            }
+            break;
+        default:
+            /* Trailing content after the root value */
+            ok = false;
+            break;
+        }
+
+        if (!ok) {
+            s->state = STREAM_ERROR;
+            return false;
+        }
+    }
+
+    return s->state != STREAM_ERROR;
+}
+
+bool json_stream_finish(json_stream *stream)
+{
+    if (!stream) return false;
+
+    if (stream->state == STREAM_NUMBER && stream->depth == 0) {
+        if (!stream_finish_number(stream)) return false;
+    }
+    return stream->state == STREAM_DONE;
 }
@@ -31,27 +31,39 @@ typedef struct json_value json_value;
 typedef struct json_pair {
     char *key;
     json_value *value;
-    struct json_pair *next;
 } json_pair;
 
-/* JSON array element */
-typedef struct json_element {
-    json_value *value;
-    struct json_element *next;
-} json_element;
-
-/* JSON value structure */
+/*
+ * JSON value structure
+ *
+ * Arrays and objects store their children contiguously, so indexed access
+ * is O(1). Containers owned by a json_document have capacity -1 and are
+ * read-only; large document objects also carry a hash index over their keys.
+ */
 struct json_value {
     json_type type;
     union {
         bool bool_val;
         double number_val;
         char *string_val;
-        json_element *array_val;
-        json_pair *object_val;
+        struct {
+            json_value **items;
+            int count;
+            int capacity;
+        } array_val;
+        struct {
+            json_pair *pairs;       /* In insertion order */
+            int count;
+            int capacity;
+            int *index;             /* Open-addressed slots into pairs, or NULL */
+            int index_size;         /* Power of two */
+        } object_val;
     } data;
 };
 
+/* Parsed JSON document whose values all live in a single arena */
+typedef struct json_document json_document;
+
 /*
  * Parsing functions
  */
@@ -62,6 +74,72 @@ json_value *json_parse(const char *str);
 /* Parse a JSON file. Returns NULL on error. */
 json_value *json_parse_file(const char *filename);
 
+/*
+ * Parse a JSON string into an arena-backed document. Every node, key and
+ * string is carved out of a few large blocks, so the whole tree is released
+ * with one json_document_free() call. Values in a document are read-only:
+ * json_array_push/json_object_set fail on them, and they must not be passed
+ * to json_free(). Object keys are indexed once an object has 16 or more.
+ * Returns NULL on error.
+ */
+json_document *json_document_parse(const char *str);
+
+/* Parse a JSON file into an arena-backed document. Returns NULL on error. */
+json_document *json_document_parse_file(const char *filename);
+
+/* Get the root value of a document. Returns NULL if doc is NULL. */
+json_value *json_document_root(const json_document *doc);
+
+/* Free a document and every value in it */
+void json_document_free(json_document *doc);
+
+/*
+ * Streaming (event) parser
+ *
+ * Emits one event per token as input is fed in arbitrary chunks, without
+ * building a tree. Tokens may span chunk boundaries. Depth counts the
+ * containers enclosing the event: the root value is at depth 0, and the
+ * keys and values of a root object are at depth 1.
+ */
+
+typedef enum {
+    JSON_EVENT_OBJECT_START,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_KEY,
+    JSON_EVENT_STRING,
+    JSON_EVENT_NUMBER,
+    JSON_EVENT_BOOL,
+    JSON_EVENT_NULL
+} json_event_type;
+
+typedef struct {
+    json_event_type type;
+    int depth;
+    const char *str;        /* KEY/STRING: unescaped, only valid during the callback */
+    size_t len;
+    double number;          /* NUMBER */
+    bool bool_val;          /* BOOL */
+} json_event;
+
+/* Event callback. Return false to stop parsing. */
+typedef bool (*json_event_fn)(void *user, const json_event *event);
+
+typedef struct json_stream json_stream;
+
+/* Create a streaming parser. Returns NULL on error. */
+json_stream *json_stream_create(json_event_fn callback, void *user);
+
+/* Feed the next chunk of input. Returns false on a syntax error or if the callback stopped. */
+bool json_stream_feed(json_stream *stream, const char *data, size_t len);
+
+/* Signal end of input. Returns true if exactly one complete value was parsed. */
+bool json_stream_finish(json_stream *stream);
+
+/* Free a streaming parser */
+void json_stream_destroy(json_stream *stream);
+
 /*
  * Value access functions
  */
@@ -131,9 +209,52 @@ char *json_stringify(const json_value *val);
 /* Convert JSON value to formatted string. Caller must free the result. */
 char *json_stringify_pretty(const json_value *val);
 
-/* Write JSON value to file */
+/* Write JSON value to file, replacing it atomically (see json_out_open) */
 bool json_write_file(const json_value *val, const char *filename, bool pretty);
 
+/*
+ * Streaming writer
+ *
+ * Writes JSON straight to a file through a fixed buffer, without building
+ * a tree. Output goes to "<filename>.tmp", and json_out_close() renames it
+ * over filename, so a crash mid-write leaves the old file intact. Errors
+ * are sticky: once a call fails the rest do nothing, and json_out_close()
+ * reports it. The format matches json_stringify_pretty().
+ */
+
+typedef struct json_out json_out;
+
+/* Start writing filename. Returns NULL if the temp file can't be created. */
+json_out *json_out_open(const char *filename, bool pretty);
+
+/*
+ * Finish and move the file into place. Returns false, leaving filename
+ * untouched, if any write failed or a container is still open. Frees out.
+ */
+bool json_out_close(json_out *out);
+
+void json_out_begin_object(json_out *out);
+void json_out_end_object(json_out *out);
+void json_out_begin_array(json_out *out);
+void json_out_end_array(json_out *out);
+
+/* Object key; the next value written belongs to it */
+void json_out_key(json_out *out, const char *key);
+
+/* Values, as array elements or after a key. A NULL string writes "". */
+void json_out_string(json_out *out, const char *val);
+void json_out_number(json_out *out, double val);
+void json_out_bool(json_out *out, bool val);
+void json_out_null(json_out *out);
+
+/* Embed an existing tree */
+void json_out_value(json_out *out, const json_value *val);
+
+/* Key and value in one call */
+void json_out_field_string(json_out *out, const char *key, const char *val);
+void json_out_field_number(json_out *out, const char *key, double val);
+void json_out_field_bool(json_out *out, const char *key, bool val);
+
 /*
  * Memory management
  */
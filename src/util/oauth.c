@@ -28,6 +28,7 @@
 #define CODE_VERIFIER_LEN 64
 #define STATE_LEN 32
 #define CALLBACK_TIMEOUT_SEC 300  /* 5 minutes */
+#define CALLBACK_POLL_MS 250      /* oauth_cancel() latency */
 
 /*
  * OAuth2 Client structure
@@ -36,8 +37,12 @@ struct oauth_client {
     /* Configuration */
     oauth_config config;
 
-    /* Current tokens */
+    /* Current tokens, swapped by refreshes on another thread */
     oauth_token tokens;
+    CRITICAL_SECTION lock;
+
+    /* Set by oauth_cancel() */
+    volatile LONG cancelled;
 
     /* PKCE state (during auth flow) */
     char *code_verifier;
@@ -175,9 +180,11 @@ static bool open_browser(const char *url)
 
 /*
  * Helper: Simple HTTP callback server
- * Waits for a single GET request and extracts the 'code' parameter
+ * Waits for a single GET request and extracts the 'code' parameter.
+ * Gives up early once *cancelled is set.
  */
-static char *wait_for_callback(int port, const char *expected_state, int timeout_sec)
+static char *wait_for_callback(int port, const char *expected_state, int timeout_sec,
+                               volatile LONG *cancelled)
 {
     WSADATA wsa;
     if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
@@ -213,12 +220,29 @@ static char *wait_for_callback(int port, const char *expected_state, int timeout
         goto cleanup;
     }
 
-    /* Set timeout */
-    DWORD timeout_ms = timeout_sec * 1000;
-    setsockopt(server_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout_ms, sizeof(timeout_ms));
-
     printf("Waiting for authorization (timeout: %d seconds)...\n", timeout_sec);
 
+    /* Poll for the browser's connection so a cancel is noticed */
+    ULONGLONG deadline = GetTickCount64() + (ULONGLONG)timeout_sec * 1000;
+    for (;;) {
+        if (*cancelled || GetTickCount64() >= deadline) {
+            goto cleanup;
+        }
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(server_socket, &readable);
+        struct timeval poll = { 0, CALLBACK_POLL_MS * 1000 };
+
+        int ready = select(0, &readable, NULL, NULL, &poll);
+        if (ready == SOCKET_ERROR) {
+            goto cleanup;
+        }
+        if (ready > 0) {
+            break;
+        }
+    }
+
     /* Accept connection */
     client_socket = accept(server_socket, NULL, NULL);
     if (client_socket == INVALID_SOCKET) {
@@ -371,6 +395,7 @@ static bool exchange_code_for_tokens(oauth_client *client, const char *code)
     }
 
     /* Store tokens */
+    EnterCriticalSection(&client->lock);
     free(client->tokens.access_token);
     free(client->tokens.refresh_token);
     free(client->tokens.token_type);
@@ -382,6 +407,7 @@ static bool exchange_code_for_tokens(oauth_client *client, const char *code)
     time_t now = time(NULL);
     client->tokens.access_expires = now + expires_in;
     client->tokens.refresh_expires = refresh_expires_in > 0 ? now + refresh_expires_in : 0;
+    LeaveCriticalSection(&client->lock);
 
     json_free(json);
     return true;
@@ -398,6 +424,8 @@ oauth_client *oauth_create(const oauth_config *config)
     oauth_client *client = calloc(1, sizeof(oauth_client));
     if (!client) return NULL;
 
+    InitializeCriticalSection(&client->lock);
+
     /* Copy configuration */
     client->config.client_id = strdup(config->client_id);
     client->config.client_secret = config->client_secret ? strdup(config->client_secret) : NULL;
@@ -454,6 +482,7 @@ void oauth_destroy(oauth_client *client)
     /* Free HTTP session */
     if (client->http) http_session_destroy(client->http);
 
+    DeleteCriticalSection(&client->lock);
     free(client);
 }
 
@@ -467,16 +496,48 @@ const char *oauth_get_access_token(oauth_client *client)
     return client->tokens.access_token;
 }
 
+char *oauth_copy_access_token(oauth_client *client)
+{
+    if (!client) return NULL;
+
+    EnterCriticalSection(&client->lock);
+    char *token = NULL;
+    if (client->tokens.access_token && time(NULL) < client->tokens.access_expires) {
+        token = strdup(client->tokens.access_token);
+    }
+    LeaveCriticalSection(&client->lock);
+    return token;
+}
+
+time_t oauth_access_expires(oauth_client *client)
+{
+    if (!client) return 0;
+
+    EnterCriticalSection(&client->lock);
+    time_t expires = client->tokens.access_token ? client->tokens.access_expires : 0;
+    LeaveCriticalSection(&client->lock);
+    return expires;
+}
+
 bool oauth_token_valid(oauth_client *client)
 {
-    if (!client || !client->tokens.access_token) return false;
-    return time(NULL) < client->tokens.access_expires;
+    if (!client) return false;
+
+    EnterCriticalSection(&client->lock);
+    bool valid = client->tokens.access_token && time(NULL) < client->tokens.access_expires;
+    LeaveCriticalSection(&client->lock);
+    return valid;
 }
 
 bool oauth_token_expiring(oauth_client *client, int margin_seconds)
 {
-    if (!client || !client->tokens.access_token) return true;
-    return (client->tokens.access_expires - time(NULL)) < margin_seconds;
+    if (!client) return true;
+
+    EnterCriticalSection(&client->lock);
+    bool expiring = !client->tokens.access_token ||
+                    (client->tokens.access_expires - time(NULL)) < margin_seconds;
+    LeaveCriticalSection(&client->lock);
+    return expiring;
 }
 
 /*
@@ -487,6 +548,12 @@ bool oauth_authorize(oauth_client *client)
 {
     if (!client) return false;
 
+    /* Cleared only by oauth_reset_cancel(), so a cancel can't be missed */
+    if (client->cancelled) {
+        set_error(client, "Authorization was cancelled");
+        return false;
+    }
+
     /* Generate PKCE code verifier */
     free(client->code_verifier);
     client->code_verifier = generate_random_string(CODE_VERIFIER_LEN);
@@ -552,7 +619,8 @@ bool oauth_authorize(oauth_client *client)
     /* Wait for callback */
     char *auth_code = wait_for_callback(client->config.callback_port,
                                          client->state,
-                                         CALLBACK_TIMEOUT_SEC);
+                                         CALLBACK_TIMEOUT_SEC,
+                                         &client->cancelled);
 
     if (!auth_code) {
         set_error(client, "Authorization timed out or was cancelled");
@@ -582,12 +650,16 @@ bool oauth_authorize(oauth_client *client)
 
 bool oauth_refresh(oauth_client *client)
 {
-    if (!client || !client->tokens.refresh_token) {
+    if (!client) return false;
+
+    /* Build refresh request body; the request itself runs unlocked */
+    EnterCriticalSection(&client->lock);
+    if (!client->tokens.refresh_token) {
+        LeaveCriticalSection(&client->lock);
         set_error(client, "No refresh token available");
         return false;
     }
 
-    /* Build refresh request body */
     char body[1024];
     snprintf(body, sizeof(body),
         "grant_type=refresh_token"
@@ -595,6 +667,7 @@ bool oauth_refresh(oauth_client *client)
         "&refresh_token=%s",
         client->config.client_id,
         client->tokens.refresh_token);
+    LeaveCriticalSection(&client->lock);
 
     if (client->config.client_secret) {
         size_t body_len = strlen(body);
@@ -644,6 +717,7 @@ bool oauth_refresh(oauth_client *client)
     }
 
     /* Clear old tokens */
+    EnterCriticalSection(&client->lock);
     if (client->tokens.access_token) {
         memset(client->tokens.access_token, 0, strlen(client->tokens.access_token));
         free(client->tokens.access_token);
@@ -659,11 +733,22 @@ bool oauth_refresh(oauth_client *client)
     time_t now = time(NULL);
     client->tokens.access_expires = now + expires_in;
     client->tokens.refresh_expires = refresh_expires_in > 0 ? now + refresh_expires_in : 0;
+    LeaveCriticalSection(&client->lock);
 
     json_free(json);
     return true;
 }
 
+void oauth_cancel(oauth_client *client)
+{
+    if (client) InterlockedExchange(&client->cancelled, 1);
+}
+
+void oauth_reset_cancel(oauth_client *client)
+{
+    if (client) InterlockedExchange(&client->cancelled, 0);
+}
+
 /*
  * Token Persistence
  */
@@ -671,11 +756,17 @@ bool oauth_refresh(oauth_client *client)
 bool oauth_save_tokens(oauth_client *client, const char *filename)
 {
     if (!client || !filename) return false;
-    if (!client->tokens.access_token) return false;
 
     json_value *root = json_new_object();
     if (!root) return false;
 
+    EnterCriticalSection(&client->lock);
+    if (!client->tokens.access_token) {
+        LeaveCriticalSection(&client->lock);
+        json_free(root);
+        return false;
+    }
+
     json_object_set(root, "access_token",
                     json_new_string(client->tokens.access_token));
 
@@ -692,6 +783,7 @@ bool oauth_save_tokens(oauth_client *client, const char *filename)
                     json_new_number((double)client->tokens.access_expires));
     json_object_set(root, "refresh_expires",
                     json_new_number((double)client->tokens.refresh_expires));
+    LeaveCriticalSection(&client->lock);
 
     bool result = json_write_file(root, filename, true);
     json_free(root);
@@ -717,6 +809,7 @@ bool oauth_load_tokens(oauth_client *client, const char *filename)
     }
 
     /* Free existing tokens */
+    EnterCriticalSection(&client->lock);
     free(client->tokens.access_token);
     free(client->tokens.refresh_token);
     free(client->tokens.token_type);
@@ -726,6 +819,7 @@ bool oauth_load_tokens(oauth_client *client, const char *filename)
     client->tokens.token_type = type ? strdup(type) : strdup("Bearer");
     client->tokens.access_expires = (time_t)access_exp;
     client->tokens.refresh_expires = (time_t)refresh_exp;
+    LeaveCriticalSection(&client->lock);
 
     json_free(root);
     return true;
@@ -51,11 +51,21 @@ void oauth_destroy(oauth_client *client);
 
 /*
  * Token Management
+ *
+ * Tokens may be refreshed on another thread, so the functions below are
+ * safe to call concurrently, except oauth_get_access_token(), whose
+ * result is only stable while no refresh can run.
  */
 
 /* Get current access token (NULL if not authenticated) */
 const char *oauth_get_access_token(oauth_client *client);
 
+/* Copy of the access token, or NULL if expired; free() it */
+char *oauth_copy_access_token(oauth_client *client);
+
+/* Absolute expiry time of the access token, 0 if there is none */
+time_t oauth_access_expires(oauth_client *client);
+
 /* Check if access token is valid (not expired) */
 bool oauth_token_valid(oauth_client *client);
 
@@ -88,6 +98,15 @@ bool oauth_authorize(oauth_client *client);
  */
 bool oauth_refresh(oauth_client *client);
 
+/*
+ * Make an oauth_authorize() on another thread stop waiting and fail. Later
+ * calls fail at once too, until oauth_reset_cancel().
+ */
+void oauth_cancel(oauth_client *client);
+
+/* Allow oauth_authorize() again after oauth_cancel() */
+void oauth_reset_cancel(oauth_client *client);
+
 /*
  * Token Persistence
  */
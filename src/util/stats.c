@@ -0,0 +1,343 @@
+/*
+ * ira - iRacing Application
+ * Runtime Statistics Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stats.h"
+#include "json.h"
+
+/* Path segments kept in an endpoint name, "/data/series/seasons" */
+#define ENDPOINT_SEGMENTS 3
+
+typedef struct {
+    volatile LONG64 count;
+    volatile LONG64 total;      /* Performance counter ticks */
+    volatile LONG64 max;
+} span_totals;
+
+typedef struct {
+    char name[96];
+    LONG64 requests;
+    LONG64 failures;
+    LONG64 bytes;
+    LONG64 total;
+    LONG64 max;
+} endpoint_totals;
+
+static const char *counter_keys[STAT_COUNTER_COUNT] = {
+    "ticks_received", "ticks_missed", "copy_retries", "copy_failures"
+};
+static const char *counter_labels[STAT_COUNTER_COUNT] = {
+    "Ticks received", "Ticks missed", "Copy retries", "Copies torn"
+};
+static const char *span_keys[STAT_SPAN_COUNT] = {
+    "log_write", "yaml_parse", "app_start", "app_stop"
+};
+static const char *span_labels[STAT_SPAN_COUNT] = {
+    "Log write batch", "Session info parse", "App start", "App stop"
+};
+
+static volatile LONG64 g_counters[STAT_COUNTER_COUNT];
+static span_totals g_spans[STAT_SPAN_COUNT];
+
+/* Requests are milliseconds apart, so a lock is cheap enough here */
+static SRWLOCK g_endpoint_lock = SRWLOCK_INIT;
+static endpoint_totals g_endpoints[STATS_MAX_ENDPOINTS + 1];   /* Last is "other" */
+static int g_endpoint_count;
+
+static double g_us_per_tick;
+
+/*
+ * Helper: Microseconds per performance counter tick
+ */
+static double us_per_tick(void)
+{
+    if (g_us_per_tick == 0.0) {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        g_us_per_tick = 1000000.0 / (double)freq.QuadPart;
+    }
+    return g_us_per_tick;
+}
+
+/*
+ * Helper: Raise *max to value if it is larger
+ */
+static void update_max(volatile LONG64 *max, LONG64 value)
+{
+    LONG64 seen = *max;
+    while (value > seen) {
+        LONG64 prev = InterlockedCompareExchange64(max, value, seen);
+        if (prev == seen) {
+            break;
+        }
+        seen = prev;
+    }
+}
+
+/*
+ * Recording
+ */
+
+void stats_add(stat_counter counter, long long n)
+{
+    if (counter < 0 || counter >= STAT_COUNTER_COUNT) {
+        return;
+    }
+    InterlockedExchangeAdd64(&g_counters[counter], n);
+}
+
+long long stats_now(void)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+void stats_span_end(stat_span span, long long start)
+{
+    if (span < 0 || span >= STAT_SPAN_COUNT) {
+        return;
+    }
+
+    LONG64 elapsed = stats_now() - start;
+    span_totals *totals = &g_spans[span];
+    InterlockedIncrement64(&totals->count);
+    InterlockedExchangeAdd64(&totals->total, elapsed);
+    update_max(&totals->max, elapsed);
+}
+
+/*
+ * Helper: Endpoint name from a URL, "host/seg1/seg2/seg3"
+ */
+static void endpoint_name(const char *url, char *name, size_t size)
+{
+    const char *p = strstr(url, "://");
+    p = p ? p + 3 : url;
+
+    size_t len = 0;
+    int slashes = 0;
+    while (p[len] && p[len] != '?' && p[len] != '#') {
+        if (p[len] == '/' && ++slashes > ENDPOINT_SEGMENTS) {
+            break;
+        }
+        len++;
+    }
+    if (len > 0 && p[len - 1] == '/') {
+        len--;
+    }
+    if (len >= size) {
+        len = size - 1;
+    }
+
+    memcpy(name, p, len);
+    name[len] = '\0';
+}
+
+void stats_http(const char *url, long long start, long long bytes, bool ok)
+{
+    LONG64 elapsed = stats_now() - start;
+    char name[sizeof(g_endpoints[0].name)];
+    endpoint_name(url ? url : "", name, sizeof(name));
+
+    AcquireSRWLockExclusive(&g_endpoint_lock);
+
+    endpoint_totals *ep = NULL;
+    for (int i = 0; i < g_endpoint_count; i++) {
+        if (strcmp(g_endpoints[i].name, name) == 0) {
+            ep = &g_endpoints[i];
+            break;
+        }
+    }
+    if (!ep && g_endpoint_count < STATS_MAX_ENDPOINTS) {
+        ep = &g_endpoints[g_endpoint_count++];
+        strcpy(ep->name, name);
+    }
+    if (!ep) {
+        ep = &g_endpoints[STATS_MAX_ENDPOINTS];
+        strcpy(ep->name, "other");
+    }
+
+    ep->requests++;
+    ep->failures += ok ? 0 : 1;
+    ep->bytes += bytes;
+    ep->total += elapsed;
+    if (elapsed > ep->max) {
+        ep->max = elapsed;
+    }
+
+    ReleaseSRWLockExclusive(&g_endpoint_lock);
+}
+
+/*
+ * Reading
+ */
+
+long long stats_get_counter(stat_counter counter)
+{
+    if (counter < 0 || counter >= STAT_COUNTER_COUNT) {
+        return 0;
+    }
+    return InterlockedOr64(&g_counters[counter], 0);
+}
+
+void stats_get_span(stat_span span, stats_span_info *info)
+{
+    if (!info) {
+        return;
+    }
+    memset(info, 0, sizeof(*info));
+    if (span < 0 || span >= STAT_SPAN_COUNT) {
+        return;
+    }
+
+    span_totals *totals = &g_spans[span];
+    info->count = InterlockedOr64(&totals->count, 0);
+    info->total_us = (double)InterlockedOr64(&totals->total, 0) * us_per_tick();
+    info->max_us = (double)InterlockedOr64(&totals->max, 0) * us_per_tick();
+}
+
+int stats_get_endpoints(stats_endpoint *endpoints, int max)
+{
+    if (!endpoints || max <= 0) {
+        return 0;
+    }
+
+    double scale = us_per_tick();
+    int count = 0;
+
+    AcquireSRWLockShared(&g_endpoint_lock);
+    for (int i = 0; i <= STATS_MAX_ENDPOINTS && count < max; i++) {
+        const endpoint_totals *ep = &g_endpoints[i];
+        if (i == STATS_MAX_ENDPOINTS ? ep->requests == 0 : i >= g_endpoint_count) {
+            continue;
+        }
+
+        stats_endpoint *out = &endpoints[count++];
+        memcpy(out->name, ep->name, sizeof(out->name));
+        out->requests = ep->requests;
+        out->failures = ep->failures;
+        out->bytes = ep->bytes;
+        out->total_us = (double)ep->total * scale;
+        out->max_us = (double)ep->max * scale;
+    }
+    ReleaseSRWLockShared(&g_endpoint_lock);
+
+    return count;
+}
+
+const char *stats_counter_name(stat_counter counter)
+{
+    if (counter < 0 || counter >= STAT_COUNTER_COUNT) {
+        return "unknown";
+    }
+    return counter_keys[counter];
+}
+
+const char *stats_span_name(stat_span span)
+{
+    if (span < 0 || span >= STAT_SPAN_COUNT) {
+        return "unknown";
+    }
+    return span_keys[span];
+}
+
+/*
+ * Output
+ */
+
+void stats_print(void)
+{
+    printf("\n=== Runtime Statistics ===\n\n");
+
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        printf("  %-20s %lld\n", counter_labels[i], stats_get_counter((stat_counter)i));
+    }
+
+    printf("\n  %-20s %8s %10s %10s\n", "Span", "Count", "Mean ms", "Max ms");
+    for (int i = 0; i < STAT_SPAN_COUNT; i++) {
+        stats_span_info info;
+        stats_get_span((stat_span)i, &info);
+        double mean = info.count > 0 ? info.total_us / (double)info.count : 0.0;
+        printf("  %-20s %8lld %10.3f %10.3f\n", span_labels[i], info.count,
+               mean / 1000.0, info.max_us / 1000.0);
+    }
+
+    stats_endpoint endpoints[STATS_MAX_ENDPOINTS + 1];
+    int count = stats_get_endpoints(endpoints, STATS_MAX_ENDPOINTS + 1);
+
+    printf("\n  HTTP requests:\n");
+    if (count == 0) {
+        printf("  (none)\n");
+    }
+    for (int i = 0; i < count; i++) {
+        const stats_endpoint *ep = &endpoints[i];
+        double mean = ep->requests > 0 ? ep->total_us / (double)ep->requests : 0.0;
+        printf("  %s\n", ep->name);
+        printf("      %lld requests, %lld failed, %.1f KB, mean %.1f ms, max %.1f ms\n",
+               ep->requests, ep->failures, (double)ep->bytes / 1024.0,
+               mean / 1000.0, ep->max_us / 1000.0);
+    }
+}
+
+/*
+ * Helper: Span totals as a JSON object
+ */
+static json_value *timing_object(long long count, double total_us, double max_us)
+{
+    json_value *obj = json_new_object();
+    json_object_set(obj, "count", json_new_number((double)count));
+    json_object_set(obj, "total_us", json_new_number(total_us));
+    json_object_set(obj, "mean_us", json_new_number(count > 0 ? total_us / (double)count : 0.0));
+    json_object_set(obj, "max_us", json_new_number(max_us));
+    return obj;
+}
+
+bool stats_dump_json(const char *filename)
+{
+    if (!filename) {
+        return false;
+    }
+
+    json_value *root = json_new_object();
+    json_value *counters = json_new_object();
+    json_value *spans = json_new_object();
+    json_value *http = json_new_array();
+
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        json_object_set(counters, counter_keys[i],
+                        json_new_number((double)stats_get_counter((stat_counter)i)));
+    }
+
+    for (int i = 0; i < STAT_SPAN_COUNT; i++) {
+        stats_span_info info;
+        stats_get_span((stat_span)i, &info);
+        json_object_set(spans, span_keys[i], timing_object(info.count, info.total_us, info.max_us));
+    }
+
+    stats_endpoint endpoints[STATS_MAX_ENDPOINTS + 1];
+    int count = stats_get_endpoints(endpoints, STATS_MAX_ENDPOINTS + 1);
+    for (int i = 0; i < count; i++) {
+        const stats_endpoint *ep = &endpoints[i];
+        json_value *obj = timing_object(ep->requests, ep->total_us, ep->max_us);
+        json_object_set(obj, "endpoint", json_new_string(ep->name));
+        json_object_set(obj, "failures", json_new_number((double)ep->failures));
+        json_object_set(obj, "bytes", json_new_number((double)ep->bytes));
+        json_array_push(http, obj);
+    }
+
+    json_object_set(root, "counters", counters);
+    json_object_set(root, "spans", spans);
+    json_object_set(root, "http", http);
+
+    bool ok = json_write_file(root, filename, true);
+    json_free(root);
+    return ok;
+}
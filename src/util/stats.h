@@ -0,0 +1,99 @@
+/*
+ * ira - iRacing Application
+ * Runtime Statistics - always-on counters and timing spans
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_STATS_H
+#define IRA_STATS_H
+
+#include <stdbool.h>
+
+/*
+ * Process-wide counters and spans, safe to update from any thread. An
+ * update is an interlocked add, and a span costs two performance counter
+ * reads, so they stay on in release builds.
+ */
+
+/* Counters */
+typedef enum {
+    STAT_TICKS_RECEIVED,        /* SDK ticks delivered to the caller */
+    STAT_TICKS_MISSED,          /* Gaps in tick_count between deliveries */
+    STAT_COPY_RETRIES,          /* Copies redone because the sim wrote the slot */
+    STAT_COPY_FAILURES,         /* Ticks lost because both copies were torn */
+    STAT_COUNTER_COUNT
+} stat_counter;
+
+/* Timed spans */
+typedef enum {
+    STAT_SPAN_LOG_WRITE,        /* Telemetry writer batch, write and flush */
+    STAT_SPAN_YAML_PARSE,       /* Session info indexing */
+    STAT_SPAN_APP_START,        /* Launching one app */
+    STAT_SPAN_APP_STOP,         /* Closing one app */
+    STAT_SPAN_COUNT
+} stat_span;
+
+/* Endpoints tracked separately; later ones are counted under "other" */
+#define STATS_MAX_ENDPOINTS 32
+
+/* Span totals */
+typedef struct {
+    long long count;
+    double total_us;
+    double max_us;
+} stats_span_info;
+
+/* HTTP totals for one endpoint (host and leading path segments) */
+typedef struct {
+    char name[96];
+    long long requests;
+    long long failures;         /* No response at all */
+    long long bytes;            /* Response bodies */
+    double total_us;
+    double max_us;
+} stats_endpoint;
+
+/*
+ * Recording
+ */
+
+/* Add n to a counter */
+void stats_add(stat_counter counter, long long n);
+
+/* Start a span; pass the result to stats_span_end() or stats_http() */
+long long stats_now(void);
+
+/* End a span started with stats_now() */
+void stats_span_end(stat_span span, long long start);
+
+/*
+ * Record an HTTP request started at start.
+ *
+ * Parameters:
+ *   url - Request URL; the query string and later path segments are dropped
+ *   bytes - Response body length
+ *   ok - false if the request got no response
+ */
+void stats_http(const char *url, long long start, long long bytes, bool ok);
+
+/*
+ * Reading
+ */
+
+long long stats_get_counter(stat_counter counter);
+void stats_get_span(stat_span span, stats_span_info *info);
+
+/* Copy up to max endpoints; returns the number copied */
+int stats_get_endpoints(stats_endpoint *endpoints, int max);
+
+const char *stats_counter_name(stat_counter counter);
+const char *stats_span_name(stat_span span);
+
+/* Print everything as a table */
+void stats_print(void);
+
+/* Write everything to a JSON file */
+bool stats_dump_json(const char *filename);
+
+#endif /* IRA_STATS_H */
@@ -0,0 +1,150 @@
+/*
+ * ira - iRacing Application
+ * Background Worker Implementation
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "worker.h"
+
+/* Queued message; the payload follows the header in the same block */
+typedef struct worker_msg {
+    struct worker_msg *next;
+    int type;
+    size_t size;
+} worker_msg;
+
+struct worker {
+    worker_fn handler;
+    void *ctx;
+
+    HANDLE thread;
+    HANDLE wake_event;          /* Auto-reset: queue became non-empty or stopping */
+    HANDLE idle_event;          /* Manual-reset: queue empty and handler idle */
+
+    CRITICAL_SECTION lock;
+    worker_msg *head;
+    worker_msg *tail;
+    bool stopping;
+};
+
+static DWORD WINAPI worker_thread_proc(LPVOID param)
+{
+    worker *w = (worker *)param;
+
+    for (;;) {
+        EnterCriticalSection(&w->lock);
+        worker_msg *msg = w->head;
+        if (msg) {
+            w->head = msg->next;
+            if (!w->head) w->tail = NULL;
+        } else {
+            SetEvent(w->idle_event);
+        }
+        bool stopping = w->stopping;
+        LeaveCriticalSection(&w->lock);
+
+        if (!msg) {
+            /* Messages are drained before stopping */
+            if (stopping) break;
+            WaitForSingleObject(w->wake_event, INFINITE);
+            continue;
+        }
+
+        w->handler(w->ctx, msg->type, msg->size ? (const void *)(msg + 1) : NULL, msg->size);
+        free(msg);
+    }
+
+    return 0;
+}
+
+worker *worker_create(worker_fn handler, void *ctx)
+{
+    if (!handler) return NULL;
+
+    worker *w = calloc(1, sizeof(worker));
+    if (!w) return NULL;
+
+    w->handler = handler;
+    w->ctx = ctx;
+    InitializeCriticalSection(&w->lock);
+
+    w->wake_event = CreateEventA(NULL, FALSE, FALSE, NULL);
+    w->idle_event = CreateEventA(NULL, TRUE, TRUE, NULL);
+    if (w->wake_event && w->idle_event) {
+        w->thread = CreateThread(NULL, 0, worker_thread_proc, w, 0, NULL);
+    }
+
+    if (!w->thread) {
+        if (w->wake_event) CloseHandle(w->wake_event);
+        if (w->idle_event) CloseHandle(w->idle_event);
+        DeleteCriticalSection(&w->lock);
+        free(w);
+        return NULL;
+    }
+
+    return w;
+}
+
+void worker_destroy(worker *w)
+{
+    if (!w) return;
+
+    EnterCriticalSection(&w->lock);
+    w->stopping = true;
+    LeaveCriticalSection(&w->lock);
+    SetEvent(w->wake_event);
+
+    WaitForSingleObject(w->thread, INFINITE);
+    CloseHandle(w->thread);
+    CloseHandle(w->wake_event);
+    CloseHandle(w->idle_event);
+    DeleteCriticalSection(&w->lock);
+    free(w);
+}
+
+bool worker_post(worker *w, int type, const void *payload, size_t size)
+{
+    return worker_post_parts(w, type, payload, size, NULL, 0);
+}
+
+bool worker_post_parts(worker *w, int type, const void *head, size_t head_size,
+                       const void *tail, size_t tail_size)
+{
+    if (!w) return false;
+
+    if (!head) head_size = 0;
+    if (!tail) tail_size = 0;
+
+    worker_msg *msg = malloc(sizeof(worker_msg) + head_size + tail_size);
+    if (!msg) return false;
+
+    msg->next = NULL;
+    msg->type = type;
+    msg->size = head_size + tail_size;
+    if (head_size) memcpy(msg + 1, head, head_size);
+    if (tail_size) memcpy((char *)(msg + 1) + head_size, tail, tail_size);
+
+    EnterCriticalSection(&w->lock);
+    if (w->tail) {
+        w->tail->next = msg;
+    } else {
+        w->head = msg;
+    }
+    w->tail = msg;
+    ResetEvent(w->idle_event);
+    LeaveCriticalSection(&w->lock);
+
+    SetEvent(w->wake_event);
+    return true;
+}
+
+void worker_flush(worker *w)
+{
+    if (!w) return;
+    WaitForSingleObject(w->idle_event, INFINITE);
+}
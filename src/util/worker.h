@@ -0,0 +1,55 @@
+/*
+ * ira - iRacing Application
+ * Background Worker - thread with a message queue
+ *
+ * Copyright (c) 2026 Christopher Griffiths
+ */
+
+#ifndef IRA_WORKER_H
+#define IRA_WORKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Worker (opaque type)
+ * Runs a handler on its own thread for each posted message, in order.
+ */
+typedef struct worker worker;
+
+/*
+ * Message handler, called on the worker thread.
+ * payload is a private copy, valid only for the duration of the call.
+ */
+typedef void (*worker_fn)(void *ctx, int type, const void *payload, size_t size);
+
+/* Start a worker thread. Returns NULL on error. */
+worker *worker_create(worker_fn handler, void *ctx);
+
+/*
+ * Finish all queued messages, then stop the thread and free the worker.
+ */
+void worker_destroy(worker *w);
+
+/*
+ * Queue a message. The payload (may be NULL) is copied, so the caller
+ * can reuse its buffer immediately. Never blocks on the handler.
+ * Returns false on allocation failure.
+ */
+bool worker_post(worker *w, int type, const void *payload, size_t size);
+
+/*
+ * Queue a message whose payload is head followed by tail, copied straight
+ * into the queue entry. Saves building the payload in a buffer of its own
+ * just for worker_post() to copy it again. Either part may be NULL.
+ */
+bool worker_post_parts(worker *w, int type, const void *head, size_t head_size,
+                       const void *tail, size_t tail_size);
+
+/*
+ * Block until every message posted so far has been handled. Whatever
+ * the handler wrote is then visible to the caller.
+ */
+void worker_flush(worker *w);
+
+#endif /* IRA_WORKER_H */